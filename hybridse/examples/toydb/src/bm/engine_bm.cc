@@ -134,6 +134,16 @@ static void BM_EngineRunBatchWindowSumFeature5(
     EngineRunBatchWindowSumFeature5(&state, BENCHMARK, state.range(0),
                                     state.range(1));
 }
+static void BM_EngineRunBatchLastJoinWithoutIndex(
+    benchmark::State& state) {  // NOLINT
+    EngineRunBatchLastJoinWithoutIndex(&state, BENCHMARK, state.range(0),
+                                       state.range(1));
+}
+static void BM_EngineRunBatchLastJoinWithoutIndexWithCondition(
+    benchmark::State& state) {  // NOLINT
+    EngineRunBatchLastJoinWithoutIndexWithCondition(
+        &state, BENCHMARK, state.range(0), state.range(1));
+}
 static void BM_EngineRunBatchWindowSumFeature1ExcludeCurrentTime(
     benchmark::State& state) {  // NOLINT
     EngineRunBatchWindowSumFeature1ExcludeCurrentTime(
@@ -248,6 +258,14 @@ BENCHMARK(BM_EngineRunBatchWindowSumFeature1)
     ->Args({100, 100})
     ->Args({1000, 1000})
     ->Args({10000, 10000});
+BENCHMARK(BM_EngineRunBatchLastJoinWithoutIndex)
+    ->Args({100, 100})
+    ->Args({1000, 1000})
+    ->Args({10000, 10000});
+BENCHMARK(BM_EngineRunBatchLastJoinWithoutIndexWithCondition)
+    ->Args({100, 100})
+    ->Args({1000, 1000})
+    ->Args({10000, 10000});
 BENCHMARK(BM_EngineRunBatchWindowSumFeature5)
     ->Args({1, 2})
     ->Args({1, 10})
@@ -251,6 +251,28 @@ void EngineRunBatchWindowSumFeature5(benchmark::State* state, MODE mode,
     EngineBatchMode(sql, mode, limit_cnt, size, state);
 }
 
+void EngineRunBatchLastJoinWithoutIndex(benchmark::State* state, MODE mode,
+                                        int64_t limit_cnt,
+                                        int64_t size) {  // NOLINT
+    // col6 isn't indexed, the right side is grouped and sorted in memory
+    const std::string sql =
+        "SELECT t1.col1, t2.col4 as t2_col4 "
+        "FROM t1 LAST JOIN t1 AS t2 ORDER BY t2.col5 ON t1.col6 = t2.col6 limit " +
+        std::to_string(limit_cnt) + ";";
+    EngineBatchMode(sql, mode, limit_cnt, size, state);
+}
+void EngineRunBatchLastJoinWithoutIndexWithCondition(benchmark::State* state,
+                                                     MODE mode,
+                                                     int64_t limit_cnt,
+                                                     int64_t size) {  // NOLINT
+    const std::string sql =
+        "SELECT t1.col1, t2.col4 as t2_col4 "
+        "FROM t1 LAST JOIN t1 AS t2 ORDER BY t2.col5 "
+        "ON t1.col6 = t2.col6 AND t1.col5 >= t2.col5 limit " +
+        std::to_string(limit_cnt) + ";";
+    EngineBatchMode(sql, mode, limit_cnt, size, state);
+}
+
 void EngineRunBatchWindowSumFeature1ExcludeCurrentTime(
     benchmark::State* state, MODE mode, int64_t limit_cnt,
     int64_t size) {  // NOLINT
@@ -49,6 +49,13 @@ void EngineRunBatchWindowSumFeature1ExcludeCurrentTime(benchmark::State* state,
 void EngineRunBatchWindowSumFeature1(benchmark::State* state, MODE mode,
                                      int64_t limit_cnt,
                                      int64_t size);  // NOLINT
+void EngineRunBatchLastJoinWithoutIndex(benchmark::State* state, MODE mode,
+                                        int64_t limit_cnt,
+                                        int64_t size);  // NOLINT
+void EngineRunBatchLastJoinWithoutIndexWithCondition(benchmark::State* state,
+                                                     MODE mode,
+                                                     int64_t limit_cnt,
+                                                     int64_t size);  // NOLINT
 void EngineRunBatchWindowSumFeature5Window5(benchmark::State* state, MODE mode,
                                             int64_t limit_cnt,
                                             int64_t size);  // NOLINT
@@ -68,6 +68,10 @@ TEST_F(EngineBMCaseTest, EngineRunBatchWindowSumFeature1_TEST) {
     EngineRunBatchWindowSumFeature1(nullptr, TEST, 100L, 100L);
     EngineRunBatchWindowSumFeature1(nullptr, TEST, 1000L, 1000L);
 }
+TEST_F(EngineBMCaseTest, EngineRunBatchLastJoinWithoutIndex_TEST) {
+    EngineRunBatchLastJoinWithoutIndex(nullptr, TEST, 100L, 100L);
+    EngineRunBatchLastJoinWithoutIndexWithCondition(nullptr, TEST, 100L, 100L);
+}
 TEST_F(EngineBMCaseTest, EngineRunBatchWindowSumFeature5Window5_TEST) {
     EngineRunBatchWindowSumFeature5Window5(nullptr, TEST, 100L, 100L);
 }
@@ -16,6 +16,7 @@
 
 #ifndef HYBRIDSE_INCLUDE_BASE_ITERATOR_H_
 #define HYBRIDSE_INCLUDE_BASE_ITERATOR_H_
+#include <stddef.h>
 #include <stdint.h>
 
 namespace hybridse {
@@ -84,6 +85,21 @@ class AbstractIterator {
 
     /// Move to the beginning of the dataset.
     virtual void SeekToFirst() = 0;
+
+    /// Copy at most `n` elements from the current position into `keys` and
+    /// `values`, and move past them. Return the count of the elements copied,
+    /// which is less than `n` only if the iteration reaches the end.
+    /// Subclasses may override it to fetch the elements in batch.
+    virtual size_t GetBatch(size_t n, K* keys, V* values) {
+        size_t cnt = 0;
+        while (cnt < n && Valid()) {
+            keys[cnt] = GetKey();
+            values[cnt] = GetValue();
+            cnt++;
+            Next();
+        }
+        return cnt;
+    }
 };
 /// \brief An iterator over a key-value pairs dataset
 /// \tparam K key type of elements
@@ -17,6 +17,7 @@
 #define HYBRIDSE_INCLUDE_PLAN_PLAN_API_H_
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "node/node_manager.h"
 namespace hybridse {
 namespace plan {
@@ -35,6 +36,13 @@ class PlanAPI {
                                          bool enable_batch_window_parallelization = false,
                                          const std::unordered_map<std::string, std::string>* extra_options = nullptr);
     static const int GetPlanLimitCount(node::PlanNode* plan_trees);
+    /// \brief Replace the literals compared in WHERE clauses of a query with anonymous parameters
+    ///
+    /// Queries differ only in these literals share the same normalized sql. The replaced literals are
+    /// returned in the order of the parameters. Return false if the sql is not a query or is parameterized
+    static bool ParameterizeLiterals(const std::string& sql, NodeManager* node_manager,
+                                     std::string* normalized_sql,
+                                     std::vector<const node::ConstNode*>* literals);
     static const std::string GenerateName(const std::string prefix, int id);
 };
 
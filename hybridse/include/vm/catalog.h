@@ -52,6 +52,15 @@ struct IndexSt {
     std::vector<ColInfo> keys;  ///< first keys set
 };
 
+/// \brief Statistics of a table index, used by the planner to estimate cost
+struct IndexStatistics {
+    uint64_t pk_cnt = 0;   ///< count of distinct keys
+    uint64_t row_cnt = 0;  ///< count of rows indexed, may include expired rows not gc'd yet
+
+    /// Return the average count of rows under one key
+    double RowsPerKey() const { return pk_cnt == 0 ? 0.0 : static_cast<double>(row_cnt) / pk_cnt; }
+};
+
 /// \typedef IndexList repeated fields of IndexDef
 typedef ::google::protobuf::RepeatedPtrField<::hybridse::type::IndexDef>
     IndexList;
@@ -227,6 +236,13 @@ class TableHandler : public DataHandler {
     virtual std::unique_ptr<WindowIterator> GetWindowIterator(
         const std::string& idx_name) = 0;
 
+    /// Fill the statistics of the given index.
+    /// Return `false` by default, means the statistics is unknown.
+    virtual bool GetIndexStatistics(const std::string& index_name,
+                                    IndexStatistics* stat) {
+        return false;
+    }
+
     /// Return the HandlerType of the dataset.
     /// Return HandlerType::kTableHandler by default
     const HandlerType GetHandlerType() override { return kTableHandler; }
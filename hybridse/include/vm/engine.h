@@ -22,6 +22,7 @@
 #include <mutex>  //NOLINT
 #include <set>
 #include <string>
+#include <thread>  //NOLINT
 #include <utility>
 #include <vector>
 #include <unordered_map>
@@ -103,7 +104,9 @@ class EngineOptions {
         return enable_batch_window_parallelization_;
     }
 
-    /// Set `true` to enable window column purning
+    /// Set `true` to enable window column purning. In request mode the table
+    /// side of windows is projected to the referenced columns, and the projected
+    /// rows of a segment are shared by the windows over it during a request
     inline EngineOptions* SetEnableWindowColumnPruning(bool flag) {
         enable_window_column_pruning_ = flag;
         return this;
@@ -113,6 +116,16 @@ class EngineOptions {
         return enable_window_column_pruning_;
     }
 
+    /// Set `true` to choose among the indexes partially matching the keys by the index
+    /// statistics of tables, the index expected to read less rows per key wins. Default `false`,
+    /// the index matching more keys wins, which doesn't change as the data grows
+    inline EngineOptions* SetEnableIndexStatistics(bool flag) {
+        enable_index_statistics_ = flag;
+        return this;
+    }
+    /// Return if the engine chooses indexes by the index statistics
+    inline bool IsEnableIndexStatistics() const { return enable_index_statistics_; }
+
     /// Set the maximum number of cache entries, default is `50`.
     inline void SetMaxSqlCacheSize(uint32_t size) {
         max_sql_cache_size_ = size;
@@ -120,6 +133,31 @@ class EngineOptions {
     /// Return the maximum number of entries we can hold for compiling cache.
     inline uint32_t GetMaxSqlCacheSize() const { return max_sql_cache_size_; }
 
+    /// Set `true` to replace the literals compared in WHERE clauses of batch mode queries
+    /// with parameters, so the queries differ only in these literals share one compiling result.
+    /// Default `false`
+    inline EngineOptions* SetEnableLiteralParameterize(bool flag) {
+        enable_literal_parameterize_ = flag;
+        return this;
+    }
+    /// Return if the engine parameterizes the literals of batch mode queries
+    inline bool IsEnableLiteralParameterize() const { return enable_literal_parameterize_; }
+
+    /// Set `true` to compile new batch mode queries without optimization first, and replace the
+    /// cached result with the optimized one compiled in background after it is hit
+    /// `GetTieredCompileThreshold()` times. Default `false`
+    inline EngineOptions* SetEnableTieredCompile(bool flag) {
+        enable_tiered_compile_ = flag;
+        return this;
+    }
+    /// Return if the engine compiles batch mode queries in tiers
+    inline bool IsEnableTieredCompile() const { return enable_tiered_compile_; }
+
+    /// Set the cache hit count to optimize a fast compiled query, default is `10`
+    inline void SetTieredCompileThreshold(uint32_t threshold) { tiered_compile_threshold_ = threshold; }
+    /// Return the cache hit count to optimize a fast compiled query
+    inline uint32_t GetTieredCompileThreshold() const { return tiered_compile_threshold_; }
+
     /// Return JitOptions
     inline hybridse::vm::JitOptions& jit_options() { return jit_options_; }
 
@@ -132,6 +170,10 @@ class EngineOptions {
     bool enable_expr_optimize_;
     bool enable_batch_window_parallelization_;
     bool enable_window_column_pruning_;
+    bool enable_index_statistics_;
+    bool enable_literal_parameterize_;
+    bool enable_tiered_compile_;
+    uint32_t tiered_compile_threshold_;
     uint32_t max_sql_cache_size_;
     JitOptions jit_options_;
 };
@@ -213,6 +255,9 @@ class BatchRunSession : public RunSession {
     virtual const Schema& GetParameterSchema() const { return parameter_schema_; }
  private:
     codec::Schema parameter_schema_;
+    // the literals replaced by parameters when compiling, used if no parameter row is given
+    Row literal_parameter_row_;
+    friend Engine;
 };
 
 /// \brief MockRequestRunSession is a kind of mock RuSession design for request query
@@ -241,8 +286,15 @@ class MockRequestRunSession : public RunSession {
 /// Request-mode query is widely used in OLAD database. It requires a request Row.
 class RequestRunSession : public RunSession {
  public:
-    RequestRunSession() : RunSession(kRequestMode) {}
+    RequestRunSession() : RunSession(kRequestMode), max_parallelism_(1) {}
     ~RequestRunSession() {}
+
+    /// \brief Set the max count of bthreads running the independent sub plans of one request concurrently,
+    /// `1` means running the whole plan in the calling thread
+    void SetMaxParallelism(uint32_t max_parallelism) { max_parallelism_ = max_parallelism; }
+    /// Return the max parallelism of one request
+    uint32_t GetMaxParallelism() const { return max_parallelism_; }
+
     /// \brief Query sql in request mode.
     ///
     /// \param in_row request row
@@ -270,6 +322,9 @@ class RequestRunSession : public RunSession {
     virtual const std::string& GetRequestDbName() const {
         return compile_info_->GetRequestDbName();
     }
+
+ private:
+    uint32_t max_parallelism_;
 };
 /// \brief BatchRequestRunSession is a kind of RunSession designed for batch request mode query.
 ///
@@ -415,18 +470,33 @@ class Engine {
     /// \brief Clear engine's compiling result cache
     void ClearCacheLocked(const std::string& db);
 
+    /// \brief Invalidate the cached compiling results depending on the table
+    void ClearCacheLocked(const std::string& db, const std::string& table);
+
+    /// \brief Get the statistics of engine's compiling cache of the engine mode
+    EngineCacheStats GetCacheStats(EngineMode engine_mode);
+
     /// \brief Get engine's options
     EngineOptions GetEngineOptions();
 
  private:
+    bool Compile(const std::string& sql, const std::string& db, RunSession& session,  // NOLINT
+                 base::Status& status);  // NOLINT
+    static bool ParameterizeLiterals(const std::string& sql, BatchRunSession* session, std::string* normalized_sql);
+    // compile the fast compiled info with optimization and replace the cache entry
+    void OptimizeCompileInfo(const std::string& db, const std::string& sql,
+                             std::shared_ptr<CompileInfo> fast_info);
     bool GetDependentTables(const node::PlanNode* node, const std::string& default_db,
                             std::set<std::pair<std::string, std::string>>* db_tables, base::Status& status);  // NOLINT
+    // set `optimize` if the entry is fast compiled and hot enough to be optimized
     std::shared_ptr<CompileInfo> GetCacheLocked(const std::string& db,
                                                 const std::string& sql,
-                                                EngineMode engine_mode);
+                                                EngineMode engine_mode,
+                                                bool* optimize = nullptr);
     bool SetCacheLocked(const std::string& db, const std::string& sql,
                         EngineMode engine_mode,
-                        std::shared_ptr<CompileInfo> info);
+                        const EngineCacheEntry& entry);
+    bool IsValidCacheEntry(const EngineCacheEntry& entry) const;
 
     bool IsCompatibleCache(RunSession& session,  // NOLINT
                            std::shared_ptr<CompileInfo> info,
@@ -440,6 +510,15 @@ class Engine {
     EngineOptions options_;
     base::SpinMutex mu_;
     EngineLRUCache lru_cache_;
+    std::map<EngineMode, EngineCacheStats> cache_stats_;
+    // the version of (db, table) is set from version_seq_ when the table changes,
+    // (db, "") is updated on any table change of the db
+    std::map<std::pair<std::string, std::string>, uint64_t> table_versions_;
+    uint64_t version_seq_;
+    // one fast compiled info is optimized at a time
+    bool optimizing_;
+    std::mutex optimize_mu_;
+    std::thread optimize_thread_;
 };
 
 /// \brief Local tablet is responsible to run a task locally.
@@ -19,6 +19,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include "boost/compute/detail/lru_cache.hpp"
 #include "vm/physical_op.h"
 namespace hybridse {
@@ -65,14 +66,42 @@ class CompileInfo {
                                 const std::string& tab) = 0;
 };
 
+/// \brief An entry of the engine compiling cache
+struct EngineCacheEntry {
+    std::shared_ptr<CompileInfo> info;
+    /// the table version sequence of the engine when the sql is compiled
+    uint64_t version = 0;
+    /// the (db, table) the sql depends on, the table name is empty if the
+    /// entry depends on all the tables of the db
+    std::set<std::pair<std::string, std::string>> tables;
+    /// the info is compiled without optimization and is replaced by the
+    /// optimized one once it is hot
+    bool fast_compiled = false;
+    bool optimizing = false;
+    uint64_t hit_cnt = 0;
+};
+
+/// \brief Statistics of the compiling cache of one engine mode
+struct EngineCacheStats {
+    uint64_t hit_cnt = 0;
+    uint64_t miss_cnt = 0;
+    /// count of the successful compiling and the time it takes
+    uint64_t compile_cnt = 0;
+    uint64_t compile_time_us = 0;
+    /// count of the queries whose literals are replaced with parameters
+    uint64_t parameterized_cnt = 0;
+    /// count of the fast compiled results replaced by the optimized ones
+    uint64_t optimized_cnt = 0;
+};
+
 /// @typedef EngineLRUCache
 /// - EngineMode
 ///     - DB name
 ///       - SQL string
-///           - CompileInfo
+///           - EngineCacheEntry
 typedef std::map<EngineMode,
                 std::map<std::string,
-                    boost::compute::detail::lru_cache<std::string, std::shared_ptr<CompileInfo>>>>
+                    boost::compute::detail::lru_cache<std::string, std::shared_ptr<EngineCacheEntry>>>>
     EngineLRUCache;
 
 class CompileInfoCache {
@@ -101,11 +130,17 @@ class JitOptions {
     bool IsEnablePerf() const { return enable_perf_; }
     void SetEnablePerf(bool flag) { enable_perf_ = flag; }
 
+    /// Set `false` to skip the ir optimization passes and generate machine code
+    /// without optimization, which compiles much faster
+    bool IsEnableOptimize() const { return enable_optimize_; }
+    void SetEnableOptimize(bool flag) { enable_optimize_ = flag; }
+
  private:
     bool enable_mcjit_ = false;
     bool enable_vtune_ = false;
     bool enable_gdb_ = false;
     bool enable_perf_ = false;
+    bool enable_optimize_ = true;
 };
 }  // namespace vm
 }  // namespace hybridse
@@ -41,6 +41,26 @@ static void BM_ArraySumColDouble(benchmark::State& state) {  // NOLINT
     SumArrayListCol(&state, BENCHMARK, state.range(0), "col4");
 }
 
+static void BM_DistinctCountInt64(benchmark::State& state) {  // NOLINT
+    DistinctCountInt64(&state, BENCHMARK, state.range(0), "distinct_count");
+}
+static void BM_ApproxDistinctCountInt64(benchmark::State& state) {  // NOLINT
+    DistinctCountInt64(&state, BENCHMARK, state.range(0), "approx_distinct_count");
+}
+static void BM_MedianInt64(benchmark::State& state) {  // NOLINT
+    MedianInt64(&state, BENCHMARK, state.range(0), "median");
+}
+static void BM_ApproxMedianInt64(benchmark::State& state) {  // NOLINT
+    MedianInt64(&state, BENCHMARK, state.range(0), "approx_median");
+}
+
+static void BM_CountCateInt64(benchmark::State& state) {  // NOLINT
+    CountCateInt64(&state, BENCHMARK, state.range(0), state.range(1));
+}
+static void BM_TopNFrequencyInt64(benchmark::State& state) {  // NOLINT
+    TopNFrequencyInt64(&state, BENCHMARK, state.range(0), state.range(1));
+}
+
 static void BM_CopyMemSegment(benchmark::State& state) {  // NOLINT
     CopyMemSegment(&state, BENCHMARK, state.range(0));
 }
@@ -123,6 +143,28 @@ BENCHMARK(BM_ArraySumColDouble)
     ->Args({100})
     ->Args({1000})
     ->Args({10000});
+BENCHMARK(BM_DistinctCountInt64)
+    ->Args({1000})
+    ->Args({10000})
+    ->Args({100000});
+BENCHMARK(BM_ApproxDistinctCountInt64)
+    ->Args({1000})
+    ->Args({10000})
+    ->Args({100000});
+BENCHMARK(BM_MedianInt64)
+    ->Args({1000})
+    ->Args({10000})
+    ->Args({100000});
+BENCHMARK(BM_ApproxMedianInt64)
+    ->Args({1000})
+    ->Args({10000})
+    ->Args({100000});
+BENCHMARK(BM_CountCateInt64)
+    ->Args({10000, 10})
+    ->Args({10000, 1000});
+BENCHMARK(BM_TopNFrequencyInt64)
+    ->Args({10000, 10})
+    ->Args({10000, 1000});
 BENCHMARK(BM_RequestUnionSumColDouble)
     ->Args({10})
     ->Args({100})
@@ -15,7 +15,10 @@
  */
 
 #include "benchmark/udf_bm_case.h"
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 #include "case/case_data_mock.h"
@@ -687,5 +690,153 @@ void RequestUnionWindowExcludeCurrentTime(benchmark::State* state, MODE mode,
         }
     }
 }
+// values in [0, data_size / 2], about 40% of them are distinct
+static std::vector<int64_t> BuildInt64Values(int64_t data_size) {
+    std::mt19937_64 rng(data_size);
+    std::uniform_int_distribution<int64_t> dist(0, data_size / 2);
+    std::vector<int64_t> values;
+    values.reserve(data_size);
+    for (int64_t i = 0; i < data_size; ++i) {
+        values.push_back(dist(rng));
+    }
+    return values;
+}
+
+void DistinctCountInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                        const std::string& fn) {
+    auto values = BuildInt64Values(data_size);
+    codec::ArrayListV<int64_t> list(&values);
+    codec::ListRef<int64_t> list_ref;
+    list_ref.list = reinterpret_cast<int8_t*>(&list);
+    auto udaf = udf::UdfFunctionBuilder(fn)
+                    .args<codec::ListRef<int64_t>>()
+                    .returns<int64_t>()
+                    .build();
+    ASSERT_TRUE(udaf.valid());
+
+    std::vector<int64_t> distinct(values);
+    std::sort(distinct.begin(), distinct.end());
+    double expect = std::unique(distinct.begin(), distinct.end()) - distinct.begin();
+    double error = std::abs(udaf(list_ref) - expect) / expect;
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(udaf(list_ref));
+            }
+            state->counters["error"] = error;
+            break;
+        }
+        case TEST: {
+            // the standard error of hyperloglog is about 1.6%
+            ASSERT_LT(error, 0.05);
+            break;
+        }
+    }
+}
+
+void MedianInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                 const std::string& fn) {
+    auto values = BuildInt64Values(data_size);
+    codec::ArrayListV<int64_t> list(&values);
+    codec::ListRef<int64_t> list_ref;
+    list_ref.list = reinterpret_cast<int8_t*>(&list);
+    auto udaf = udf::UdfFunctionBuilder(fn)
+                    .args<codec::ListRef<int64_t>>()
+                    .returns<udf::Nullable<double>>()
+                    .build();
+    ASSERT_TRUE(udaf.valid());
+
+    std::vector<int64_t> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    double expect = (sorted[(data_size - 1) / 2] + sorted[data_size / 2]) / 2.0;
+    // error relative to the value range
+    double error = std::abs(udaf(list_ref).value() - expect) / (data_size / 2 + 1);
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(udaf(list_ref));
+            }
+            state->counters["error"] = error;
+            break;
+        }
+        case TEST: {
+            ASSERT_LT(error, 0.01);
+            break;
+        }
+    }
+}
+static std::vector<int64_t> BuildCateValues(int64_t data_size, int64_t cate_size) {
+    std::vector<int64_t> cates;
+    cates.reserve(data_size);
+    for (int64_t i = 0; i < data_size; ++i) {
+        cates.push_back(i % cate_size);
+    }
+    return cates;
+}
+
+void CountCateInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                    int64_t cate_size) {
+    auto values = BuildInt64Values(data_size);
+    auto cates = BuildCateValues(data_size, cate_size);
+    codec::ArrayListV<int64_t> value_list(&values);
+    codec::ArrayListV<int64_t> cate_list(&cates);
+    codec::ListRef<int64_t> value_ref;
+    value_ref.list = reinterpret_cast<int8_t*>(&value_list);
+    codec::ListRef<int64_t> cate_ref;
+    cate_ref.list = reinterpret_cast<int8_t*>(&cate_list);
+    auto udaf = udf::UdfFunctionBuilder("count_cate")
+                    .args<codec::ListRef<int64_t>, codec::ListRef<int64_t>>()
+                    .returns<codec::StringRef>()
+                    .build();
+    ASSERT_TRUE(udaf.valid());
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(udaf(value_ref, cate_ref));
+            }
+            break;
+        }
+        case TEST: {
+            std::string cnt = std::to_string(data_size / cate_size);
+            std::string expect = "0:" + cnt + ",1:" + cnt + ",";
+            ASSERT_EQ(expect, udaf(value_ref, cate_ref).ToString().substr(0, expect.size()));
+            break;
+        }
+    }
+}
+
+void TopNFrequencyInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                        int64_t cate_size) {
+    auto cates = BuildCateValues(data_size, cate_size);
+    // the most frequent keys are 0, 1 and 2
+    for (int64_t i = 0; i < 3 && i < data_size; ++i) {
+        cates[i] = 0;
+        cates[data_size - 1 - i] = i < 2 ? 1 : 2;
+    }
+    std::vector<int32_t> top_n(data_size, 3);
+    codec::ArrayListV<int64_t> cate_list(&cates);
+    codec::ArrayListV<int32_t> top_n_list(&top_n);
+    codec::ListRef<int64_t> cate_ref;
+    cate_ref.list = reinterpret_cast<int8_t*>(&cate_list);
+    codec::ListRef<int32_t> top_n_ref;
+    top_n_ref.list = reinterpret_cast<int8_t*>(&top_n_list);
+    auto udaf = udf::UdfFunctionBuilder("topn_frequency")
+                    .args<codec::ListRef<int64_t>, codec::ListRef<int32_t>>()
+                    .returns<codec::StringRef>()
+                    .build();
+    ASSERT_TRUE(udaf.valid());
+    switch (mode) {
+        case BENCHMARK: {
+            for (auto _ : *state) {
+                benchmark::DoNotOptimize(udaf(cate_ref, top_n_ref));
+            }
+            break;
+        }
+        case TEST: {
+            ASSERT_EQ("0,1,2", udaf(cate_ref, top_n_ref).ToString());
+            break;
+        }
+    }
+}
 }  // namespace bm
 }  // namespace hybridse
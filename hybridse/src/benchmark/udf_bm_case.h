@@ -53,6 +53,17 @@ void HistoryWindowBufferExcludeCurrentTime(benchmark::State* state, MODE mode,
 void RequestUnionWindow(benchmark::State* state, MODE mode, int64_t data_size);
 void RequestUnionWindowExcludeCurrentTime(benchmark::State* state, MODE mode,
                                           int64_t data_size);
+// Aggregate udaf `fn` over int64 values, the relative error against the exact
+// udaf is reported as counter `error`
+void DistinctCountInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                        const std::string& fn);
+void MedianInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                 const std::string& fn);
+// Aggregate `data_size` rows evenly grouped into `cate_size` int64 categories
+void CountCateInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                    int64_t cate_size);
+void TopNFrequencyInt64(benchmark::State* state, MODE mode, int64_t data_size,
+                        int64_t cate_size);
 }  // namespace bm
 }  // namespace hybridse
 #endif  // HYBRIDSE_SRC_BENCHMARK_UDF_BM_CASE_H_
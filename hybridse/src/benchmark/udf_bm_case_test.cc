@@ -63,6 +63,26 @@ TEST_F(UdfBMCaseTest, CopyArrayList_TEST) {
     CopyArrayList(nullptr, TEST, 1000L);
 }
 
+TEST_F(UdfBMCaseTest, ApproxDistinctCount_TEST) {
+    DistinctCountInt64(nullptr, TEST, 100L, "approx_distinct_count");
+    DistinctCountInt64(nullptr, TEST, 100000L, "approx_distinct_count");
+}
+
+TEST_F(UdfBMCaseTest, ApproxMedian_TEST) {
+    MedianInt64(nullptr, TEST, 100L, "approx_median");
+    MedianInt64(nullptr, TEST, 100000L, "approx_median");
+}
+
+TEST_F(UdfBMCaseTest, CountCate_TEST) {
+    CountCateInt64(nullptr, TEST, 100L, 10L);
+    CountCateInt64(nullptr, TEST, 10000L, 1000L);
+}
+
+TEST_F(UdfBMCaseTest, TopNFrequency_TEST) {
+    TopNFrequencyInt64(nullptr, TEST, 100L, 10L);
+    TopNFrequencyInt64(nullptr, TEST, 10000L, 1000L);
+}
+
 TEST_F(UdfBMCaseTest, CTimeDay_TEST) { CTimeDay(nullptr, TEST, 1); }
 TEST_F(UdfBMCaseTest, CTimeMonth) { CTimeMonth(nullptr, TEST, 1); }
 TEST_F(UdfBMCaseTest, CTimeYear_TEST) { CTimeYear(nullptr, TEST, 1); }
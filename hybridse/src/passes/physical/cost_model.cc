@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "passes/physical/cost_model.h"
+
+#include <algorithm>
+
+namespace hybridse {
+namespace passes {
+
+std::optional<uint64_t> CostModel::EstimateTableRows(vm::TableHandler* table) {
+    if (table == nullptr) {
+        return std::nullopt;
+    }
+    // every index covers all the rows except those expired by its own TTL,
+    // so the largest one is the closest to the table size
+    std::optional<uint64_t> rows;
+    for (const auto& kv : table->GetIndex()) {
+        vm::IndexStatistics stat;
+        if (table->GetIndexStatistics(kv.first, &stat)) {
+            rows = std::max(rows.value_or(0), stat.row_cnt);
+        }
+    }
+    return rows;
+}
+
+std::optional<double> CostModel::EstimateRowsPerKey(vm::TableHandler* table, const std::string& index_name) {
+    if (table == nullptr) {
+        return std::nullopt;
+    }
+    vm::IndexStatistics stat;
+    if (!table->GetIndexStatistics(index_name, &stat)) {
+        return std::nullopt;
+    }
+    return stat.RowsPerKey();
+}
+
+std::optional<bool> CostModel::IsCheaperIndex(vm::TableHandler* table, const std::string& lhs,
+                                              const std::string& rhs) {
+    auto lhs_rows = EstimateRowsPerKey(table, lhs);
+    auto rhs_rows = EstimateRowsPerKey(table, rhs);
+    if (!lhs_rows.has_value() || !rhs_rows.has_value() || lhs_rows.value() == rhs_rows.value()) {
+        return std::nullopt;
+    }
+    return lhs_rows.value() < rhs_rows.value();
+}
+
+}  // namespace passes
+}  // namespace hybridse
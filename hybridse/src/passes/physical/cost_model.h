@@ -0,0 +1,47 @@
+/*
+ * Copyright 2021 4paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HYBRIDSE_SRC_PASSES_PHYSICAL_COST_MODEL_H_
+#define HYBRIDSE_SRC_PASSES_PHYSICAL_COST_MODEL_H_
+
+#include <optional>
+#include <string>
+
+#include "vm/catalog.h"
+
+namespace hybridse {
+namespace passes {
+
+// CostModel estimates the rows read by data providers with the index
+// statistics published by the catalog. Every estimation returns nullopt
+// if the catalog knows nothing about the table, then the callers fall back
+// to the rule based decisions.
+class CostModel {
+ public:
+    // estimated count of rows of the table
+    static std::optional<uint64_t> EstimateTableRows(vm::TableHandler* table);
+
+    // estimated count of rows read by one key lookup on the index
+    static std::optional<double> EstimateRowsPerKey(vm::TableHandler* table, const std::string& index_name);
+
+    // return true if a lookup on index `lhs` is expected to read less rows than `rhs`,
+    // nullopt if any of them is unknown or they are expected to read the same rows
+    static std::optional<bool> IsCheaperIndex(vm::TableHandler* table, const std::string& lhs,
+                                              const std::string& rhs);
+};
+
+}  // namespace passes
+}  // namespace hybridse
+#endif  // HYBRIDSE_SRC_PASSES_PHYSICAL_COST_MODEL_H_
@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "passes/physical/cost_model.h"
 #include "vm/physical_op.h"
 
 namespace hybridse {
@@ -656,7 +657,13 @@ bool GroupAndSortOptimized::MatchBestIndex(const std::vector<std::string>& colum
                 } else {
                     auto org_index = index_hint.at(best_index_name);
                     auto new_index = index_hint.at(name);
-                    if (org_index.keys.size() < new_index.keys.size()) {
+                    // prefer the index with more keys. If index statistics are enabled, prefer the
+                    // index expected to read less rows per key, fall back to more keys without statistics
+                    std::optional<bool> cheaper;
+                    if (plan_ctx_->enable_index_statistics()) {
+                        cheaper = CostModel::IsCheaperIndex(table_handler.get(), name, best_index_name);
+                    }
+                    if (cheaper.has_value() ? cheaper.value() : org_index.keys.size() < new_index.keys.size()) {
                         // override with better index
                         best_index_name = name;
                         best_index_bitmap = sub_best_bitmap;
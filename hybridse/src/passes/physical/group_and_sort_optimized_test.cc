@@ -16,7 +16,9 @@
 
 #include "passes/physical/group_and_sort_optimized.h"
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -24,6 +26,7 @@
 #include "plan/plan_api.h"
 #include "testing/test_base.h"
 #include "udf/default_udf_library.h"
+#include "vm/simple_catalog.h"
 #include "vm/transform.h"
 
 namespace hybridse {
@@ -110,6 +113,133 @@ TEST_P(GroupAndSortOptOnCombinedIndexTest, OptimizeOutOfOrderFilter) {
     EXPECT_EQ(cs.physical_tree_str, physical_plan->GetTreeString());
 }
 
+// SimpleCatalogTableHandler reporting the given index statistics
+class StatisticsTableHandler : public vm::SimpleCatalogTableHandler {
+ public:
+    StatisticsTableHandler(const std::string& db, const type::TableDef& table_def,
+                           const std::map<std::string, vm::IndexStatistics>& stats)
+        : vm::SimpleCatalogTableHandler(db, table_def), stats_(stats) {}
+
+    bool GetIndexStatistics(const std::string& index_name, vm::IndexStatistics* stat) override {
+        auto it = stats_.find(index_name);
+        if (it == stats_.end()) {
+            return false;
+        }
+        *stat = it->second;
+        return true;
+    }
+
+ private:
+    std::map<std::string, vm::IndexStatistics> stats_;
+};
+
+class StatisticsCatalog : public vm::SimpleCatalog {
+ public:
+    explicit StatisticsCatalog(std::shared_ptr<vm::TableHandler> table)
+        : vm::SimpleCatalog(true), table_(table) {}
+
+    std::shared_ptr<vm::TableHandler> GetTable(const std::string& db, const std::string& table_name) override {
+        if (table_name == table_->GetName()) {
+            return table_;
+        }
+        return vm::SimpleCatalog::GetTable(db, table_name);
+    }
+
+ private:
+    std::shared_ptr<vm::TableHandler> table_;
+};
+
+class GroupAndSortOptWithStatisticsTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        db_.set_name("db");
+        table_def_.set_name("t2");
+        table_def_.set_catalog("db");
+        auto* a = table_def_.add_columns();
+        a->set_type(::hybridse::type::kVarchar);
+        a->set_name("a");
+        auto* b = table_def_.add_columns();
+        b->set_type(::hybridse::type::kInt32);
+        b->set_name("b");
+        auto* c = table_def_.add_columns();
+        c->set_type(::hybridse::type::kVarchar);
+        c->set_name("c");
+        auto* idx_ab = table_def_.add_indexes();
+        idx_ab->set_name("idx_ab");
+        idx_ab->add_first_keys("a");
+        idx_ab->add_first_keys("b");
+        auto* idx_c = table_def_.add_indexes();
+        idx_c->set_name("idx_c");
+        idx_c->add_first_keys("c");
+        vm::AddTable(db_, table_def_);
+    }
+
+    PhysicalOpNode* Transform(std::shared_ptr<vm::Catalog> catalog, const std::string& sql,
+                              bool enable_index_statistics = true) {
+        ::hybridse::node::PlanNodeList plan_trees;
+        ::hybridse::base::Status status;
+        EXPECT_TRUE(plan::PlanAPI::CreatePlanTreeFromScript(sql, plan_trees, &manager_, status)) << status;
+        modules_.push_back(llvm::make_unique<llvm::Module>("test_op_generator", ctx_));
+        vm::BatchModeTransformer tf(&manager_, "db", catalog, &empty_schema_, modules_.back().get(),
+                                    ::hybridse::udf::DefaultUdfLibrary::get());
+        tf.GetPlanContext()->SetEnableIndexStatistics(enable_index_statistics);
+        tf.AddDefaultPasses();
+        PhysicalOpNode* physical_plan = nullptr;
+        status = tf.TransformPhysicalPlan(plan_trees, &physical_plan);
+        EXPECT_TRUE(status.isOK()) << status;
+        return physical_plan;
+    }
+
+    static std::string IndexOf(PhysicalOpNode* node) {
+        while (node != nullptr && node->GetOpType() != vm::kPhysicalOpDataProvider) {
+            node = node->GetProducerCnt() > 0 ? node->GetProducer(0) : nullptr;
+        }
+        auto provider = dynamic_cast<vm::PhysicalPartitionProviderNode*>(node);
+        return provider == nullptr ? "" : provider->index_name_;
+    }
+
+    node::NodeManager manager_;
+    llvm::LLVMContext ctx_;
+    std::vector<std::unique_ptr<llvm::Module>> modules_;
+    const codec::Schema empty_schema_;
+    hybridse::type::Database db_;
+    hybridse::type::TableDef table_def_;
+};
+
+TEST_F(GroupAndSortOptWithStatisticsTest, ChooseIndexByRowsPerKey) {
+    const std::string sql = "select * from t2 where a = 'aaa' and b = 12 and c = 'ccc';";
+
+    // without statistics, the index matching more keys wins
+    auto simple_catalog = std::make_shared<vm::SimpleCatalog>(true);
+    simple_catalog->AddDatabase(db_);
+    auto plan = Transform(simple_catalog, sql);
+    ASSERT_TRUE(plan != nullptr);
+    EXPECT_EQ("idx_ab", IndexOf(plan));
+    EXPECT_EQ(std::string::npos, plan->GetTreeString().find("est_rows_per_key"));
+
+    // keys of idx_ab are skewed, a lookup on idx_c reads far less rows
+    std::map<std::string, vm::IndexStatistics> stats;
+    stats["idx_ab"].pk_cnt = 10;
+    stats["idx_ab"].row_cnt = 10000;
+    stats["idx_c"].pk_cnt = 5000;
+    stats["idx_c"].row_cnt = 10000;
+    auto catalog = std::make_shared<StatisticsCatalog>(std::make_shared<StatisticsTableHandler>("db", table_def_, stats));
+    catalog->AddDatabase(db_);
+
+    // index statistics are not used to choose indexes unless enabled, but still shown
+    plan = Transform(catalog, sql, false);
+    ASSERT_TRUE(plan != nullptr);
+    EXPECT_EQ("idx_ab", IndexOf(plan));
+    EXPECT_NE(std::string::npos, plan->GetTreeString().find("index=idx_ab, est_rows_per_key=1000"))
+        << plan->GetTreeString();
+
+    plan = Transform(catalog, sql);
+    ASSERT_TRUE(plan != nullptr);
+    EXPECT_EQ("idx_c", IndexOf(plan));
+    EXPECT_NE(std::string::npos, plan->GetTreeString().find("index=idx_c, est_rows_per_key=2"))
+        << plan->GetTreeString();
+}
+
 }  // namespace passes
 }  // namespace hybridse
 
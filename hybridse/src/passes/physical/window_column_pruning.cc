@@ -17,19 +17,29 @@
 #include "passes/physical/window_column_pruning.h"
 
 #include <algorithm>
+#include <iterator>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "passes/expression/expr_pass.h"
+
 namespace hybridse {
 namespace passes {
 
 using hybridse::common::kPlanError;
 using hybridse::vm::ColumnProjects;
+using hybridse::vm::ConditionFilter;
+using hybridse::vm::kAggregation;
+using hybridse::vm::kPhysicalOpDataProvider;
 using hybridse::vm::kPhysicalOpProject;
+using hybridse::vm::kPhysicalOpRequestUnion;
+using hybridse::vm::kProviderTypePartition;
 using hybridse::vm::kWindowAggregation;
+using hybridse::vm::PhysicalPartitionProviderNode;
 using hybridse::vm::PhysicalProjectNode;
 using hybridse::vm::PhysicalSimpleProjectNode;
+using hybridse::vm::SchemasContext;
 
 Status WindowColumnPruning::Apply(PhysicalPlanContext* ctx,
                                   PhysicalOpNode* input, PhysicalOpNode** out) {
@@ -199,5 +209,239 @@ Status WindowColumnPruning::ProcessWindow(PhysicalPlanContext* ctx,
     return Status::OK();
 }
 
+// resolve column expressions into the column indexes of the single schema
+// source of `schemas_ctx`
+static Status ResolveColumnIndexes(const SchemasContext* schemas_ctx,
+                                   const std::vector<const node::ExprNode*>& columns,
+                                   std::vector<size_t>* column_indexes) {
+    for (const auto col_expr : columns) {
+        size_t schema_idx = 0;
+        size_t col_idx = 0;
+        switch (col_expr->GetExprType()) {
+            case node::kExprColumnRef: {
+                auto col = dynamic_cast<const node::ColumnRefNode*>(col_expr);
+                CHECK_STATUS(schemas_ctx->ResolveColumnRefIndex(col, &schema_idx, &col_idx));
+                break;
+            }
+            case node::kExprColumnId: {
+                auto col = dynamic_cast<const node::ColumnIdNode*>(col_expr);
+                CHECK_STATUS(schemas_ctx->ResolveColumnIndexByID(col->GetColumnID(), &schema_idx, &col_idx));
+                break;
+            }
+            default:
+                FAIL_STATUS(kPlanError, "Invalid column expression: ", col_expr->GetExprString());
+        }
+        CHECK_TRUE(schema_idx == 0, kPlanError, "Window input should have a single schema source");
+        column_indexes->push_back(col_idx);
+    }
+    return Status::OK();
+}
+
+// the columns of request union output the aggregation depends on
+static Status ResolveAggregationColumns(const PhysicalAggregationNode* agg_op,
+                                        const PhysicalRequestUnionNode* union_op,
+                                        std::vector<const node::ExprNode*>* depend_columns) {
+    auto union_schema = union_op->schemas_ctx();
+    const auto& projects = agg_op->project();
+    for (size_t i = 0; i < projects.size(); ++i) {
+        std::vector<const node::ExprNode*> project_depend_columns;
+        CHECK_STATUS(union_schema->ResolveExprDependentColumns(projects.GetExpr(i), &project_depend_columns));
+        std::copy(project_depend_columns.begin(), project_depend_columns.end(), std::back_inserter(*depend_columns));
+    }
+    agg_op->having_condition_.ResolvedRelatedColumns(depend_columns);
+    return Status::OK();
+}
+
+Status RequestWindowColumnPruning::Apply(PhysicalPlanContext* ctx,
+                                         PhysicalOpNode* input,
+                                         PhysicalOpNode** out) {
+    visited_.clear();
+    cache_.clear();
+    partition_columns_.clear();
+    partition_projects_.clear();
+    request_projects_.clear();
+    CHECK_TRUE(input != nullptr, kPlanError);
+    CHECK_STATUS(CollectColumns(input));
+    return DoApply(ctx, input, out);
+}
+
+PhysicalRequestUnionNode* RequestWindowColumnPruning::GetPrunableUnion(PhysicalOpNode* input) {
+    if (input->GetOpType() != kPhysicalOpProject ||
+        dynamic_cast<PhysicalProjectNode*>(input)->project_type_ != kAggregation) {
+        return nullptr;
+    }
+    auto producer = input->GetProducer(0);
+    if (producer->GetOpType() != kPhysicalOpRequestUnion) {
+        return nullptr;
+    }
+    auto union_op = dynamic_cast<PhysicalRequestUnionNode*>(producer);
+    if (union_op->instance_not_in_window() || !union_op->window_unions().Empty()) {
+        return nullptr;
+    }
+    auto right = union_op->GetProducer(1);
+    if (right->GetOpType() != kPhysicalOpDataProvider ||
+        dynamic_cast<vm::PhysicalDataProviderNode*>(right)->provider_type_ != kProviderTypePartition) {
+        return nullptr;
+    }
+    if (union_op->schemas_ctx()->GetSchemaSourceSize() != 1 ||
+        union_op->GetProducer(0)->schemas_ctx()->GetSchemaSourceSize() != 1 ||
+        right->schemas_ctx()->GetSchemaSourceSize() != 1) {
+        return nullptr;
+    }
+    return union_op;
+}
+
+std::string RequestWindowColumnPruning::PartitionKey(const PhysicalRequestUnionNode* union_op) {
+    auto partition = dynamic_cast<const PhysicalPartitionProviderNode*>(union_op->GetProducer(1));
+    return partition->table_handler_->GetDatabase() + "." + partition->table_handler_->GetName() + "." +
+           partition->index_name_;
+}
+
+Status RequestWindowColumnPruning::CollectColumns(PhysicalOpNode* input) {
+    if (!visited_.insert(input->node_id()).second) {
+        return Status::OK();
+    }
+    for (size_t i = 0; i < input->GetProducerCnt(); ++i) {
+        CHECK_STATUS(CollectColumns(input->GetProducer(i)));
+    }
+    auto union_op = GetPrunableUnion(input);
+    if (union_op == nullptr) {
+        return Status::OK();
+    }
+    std::vector<size_t> column_indexes;
+    // window op depends, bound to the request side
+    std::vector<const node::ExprNode*> window_columns;
+    union_op->window().ResolvedRelatedColumns(&window_columns);
+    CHECK_STATUS(ResolveColumnIndexes(union_op->GetProducer(0)->schemas_ctx(), window_columns, &column_indexes));
+
+    // aggregation depends
+    std::vector<const node::ExprNode*> depend_columns;
+    CHECK_STATUS(ResolveAggregationColumns(dynamic_cast<PhysicalAggregationNode*>(input), union_op, &depend_columns));
+    CHECK_STATUS(ResolveColumnIndexes(union_op->schemas_ctx(), depend_columns, &column_indexes));
+
+    auto& partition_columns = partition_columns_[PartitionKey(union_op)];
+    partition_columns.insert(column_indexes.begin(), column_indexes.end());
+    return Status::OK();
+}
+
+Status RequestWindowColumnPruning::DoApply(PhysicalPlanContext* ctx,
+                                           PhysicalOpNode* input,
+                                           PhysicalOpNode** out) {
+    CHECK_TRUE(input != nullptr, kPlanError);
+    auto cache_iter = cache_.find(input->node_id());
+    if (cache_iter != cache_.end()) {
+        *out = cache_iter->second;
+        return Status::OK();
+    }
+    bool changed = false;
+    std::vector<PhysicalOpNode*> children;
+    for (size_t i = 0; i < input->GetProducerCnt(); ++i) {
+        auto origin_child = input->GetProducer(i);
+        PhysicalOpNode* new_child = nullptr;
+        CHECK_STATUS(DoApply(ctx, origin_child, &new_child));
+        if (new_child != origin_child) {
+            changed = true;
+        }
+        children.push_back(new_child);
+    }
+    auto origin_id = input->node_id();
+    if (changed) {
+        PhysicalOpNode* new_input = nullptr;
+        CHECK_STATUS(ctx->WithNewChildren(input, children, &new_input));
+        input = new_input;
+    }
+    *out = input;
+    // the request union is a leaf of the windows to prune, it is never renewed
+    if (!changed && GetPrunableUnion(input) != nullptr) {
+        CHECK_STATUS(ProcessWindow(ctx, dynamic_cast<PhysicalAggregationNode*>(input), out));
+    }
+    cache_[origin_id] = *out;
+    return Status::OK();
+}
+
+Status RequestWindowColumnPruning::CreatePrunedProject(PhysicalPlanContext* ctx, PhysicalOpNode* input,
+                                                       const std::set<size_t>& column_indexes,
+                                                       PhysicalOpNode** out) {
+    auto source = input->schemas_ctx()->GetSchemaSource(0);
+    ColumnProjects pruned_projects;
+    for (size_t col_idx : column_indexes) {
+        auto col_expr = ctx->node_manager()->MakeColumnIdNode(source->GetColumnID(col_idx));
+        pruned_projects.Add(source->GetColumnName(col_idx), col_expr, nullptr);
+    }
+    PhysicalSimpleProjectNode* pruned_project_op = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalSimpleProjectNode>(&pruned_project_op, input, pruned_projects));
+    *out = pruned_project_op;
+    return Status::OK();
+}
+
+Status RequestWindowColumnPruning::ProcessWindow(PhysicalPlanContext* ctx,
+                                                 PhysicalAggregationNode* agg_op,
+                                                 PhysicalOpNode** out) {
+    auto union_op = dynamic_cast<PhysicalRequestUnionNode*>(agg_op->GetProducer(0));
+    auto key = PartitionKey(union_op);
+    const auto& column_indexes = partition_columns_[key];
+    auto origin_source = union_op->schemas_ctx()->GetSchemaSource(0);
+    if (column_indexes.size() >= origin_source->size()) {
+        return Status::OK();
+    }
+
+    // the windows on the same partition share the projection of it
+    PhysicalOpNode* right = nullptr;
+    auto right_iter = partition_projects_.find(key);
+    if (right_iter != partition_projects_.end()) {
+        right = right_iter->second;
+    } else {
+        CHECK_STATUS(CreatePrunedProject(ctx, union_op->GetProducer(1), column_indexes, &right));
+        partition_projects_[key] = right;
+    }
+    PhysicalOpNode* left = nullptr;
+    auto request = union_op->GetProducer(0);
+    auto left_key = std::make_pair(request->node_id(), key);
+    auto left_iter = request_projects_.find(left_key);
+    if (left_iter != request_projects_.end()) {
+        left = left_iter->second;
+    } else {
+        CHECK_STATUS(CreatePrunedProject(ctx, request, column_indexes, &left));
+        request_projects_[left_key] = left;
+    }
+
+    // the pruned projects keep column ids, so the window is still valid on the new inputs
+    PhysicalRequestUnionNode* new_union_op = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalRequestUnionNode>(
+        &new_union_op, left, right, union_op->window(), union_op->instance_not_in_window(),
+        union_op->exclude_current_time(), union_op->output_request_row()));
+    new_union_op->exclude_current_row_ = union_op->exclude_current_row_;
+    new_union_op->SetLimitCnt(union_op->GetLimitCnt());
+
+    // request union renews the column ids, rebase the aggregation on them
+    std::vector<const node::ExprNode*> depend_columns;
+    CHECK_STATUS(ResolveAggregationColumns(agg_op, union_op, &depend_columns));
+    auto new_source = new_union_op->schemas_ctx()->GetSchemaSource(0);
+    passes::ExprReplacer replacer;
+    for (const auto col_expr : depend_columns) {
+        std::vector<size_t> col_idx;
+        CHECK_STATUS(ResolveColumnIndexes(union_op->schemas_ctx(), {col_expr}, &col_idx));
+        size_t new_col_idx = std::distance(column_indexes.begin(), column_indexes.find(col_idx[0]));
+        auto new_col_expr = ctx->node_manager()->MakeColumnIdNode(new_source->GetColumnID(new_col_idx));
+        if (col_expr->GetExprType() == node::kExprColumnRef) {
+            auto col_ref = dynamic_cast<const node::ColumnRefNode*>(col_expr);
+            replacer.AddReplacement(col_ref->GetRelationName(), col_ref->GetColumnName(), new_col_expr);
+        } else {
+            replacer.AddReplacement(origin_source->GetColumnID(col_idx[0]), new_col_expr);
+        }
+    }
+    ColumnProjects new_projects;
+    CHECK_STATUS(agg_op->project().ReplaceExpr(replacer, ctx->node_manager(), &new_projects));
+    ConditionFilter new_having_condition;
+    CHECK_STATUS(agg_op->having_condition_.ReplaceExpr(replacer, ctx->node_manager(), &new_having_condition));
+
+    PhysicalAggregationNode* new_agg_op = nullptr;
+    CHECK_STATUS(ctx->CreateOp<PhysicalAggregationNode>(&new_agg_op, new_union_op, new_projects,
+                                                        new_having_condition.condition()));
+    new_agg_op->SetLimitCnt(agg_op->GetLimitCnt());
+    *out = new_agg_op;
+    return Status::OK();
+}
+
 }  // namespace passes
 }  // namespace hybridse
@@ -15,6 +15,9 @@
  */
 
 #include <map>
+#include <set>
+#include <string>
+#include <utility>
 
 #include "passes/physical/physical_pass.h"
 #include "vm/physical_op.h"
@@ -26,6 +29,8 @@ namespace hybridse {
 namespace passes {
 
 using hybridse::base::Status;
+using hybridse::vm::PhysicalAggregationNode;
+using hybridse::vm::PhysicalRequestUnionNode;
 using hybridse::vm::PhysicalWindowAggrerationNode;
 
 class WindowColumnPruning : public PhysicalPass {
@@ -43,6 +48,41 @@ class WindowColumnPruning : public PhysicalPass {
     std::map<size_t, PhysicalOpNode*> cache_;
 };
 
+// Column pruning for the windows of request mode. The table side of
+// RequestUnion(request, partition) is projected to the columns referenced by
+// the window and its aggregation. The windows over the same table index share
+// one projection with the union of their columns, so the projected rows of a
+// segment are shared during a request.
+class RequestWindowColumnPruning : public PhysicalPass {
+ public:
+    Status Apply(PhysicalPlanContext* ctx, PhysicalOpNode* input,
+                 PhysicalOpNode** out) override;
+
+ private:
+    Status CollectColumns(PhysicalOpNode* input);
+    Status DoApply(PhysicalPlanContext* ctx, PhysicalOpNode* input,
+                   PhysicalOpNode** out);
+    Status ProcessWindow(PhysicalPlanContext* ctx,
+                         PhysicalAggregationNode* agg_op,
+                         PhysicalOpNode** out);
+    Status CreatePrunedProject(PhysicalPlanContext* ctx, PhysicalOpNode* input,
+                               const std::set<size_t>& column_indexes,
+                               PhysicalOpNode** out);
+
+    // return the request union if the aggregation is prunable, otherwise null
+    static PhysicalRequestUnionNode* GetPrunableUnion(PhysicalOpNode* input);
+    static std::string PartitionKey(const PhysicalRequestUnionNode* union_op);
+
+    std::set<size_t> visited_;
+    std::map<size_t, PhysicalOpNode*> cache_;
+    // partition key -> indexes of the columns referenced by the windows on it
+    std::map<std::string, std::set<size_t>> partition_columns_;
+    // partition key -> projection over the partition
+    std::map<std::string, PhysicalOpNode*> partition_projects_;
+    // (request node id, partition key) -> projection over the request
+    std::map<std::pair<size_t, std::string>, PhysicalOpNode*> request_projects_;
+};
+
 }  // namespace passes
 }  // namespace hybridse
 #endif  // HYBRIDSE_SRC_PASSES_PHYSICAL_WINDOW_COLUMN_PRUNING_H_
@@ -15,6 +15,10 @@
  */
 #include "plan/plan_api.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "planv2/ast_node_converter.h"
 #include "planv2/planner_v2.h"
 #include "zetasql/public/error_helpers.h"
 #include "zetasql/public/error_location.pb.h"
@@ -51,6 +55,115 @@ bool PlanAPI::CreatePlanTreeFromScript(const std::string &sql, PlanNodeList &pla
     return status.isOK();
 }
 
+static bool IsParameterizableLiteral(const zetasql::ASTNode* node) {
+    switch (node->node_kind()) {
+        case zetasql::AST_INT_LITERAL:
+        case zetasql::AST_STRING_LITERAL:
+        case zetasql::AST_FLOAT_LITERAL:
+        case zetasql::AST_BOOLEAN_LITERAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsComparison(const zetasql::ASTBinaryExpression* expr) {
+    switch (expr->op()) {
+        case zetasql::ASTBinaryExpression::Op::EQ:
+        case zetasql::ASTBinaryExpression::Op::NE:
+        case zetasql::ASTBinaryExpression::Op::NE2:
+        case zetasql::ASTBinaryExpression::Op::GT:
+        case zetasql::ASTBinaryExpression::Op::LT:
+        case zetasql::ASTBinaryExpression::Op::GE:
+        case zetasql::ASTBinaryExpression::Op::LE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// collect the literals which are the operands of comparisons in WHERE clauses,
+// return false if there are parameters in the query already
+static bool CollectWhereLiterals(const zetasql::ASTNode* node, bool in_where,
+                                 std::vector<const zetasql::ASTExpression*>* literals) {
+    if (node->node_kind() == zetasql::AST_PARAMETER_EXPR) {
+        return false;
+    }
+    if (node->node_kind() == zetasql::AST_WHERE_CLAUSE) {
+        in_where = true;
+    } else if (node->node_kind() == zetasql::AST_QUERY) {
+        // WHERE clause of subquery is handled when visiting its own where clause
+        in_where = false;
+    }
+    if (in_where && node->node_kind() == zetasql::AST_BINARY_EXPRESSION) {
+        auto binary_expr = node->GetAsOrDie<zetasql::ASTBinaryExpression>();
+        if (IsComparison(binary_expr)) {
+            for (auto operand : {binary_expr->lhs(), binary_expr->rhs()}) {
+                if (IsParameterizableLiteral(operand)) {
+                    literals->push_back(operand);
+                }
+            }
+        }
+    }
+    for (int i = 0; i < node->num_children(); i++) {
+        if (!CollectWhereLiterals(node->child(i), in_where, literals)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PlanAPI::ParameterizeLiterals(const std::string& sql, NodeManager* node_manager,
+                                   std::string* normalized_sql,
+                                   std::vector<const node::ConstNode*>* literals) {
+    if (node_manager == nullptr || normalized_sql == nullptr || literals == nullptr) {
+        return false;
+    }
+    std::unique_ptr<zetasql::ParserOutput> parser_output;
+    zetasql::ParserOptions parser_opts;
+    zetasql::LanguageOptions language_opts;
+    language_opts.EnableLanguageFeature(zetasql::FEATURE_V_1_3_COLUMN_DEFAULT_VALUE);
+    parser_opts.set_language_options(&language_opts);
+    auto zetasql_status = zetasql::ParseScript(sql, parser_opts,
+                                               zetasql::ERROR_MESSAGE_MULTI_LINE_WITH_CARET, &parser_output);
+    if (!zetasql_status.ok()) {
+        return false;
+    }
+    const zetasql::ASTScript* script = parser_output->script();
+    if (script->statement_list().size() != 1 ||
+        script->statement_list()[0]->node_kind() != zetasql::AST_QUERY_STATEMENT) {
+        return false;
+    }
+    std::vector<const zetasql::ASTExpression*> ast_literals;
+    if (!CollectWhereLiterals(script->statement_list()[0], false, &ast_literals)) {
+        return false;
+    }
+    // parameters are numbered by the position in sql
+    std::sort(ast_literals.begin(), ast_literals.end(),
+              [](const zetasql::ASTExpression* lhs, const zetasql::ASTExpression* rhs) {
+                  return lhs->GetParseLocationRange().start().GetByteOffset() <
+                         rhs->GetParseLocationRange().start().GetByteOffset();
+              });
+    literals->clear();
+    normalized_sql->clear();
+    int pos = 0;
+    for (auto ast_literal : ast_literals) {
+        node::ExprNode* expr = nullptr;
+        if (!ConvertExprNode(ast_literal, node_manager, &expr).isOK() || expr == nullptr ||
+            expr->GetExprType() != node::kExprPrimary) {
+            return false;
+        }
+        int start = ast_literal->GetParseLocationRange().start().GetByteOffset();
+        int end = ast_literal->GetParseLocationRange().end().GetByteOffset();
+        normalized_sql->append(sql, pos, start - pos);
+        normalized_sql->append("?");
+        pos = end;
+        literals->push_back(dynamic_cast<const node::ConstNode*>(expr));
+    }
+    normalized_sql->append(sql, pos, std::string::npos);
+    return true;
+}
+
 const int PlanAPI::GetPlanLimitCount(node::PlanNode* plan_tree) {
     if (nullptr == plan_tree) {
         return 0;
@@ -18,11 +18,14 @@
 #define HYBRIDSE_SRC_UDF_CONTAINERS_H_
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
-#include <set>
 #include <utility>
 
 #include "base/type.h"
@@ -164,6 +167,111 @@ class TopKContainer {
     BoundT bound_ = -1;  // delayed to be set by first push
 };
 
+/**
+ * Open addressing hash map with linear probing. Entries are stored densely in
+ * insertion order, so there is no allocation per entry and iterating is cache
+ * friendly. Single entries can not be erased, use `Truncate` instead.
+ */
+template <typename K, typename V>
+class FlatHashMap {
+ public:
+    using value_type = std::pair<K, V>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    iterator begin() { return entries_.begin(); }
+    iterator end() { return entries_.end(); }
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    void clear() {
+        entries_.clear();
+        index_.clear();
+        bits_ = 0;
+    }
+
+    iterator find(const K& key) {
+        if (entries_.empty()) {
+            return end();
+        }
+        size_t mask = index_.size() - 1;
+        for (size_t pos = Slot(key);; pos = (pos + 1) & mask) {
+            int32_t idx = index_[pos];
+            if (idx < 0) {
+                return end();
+            }
+            if (entries_[idx].first == key) {
+                return entries_.begin() + idx;
+            }
+        }
+    }
+
+    // the iterator is invalidated by the next insertion
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        // keep the load factor under 0.5
+        if ((entries_.size() + 1) * 2 > index_.size()) {
+            Rehash(std::max<size_t>(16, index_.size() * 2));
+        }
+        size_t mask = index_.size() - 1;
+        size_t pos = Slot(key);
+        for (;; pos = (pos + 1) & mask) {
+            int32_t idx = index_[pos];
+            if (idx < 0) {
+                break;
+            }
+            if (entries_[idx].first == key) {
+                return {entries_.begin() + idx, false};
+            }
+        }
+        index_[pos] = entries_.size();
+        entries_.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        return {entries_.end() - 1, true};
+    }
+
+    // keep the first n entries ordered by `cmp` only
+    template <typename Cmp>
+    void Truncate(size_t n, Cmp cmp) {
+        if (entries_.size() <= n) {
+            return;
+        }
+        std::nth_element(entries_.begin(), entries_.begin() + n, entries_.end(), cmp);
+        entries_.resize(n);
+        Rehash(index_.size());
+    }
+
+ private:
+    size_t Slot(const K& key) const {
+        // fibonacci hashing, std::hash of integers is identity
+        uint64_t h = std::hash<K>()(key);
+        return (h * 0x9E3779B97F4A7C15ULL) >> (64 - bits_);
+    }
+
+    void Rehash(size_t capacity) {
+        bits_ = 0;
+        while ((static_cast<size_t>(1) << bits_) < capacity) {
+            bits_++;
+        }
+        index_.assign(static_cast<size_t>(1) << bits_, -1);
+        size_t mask = index_.size() - 1;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            size_t pos = Slot(entries_[i].first);
+            while (index_[pos] >= 0) {
+                pos = (pos + 1) & mask;
+            }
+            index_[pos] = i;
+        }
+    }
+
+    std::vector<value_type> entries_;
+    // position of the entry in `entries_`, -1 if the slot is empty
+    std::vector<int32_t> index_;
+    uint32_t bits_ = 0;
+};
+
 template <typename K, typename V,
           typename StorageV = typename ContainerStorageTypeTrait<V>::type>
 class BoundedGroupByDict {
@@ -182,6 +290,8 @@ class BoundedGroupByDict {
     // self type
     using ContainerT = BoundedGroupByDict<K, V, StorageV>;
 
+    using Entry = std::pair<StorageK, StorageV>;
+
     using FormatValueF = std::function<uint32_t(const StorageV&, char*, size_t)>;
 
     template <typename>
@@ -243,44 +353,46 @@ class BoundedGroupByDict {
                      });
     }
 
+    // output the groups ordered by key, only the largest `bound` keys are
+    // kept if the bound is set
     static void OutputString(ContainerT* ptr, bool is_desc,
                              codec::StringRef* output,
                              const FormatValueF& format_value) {
         auto& map = ptr->map_;
-        if (map.empty()) {
+        size_t limit = map.size();
+        if (ptr->bound_ >= 0 && static_cast<size_t>(ptr->bound_) < limit) {
+            limit = ptr->bound_;
+        }
+        if (limit == 0) {
             output->size_ = 0;
             output->data_ = "";
             return;
         }
 
+        std::vector<const Entry*> entries;
+        entries.reserve(map.size());
+        for (auto& entry : map) {
+            entries.push_back(&entry);
+        }
+        auto key_cmp = [](const Entry* lhs, const Entry* rhs) { return lhs->first > rhs->first; };
+        std::partial_sort(entries.begin(), entries.begin() + limit, entries.end(), key_cmp);
+        entries.resize(limit);
+        if (!is_desc) {
+            std::reverse(entries.begin(), entries.end());
+        }
+
         // estimate output length
         uint32_t str_len = 0;
-        auto stop_pos = map.end();
-        auto stop_rpos = map.rend();
-        if (is_desc) {
-            for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-                uint32_t key_len = v1::to_string_len(iter->first);
-                uint32_t value_len = format_value(iter->second, nullptr, 0);
-                uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
-                if (new_len > MAX_OUTPUT_STR_SIZE) {
-                    stop_rpos = iter;
-                    break;
-                } else {
-                    str_len = new_len;
-                }
-            }
-        } else {
-            for (auto iter = map.begin(); iter != map.end(); ++iter) {
-                uint32_t key_len = v1::to_string_len(iter->first);
-                uint32_t value_len = format_value(iter->second, nullptr, 0);
-                uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
-                if (new_len > MAX_OUTPUT_STR_SIZE) {
-                    stop_pos = iter;
-                    break;
-                } else {
-                    str_len = new_len;
-                }
+        size_t output_cnt = 0;
+        for (; output_cnt < entries.size(); ++output_cnt) {
+            const Entry* entry = entries[output_cnt];
+            uint32_t key_len = v1::to_string_len(entry->first);
+            uint32_t value_len = format_value(entry->second, nullptr, 0);
+            uint32_t new_len = str_len + key_len + value_len + 2;  // "k:v,"
+            if (new_len > MAX_OUTPUT_STR_SIZE) {
+                break;
             }
+            str_len = new_len;
         }
 
         // allocate string buffer
@@ -294,43 +406,18 @@ class BoundedGroupByDict {
         // fill string buffer
         char* cur = buffer;
         uint32_t remain_space = str_len;
-        if (is_desc) {
-            for (auto iter = map.rbegin(); iter != map.rend(); ++iter) {
-                if (iter == stop_rpos) {
-                    break;
-                }
-                uint32_t key_len =
-                    v1::format_string(iter->first, cur, remain_space);
-                cur += key_len;
-                *(cur++) = ':';
-                remain_space -= key_len + 1;
-
-                uint32_t value_len =
-                    format_value(iter->second, cur, remain_space);
-                cur += value_len;
-                remain_space -= value_len;
-                if (remain_space-- > 0) {
-                    *(cur++) = ',';
-                }
-            }
-        } else {
-            for (auto iter = map.begin(); iter != map.end(); ++iter) {
-                if (iter == stop_pos) {
-                    break;
-                }
-                uint32_t key_len =
-                    v1::format_string(iter->first, cur, remain_space);
-                cur += key_len;
-                *(cur++) = ':';
-                remain_space -= key_len + 1;
+        for (size_t i = 0; i < output_cnt; ++i) {
+            const Entry* entry = entries[i];
+            uint32_t key_len = v1::format_string(entry->first, cur, remain_space);
+            cur += key_len;
+            *(cur++) = ':';
+            remain_space -= key_len + 1;
 
-                uint32_t value_len =
-                    format_value(iter->second, cur, remain_space);
-                cur += value_len;
-                remain_space -= value_len;
-                if (remain_space-- > 0) {
-                    *(cur++) = ',';
-                }
+            uint32_t value_len = format_value(entry->second, cur, remain_space);
+            cur += value_len;
+            remain_space -= value_len;
+            if (remain_space-- > 0) {
+                *(cur++) = ',';
             }
         }
 
@@ -340,7 +427,6 @@ class BoundedGroupByDict {
             str_len - 1;  // must leave one '\0' for string format impl
     }
 
-
     // fetch top n elements in `map_` order by value of map in desc.
     // return string with the format of `key1:value1,key2:value...`.
     void OutputTopNByValue(int64_t topn, const FormatValueF& format_value, codec::StringRef* output) {
@@ -349,30 +435,31 @@ class BoundedGroupByDict {
             output->data_ = "";
             return;
         }
-        std::set<std::pair<StorageK, StorageV>, PairCmp> ordered_set;
-        for (auto& kv : map_) {
-            ordered_set.emplace(kv.first, kv.second);
-
-            if (topn >= 0 && ordered_set.size() > static_cast<size_t>(topn)) {
-                ordered_set.erase(ordered_set.begin());
-            }
+        std::vector<const Entry*> entries;
+        entries.reserve(map_.size());
+        for (auto& entry : map_) {
+            entries.push_back(&entry);
+        }
+        size_t limit = entries.size();
+        if (topn >= 0 && static_cast<size_t>(topn) < limit) {
+            limit = topn;
         }
+        PairCmp pair_cmp;
+        std::partial_sort(entries.begin(), entries.begin() + limit, entries.end(),
+                          [&pair_cmp](const Entry* lhs, const Entry* rhs) { return pair_cmp(*rhs, *lhs); });
+        entries.resize(limit);
 
         uint32_t outlen = 0;
-        auto it = ordered_set.crbegin();
-        auto end = ordered_set.crend();
-        auto stop_it = ordered_set.crend();
-
-        for (; it != end; ++it) {
-            uint32_t key_len = v1::to_string_len(it->first);
-            uint32_t value_len = format_value(it->second, nullptr, 0);
+        size_t output_cnt = 0;
+        for (; output_cnt < entries.size(); ++output_cnt) {
+            const Entry* entry = entries[output_cnt];
+            uint32_t key_len = v1::to_string_len(entry->first);
+            uint32_t value_len = format_value(entry->second, nullptr, 0);
             uint32_t new_len = outlen + key_len + value_len + 2;  // "k:v,"
             if (new_len > MAX_OUTPUT_STR_SIZE) {
-                stop_it = it;
                 break;
-            } else {
-                outlen = new_len;
             }
+            outlen = new_len;
         }
 
         // allocate string buffer
@@ -385,14 +472,14 @@ class BoundedGroupByDict {
 
         char* cur = buffer;
         uint32_t remain_space = outlen;
-        auto cur_it = ordered_set.crbegin();
-        for (; cur_it != stop_it; ++cur_it) {
-            uint32_t key_len = v1::format_string(cur_it->first, cur, remain_space);
+        for (size_t i = 0; i < output_cnt; ++i) {
+            const Entry* entry = entries[i];
+            uint32_t key_len = v1::format_string(entry->first, cur, remain_space);
             cur += key_len;
             *(cur++) = ':';
             remain_space -= key_len + 1;
 
-            uint32_t value_len = format_value(cur_it->second, cur, remain_space);
+            uint32_t value_len = format_value(entry->second, cur, remain_space);
             cur += value_len;
             remain_space -= value_len;
             if (remain_space-- > 0) {
@@ -405,14 +492,270 @@ class BoundedGroupByDict {
         output->size_ = outlen - 1;  // must leave one '\0' for string format impl
     }
 
+    // keep the largest `bound` keys only, negative bound means no limit. It is
+    // the same as dropping the smallest key once the size exceeds the bound,
+    // but the keys are dropped in batch
+    void Bound(int64_t bound) {
+        bound_ = bound;
+        if (bound_ >= 0 && map_.size() > static_cast<size_t>(bound_) * 2 + 16) {
+            map_.Truncate(bound_, [](const Entry& lhs, const Entry& rhs) { return lhs.first > rhs.first; });
+        }
+    }
+
     auto& map() { return map_; }
 
  private:
-    std::map<StorageK, StorageV, std::less<StorageK>> map_;
+    FlatHashMap<StorageK, StorageV> map_;
+    int64_t bound_ = -1;
 
     static const size_t MAX_OUTPUT_STR_SIZE = 4096;
 };
 
+/**
+ * HyperLogLog sketch counting the distinct values approximately with fixed
+ * memory, the standard error is about 1.04 / sqrt(2^kPrecision). Sketches
+ * are mergeable, so partial aggregations can be combined.
+ */
+class HyperLogLog {
+ public:
+    static constexpr uint32_t kPrecision = 12;
+    static constexpr uint32_t kRegisterNum = 1u << kPrecision;
+
+    HyperLogLog() : registers_() {}
+
+    static void Init(HyperLogLog* addr) { new (addr) HyperLogLog(); }
+
+    static void Destroy(HyperLogLog* ptr) { ptr->~HyperLogLog(); }
+
+    // std::hash is identity for integers, mix it to spread the bits
+    template <typename V>
+    static uint64_t Hash(const V& value) {
+        uint64_t h = std::hash<V>()(value);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    void Add(uint64_t hash) {
+        uint32_t idx = hash >> (64 - kPrecision);
+        // the guard bit bounds the rank when the rest bits are all zero
+        uint64_t rest = (hash << kPrecision) | (1ULL << (kPrecision - 1));
+        uint8_t rank = __builtin_clzll(rest) + 1;
+        if (rank > registers_[idx]) {
+            registers_[idx] = rank;
+        }
+    }
+
+    void Merge(const HyperLogLog& other) {
+        for (uint32_t i = 0; i < kRegisterNum; ++i) {
+            registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+    }
+
+    double Estimate() const {
+        double m = kRegisterNum;
+        double sum = 0;
+        uint32_t zeros = 0;
+        for (uint8_t reg : registers_) {
+            sum += std::ldexp(1.0, -reg);
+            if (reg == 0) {
+                zeros++;
+            }
+        }
+        double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+        // linear counting is more accurate for small cardinalities
+        if (estimate <= 2.5 * m && zeros > 0) {
+            estimate = m * std::log(m / zeros);
+        }
+        return estimate;
+    }
+
+    void Encode(std::string* output) const {
+        output->assign(reinterpret_cast<const char*>(registers_.data()), registers_.size());
+    }
+
+    bool Decode(const char* data, size_t size) {
+        if (size != kRegisterNum) {
+            return false;
+        }
+        memcpy(registers_.data(), data, size);
+        return true;
+    }
+
+ private:
+    // fixed size, the sketch lives in the UDAF state without heap allocation
+    std::array<uint8_t, kRegisterNum> registers_;
+};
+
+/**
+ * Merging t-digest estimating the quantiles approximately. The count of the
+ * centroids is bounded by kCompression, the centroids near the tails are
+ * smaller, so the extreme quantiles are more accurate. The result is exact
+ * for small inputs, where every value is kept as a centroid.
+ */
+class TDigest {
+ public:
+    static constexpr double kCompression = 100;
+    static constexpr size_t kBufferSize = 500;
+
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    TDigest() : centroids_(), buffer_(), total_(0), min_(0), max_(0) {}
+
+    static void Init(TDigest* addr) { new (addr) TDigest(); }
+
+    static void Destroy(TDigest* ptr) { ptr->~TDigest(); }
+
+    void Add(double value, double weight = 1) {
+        if (std::isnan(value) || weight <= 0) {
+            return;
+        }
+        if (total_ == 0) {
+            min_ = value;
+            max_ = value;
+        } else {
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+        total_ += weight;
+        buffer_.push_back({value, weight});
+        if (buffer_.size() >= kBufferSize) {
+            Compress();
+        }
+    }
+
+    void Merge(const TDigest& other) {
+        if (other.total_ == 0) {
+            return;
+        }
+        if (total_ == 0) {
+            min_ = other.min_;
+            max_ = other.max_;
+        } else {
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+        total_ += other.total_;
+        buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+        buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+        Compress();
+    }
+
+    double Count() const { return total_; }
+
+    // q is in [0, 1], return NaN if the digest is empty
+    double Quantile(double q) {
+        Compress();
+        if (centroids_.empty()) {
+            return std::nan("");
+        }
+        q = std::min(1.0, std::max(0.0, q));
+        if (centroids_.size() == 1) {
+            return centroids_[0].mean;
+        }
+        // interpolate between the centers of the neighbouring centroids, the value
+        // at rank i of n values is at position i / (n - 1) like numpy
+        double target = q * (total_ - 1);
+        const auto& first = centroids_.front();
+        double first_center = (first.weight - 1) / 2;
+        if (target <= first_center) {
+            return first_center <= 0 ? min_ : min_ + (first.mean - min_) * target / first_center;
+        }
+        double cum = 0;
+        for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+            const auto& cur = centroids_[i];
+            const auto& next = centroids_[i + 1];
+            double left = cum + (cur.weight - 1) / 2;
+            double right = cum + cur.weight + (next.weight - 1) / 2;
+            if (target <= right) {
+                return cur.mean + (next.mean - cur.mean) * (target - left) / (right - left);
+            }
+            cum += cur.weight;
+        }
+        const auto& last = centroids_.back();
+        double last_center = total_ - 1 - (last.weight - 1) / 2;
+        double tail = total_ - 1 - last_center;
+        return tail <= 0 ? max_ : last.mean + (max_ - last.mean) * (target - last_center) / tail;
+    }
+
+    void Encode(std::string* output) {
+        Compress();
+        output->resize(sizeof(double) * (3 + centroids_.size() * 2));
+        char* cur = &(*output)[0];
+        for (double v : {total_, min_, max_}) {
+            memcpy(cur, &v, sizeof(double));
+            cur += sizeof(double);
+        }
+        for (const auto& centroid : centroids_) {
+            memcpy(cur, &centroid.mean, sizeof(double));
+            memcpy(cur + sizeof(double), &centroid.weight, sizeof(double));
+            cur += sizeof(double) * 2;
+        }
+    }
+
+    bool Decode(const char* data, size_t size) {
+        if (size < sizeof(double) * 3 || (size / sizeof(double) - 3) % 2 != 0 || size % sizeof(double) != 0) {
+            return false;
+        }
+        memcpy(&total_, data, sizeof(double));
+        memcpy(&min_, data + sizeof(double), sizeof(double));
+        memcpy(&max_, data + sizeof(double) * 2, sizeof(double));
+        centroids_.resize((size / sizeof(double) - 3) / 2);
+        memcpy(centroids_.data(), data + sizeof(double) * 3, size - sizeof(double) * 3);
+        buffer_.clear();
+        return true;
+    }
+
+ private:
+    // k1 scale function of t-digest
+    static double ScaleK(double q) { return kCompression / (2 * M_PI) * std::asin(2 * q - 1); }
+    static double ScaleQ(double k) {
+        if (k >= kCompression / 4) {
+            return 1;
+        }
+        return (std::sin(k * 2 * M_PI / kCompression) + 1) / 2;
+    }
+
+    void Compress() {
+        if (buffer_.empty()) {
+            return;
+        }
+        buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+        std::sort(buffer_.begin(), buffer_.end(),
+                  [](const Centroid& lhs, const Centroid& rhs) { return lhs.mean < rhs.mean; });
+        centroids_.clear();
+        centroids_.push_back(buffer_[0]);
+        double weight_so_far = 0;
+        double weight_limit = total_ * ScaleQ(ScaleK(0) + 1);
+        for (size_t i = 1; i < buffer_.size(); ++i) {
+            auto& cur = centroids_.back();
+            const auto& next = buffer_[i];
+            if (weight_so_far + cur.weight + next.weight <= weight_limit) {
+                cur.weight += next.weight;
+                cur.mean += (next.mean - cur.mean) * next.weight / cur.weight;
+            } else {
+                weight_so_far += cur.weight;
+                weight_limit = total_ * ScaleQ(ScaleK(weight_so_far / total_) + 1);
+                centroids_.push_back(next);
+            }
+        }
+        buffer_.clear();
+    }
+
+    std::vector<Centroid> centroids_;
+    // values not merged into centroids yet
+    std::vector<Centroid> buffer_;
+    double total_;
+    double min_;
+    double max_;
+};
+
 }  // namespace container
 }  // namespace udf
 }  // namespace hybridse
@@ -73,15 +73,9 @@ struct AvgCateDef {
             }
             auto& map = ptr->map();
             auto stored_key = ContainerT::to_stored_key(key);
-            auto iter = map.find(stored_key);
-            if (iter == map.end()) {
-                map.insert(iter, {stored_key,
-                                  {1, ContainerT::to_stored_value(value)}});
-            } else {
-                auto& pair = iter->second;
-                pair.first += 1;
-                pair.second += ContainerT::to_stored_value(value);
-            }
+            auto& pair = map.try_emplace(stored_key, 0, 0.0).first->second;
+            pair.first += 1;
+            pair.second += ContainerT::to_stored_value(value);
             return ptr;
         }
 
@@ -184,10 +178,7 @@ struct TopKAvgCateWhereDef {
             if (cond && !is_cond_null) {
                 AvgCateImpl::Update(ptr, value, is_value_null, key,
                                     is_key_null);
-                auto& map = ptr->map();
-                if (bound >= 0 && map.size() > static_cast<size_t>(bound)) {
-                    map.erase(map.begin());
-                }
+                ptr->Bound(bound);
             }
             return ptr;
         }
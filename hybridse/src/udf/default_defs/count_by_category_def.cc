@@ -175,10 +175,7 @@ struct TopNKeyCountCateWhereDef {
                                   bool is_key_null, int64_t bound) {
             if (cond && !is_cond_null) {
                 CateImpl::Update(ptr, value, is_value_null, key, is_key_null);
-                auto& map = ptr->map();
-                if (bound >= 0 && map.size() > static_cast<size_t>(bound)) {
-                    map.erase(map.begin());
-                }
+                ptr->Bound(bound);
             }
             return ptr;
         }
@@ -15,7 +15,6 @@
  */
 
 #include <algorithm>
-#include <queue>
 #include <string>
 #include <tuple>
 #include <unordered_set>
@@ -405,13 +404,7 @@ struct FZTop1Ratio {
         }
         auto& map = ptr->map();
         auto stored_key = ContainerT::to_stored_key(key);
-        auto iter = map.find(stored_key);
-        if (iter == map.end()) {
-            map.insert(iter, {stored_key, 1});
-        } else {
-            auto& single = iter->second;
-            single += 1;
-        }
+        map.try_emplace(stored_key, 0).first->second += 1;
         return ptr;
     }
 
@@ -468,13 +461,7 @@ struct FZTopNFrequency {
             return ptr;
         }
         auto stored_key = TopNContainer::to_stored_key(key);
-        auto iter = map.find(stored_key);
-        if (iter == map.end()) {
-            map.insert(iter, {stored_key, 1});
-        } else {
-            auto& single = iter->second;
-            single += 1;
-        }
+        map.try_emplace(stored_key, 0).first->second += 1;
         return ptr;
     }
 
@@ -487,28 +474,22 @@ struct FZTopNFrequency {
         size_t top_n = ptr->top_n_ < MAXIMUM_TOPN ? ptr->top_n_ : MAXIMUM_TOPN;
         auto& map = ptr->map();
         using StorageK = typename container::ContainerStorageTypeTrait<K>::type;
-        using Entry = std::pair<StorageK, size_t>;
-        auto cmp = [](Entry x, Entry y) {
-            if (x.second < y.second) {
-                return true;
-            } else if (x.second == y.second) {
-                return x.first > y.first;
-            } else {
-                return false;
-            }
-        };
-        std::priority_queue<Entry, std::vector<Entry>, decltype(cmp)> queue(
-            cmp);
-        for (auto iter = map.begin(); iter != map.end(); ++iter) {
-            queue.push({iter->first, iter->second});
+        using Entry = typename TopNContainer::Entry;
+        // most frequent first, the smaller key first if the counts are equal
+        std::vector<const Entry*> entries;
+        entries.reserve(map.size());
+        for (auto& entry : map) {
+            entries.push_back(&entry);
         }
+        size_t limit = std::min(top_n, entries.size());
+        std::partial_sort(entries.begin(), entries.begin() + limit, entries.end(),
+                          [](const Entry* x, const Entry* y) {
+                              return x->second > y->second || (x->second == y->second && x->first < y->first);
+                          });
         std::vector<StorageK> keys;
-        for (size_t i = 0; i < top_n; ++i) {
-            if (queue.empty()) {
-                break;
-            }
-            keys.emplace_back(queue.top().first);
-            queue.pop();
+        keys.reserve(limit);
+        for (size_t i = 0; i < limit; ++i) {
+            keys.emplace_back(entries[i]->first);
         }
 
         // estimate output length
@@ -72,15 +72,10 @@ struct MinCateDef {
             }
             auto& map = ptr->map();
             auto stored_key = ContainerT::to_stored_key(key);
-            auto iter = map.find(stored_key);
-            if (iter == map.end()) {
-                map.insert(iter,
-                           {stored_key, ContainerT::to_stored_value(value)});
-            } else {
-                auto& single = iter->second;
-                if (single > ContainerT::to_stored_value(value)) {
-                    single = ContainerT::to_stored_value(value);
-                }
+            auto stored_value = ContainerT::to_stored_value(value);
+            auto iter = map.try_emplace(stored_key, stored_value);
+            if (!iter.second && iter.first->second > stored_value) {
+                iter.first->second = stored_value;
             }
             return ptr;
         }
@@ -187,10 +182,7 @@ struct TopKMinCateWhereDef {
             if (cond && !is_cond_null) {
                 AvgCateImpl::Update(ptr, value, is_value_null, key,
                                     is_key_null);
-                auto& map = ptr->map();
-                if (bound >= 0 && map.size() > static_cast<size_t>(bound)) {
-                    map.erase(map.begin());
-                }
+                ptr->Bound(bound);
             }
             return ptr;
         }
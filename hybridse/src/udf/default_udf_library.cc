@@ -16,6 +16,7 @@
 
 #include "udf/default_udf_library.h"
 
+#include <cmath>
 #include <string>
 #include <tuple>
 #include <unordered_set>
@@ -377,6 +378,111 @@ struct MedianDef {
     }
 };
 
+template <typename T>
+struct ApproxDistinctCountDef {
+    using ArgT = typename DataTypeTrait<T>::CCallArgType;
+    using ContainerT = container::HyperLogLog;
+
+    void operator()(UdafRegistryHelper& helper) {  // NOLINT
+        std::string suffix = ".opaque_hll_" + DataTypeTrait<T>::to_string();
+        helper.templates<int64_t, Opaque<ContainerT>, Nullable<T>>()
+            .init("approx_distinct_count_init" + suffix, ContainerT::Init)
+            .update("approx_distinct_count_update" + suffix, UpdateImpl<ArgT>::Update)
+            .output("approx_distinct_count_output" + suffix, Output);
+    }
+
+    static int64_t Output(ContainerT* hll) {
+        int64_t cnt = std::llround(hll->Estimate());
+        ContainerT::Destroy(hll);
+        return cnt;
+    }
+
+    template <typename V>
+    struct UpdateImpl {
+        static ContainerT* Update(ContainerT* hll, V value, bool is_null) {
+            if (!is_null) {
+                hll->Add(ContainerT::Hash(value));
+            }
+            return hll;
+        }
+    };
+
+    template <typename V>
+    struct UpdateImpl<V*> {
+        static ContainerT* Update(ContainerT* hll, V* value, bool is_null) {
+            if (!is_null) {
+                hll->Add(ContainerT::Hash(*value));
+            }
+            return hll;
+        }
+    };
+};
+
+static void OutputQuantile(container::TDigest* digest, double q, double* ret, bool* is_null) {
+    if (digest->Count() == 0 || !(q >= 0 && q <= 1)) {
+        *is_null = true;
+    } else {
+        *is_null = false;
+        *ret = digest->Quantile(q);
+    }
+}
+
+template <typename T>
+struct ApproxMedianDef {
+    using ContainerT = container::TDigest;
+
+    void operator()(UdafRegistryHelper& helper) {  // NOLINT
+        std::string suffix = ".opaque_tdigest_" + DataTypeTrait<T>::to_string();
+        helper.templates<Nullable<double>, Opaque<ContainerT>, Nullable<T>>()
+            .init("approx_median_init" + suffix, ContainerT::Init)
+            .update("approx_median_update" + suffix, Update)
+            .output("approx_median_output" + suffix, reinterpret_cast<void*>(Output), true);
+    }
+
+    static ContainerT* Update(ContainerT* digest, T value, bool is_null) {
+        if (!is_null) {
+            digest->Add(static_cast<double>(value));
+        }
+        return digest;
+    }
+
+    static void Output(ContainerT* digest, double* ret, bool* is_null) {
+        OutputQuantile(digest, 0.5, ret, is_null);
+        ContainerT::Destroy(digest);
+    }
+};
+
+template <typename T>
+struct ApproxQuantileDef {
+    struct ContainerT {
+        container::TDigest digest;
+        double q = 0;
+    };
+
+    void operator()(UdafRegistryHelper& helper) {  // NOLINT
+        std::string suffix = ".opaque_tdigest_" + DataTypeTrait<T>::to_string();
+        helper.templates<Nullable<double>, Opaque<ContainerT>, Nullable<T>, double>()
+            .init("approx_quantile_init" + suffix, Init)
+            .update("approx_quantile_update" + suffix, Update)
+            .output("approx_quantile_output" + suffix, reinterpret_cast<void*>(Output), true);
+    }
+
+    static void Init(ContainerT* addr) { new (addr) ContainerT(); }
+
+    static ContainerT* Update(ContainerT* container, T value, bool is_null, double q) {
+        container->q = q;
+        if (!is_null) {
+            container->digest.Add(static_cast<double>(value));
+        }
+        return container;
+    }
+
+    static void Output(ContainerT* container, double* ret, bool* is_null) {
+        OutputQuantile(&container->digest, container->q, ret, is_null);
+        container->~ContainerT();
+    }
+};
+
 template <typename T>
 struct SumWhereDef {
     void operator()(UdafRegistryHelper& helper) {  // NOLINT
@@ -2737,6 +2843,80 @@ void DefaultUdfLibrary::InitUdaf() {
         .args_in<int16_t, int32_t, int64_t, float, double>();
 
 
+    RegisterUdafTemplate<ApproxDistinctCountDef>("approx_distinct_count")
+        .doc(R"(
+            @brief Compute approximate number of distinct values with HyperLogLog, null values are ignored.
+            The memory is fixed to 4KB and the standard error is about 1.6%.
+
+            @param value  Specify value column to aggregate on.
+
+            Example:
+
+            |value|
+            |--|
+            |0|
+            |0|
+            |2|
+            |2|
+            |4|
+            @code{.sql}
+                SELECT approx_distinct_count(value) OVER w;
+                -- output 3
+            @endcode
+            @since 0.6.0
+        )")
+        .args_in<bool, int16_t, int32_t, int64_t, float, double, Timestamp,
+                 Date, StringRef>();
+
+    RegisterUdafTemplate<ApproxMedianDef>("approx_median")
+        .doc(R"(
+            @brief Compute approximate median of values with t-digest, null values are ignored.
+            The memory is bounded and the result is exact when the window is small.
+
+            @param value  Specify value column to aggregate on.
+
+            Example:
+
+            |value|
+            |--|
+            |1|
+            |2|
+            |3|
+            |4|
+            @code{.sql}
+                SELECT approx_median(value) OVER w;
+                -- output 2.5
+            @endcode
+            @since 0.6.0
+        )")
+        .args_in<int16_t, int32_t, int64_t, float, double>();
+
+    RegisterUdafTemplate<ApproxQuantileDef>("approx_quantile")
+        .doc(R"(
+            @brief Compute approximate quantile of values with t-digest, null values are ignored.
+            The memory is bounded and the result is exact when the window is small.
+
+            @param value  Specify value column to aggregate on.
+            @param q  The quantile in [0, 1], return null if it is out of range.
+
+            Example:
+
+            |value|
+            |--|
+            |1|
+            |2|
+            |3|
+            |4|
+            |5|
+            @code{.sql}
+                SELECT approx_quantile(value, 0.25) OVER w;
+                -- output 2
+            @endcode
+            @since 0.6.0
+        )")
+        .args_in<int16_t, int32_t, int64_t, float, double>();
+
+
     InitAggByCateUdafs();
 }
 
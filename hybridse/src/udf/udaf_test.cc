@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <string>
+
+#include "udf/containers.h"
 #include "udf/udf_test.h"
 
 namespace hybridse {
@@ -122,6 +125,69 @@ TEST_F(UdafTest, MedianTest) {
     CheckUdafOneParam<Nullable<double>, Nullable<double>>("median", 3.0, {1.0, 5.0, 2.0, 4.0, 3.0});
 }
 
+TEST_F(UdafTest, ApproxDistinctCountTest) {
+    CheckUdafOneParam<int64_t, Nullable<int32_t>>("approx_distinct_count", 0, {});
+    CheckUdafOneParam<int64_t, Nullable<int32_t>>("approx_distinct_count", 0, {nullptr});
+    CheckUdafOneParam<int64_t, Nullable<int32_t>>("approx_distinct_count", 3, {0, 0, 2, 2, 4, nullptr});
+    CheckUdafOneParam<int64_t, Nullable<double>>("approx_distinct_count", 2, {1.0, 2.0, 1.0});
+    CheckUdafOneParam<int64_t, Nullable<StringRef>>("approx_distinct_count", 2,
+                                                   {StringRef("a"), StringRef("bb"), StringRef("a")});
+    CheckUdafOneParam<int64_t, Nullable<Timestamp>>("approx_distinct_count", 2,
+                                                   {Timestamp(1), Timestamp(2), nullptr});
+}
+
+TEST_F(UdafTest, ApproxMedianTest) {
+    CheckUdafOneParam<Nullable<double>, Nullable<int32_t>>("approx_median", nullptr, {});
+    CheckUdafOneParam<Nullable<double>, Nullable<int32_t>>("approx_median", nullptr, {nullptr});
+    CheckUdafOneParam<Nullable<double>, Nullable<int32_t>>("approx_median", 1, {0, 1, 2, nullptr});
+    CheckUdafOneParam<Nullable<double>, Nullable<int32_t>>("approx_median", 2.5, {1, 2, 4, 3});
+    CheckUdafOneParam<Nullable<double>, Nullable<double>>("approx_median", 3.0, {1.0, 5.0, 2.0, 4.0, 3.0});
+}
+
+TEST_F(UdafTest, ApproxQuantileTest) {
+    CheckUdf<Nullable<double>, ListRef<Nullable<int32_t>>, ListRef<double>>(
+        "approx_quantile", nullptr, MakeList<Nullable<int32_t>>({}), MakeList<double>({}));
+    CheckUdf<Nullable<double>, ListRef<Nullable<int32_t>>, ListRef<double>>(
+        "approx_quantile", 2.0, MakeList<Nullable<int32_t>>({1, 2, 3, 4, 5}),
+        MakeList<double>({0.25, 0.25, 0.25, 0.25, 0.25}));
+    CheckUdf<Nullable<double>, ListRef<Nullable<int32_t>>, ListRef<double>>(
+        "approx_quantile", 5.0, MakeList<Nullable<int32_t>>({1, 2, 3, 4, 5}),
+        MakeList<double>({1, 1, 1, 1, 1}));
+    // quantile out of range
+    CheckUdf<Nullable<double>, ListRef<Nullable<int32_t>>, ListRef<double>>(
+        "approx_quantile", nullptr, MakeList<Nullable<int32_t>>({1, 2}), MakeList<double>({1.5, 1.5}));
+}
+
+TEST_F(UdafTest, SketchMergeTest) {
+    container::HyperLogLog hll1;
+    container::HyperLogLog hll2;
+    container::TDigest digest1;
+    container::TDigest digest2;
+    for (int64_t i = 0; i < 100000; ++i) {
+        hll1.Add(container::HyperLogLog::Hash(i));
+        hll2.Add(container::HyperLogLog::Hash(i + 50000));
+        (i % 2 == 0 ? digest1 : digest2).Add(i);
+    }
+    hll1.Merge(hll2);
+    ASSERT_NEAR(150000, hll1.Estimate(), 150000 * 0.05);
+    digest1.Merge(digest2);
+    ASSERT_EQ(100000, digest1.Count());
+    ASSERT_NEAR(50000, digest1.Quantile(0.5), 100000 * 0.01);
+    ASSERT_NEAR(99000, digest1.Quantile(0.99), 100000 * 0.001);
+
+    // the encoded sketches are used as partial aggregations
+    std::string buf;
+    hll1.Encode(&buf);
+    container::HyperLogLog decoded_hll;
+    ASSERT_TRUE(decoded_hll.Decode(buf.data(), buf.size()));
+    ASSERT_EQ(hll1.Estimate(), decoded_hll.Estimate());
+    digest1.Encode(&buf);
+    container::TDigest decoded_digest;
+    ASSERT_TRUE(decoded_digest.Decode(buf.data(), buf.size()));
+    ASSERT_EQ(digest1.Quantile(0.5), decoded_digest.Quantile(0.5));
+    ASSERT_FALSE(decoded_digest.Decode(buf.data(), 7));
+}
+
 TEST_F(UdafTest, SumWhereTest) {
     CheckUdf<int32_t, ListRef<int32_t>, ListRef<bool>>(
         "sum_where", 10, MakeList<int32_t>({4, 5, 6}),
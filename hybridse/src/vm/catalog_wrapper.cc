@@ -15,6 +15,9 @@
  */
 
 #include "vm/catalog_wrapper.h"
+
+#include <algorithm>
+
 namespace hybridse {
 namespace vm {
 
@@ -37,6 +40,81 @@ base::ConstIterator<uint64_t, Row>* PartitionProjectWrapper::GetRawIterator() {
     }
 }
 
+ProjectedSegment::ProjectedSegment(std::shared_ptr<TableHandler> segment, const Row& parameter,
+                                   const ProjectFun* fun)
+    : segment_(segment), parameter_(parameter), fun_(fun), iter_(segment->GetIterator()), mu_(), blocks_(), size_(0) {
+    if (iter_) {
+        iter_->SeekToFirst();
+    }
+}
+
+bool ProjectedSegment::FetchNext() {
+    if (!iter_ || !iter_->Valid()) {
+        return false;
+    }
+    if (size_ % kBlockSize == 0) {
+        blocks_.emplace_back(new Block());
+    }
+    auto& block = blocks_.back();
+    block->keys[size_ % kBlockSize] = iter_->GetKey();
+    block->rows[size_ % kBlockSize] = fun_->operator()(iter_->GetValue(), parameter_);
+    size_++;
+    iter_->Next();
+    return true;
+}
+
+const ProjectedSegment::Block* ProjectedSegment::Fetch(size_t pos, size_t* end) {
+    std::lock_guard<std::mutex> lock(mu_);
+    while (size_ <= pos) {
+        if (!FetchNext()) {
+            return nullptr;
+        }
+    }
+    *end = std::min(size_, pos - pos % kBlockSize + kBlockSize);
+    return blocks_[pos / kBlockSize].get();
+}
+
+size_t ProjectedSegment::Seek(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (size_ > 0 && KeyAt(size_ - 1) <= key) {
+        size_t low = 0;
+        size_t high = size_ - 1;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (KeyAt(mid) <= key) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+    while (FetchNext()) {
+        if (KeyAt(size_ - 1) <= key) {
+            return size_ - 1;
+        }
+    }
+    return size_;
+}
+
+std::shared_ptr<TableHandler> PartitionProjectCacheWrapper::GetSegment(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto iter = segments_.find(key);
+    if (iter != segments_.end()) {
+        return std::make_shared<ProjectedSegmentHandler>(iter->second);
+    }
+    auto segment = partition_handler_->GetSegment(key);
+    if (!segment) {
+        return std::shared_ptr<TableHandler>();
+    }
+    if (segment->GetOrderType() == kAscOrder) {
+        return std::make_shared<TableProjectWrapper>(segment, parameter_, fun_);
+    }
+    auto projected = std::make_shared<ProjectedSegment>(segment, parameter_, fun_);
+    segments_.emplace(key, projected);
+    return std::make_shared<ProjectedSegmentHandler>(projected);
+}
+
 std::shared_ptr<TableHandler> PartitionFilterWrapper::GetSegment(
     const std::string& key) {
     auto segment = partition_handler_->GetSegment(key);
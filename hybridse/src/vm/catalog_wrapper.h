@@ -16,9 +16,13 @@
 
 #ifndef HYBRIDSE_SRC_VM_CATALOG_WRAPPER_H_
 #define HYBRIDSE_SRC_VM_CATALOG_WRAPPER_H_
+#include <array>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "vm/catalog.h"
 namespace hybridse {
 namespace vm {
@@ -384,6 +388,123 @@ class TableProjectWrapper : public TableHandler {
     const ProjectFun* fun_;
 };
 
+// Rows of one segment projected by `fun`. A row is projected on its first access and
+// kept as long as the segment, so the windows of a request over the same segment project
+// every row once. Projected rows are appended into fixed size blocks and never change
+// once published. Fetch takes the lock to project and find the block, then the iterators
+// read the rows of the fetched block without lock until they move past it.
+class ProjectedSegment {
+ public:
+    static constexpr size_t kBlockSize = 64;
+    struct Block {
+        std::array<uint64_t, kBlockSize> keys;
+        std::array<Row, kBlockSize> rows;
+    };
+
+    ProjectedSegment(std::shared_ptr<TableHandler> segment, const Row& parameter, const ProjectFun* fun);
+
+    // Project rows until the row at `pos` is available. Return the block of `pos` and set
+    // `end` to the end position of the rows available in that block, or return null if the
+    // segment has no row at `pos`
+    const Block* Fetch(size_t pos, size_t* end);
+
+    // Return the position of the first row whose key is not greater than `key`, the rows
+    // are in descending order of key
+    size_t Seek(uint64_t key);
+
+    const std::shared_ptr<TableHandler>& segment() const { return segment_; }
+
+ private:
+    bool FetchNext();
+    uint64_t KeyAt(size_t pos) const { return blocks_[pos / kBlockSize]->keys[pos % kBlockSize]; }
+
+    std::shared_ptr<TableHandler> segment_;
+    const Row& parameter_;
+    const ProjectFun* fun_;
+    std::unique_ptr<RowIterator> iter_;
+    // guard all the fields below
+    std::mutex mu_;
+    std::vector<std::unique_ptr<Block>> blocks_;
+    size_t size_;
+};
+
+class ProjectedSegmentIterator : public RowIterator {
+ public:
+    explicit ProjectedSegmentIterator(std::shared_ptr<ProjectedSegment> segment)
+        : RowIterator(), segment_(segment), block_(nullptr), pos_(0), end_(0) {}
+    ~ProjectedSegmentIterator() {}
+    bool Valid() const override { return block_ != nullptr; }
+    void Next() override {
+        if (++pos_ >= end_) {
+            Locate(pos_);
+        }
+    }
+    const uint64_t& GetKey() const override { return block_->keys[pos_ % ProjectedSegment::kBlockSize]; }
+    const Row& GetValue() override { return block_->rows[pos_ % ProjectedSegment::kBlockSize]; }
+    void Seek(const uint64_t& key) override { Locate(segment_->Seek(key)); }
+    void SeekToFirst() override { Locate(0); }
+    bool IsSeekable() const override { return true; }
+
+ private:
+    void Locate(size_t pos) {
+        pos_ = pos;
+        block_ = segment_->Fetch(pos_, &end_);
+    }
+
+    std::shared_ptr<ProjectedSegment> segment_;
+    const ProjectedSegment::Block* block_;
+    size_t pos_;
+    size_t end_;
+};
+
+class ProjectedSegmentHandler : public TableHandler {
+ public:
+    explicit ProjectedSegmentHandler(std::shared_ptr<ProjectedSegment> segment)
+        : TableHandler(), segment_(segment), value_() {}
+    ~ProjectedSegmentHandler() {}
+
+    std::unique_ptr<RowIterator> GetIterator() override {
+        return std::unique_ptr<RowIterator>(new ProjectedSegmentIterator(segment_));
+    }
+    RowIterator* GetRawIterator() override { return new ProjectedSegmentIterator(segment_); }
+    std::unique_ptr<WindowIterator> GetWindowIterator(const std::string& idx_name) override {
+        return std::unique_ptr<WindowIterator>();
+    }
+    const Types& GetTypes() override { return segment_->segment()->GetTypes(); }
+    const IndexHint& GetIndex() override { return segment_->segment()->GetIndex(); }
+    const Schema* GetSchema() override { return segment_->segment()->GetSchema(); }
+    const std::string& GetName() override { return segment_->segment()->GetName(); }
+    const std::string& GetDatabase() override { return segment_->segment()->GetDatabase(); }
+    const uint64_t GetCount() override { return segment_->segment()->GetCount(); }
+    Row At(uint64_t pos) override {
+        size_t end = 0;
+        auto block = segment_->Fetch(pos, &end);
+        value_ = block == nullptr ? Row() : block->rows[pos % ProjectedSegment::kBlockSize];
+        return value_;
+    }
+    const OrderType GetOrderType() const override { return segment_->segment()->GetOrderType(); }
+
+ private:
+    std::shared_ptr<ProjectedSegment> segment_;
+    Row value_;
+};
+
+// PartitionProjectWrapper keeping the projected segments, the segments of the same key
+// share the projected rows
+class PartitionProjectCacheWrapper : public PartitionProjectWrapper {
+ public:
+    PartitionProjectCacheWrapper(std::shared_ptr<PartitionHandler> partition_handler, const Row& parameter,
+                                 const ProjectFun* fun)
+        : PartitionProjectWrapper(partition_handler, parameter, fun), mu_(), segments_() {}
+    ~PartitionProjectCacheWrapper() {}
+
+    std::shared_ptr<TableHandler> GetSegment(const std::string& key) override;
+
+ private:
+    std::mutex mu_;
+    std::unordered_map<std::string, std::shared_ptr<ProjectedSegment>> segments_;
+};
+
 class TableFilterWrapper : public TableHandler {
  public:
     TableFilterWrapper(std::shared_ptr<TableHandler> table_handler, const Row& parameter, const PredicateFun* fun)
@@ -15,6 +15,8 @@
  */
 
 #include "vm/engine.h"
+#include <chrono>  // NOLINT
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,7 +29,9 @@
 #include "codegen/buf_ir_builder.h"
 #include "gflags/gflags.h"
 #include "llvm-c/Target.h"
+#include "plan/plan_api.h"
 #include "udf/default_udf_library.h"
+#include "vm/core_api.h"
 #include "vm/local_tablet_handler.h"
 #include "vm/mem_catalog.h"
 #include "vm/sql_compiler.h"
@@ -48,13 +52,37 @@ EngineOptions::EngineOptions()
       enable_expr_optimize_(true),
       enable_batch_window_parallelization_(false),
       enable_window_column_pruning_(false),
+      enable_index_statistics_(false),
+      enable_literal_parameterize_(false),
+      enable_tiered_compile_(false),
+      tiered_compile_threshold_(10),
       max_sql_cache_size_(50) {
 }
 
-Engine::Engine(const std::shared_ptr<Catalog>& catalog) : cl_(catalog), options_(), mu_(), lru_cache_() {}
+Engine::Engine(const std::shared_ptr<Catalog>& catalog)
+    : cl_(catalog),
+      options_(),
+      mu_(),
+      lru_cache_(),
+      cache_stats_(),
+      table_versions_(),
+      version_seq_(0),
+      optimizing_(false) {}
 Engine::Engine(const std::shared_ptr<Catalog>& catalog, const EngineOptions& options)
-    : cl_(catalog), options_(options), mu_(), lru_cache_() {}
-Engine::~Engine() {}
+    : cl_(catalog),
+      options_(options),
+      mu_(),
+      lru_cache_(),
+      cache_stats_(),
+      table_versions_(),
+      version_seq_(0),
+      optimizing_(false) {}
+Engine::~Engine() {
+    std::lock_guard<std::mutex> lock(optimize_mu_);
+    if (optimize_thread_.joinable()) {
+        optimize_thread_.join();
+    }
+}
 void Engine::InitializeGlobalLLVM() {
     if (LLVM_IS_INITIALIZED) return;
     LLVMInitializeNativeTarget();
@@ -200,9 +228,128 @@ bool Engine::IsCompatibleCache(RunSession& session,  // NOLINT
     return true;
 }
 
+// Replace the literals in WHERE clauses with parameters, the literals are bound to the
+// session as the parameter row
+bool Engine::ParameterizeLiterals(const std::string& sql, BatchRunSession* session, std::string* normalized_sql) {
+    if (session == nullptr || !session->GetParameterSchema().empty()) {
+        return false;
+    }
+    node::NodeManager nm;
+    std::vector<const node::ConstNode*> literals;
+    if (!plan::PlanAPI::ParameterizeLiterals(sql, &nm, normalized_sql, &literals) || literals.empty()) {
+        return false;
+    }
+    codec::Schema schema;
+    uint32_t str_length = 0;
+    for (auto literal : literals) {
+        auto column = schema.Add();
+        switch (literal->GetDataType()) {
+            case node::kBool:
+                column->set_type(type::kBool);
+                break;
+            case node::kInt32:
+                column->set_type(type::kInt32);
+                break;
+            case node::kInt64:
+                column->set_type(type::kInt64);
+                break;
+            case node::kFloat:
+                column->set_type(type::kFloat);
+                break;
+            case node::kDouble:
+                column->set_type(type::kDouble);
+                break;
+            case node::kVarchar:
+                column->set_type(type::kVarchar);
+                str_length += strlen(literal->GetStr());
+                break;
+            default:
+                return false;
+        }
+    }
+    codec::RowBuilder builder(schema);
+    uint32_t size = builder.CalTotalLength(str_length);
+    Row row = CoreAPI::NewRow(size);
+    builder.SetBuffer(row.buf(), size);
+    for (auto literal : literals) {
+        switch (literal->GetDataType()) {
+            case node::kBool:
+                builder.AppendBool(literal->GetBool());
+                break;
+            case node::kInt32:
+                builder.AppendInt32(literal->GetInt());
+                break;
+            case node::kInt64:
+                builder.AppendInt64(literal->GetLong());
+                break;
+            case node::kFloat:
+                builder.AppendFloat(literal->GetFloat());
+                break;
+            case node::kDouble:
+                builder.AppendDouble(literal->GetDouble());
+                break;
+            default:
+                builder.AppendString(literal->GetStr(), strlen(literal->GetStr()));
+                break;
+        }
+    }
+    session->SetParameterSchema(schema);
+    session->literal_parameter_row_ = row;
+    return true;
+}
+
+// the parameterized sql is cached together with the parameter types
+static std::string GetCacheKey(const std::string& sql, RunSession& session) {  // NOLINT
+    if (session.engine_mode() != kBatchMode) {
+        return sql;
+    }
+    auto& parameter_schema = dynamic_cast<BatchRunSession*>(&session)->GetParameterSchema();
+    if (parameter_schema.empty()) {
+        return sql;
+    }
+    std::string key = sql;
+    key.append("\n--");
+    for (const auto& column : parameter_schema) {
+        key.append(" ").append(type::Type_Name(column.type()));
+    }
+    return key;
+}
+
 bool Engine::Get(const std::string& sql, const std::string& db, RunSession& session,
                  base::Status& status) {  // NOLINT (runtime/references)
-    std::shared_ptr<CompileInfo> cached_info = GetCacheLocked(db, sql, session.engine_mode());
+    if (options_.IsEnableLiteralParameterize() && session.engine_mode() == kBatchMode) {
+        auto batch_sess = dynamic_cast<BatchRunSession*>(&session);
+        std::string normalized_sql;
+        if (ParameterizeLiterals(sql, batch_sess, &normalized_sql)) {
+            {
+                std::lock_guard<base::SpinMutex> lock(mu_);
+                cache_stats_[kBatchMode].parameterized_cnt++;
+            }
+            if (Compile(normalized_sql, db, session, status)) {
+                return true;
+            }
+            // the literal may be not allowed to be a parameter, compile the original sql
+            DLOG(INFO) << "fail to compile parameterized sql " << normalized_sql << ": " << status.msg;
+            batch_sess->SetParameterSchema(codec::Schema());
+            batch_sess->literal_parameter_row_ = Row();
+            status = base::Status::OK();
+        }
+    }
+    return Compile(sql, db, session, status);
+}
+
+bool Engine::Compile(const std::string& sql, const std::string& db, RunSession& session,
+                     base::Status& status) {  // NOLINT (runtime/references)
+    std::string cache_key = GetCacheKey(sql, session);
+    bool optimize = false;
+    std::shared_ptr<CompileInfo> cached_info = GetCacheLocked(db, cache_key, session.engine_mode(), &optimize);
+    if (optimize) {
+        std::lock_guard<std::mutex> lock(optimize_mu_);
+        if (optimize_thread_.joinable()) {
+            optimize_thread_.join();
+        }
+        optimize_thread_ = std::thread(&Engine::OptimizeCompileInfo, this, db, cache_key, cached_info);
+    }
     if (cached_info && IsCompatibleCache(session, cached_info, status)) {
         session.SetCompileInfo(cached_info);
         return true;
@@ -214,6 +361,13 @@ bool Engine::Get(const std::string& sql, const std::string& db, RunSession& sess
     }
     DLOG(INFO) << "Compile Engine ...";
     status = base::Status::OK();
+    auto compile_start = std::chrono::steady_clock::now();
+    EngineCacheEntry entry;
+    {
+        // the tables changed during compiling invalidate the entry
+        std::lock_guard<base::SpinMutex> lock(mu_);
+        entry.version = version_seq_;
+    }
     std::shared_ptr<SqlCompileInfo> info = std::make_shared<SqlCompileInfo>();
     auto& sql_context = std::dynamic_pointer_cast<SqlCompileInfo>(info)->get_sql_context();
     sql_context.sql = sql;
@@ -223,9 +377,15 @@ bool Engine::Get(const std::string& sql, const std::string& db, RunSession& sess
     sql_context.is_batch_request_optimized = options_.IsBatchRequestOptimized();
     sql_context.enable_batch_window_parallelization = options_.IsEnableBatchWindowParallelization();
     sql_context.enable_window_column_pruning = options_.IsEnableWindowColumnPruning();
+    sql_context.enable_index_statistics = options_.IsEnableIndexStatistics();
     sql_context.enable_expr_optimize = options_.IsEnableExprOptimize();
     sql_context.jit_options = options_.jit_options();
     sql_context.options = session.GetOptions();
+    // serve the ad-hoc batch queries quickly, the deployed ones are compiled with optimization
+    entry.fast_compiled = options_.IsEnableTieredCompile() && session.engine_mode() == kBatchMode;
+    if (entry.fast_compiled) {
+        sql_context.jit_options.SetEnableOptimize(false);
+    }
     if (session.engine_mode() == kBatchMode) {
         sql_context.parameter_types = dynamic_cast<BatchRunSession*>(&session)->GetParameterSchema();
     } else if (session.engine_mode() == kBatchRequestMode) {
@@ -247,7 +407,26 @@ bool Engine::Get(const std::string& sql, const std::string& db, RunSession& sess
         }
     }
 
-    SetCacheLocked(db, sql, session.engine_mode(), info);
+    for (auto iter = sql_context.logical_plan.cbegin(); iter != sql_context.logical_plan.cend(); iter++) {
+        base::Status dep_status;
+        if (!GetDependentTables(*iter, db, &entry.tables, dep_status)) {
+            entry.tables.clear();
+            break;
+        }
+    }
+    if (entry.tables.empty()) {
+        entry.tables.insert({db, ""});
+    }
+    entry.info = info;
+    auto compile_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                              compile_start).count();
+    {
+        std::lock_guard<base::SpinMutex> lock(mu_);
+        auto& stats = cache_stats_[session.engine_mode()];
+        stats.compile_cnt++;
+        stats.compile_time_us += compile_time;
+    }
+    SetCacheLocked(db, cache_key, session.engine_mode(), entry);
     session.SetCompileInfo(info);
     if (session.is_debug_) {
         std::ostringstream plan_oss;
@@ -368,59 +547,156 @@ bool Engine::Explain(const std::string& sql, const std::string& db, EngineMode e
 
 void Engine::ClearCacheLocked(const std::string& db) {
     std::lock_guard<base::SpinMutex> lock(mu_);
+    version_seq_++;
     if (db.empty()) {
         lru_cache_.clear();
         return;
     }
+    table_versions_[{db, ""}] = version_seq_;
     for (auto& cache : lru_cache_) {
         auto& mode_cache = cache.second;
         mode_cache.erase(db);
     }
 }
 
+void Engine::ClearCacheLocked(const std::string& db, const std::string& table) {
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    version_seq_++;
+    table_versions_[{db, table}] = version_seq_;
+    table_versions_[{db, ""}] = version_seq_;
+}
+
+EngineCacheStats Engine::GetCacheStats(EngineMode engine_mode) {
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    return cache_stats_[engine_mode];
+}
+
+bool Engine::IsValidCacheEntry(const EngineCacheEntry& entry) const {
+    for (const auto& table : entry.tables) {
+        auto iter = table_versions_.find(table);
+        if (iter != table_versions_.end() && iter->second > entry.version) {
+            return false;
+        }
+    }
+    return true;
+}
+
 EngineOptions Engine::GetEngineOptions() {
     return options_;
 }
 
 std::shared_ptr<CompileInfo> Engine::GetCacheLocked(const std::string& db, const std::string& sql,
-                                                    EngineMode engine_mode) {
+                                                    EngineMode engine_mode, bool* optimize) {
     std::lock_guard<base::SpinMutex> lock(mu_);
+    auto& stats = cache_stats_[engine_mode];
     // Check mode
     auto mode_iter = lru_cache_.find(engine_mode);
     if (mode_iter == lru_cache_.end()) {
+        stats.miss_cnt++;
         return nullptr;
     }
     auto& mode_cache = mode_iter->second;
     // Check db
     auto db_iter = mode_cache.find(db);
     if (db_iter == mode_cache.end()) {
+        stats.miss_cnt++;
         return nullptr;
     }
     auto& lru = db_iter->second;
 
-    // Check SQL
+    // Check SQL and the versions of the dependent tables
     auto value = lru.get(sql);
-    if (value == boost::none) {
+    if (value == boost::none || !IsValidCacheEntry(*value.value())) {
+        stats.miss_cnt++;
         return nullptr;
     } else {
-        return value.value();
+        stats.hit_cnt++;
+        auto& entry = value.value();
+        entry->hit_cnt++;
+        if (optimize != nullptr && entry->fast_compiled && !entry->optimizing && !optimizing_ &&
+            entry->hit_cnt >= options_.GetTieredCompileThreshold()) {
+            entry->optimizing = true;
+            optimizing_ = true;
+            *optimize = true;
+        }
+        return entry->info;
+    }
+}
+
+void Engine::OptimizeCompileInfo(const std::string& db, const std::string& sql,
+                                 std::shared_ptr<CompileInfo> fast_info) {
+    auto& fast_context = std::dynamic_pointer_cast<SqlCompileInfo>(fast_info)->get_sql_context();
+    auto info = std::make_shared<SqlCompileInfo>();
+    auto& sql_context = info->get_sql_context();
+    sql_context.sql = fast_context.sql;
+    sql_context.db = fast_context.db;
+    sql_context.engine_mode = fast_context.engine_mode;
+    sql_context.is_cluster_optimized = fast_context.is_cluster_optimized;
+    sql_context.is_batch_request_optimized = fast_context.is_batch_request_optimized;
+    sql_context.enable_batch_window_parallelization = fast_context.enable_batch_window_parallelization;
+    sql_context.enable_window_column_pruning = fast_context.enable_window_column_pruning;
+    sql_context.enable_index_statistics = fast_context.enable_index_statistics;
+    sql_context.enable_expr_optimize = fast_context.enable_expr_optimize;
+    sql_context.jit_options = fast_context.jit_options;
+    sql_context.jit_options.SetEnableOptimize(true);
+    sql_context.options = fast_context.options;
+    sql_context.parameter_types = fast_context.parameter_types;
+
+    base::Status status;
+    SqlCompiler compiler(std::atomic_load_explicit(&cl_, std::memory_order_acquire), options_.IsKeepIr(), false,
+                         options_.IsPlanOnly());
+    bool ok = compiler.Compile(sql_context, status) && status.isOK();
+    if (ok && !options_.IsCompileOnly()) {
+        ok = compiler.BuildClusterJob(sql_context, status) && status.isOK();
+    }
+    if (!ok) {
+        LOG(WARNING) << "fail to optimize sql " << sql_context.sql << ": " << status.msg;
+    }
+
+    std::lock_guard<base::SpinMutex> lock(mu_);
+    optimizing_ = false;
+    auto mode_iter = lru_cache_.find(sql_context.engine_mode);
+    if (mode_iter == lru_cache_.end()) {
+        return;
+    }
+    auto db_iter = mode_iter->second.find(db);
+    if (db_iter == mode_iter->second.end()) {
+        return;
+    }
+    auto value = db_iter->second.get(sql);
+    // the entry may be evicted or recompiled meanwhile
+    if (value == boost::none || value.value()->info != fast_info) {
+        return;
+    }
+    auto& entry = value.value();
+    entry->optimizing = false;
+    // the entry is not optimized again if it fails, the fast compiled info is kept
+    entry->fast_compiled = false;
+    if (ok) {
+        // sessions running the fast compiled info keep it alive
+        entry->info = info;
+        cache_stats_[sql_context.engine_mode].optimized_cnt++;
     }
 }
 
 bool Engine::SetCacheLocked(const std::string& db, const std::string& sql, EngineMode engine_mode,
-                            std::shared_ptr<CompileInfo> info) {
+                            const EngineCacheEntry& entry) {
     std::lock_guard<base::SpinMutex> lock(mu_);
 
     auto& mode_cache = lru_cache_[engine_mode];
-    using BoostLRU = boost::compute::detail::lru_cache<std::string, std::shared_ptr<CompileInfo>>;
+    using BoostLRU = boost::compute::detail::lru_cache<std::string, std::shared_ptr<EngineCacheEntry>>;
     std::map<std::string, BoostLRU>::iterator db_iter = mode_cache.find(db);
     if (db_iter == mode_cache.end()) {
         db_iter = mode_cache.insert(db_iter, {db, BoostLRU(options_.GetMaxSqlCacheSize())});
     }
     auto& lru = db_iter->second;
     auto value = lru.get(sql);
-    if (value == boost::none || engine_mode == kBatchRequestMode) {
-        lru.insert(sql, info);
+    if (value == boost::none) {
+        lru.insert(sql, std::make_shared<EngineCacheEntry>(entry));
+        return true;
+    } else if (engine_mode == kBatchRequestMode || !IsValidCacheEntry(*value.value())) {
+        // lru_cache can not overwrite a key, replace the entry in place
+        *value.value() = entry;
         return true;
     } else {
         // TODO(xxx): Ensure compile result is stable
@@ -454,6 +730,7 @@ int32_t RequestRunSession::Run(const uint32_t task_id, const Row& in_row, Row* o
     DLOG(INFO) << "Request Row Run with task_id " << task_id;
     RunnerContext ctx(&std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context().cluster_job, in_row,
                       sp_name_, is_debug_);
+    ctx.SetMaxParallelism(max_parallelism_);
     auto output = task->RunWithCache(ctx);
     if (!output) {
         LOG(WARNING) << "Run request plan output is null";
@@ -497,7 +774,8 @@ int32_t BatchRunSession::Run(std::vector<Row>& rows, uint64_t limit) {
 }
 int32_t BatchRunSession::Run(const Row& parameter_row, std::vector<Row>& rows, uint64_t limit) {
     auto& sql_ctx = std::dynamic_pointer_cast<SqlCompileInfo>(compile_info_)->get_sql_context();
-    RunnerContext ctx(&sql_ctx.cluster_job, parameter_row, is_debug_);
+    RunnerContext ctx(&sql_ctx.cluster_job, parameter_row.empty() ? literal_parameter_row_ : parameter_row,
+                      is_debug_);
     auto output = sql_ctx.cluster_job.GetTask(0).GetRoot()->RunWithCache(ctx);
     if (!output) {
         DLOG(INFO) << "Run batch plan output is empty";
@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+
 #include "case/case_data_mock.h"
 #include "gtest/gtest.h"
 #include "gtest/internal/gtest-param-util.h"
+#include "plan/plan_api.h"
 #include "testing/engine_test_base.h"
 #include "udf/openmldb_udf.h"
 
@@ -157,6 +161,130 @@ TEST_F(EngineCompileTest, EngineWithParameterizedLRUCacheTest) {
 }
 
 
+TEST_F(EngineCompileTest, EngineTableChangeCacheTest) {
+    auto catalog = BuildSimpleCatalog();
+    hybridse::type::Database db;
+    db.set_name("simple_db");
+    hybridse::type::TableDef table_def;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def);
+    table_def.set_name("t1");
+    AddTable(db, table_def);
+    hybridse::type::TableDef table_def2;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def2);
+    table_def2.set_name("t2");
+    AddTable(db, table_def2);
+    catalog->AddDatabase(db);
+
+    EngineOptions options;
+    options.SetCompileOnly(true);
+    Engine engine(catalog, options);
+
+    std::string sql = "select col1, col2 from t1;";
+    base::Status get_status;
+    BatchRunSession bsession1;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession1, get_status)) << get_status;
+    // change of other tables keeps the cache
+    engine.ClearCacheLocked("simple_db", "t2");
+    BatchRunSession bsession2;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession2, get_status)) << get_status;
+    ASSERT_EQ(bsession1.GetCompileInfo().get(), bsession2.GetCompileInfo().get());
+    // change of the dependent table invalidates the cache
+    engine.ClearCacheLocked("simple_db", "t1");
+    BatchRunSession bsession3;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession3, get_status)) << get_status;
+    ASSERT_NE(bsession1.GetCompileInfo().get(), bsession3.GetCompileInfo().get());
+    BatchRunSession bsession4;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession4, get_status)) << get_status;
+    ASSERT_EQ(bsession3.GetCompileInfo().get(), bsession4.GetCompileInfo().get());
+
+    auto stats = engine.GetCacheStats(kBatchMode);
+    ASSERT_EQ(2u, stats.hit_cnt);
+    ASSERT_EQ(2u, stats.miss_cnt);
+    ASSERT_EQ(2u, stats.compile_cnt);
+}
+
+TEST_F(EngineCompileTest, EngineLiteralParameterizeTest) {
+    auto catalog = BuildSimpleCatalog();
+    hybridse::type::Database db;
+    db.set_name("simple_db");
+    hybridse::type::TableDef table_def;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def);
+    table_def.set_name("t1");
+    ::hybridse::type::IndexDef* index = table_def.add_indexes();
+    index->set_name("index0");
+    index->add_first_keys("col0");
+    index->set_second_key("col5");
+    AddTable(db, table_def);
+    catalog->AddDatabase(db);
+
+    EngineOptions options;
+    options.SetCompileOnly(true);
+    options.SetEnableLiteralParameterize(true);
+    Engine engine(catalog, options);
+
+    base::Status get_status;
+    BatchRunSession bsession1;
+    ASSERT_TRUE(engine.Get("select col1, col2 from t1 where col0 = 'a' and col5 < 100;", "simple_db", bsession1,
+                           get_status)) << get_status;
+    ASSERT_EQ(2, bsession1.GetParameterSchema().size());
+    ASSERT_EQ(hybridse::type::kVarchar, bsession1.GetParameterSchema().Get(0).type());
+    ASSERT_EQ(hybridse::type::kInt32, bsession1.GetParameterSchema().Get(1).type());
+    BatchRunSession bsession2;
+    ASSERT_TRUE(engine.Get("select col1, col2 from t1 where col0 = 'bb' and col5 < 200;", "simple_db", bsession2,
+                           get_status)) << get_status;
+    ASSERT_EQ(bsession1.GetCompileInfo().get(), bsession2.GetCompileInfo().get());
+    ASSERT_EQ(2u, engine.GetCacheStats(kBatchMode).parameterized_cnt);
+
+    // the literals out of WHERE clauses are kept
+    std::string normalized_sql;
+    std::vector<const node::ConstNode*> literals;
+    node::NodeManager nm;
+    ASSERT_TRUE(plan::PlanAPI::ParameterizeLiterals("select col1 + 1 from t1 where col1 > 10 limit 5;", &nm,
+                                                    &normalized_sql, &literals));
+    ASSERT_EQ("select col1 + 1 from t1 where col1 > ? limit 5;", normalized_sql);
+    ASSERT_EQ(1u, literals.size());
+    ASSERT_EQ(10, literals[0]->GetInt());
+    ASSERT_FALSE(plan::PlanAPI::ParameterizeLiterals("select col1 from t1 where col1 > ?;", &nm, &normalized_sql,
+                                                     &literals));
+}
+
+TEST_F(EngineCompileTest, EngineTieredCompileTest) {
+    auto catalog = BuildSimpleCatalog();
+    hybridse::type::Database db;
+    db.set_name("simple_db");
+    hybridse::type::TableDef table_def;
+    sqlcase::CaseSchemaMock::BuildTableDef(table_def);
+    table_def.set_name("t1");
+    AddTable(db, table_def);
+    catalog->AddDatabase(db);
+
+    EngineOptions options;
+    options.SetCompileOnly(true);
+    options.SetEnableTieredCompile(true);
+    options.SetTieredCompileThreshold(2);
+    Engine engine(catalog, options);
+
+    std::string sql = "select col1 + 1, col2 from t1;";
+    base::Status get_status;
+    BatchRunSession bsession1;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession1, get_status)) << get_status;
+    auto fast_info = bsession1.GetCompileInfo();
+    for (int i = 0; i < 2; i++) {
+        BatchRunSession bsession;
+        ASSERT_TRUE(engine.Get(sql, "simple_db", bsession, get_status)) << get_status;
+        ASSERT_EQ(fast_info.get(), bsession.GetCompileInfo().get());
+    }
+    // the optimized compile info replaces the fast one in background
+    for (int i = 0; i < 300 && engine.GetCacheStats(kBatchMode).optimized_cnt == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, engine.GetCacheStats(kBatchMode).optimized_cnt);
+    BatchRunSession bsession2;
+    ASSERT_TRUE(engine.Get(sql, "simple_db", bsession2, get_status)) << get_status;
+    ASSERT_NE(fast_info.get(), bsession2.GetCompileInfo().get());
+    ASSERT_EQ(1u, engine.GetCacheStats(kBatchMode).compile_cnt);
+}
+
 TEST_F(EngineCompileTest, EngineEmptyDefaultDBLRUCacheTest) {
     // Build Simple Catalog
     auto catalog = BuildSimpleCatalog();
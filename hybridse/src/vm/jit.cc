@@ -150,8 +150,19 @@ bool HybridSeJit::AddSymbol(::llvm::orc::JITDylib& jd,
 
 bool HybridSeLlvmJitWrapper::Init() {
     DLOG(INFO) << "Start to initialize hybridse jit";
+    HybridSeJitBuilder builder;
+    if (!jit_options_.IsEnableOptimize()) {
+        // fast instruction selection is used without optimization
+        auto jtmb = ::llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (!jtmb) {
+            LOG(WARNING) << "fail to detect host: " << LlvmToString(jtmb.takeError());
+            return false;
+        }
+        jtmb->setCodeGenOptLevel(::llvm::CodeGenOpt::Level::None);
+        builder.setJITTargetMachineBuilder(std::move(*jtmb));
+    }
     auto jit = ::llvm::Expected<std::unique_ptr<HybridSeJit>>(
-        HybridSeJitBuilder().create());
+        builder.create());
     {
         ::llvm::Error e = jit.takeError();
         if (e) {
@@ -170,6 +181,10 @@ bool HybridSeLlvmJitWrapper::Init() {
 }
 
 bool HybridSeLlvmJitWrapper::OptModule(::llvm::Module* module) {
+    if (!jit_options_.IsEnableOptimize()) {
+        // data layout is applied when the module is added
+        return true;
+    }
     return jit_->OptModule(module);
 }
 
@@ -209,6 +224,9 @@ bool HybridSeLlvmJitWrapper::AddExternalFunction(const std::string& name,
 bool HybridSeMcJitWrapper::Init() { return true; }
 
 bool HybridSeMcJitWrapper::OptModule(::llvm::Module* module) {
+    if (!jit_options_.IsEnableOptimize()) {
+        return true;
+    }
     DLOG(INFO) << "Module before opt:\n" << LlvmToString(*module);
     RunDefaultOptPasses(module);
     DLOG(INFO) << "Module after opt:\n" << LlvmToString(*module);
@@ -237,7 +255,8 @@ bool HybridSeMcJitWrapper::AddModule(
             engine_builder.setEngineKind(llvm::EngineKind::JIT)
                 .setErrorStr(&err_str_)
                 .setVerifyModules(true)
-                .setOptLevel(::llvm::CodeGenOpt::Level::Default)
+                .setOptLevel(jit_options_.IsEnableOptimize() ? ::llvm::CodeGenOpt::Level::Default
+                                                             : ::llvm::CodeGenOpt::Level::None)
                 .setSymbolResolver(
                     std::unique_ptr<::llvm::LegacyJITSymbolResolver>(
                         ::llvm::cast<::llvm::LegacyJITSymbolResolver>(
@@ -247,6 +247,76 @@ TEST_F(MemCataLogTest, partition_hander_wrapper_test) {
         ASSERT_EQ(7.5f, row_view.GetFloatUnsafe(1));
     }
 }
+class CountingWrapperFun : public ProjectFun {
+ public:
+    CountingWrapperFun() : ProjectFun(), cnt_(0) {}
+    ~CountingWrapperFun() {}
+    Row operator()(const Row& row, const Row& parameter) const override {
+        cnt_++;
+        return project(row);
+    }
+    mutable size_t cnt_;
+};
+
+TEST_F(MemCataLogTest, partition_project_cache_wrapper_test) {
+    std::vector<Row> rows;
+    ::hybridse::type::TableDef table;
+    BuildRows(table, rows);
+    std::shared_ptr<vm::MemPartitionHandler> partition_handler =
+        std::make_shared<vm::MemPartitionHandler>("t1", "temp", &(table.columns()));
+    uint64_t ts = 1;
+    for (auto row : rows) {
+        partition_handler->AddRow("group1", ts++, row);
+    }
+    partition_handler->Sort(false);
+
+    CountingWrapperFun fn;
+    Row parameter;
+    vm::PartitionProjectCacheWrapper wrapper(partition_handler, parameter, &fn);
+    vm::PartitionProjectWrapper expect_wrapper(partition_handler, parameter, &fn);
+
+    // only the rows before the seek position are projected
+    auto iter = wrapper.GetSegment("group1")->GetIterator();
+    iter->Seek(3);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(3u, iter->GetKey());
+    ASSERT_EQ(rows.size() - 2, fn.cnt_);
+
+    auto expect_iter = expect_wrapper.GetSegment("group1")->GetIterator();
+    expect_iter->SeekToFirst();
+    auto iter2 = wrapper.GetSegment("group1")->GetIterator();
+    iter2->SeekToFirst();
+    size_t cnt = 0;
+    while (iter2->Valid()) {
+        ASSERT_TRUE(expect_iter->Valid());
+        ASSERT_EQ(expect_iter->GetKey(), iter2->GetKey());
+        ASSERT_EQ(expect_iter->GetValue().ToString(), iter2->GetValue().ToString());
+        iter2->Next();
+        expect_iter->Next();
+        cnt++;
+    }
+    ASSERT_FALSE(expect_iter->Valid());
+    ASSERT_EQ(rows.size(), cnt);
+
+    // the other segments of the same key share the projected rows
+    fn.cnt_ = 0;
+    auto iter3 = wrapper.GetSegment("group1")->GetIterator();
+    iter3->SeekToFirst();
+    cnt = 0;
+    while (iter3->Valid()) {
+        iter3->Next();
+        cnt++;
+    }
+    ASSERT_EQ(rows.size(), cnt);
+    ASSERT_EQ(0u, fn.cnt_);
+
+    iter->Seek(0);
+    ASSERT_TRUE(!iter->Valid());
+    iter->Seek(100);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(rows.size(), iter->GetKey());
+}
+
 TEST_F(MemCataLogTest, mem_time_table_handler_test) {
     std::vector<Row> rows;
     ::hybridse::type::TableDef table;
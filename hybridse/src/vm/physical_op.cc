@@ -16,10 +16,12 @@
 
 #include "vm/physical_op.h"
 
+#include <cmath>
 #include <set>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/substitute.h"
+#include "passes/physical/cost_model.h"
 #include "passes/physical/physical_pass.h"
 
 namespace hybridse {
@@ -179,7 +181,12 @@ void PhysicalBinaryNode::Print(std::ostream& output, const std::string& tab) con
 
 void PhysicalTableProviderNode::Print(std::ostream& output, const std::string& tab) const {
     PhysicalOpNode::Print(output, tab);
-    output << "(table=" << table_handler_->GetName() << ")";
+    output << "(table=" << table_handler_->GetName();
+    auto rows = passes::CostModel::EstimateTableRows(table_handler_.get());
+    if (rows.has_value()) {
+        output << ", est_rows=" << rows.value();
+    }
+    output << ")";
 }
 
 void PhysicalRequestProviderNode::Print(std::ostream& output, const std::string& tab) const {
@@ -204,7 +211,12 @@ void PhysicalRequestProviderNodeWithCommonColumn::Print(std::ostream& output, co
 void PhysicalPartitionProviderNode::Print(std::ostream& output, const std::string& tab) const {
     PhysicalOpNode::Print(output, tab);
     output << "(type=" << DataProviderTypeName(provider_type_) << ", table=" << table_handler_->GetName()
-           << ", index=" << index_name_ << ")";
+           << ", index=" << index_name_;
+    auto rows_per_key = passes::CostModel::EstimateRowsPerKey(table_handler_.get(), index_name_);
+    if (rows_per_key.has_value()) {
+        output << ", est_rows_per_key=" << static_cast<uint64_t>(std::ceil(rows_per_key.value()));
+    }
+    output << ")";
 }
 
 Status PhysicalGroupNode::WithNewChildren(node::NodeManager* nm, const std::vector<PhysicalOpNode*>& children,
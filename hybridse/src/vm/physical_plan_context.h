@@ -124,6 +124,10 @@ class PhysicalPlanContext {
         return options_;
     }
 
+    // choose indexes by the index statistics of tables, see EngineOptions::SetEnableIndexStatistics
+    void SetEnableIndexStatistics(bool flag) { enable_index_statistics_ = flag; }
+    bool enable_index_statistics() const { return enable_index_statistics_; }
+
     node::NodeManager* node_manager() const { return nm_; }
     const udf::UdfLibrary* library() const { return library_; }
     const std::string& db() { return db_; }
@@ -159,6 +163,7 @@ class PhysicalPlanContext {
     size_t codegen_func_id_counter_ = 0;
 
     bool enable_expr_opt_ = false;
+    bool enable_index_statistics_ = false;
     const std::unordered_map<std::string, std::string>* options_ = nullptr;
 };
 }  // namespace vm
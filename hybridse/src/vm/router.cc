@@ -28,6 +28,10 @@ bool Router::IsWindowNode(const PhysicalOpNode* physical_node) {
     if (physical_node->GetOpType() == kPhysicalOpRequestUnion) {
         if (physical_node->GetProducerCnt() > 0) {
             auto node = physical_node->GetProducer(0);
+            // skip the column pruning of request
+            while (node != nullptr && node->GetOpType() == kPhysicalOpSimpleProject) {
+                node = node->GetProducer(0);
+            }
             if (node != nullptr &&
                 node->GetOpType() == kPhysicalOpDataProvider) {
                 auto provider_node =
@@ -16,6 +16,7 @@
 
 #include "vm/runner.h"
 
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "base/texttable.h"
+#include "bthread/bthread.h"
 #include "udf/udf.h"
 #include "vm/catalog_wrapper.h"
 #include "vm/core_api.h"
@@ -311,6 +313,10 @@ ClusterTask RunnerBuilder::Build(PhysicalOpNode* node, Status& status) {
                 LOG(WARNING) << status;
                 return fail;
             }
+            if (right->type_ == kRunnerSimpleProject) {
+                // windows over the same projected partition share the projected rows
+                dynamic_cast<SimpleProjectRunner*>(right)->EnableSegmentCache();
+            }
             auto op = dynamic_cast<const PhysicalRequestUnionNode*>(node);
             RequestUnionRunner* runner = nullptr;
             CreateRunner<RequestUnionRunner>(
@@ -1083,9 +1089,13 @@ std::shared_ptr<TableHandler> Runner::TableReverse(
         return std::shared_ptr<TableHandler>();
     }
     iter->SeekToFirst();
-    while (iter->Valid()) {
-        output_table->AddRow(iter->GetKey(), iter->GetValue());
-        iter->Next();
+    std::array<uint64_t, 64> keys;
+    std::array<Row, 64> rows;
+    size_t cnt = 0;
+    while ((cnt = iter->GetBatch(keys.size(), keys.data(), rows.data())) > 0) {
+        for (size_t i = 0; i < cnt; i++) {
+            output_table->AddRow(keys[i], rows[i]);
+        }
     }
     output_table->Reverse();
     return output_table;
@@ -1150,6 +1160,50 @@ std::shared_ptr<DataHandlerList> Runner::BatchRequestRun(RunnerContext& ctx) {
     }
     return outputs;
 }
+namespace {
+struct ProducerTask {
+    Runner* producer;
+    RunnerContext* ctx;
+    std::shared_ptr<DataHandler>* output;
+};
+
+void* RunProducerTask(void* arg) {
+    auto task = reinterpret_cast<ProducerTask*>(arg);
+    *task->output = task->producer->RunWithCache(*task->ctx);
+    return nullptr;
+}
+}  // namespace
+
+void Runner::RunProducersWithCache(RunnerContext& ctx, std::vector<std::shared_ptr<DataHandler>>* inputs) {
+    // the independent producers run in background bthreads while the parallelism budget of the
+    // request allows, the first producer always runs in the current bthread
+    std::vector<ProducerTask> tasks(producers_.size());
+    std::vector<bthread_t> tids;
+    for (size_t idx = producers_.size(); idx > 0; idx--) {
+        auto producer = producers_[idx - 1];
+        auto& output = (*inputs)[idx - 1];
+        if (idx > 1 && !IsTrivialRunner(producer) && ctx.AcquireWorker()) {
+            tasks[idx - 1] = {producer, &ctx, &output};
+            bthread_t tid;
+            if (bthread_start_background(&tid, nullptr, RunProducerTask, &tasks[idx - 1]) == 0) {
+                tids.push_back(tid);
+                continue;
+            }
+            ctx.ReleaseWorker();
+        }
+        output = producer->RunWithCache(ctx);
+    }
+    for (auto tid : tids) {
+        bthread_join(tid, nullptr);
+        ctx.ReleaseWorker();
+    }
+}
+
+bool Runner::IsTrivialRunner(const Runner* runner) {
+    // not worth a bthread switch
+    return runner->type_ == kRunnerData || runner->type_ == kRunnerRequest;
+}
+
 std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
     if (need_cache_) {
         auto cached = ctx.GetCache(id_);
@@ -1159,9 +1213,7 @@ std::shared_ptr<DataHandler> Runner::RunWithCache(RunnerContext& ctx) {
         }
     }
     std::vector<std::shared_ptr<DataHandler>> inputs(producers_.size());
-    for (size_t idx = producers_.size(); idx > 0; idx--) {
-        inputs[idx - 1] = producers_[idx - 1]->RunWithCache(ctx);
-    }
+    RunProducersWithCache(ctx, &inputs);
 
     auto res = Run(ctx, inputs);
     if (ctx.is_debug()) {
@@ -1349,6 +1401,10 @@ std::shared_ptr<DataHandler> SimpleProjectRunner::Run(
                 parameter, &project_gen_.fun_));
         }
         case kPartitionHandler: {
+            if (cache_segment_ && need_cache_) {
+                return std::shared_ptr<TableHandler>(new PartitionProjectCacheWrapper(
+                    std::dynamic_pointer_cast<PartitionHandler>(input), parameter, &project_gen_.fun_));
+            }
             return std::shared_ptr<TableHandler>(new PartitionProjectWrapper(
                 std::dynamic_pointer_cast<PartitionHandler>(input),
                 parameter, &project_gen_.fun_));
@@ -1626,7 +1682,7 @@ std::shared_ptr<DataHandler> LastJoinRunner::Run(RunnerContext& ctx,
                         left_table,
                         std::dynamic_pointer_cast<PartitionHandler>(right),
                         parameter,
-                        output_table)) {
+                        output_table, hash_join_)) {
                     return fail_ptr;
                 }
             } else {
@@ -1634,7 +1690,7 @@ std::shared_ptr<DataHandler> LastJoinRunner::Run(RunnerContext& ctx,
                         left_table,
                         std::dynamic_pointer_cast<TableHandler>(right),
                         parameter,
-                        output_table)) {
+                        output_table, hash_join_)) {
                     return fail_ptr;
                 }
             }
@@ -1658,7 +1714,7 @@ std::shared_ptr<DataHandler> LastJoinRunner::Run(RunnerContext& ctx,
                         left_partition,
                         std::dynamic_pointer_cast<PartitionHandler>(right),
                         parameter,
-                        output_partition)) {
+                        output_partition, hash_join_)) {
                     return fail_ptr;
                 }
 
@@ -1986,13 +2042,23 @@ Row JoinGenerator::RowLastJoinTable(const Row& left_row,
 bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
                               std::shared_ptr<TableHandler> right,
                               const Row& parameter,
-                              std::shared_ptr<MemTimeTableHandler> output) {
+                              std::shared_ptr<MemTimeTableHandler> output,
+                              bool hash_join) {
     auto left_iter = left->GetIterator();
     if (!left_iter) {
         LOG(WARNING) << "Table Join with empty left table";
         return false;
     }
     left_iter->SeekToFirst();
+    if (hash_join) {
+        // no join keys, every left row looks up the whole right table
+        HashSegment segment = BuildHashSegment(right);
+        while (left_iter->Valid()) {
+            output->AddRow(left_iter->GetKey(), RowLastJoinHashSegment(left_iter->GetValue(), segment, parameter));
+            left_iter->Next();
+        }
+        return true;
+    }
     while (left_iter->Valid()) {
         const Row& left_row = left_iter->GetValue();
         output->AddRow(
@@ -2007,7 +2073,8 @@ bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
 bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
                               std::shared_ptr<PartitionHandler> right,
                               const Row& parameter,
-                              std::shared_ptr<MemTimeTableHandler> output) {
+                              std::shared_ptr<MemTimeTableHandler> output,
+                              bool hash_join) {
     if (!left_key_gen_.Valid() && !index_key_gen_.Valid()) {
         LOG(WARNING) << "can't join right partition table when neither left_key_gen_ or index_key_gen_ is valid";
         return false;
@@ -2019,6 +2086,7 @@ bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
         return false;
     }
 
+    HashTable hash_table;
     left_iter->SeekToFirst();
     while (left_iter->Valid()) {
         const Row& left_row = left_iter->GetValue();
@@ -2030,6 +2098,12 @@ bool JoinGenerator::TableJoin(std::shared_ptr<TableHandler> left,
                           : key_str + "|" + left_key_gen_.Gen(left_row, parameter);
         }
         DLOG(INFO) << "key_str " << key_str;
+        if (hash_join) {
+            output->AddRow(left_iter->GetKey(),
+                           RowLastJoinHashTable(left_row, key_str, right, parameter, &hash_table));
+            left_iter->Next();
+            continue;
+        }
         auto right_table = right->GetSegment(key_str);
         output->AddRow(left_iter->GetKey(), Runner::RowLastJoinTable(left_slices_, left_row, right_slices_, right_table,
                                                                      parameter, right_sort_gen_, condition_gen_));
@@ -2074,7 +2148,8 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
 bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
                                   std::shared_ptr<PartitionHandler> right,
                                   const Row& parameter,
-                                  std::shared_ptr<MemPartitionHandler> output) {
+                                  std::shared_ptr<MemPartitionHandler> output,
+                                  bool hash_join) {
     if (!left) {
         LOG(WARNING) << "fail to run last join: left input empty";
         return false;
@@ -2090,6 +2165,7 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
         return false;
     }
 
+    HashTable hash_table;
     left_partition_iter->SeekToFirst();
     while (left_partition_iter->Valid()) {
         auto left_iter = left_partition_iter->GetValue();
@@ -2110,9 +2186,15 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
                 key_str = key_str.empty() ? left_key_gen_.Gen(left_row, parameter) :
                                           key_str.append("|").append(left_key_gen_.Gen(left_row, parameter));
             }
-            auto right_table = right->GetSegment(key_str);
             auto left_key_str = std::string(
                 reinterpret_cast<const char*>(left_key.buf()), left_key.size());
+            if (hash_join) {
+                output->AddRow(left_key_str, left_iter->GetKey(),
+                               RowLastJoinHashTable(left_row, key_str, right, parameter, &hash_table));
+                left_iter->Next();
+                continue;
+            }
+            auto right_table = right->GetSegment(key_str);
             output->AddRow(left_key_str, left_iter->GetKey(),
                            Runner::RowLastJoinTable(
                                left_slices_, left_row, right_slices_,
@@ -2123,6 +2205,52 @@ bool JoinGenerator::PartitionJoin(std::shared_ptr<PartitionHandler> left,
     }
     return true;
 }
+JoinGenerator::HashSegment JoinGenerator::BuildHashSegment(std::shared_ptr<TableHandler> table) {
+    HashSegment segment;
+    auto rows = right_sort_gen_.Sort(table, true);
+    if (!rows) {
+        return segment;
+    }
+    auto iter = rows->GetIterator();
+    if (!iter) {
+        return segment;
+    }
+    iter->SeekToFirst();
+    if (iter->Valid()) {
+        segment.last = iter->GetValue();
+        if (condition_gen_.Valid()) {
+            segment.rows = rows;
+        }
+    }
+    return segment;
+}
+
+Row JoinGenerator::RowLastJoinHashSegment(const Row& left_row, const HashSegment& segment, const Row& parameter) {
+    if (!segment.rows) {
+        return Row(left_slices_, left_row, right_slices_, segment.last);
+    }
+    auto right_iter = segment.rows->GetIterator();
+    right_iter->SeekToFirst();
+    while (right_iter->Valid()) {
+        Row joined_row(left_slices_, left_row, right_slices_, right_iter->GetValue());
+        if (condition_gen_.Gen(joined_row, parameter)) {
+            return joined_row;
+        }
+        right_iter->Next();
+    }
+    return Row(left_slices_, left_row, right_slices_, Row());
+}
+
+Row JoinGenerator::RowLastJoinHashTable(const Row& left_row, const std::string& key,
+                                        std::shared_ptr<PartitionHandler> right, const Row& parameter,
+                                        HashTable* hash_table) {
+    auto it = hash_table->find(key);
+    if (it == hash_table->end()) {
+        it = hash_table->emplace(key, BuildHashSegment(right->GetSegment(key))).first;
+    }
+    return RowLastJoinHashSegment(left_row, it->second, parameter);
+}
+
 const Row Runner::RowLastJoinTable(size_t left_slices, const Row& left_row,
                                    size_t right_slices,
                                    std::shared_ptr<TableHandler> right_table,
@@ -4156,9 +4284,14 @@ void RunnerContext::SetBatchCache(int64_t id,
     batch_cache_[id] = data;
 }
 
-std::shared_ptr<DataHandler> RunnerContext::GetCache(int64_t id) const {
+std::shared_ptr<DataHandler> RunnerContext::GetCache(int64_t id) {
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    while (running_.find(id) != running_.end()) {
+        cv_.wait(lock);
+    }
     auto iter = cache_.find(id);
-    if (iter == cache_.end()) {
+    if (iter == cache_.end() || !iter->second) {
+        running_.insert(id);
         return std::shared_ptr<DataHandler>();
     } else {
         return iter->second;
@@ -4167,7 +4300,21 @@ std::shared_ptr<DataHandler> RunnerContext::GetCache(int64_t id) const {
 
 void RunnerContext::SetCache(int64_t id,
                              const std::shared_ptr<DataHandler> data) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
     cache_[id] = data;
+    if (running_.erase(id) > 0) {
+        cv_.notify_all();
+    }
+}
+
+bool RunnerContext::AcquireWorker() {
+    int32_t spare = spare_workers_.load(std::memory_order_relaxed);
+    while (spare > 0) {
+        if (spare_workers_.compare_exchange_weak(spare, spare - 1, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void RunnerContext::SetRequest(const hybridse::codec::Row& request) {
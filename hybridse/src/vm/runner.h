@@ -17,6 +17,7 @@
 #ifndef HYBRIDSE_SRC_VM_RUNNER_H_
 #define HYBRIDSE_SRC_VM_RUNNER_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -28,6 +29,8 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "base/fe_status.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "codec/fe_row_codec.h"
 #include "node/node_manager.h"
 #include "vm/aggregator.h"
@@ -566,6 +569,12 @@ class Runner : public node::NodeBase<Runner> {
         }
     }
 
+    // run the producers and put the outputs into inputs, the independent
+    // producers may run concurrently up to the parallelism of the request
+    void RunProducersWithCache(RunnerContext& ctx,  // NOLINT
+                               std::vector<std::shared_ptr<DataHandler>>* inputs);
+    static bool IsTrivialRunner(const Runner* runner);
+
     bool need_cache_;
     bool need_batch_cache_;
     std::vector<Runner*> producers_;
@@ -666,12 +675,16 @@ class JoinGenerator {
           left_slices_(left_slices),
           right_slices_(right_slices) {}
     virtual ~JoinGenerator() {}
+    // If `hash_join` is true, the right table, or the segment of every key, is sorted only once
+    // and reused by all the left rows with the same key
     bool TableJoin(std::shared_ptr<TableHandler> left, std::shared_ptr<TableHandler> right,
                    const Row& parameter,
-                   std::shared_ptr<MemTimeTableHandler> output);  // NOLINT
+                   std::shared_ptr<MemTimeTableHandler> output,  // NOLINT
+                   bool hash_join = false);
     bool TableJoin(std::shared_ptr<TableHandler> left, std::shared_ptr<PartitionHandler> right,
                    const Row& parameter,
-                   std::shared_ptr<MemTimeTableHandler> output);  // NOLINT
+                   std::shared_ptr<MemTimeTableHandler> output,  // NOLINT
+                   bool hash_join = false);
     bool PartitionJoin(std::shared_ptr<PartitionHandler> left,
                        std::shared_ptr<TableHandler> right,
                        const Row& parameter,
@@ -679,7 +692,8 @@ class JoinGenerator {
     bool PartitionJoin(std::shared_ptr<PartitionHandler> left,
                        std::shared_ptr<PartitionHandler> right,
                        const Row& parameter,
-                       std::shared_ptr<MemPartitionHandler>);  // NOLINT
+                       std::shared_ptr<MemPartitionHandler>,  // NOLINT
+                       bool hash_join = false);
 
     Row RowLastJoin(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
     Row RowLastJoinDropLeftSlices(const Row& left_row, std::shared_ptr<DataHandler> right, const Row& parameter);
@@ -698,6 +712,19 @@ class JoinGenerator {
                          std::shared_ptr<TableHandler> table,
                          const Row& parameter);
 
+    // right rows of one join key in last join order
+    struct HashSegment {
+        // null if there is no join condition, then `last` is the joined row
+        std::shared_ptr<TableHandler> rows;
+        Row last;
+    };
+    typedef absl::flat_hash_map<std::string, HashSegment> HashTable;
+    HashSegment BuildHashSegment(std::shared_ptr<TableHandler> table);
+    Row RowLastJoinHashSegment(const Row& left_row, const HashSegment& segment, const Row& parameter);
+    Row RowLastJoinHashTable(const Row& left_row, const std::string& key,
+                             std::shared_ptr<PartitionHandler> right,
+                             const Row& parameter, HashTable* hash_table);
+
     size_t left_slices_;
     size_t right_slices_;
 };
@@ -842,7 +869,13 @@ class SimpleProjectRunner : public Runner {
         RunnerContext& ctx,  // NOLINT
         const std::vector<std::shared_ptr<DataHandler>>& inputs)
         override;  // NOLINT
+    // keep the projected segments of a partition input during the request, it takes effect
+    // only if the output is shared by several runners
+    void EnableSegmentCache() { cache_segment_ = true; }
     ProjectGenerator project_gen_;
+
+ private:
+    bool cache_segment_ = false;
 };
 
 class SelectSliceRunner : public Runner {
@@ -1098,7 +1131,9 @@ class LastJoinRunner : public Runner {
                    const std::optional<int32_t> limit_cnt, const Join& join,
                    size_t left_slices, size_t right_slices)
         : Runner(id, kRunnerLastJoin, schema, limit_cnt),
-          join_gen_(join, left_slices, right_slices) {}
+          join_gen_(join, left_slices, right_slices),
+          hash_join_(!join.index_key().ValidKey() || join.right_key().ValidKey() ||
+                     join.right_sort().ValidSort()) {}
     ~LastJoinRunner() {}
     std::shared_ptr<DataHandler> Run(
         RunnerContext& ctx,  // NOLINT
@@ -1106,6 +1141,11 @@ class LastJoinRunner : public Runner {
         override;  // NOLINT
 
     JoinGenerator join_gen_;
+
+ private:
+    // unless the right rows come from an index lookup already in last join order,
+    // build the right side into a hash table once instead of sorting it for every left row
+    const bool hash_join_;
 };
 class RequestLastJoinRunner : public Runner {
  public:
@@ -1584,7 +1624,8 @@ class RunnerContext {
           requests_(),
           parameter_(parameter),
           is_debug_(is_debug),
-          batch_cache_() {}
+          batch_cache_(),
+          spare_workers_(0) {}
     explicit RunnerContext(hybridse::vm::ClusterJob* cluster_job,
                            const hybridse::codec::Row& request,
                            const std::string& sp_name = "",
@@ -1595,7 +1636,8 @@ class RunnerContext {
           requests_(),
           parameter_(),
           is_debug_(is_debug),
-          batch_cache_() {}
+          batch_cache_(),
+          spare_workers_(0) {}
     explicit RunnerContext(hybridse::vm::ClusterJob* cluster_job,
                            const std::vector<Row>& request_batch,
                            const std::string& sp_name = "",
@@ -1606,7 +1648,8 @@ class RunnerContext {
           requests_(request_batch),
           parameter_(),
           is_debug_(is_debug),
-          batch_cache_() {}
+          batch_cache_(),
+          spare_workers_(0) {}
 
     const size_t GetRequestSize() const { return requests_.size(); }
     const hybridse::codec::Row& GetRequest() const { return request_; }
@@ -1620,12 +1663,27 @@ class RunnerContext {
     bool is_debug() const { return is_debug_; }
 
     const std::string& sp_name() { return sp_name_; }
-    std::shared_ptr<DataHandler> GetCache(int64_t id) const;
+    // Return the cached output of runner `id`. If the runner is running in
+    // another bthread, wait until it finishes. Otherwise return null and the
+    // caller is in charge of running it and calling SetCache
+    std::shared_ptr<DataHandler> GetCache(int64_t id);
     void SetCache(int64_t id, std::shared_ptr<DataHandler> data);
-    void ClearCache() { cache_.clear(); }
+    void ClearCache() {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        cache_.clear();
+        running_.clear();
+    }
     std::shared_ptr<DataHandlerList> GetBatchCache(int64_t id) const;
     void SetBatchCache(int64_t id, std::shared_ptr<DataHandlerList> data);
 
+    // Set the max count of bthreads running the producers of one request concurrently
+    void SetMaxParallelism(uint32_t max_parallelism) {
+        spare_workers_.store(max_parallelism > 1 ? max_parallelism - 1 : 0, std::memory_order_relaxed);
+    }
+    // Take one extra worker from the parallelism budget, return false if it is used up
+    bool AcquireWorker();
+    void ReleaseWorker() { spare_workers_.fetch_add(1, std::memory_order_relaxed); }
+
  private:
     hybridse::vm::ClusterJob* cluster_job_;
     const std::string sp_name_;
@@ -1637,6 +1695,11 @@ class RunnerContext {
     // TODO(chenjing): optimize
     std::map<int64_t, std::shared_ptr<DataHandler>> cache_;
     std::map<int64_t, std::shared_ptr<DataHandlerList>> batch_cache_;
+    // guard cache_ and running_, the producers may run in several bthreads
+    bthread::Mutex mu_;
+    bthread::ConditionVariable cv_;
+    std::set<int64_t> running_;
+    std::atomic<int32_t> spare_workers_;
 };
 }  // namespace vm
 }  // namespace hybridse
@@ -17,6 +17,7 @@
 #include <memory>
 #include <utility>
 #include "boost/algorithm/string.hpp"
+#include "bthread/bthread.h"
 #include "case/sql_case.h"
 #include "gtest/gtest.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
@@ -522,6 +523,41 @@ TEST_F(RunnerTest, RunnerPrintDataMemTimeTableTest) {
         LOG(INFO) << oss.str();
     }
 }
+
+TEST_F(RunnerTest, RunnerContextParallelismTest) {
+    RunnerContext ctx(nullptr, Row(), "", false);
+    ASSERT_FALSE(ctx.AcquireWorker());
+    ctx.SetMaxParallelism(3);
+    ASSERT_TRUE(ctx.AcquireWorker());
+    ASSERT_TRUE(ctx.AcquireWorker());
+    ASSERT_FALSE(ctx.AcquireWorker());
+    ctx.ReleaseWorker();
+    ASSERT_TRUE(ctx.AcquireWorker());
+}
+
+TEST_F(RunnerTest, RunnerContextCacheTest) {
+    RunnerContext ctx(nullptr, Row(), "", false);
+    // the first getter is in charge of running the runner
+    ASSERT_TRUE(ctx.GetCache(1) == nullptr);
+    struct Arg {
+        RunnerContext* ctx;
+        std::shared_ptr<DataHandler> output;
+    } arg = {&ctx, nullptr};
+    bthread_t tid;
+    ASSERT_EQ(0, bthread_start_background(
+                     &tid, nullptr,
+                     [](void* p) -> void* {
+                         auto arg = reinterpret_cast<Arg*>(p);
+                         arg->output = arg->ctx->GetCache(1);
+                         return nullptr;
+                     },
+                     &arg));
+    auto handler = std::make_shared<MemRowHandler>(Row());
+    ctx.SetCache(1, handler);
+    bthread_join(tid, nullptr);
+    ASSERT_EQ(handler, arg.output);
+    ASSERT_EQ(handler, ctx.GetCache(1));
+}
 }  // namespace vm
 }  // namespace hybridse
 
@@ -166,6 +166,7 @@ Status SqlCompiler::BuildBatchModePhysicalPlan(SqlContext* ctx, const ::hybridse
                                          ctx->is_cluster_optimized, ctx->enable_expr_optimize,
                                          ctx->enable_batch_window_parallelization, ctx->enable_window_column_pruning,
                                          ctx->options.get());
+    transformer.GetPlanContext()->SetEnableIndexStatistics(ctx->enable_index_statistics);
     transformer.AddDefaultPasses();
     CHECK_STATUS(transformer.TransformPhysicalPlan(plan_list, output), "Fail to generate physical plan batch mode");
     ctx->schema = *(*output)->GetOutputSchema();
@@ -178,7 +179,9 @@ Status SqlCompiler::BuildRequestModePhysicalPlan(SqlContext* ctx, const ::hybrid
                                                  PhysicalOpNode** output) {
     vm::RequestModeTransformer transformer(&ctx->nm, ctx->db, cl_, &ctx->parameter_types, llvm_module, library, {},
                                            ctx->is_cluster_optimized, false, ctx->enable_expr_optimize,
-                                           enable_request_performance_sensitive, ctx->options.get());
+                                           enable_request_performance_sensitive, ctx->options.get(),
+                                           ctx->enable_window_column_pruning);
+    transformer.GetPlanContext()->SetEnableIndexStatistics(ctx->enable_index_statistics);
     if (ctx->options && ctx->options->count(LONG_WINDOWS)) {
         transformer.AddPass(passes::kPassSplitAggregationOptimized);
         transformer.AddPass(passes::kPassLongWindowOptimized);
@@ -202,7 +205,9 @@ Status SqlCompiler::BuildBatchRequestModePhysicalPlan(SqlContext* ctx, const ::h
     vm::RequestModeTransformer transformer(&ctx->nm, ctx->db, cl_, &ctx->parameter_types, llvm_module, library,
                                            ctx->batch_request_info.common_column_indices,
                                            ctx->is_cluster_optimized, ctx->is_batch_request_optimized,
-                                           ctx->enable_expr_optimize, true, ctx->options.get());
+                                           ctx->enable_expr_optimize, true, ctx->options.get(),
+                                           ctx->enable_window_column_pruning);
+    transformer.GetPlanContext()->SetEnableIndexStatistics(ctx->enable_index_statistics);
     if (ctx->options && ctx->options->count(LONG_WINDOWS)) {
         transformer.AddPass(passes::kPassSplitAggregationOptimized);
         transformer.AddPass(passes::kPassLongWindowOptimized);
@@ -45,6 +45,7 @@ struct SqlContext {
     bool enable_expr_optimize = false;
     bool enable_batch_window_parallelization = true;
     bool enable_window_column_pruning = false;
+    bool enable_index_statistics = false;
 
     // the sql content
     std::string sql;
@@ -272,6 +272,7 @@ TEST_P(SqlCompilerTest, CompileRequestModeTest) {
     catalog->AddDatabase(db2);
 
     CompilerCheck(catalog, sql_case, sql_case.ExtractParameterTypes(), kRequestMode);
+    CompilerCheck(catalog, sql_case, sql_case.ExtractParameterTypes(), kRequestMode, false, true);
     RequestSchemaCheck(catalog, sql_case, sql_case.ExtractParameterTypes(), table_def);
 }
 
@@ -52,6 +52,7 @@ using hybridse::passes::LeftJoinOptimized;
 using hybridse::passes::LimitOptimized;
 using hybridse::passes::PhysicalPlanPassType;
 using hybridse::passes::SimpleProjectOptimized;
+using hybridse::passes::RequestWindowColumnPruning;
 using hybridse::passes::WindowColumnPruning;
 using hybridse::passes::LongWindowOptimized;
 using hybridse::passes::SplitAggregationOptimized;
@@ -2098,10 +2099,13 @@ RequestModeTransformer::RequestModeTransformer(node::NodeManager* node_manager,
                                                udf::UdfLibrary* library, const std::set<size_t>& common_column_indices,
                                                const bool cluster_optimized, const bool enable_batch_request_opt,
                                                bool enable_expr_opt, bool performance_sensitive,
-                                               const std::unordered_map<std::string, std::string>* options)
+                                               const std::unordered_map<std::string, std::string>* options,
+                                               bool enable_window_column_pruning)
     : BatchModeTransformer(node_manager, db, catalog, parameter_types, module, library, cluster_optimized,
                            enable_expr_opt, true, false, options),
-      enable_batch_request_opt_(enable_batch_request_opt), performance_sensitive_(performance_sensitive) {
+      enable_batch_request_opt_(enable_batch_request_opt),
+      performance_sensitive_(performance_sensitive),
+      enable_window_column_pruning_(enable_window_column_pruning) {
     batch_request_info_.common_column_indices = common_column_indices;
 }
 
@@ -2332,6 +2336,17 @@ void RequestModeTransformer::ApplyPasses(PhysicalOpNode* node,
     }
     if (!enable_batch_request_opt_ ||
         batch_request_info_.common_column_indices.empty()) {
+        if (enable_window_column_pruning_) {
+            DLOG(INFO) << "Apply column pruning for request window";
+            RequestWindowColumnPruning pass;
+            PhysicalOpNode* pruned_op = nullptr;
+            Status status = pass.Apply(this->GetPlanContext(), optimized, &pruned_op);
+            if (status.isOK()) {
+                optimized = pruned_op;
+            } else {
+                DLOG(WARNING) << status;
+            }
+        }
         *output = optimized;
         return;
     }
@@ -263,7 +263,8 @@ class RequestModeTransformer : public BatchModeTransformer {
                            const std::set<size_t>& common_column_indices,
                            const bool cluster_optimized, const bool enable_batch_request_opt, bool enable_expr_opt,
                            bool performance_sensitive = true,
-                           const std::unordered_map<std::string, std::string>* options = nullptr);
+                           const std::unordered_map<std::string, std::string>* options = nullptr,
+                           bool enable_window_column_pruning = false);
     virtual ~RequestModeTransformer();
 
     const Schema& request_schema() const { return request_schema_; }
@@ -302,6 +303,7 @@ class RequestModeTransformer : public BatchModeTransformer {
  private:
     bool enable_batch_request_opt_;
     bool performance_sensitive_;
+    bool enable_window_column_pruning_;
     vm::Schema request_schema_;
     std::string request_name_ = "";
     std::string request_db_name_ = "";
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "apiserver/api_server_impl.h"
+#include "apiserver/procedure_request.h"
+#include "benchmark/benchmark.h"
+#include "catalog/base.h"
+#include "codec/fe_row_codec.h"
+#include "codec/fe_schema_codec.h"
+#include "codec/field_codec.h"
+
+namespace openmldb {
+namespace apiserver {
+
+static const std::vector<std::pair<std::string, ::openmldb::type::DataType>> COLUMNS = {
+    {"c1", ::openmldb::type::kString}, {"c3", ::openmldb::type::kInt},       {"c4", ::openmldb::type::kBigInt},
+    {"c5", ::openmldb::type::kFloat},  {"c6", ::openmldb::type::kDouble},    {"c7", ::openmldb::type::kTimestamp},
+    {"c8", ::openmldb::type::kDate},   {"c9", ::openmldb::type::kString},
+};
+
+static std::shared_ptr<hybridse::sdk::ProcedureInfo> NewDeploymentInfo() {
+    ::openmldb::api::ProcedureInfo info;
+    info.set_db_name("db");
+    info.set_sp_name("sp");
+    info.set_type(::openmldb::type::kReqDeployment);
+    for (const auto& kv : COLUMNS) {
+        auto col = info.add_input_schema();
+        col->set_name(kv.first);
+        col->set_data_type(kv.second);
+        *info.add_output_schema() = *col;
+    }
+    return std::make_shared<::openmldb::catalog::ProcedureInfoImpl>(info);
+}
+
+static std::string GenerateBody(int64_t rows) {
+    std::string body = R"({"input": [)";
+    for (int64_t i = 0; i < rows; i++) {
+        body += (i == 0 ? "[" : ",[");
+        body += "\"card_" + std::to_string(i) + "\", " + std::to_string(i % 100) + ", " + std::to_string(i * 13) +
+                ", 1.5, " + std::to_string(i * 1.25 + 0.5) + ", " + std::to_string(1590738989000 + i) +
+                ", \"2021-05-" + std::to_string(i % 28 + 1) + "\", \"merchant_" + std::to_string(i % 50) + "\"]";
+    }
+    body += R"(], "need_schema": false})";
+    return body;
+}
+
+// the request path before the SAX parser: parse to a DOM, then append the values of the DOM to request rows
+static void BM_BuildRowsByDom(benchmark::State& state) {  // NOLINT
+    auto input = std::make_shared<ProcedureInput>(NewDeploymentInfo(), false);
+    butil::IOBuf req_body;
+    req_body.append(GenerateBody(state.range(0)));
+    for (auto _ : state) {
+        Document document;
+        if (document.Parse(req_body.to_string().c_str()).HasParseError()) {
+            state.SkipWithError("parse failed");
+            return;
+        }
+        const auto& rows = document["input"];
+        for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
+            const auto& row_v = rows[i];
+            sdk::SQLRequestRow row(input->schema, input->record_cols);
+            uint32_t str_len = 0;
+            for (size_t c = 0; c < input->types.size(); c++) {
+                if (input->types[c] == hybridse::sdk::kTypeString) {
+                    str_len += row_v[c].GetStringLength();
+                }
+            }
+            row.Init(static_cast<int32_t>(str_len));
+            row.AppendString(row_v[0].GetString(), row_v[0].GetStringLength());
+            row.AppendInt32(row_v[1].GetInt());
+            row.AppendInt64(row_v[2].GetInt64());
+            row.AppendFloat(static_cast<float>(row_v[3].GetDouble()));
+            row.AppendDouble(row_v[4].GetDouble());
+            row.AppendTimestamp(row_v[5].GetInt64());
+            int32_t year = 0, mon = 0, day = 0;
+            ::openmldb::codec::ParseDate(row_v[6].GetString(), &year, &mon, &day);
+            row.AppendDate(year, mon, day);
+            row.AppendString(row_v[7].GetString(), row_v[7].GetStringLength());
+            row.Build();
+            benchmark::DoNotOptimize(row.GetRow().data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_BuildRowsBySax(benchmark::State& state) {  // NOLINT
+    auto input = std::make_shared<ProcedureInput>(NewDeploymentInfo(), false);
+    butil::IOBuf req_body;
+    req_body.append(GenerateBody(state.range(0)));
+    for (auto _ : state) {
+        std::string body = req_body.to_string();
+        ProcedureRequest req;
+        if (!req.Parse(&body[0])) {
+            state.SkipWithError("parse failed");
+            return;
+        }
+        for (size_t i = 0; i < req.GetRowCnt(); ++i) {
+            sdk::SQLRequestRow row(input->schema, input->record_cols);
+            if (!BuildRequestRow(*input, req.GetCommonCols().data(), req.GetRow(i), &row)) {
+                state.SkipWithError("build row failed");
+                return;
+            }
+            row.Build();
+            benchmark::DoNotOptimize(row.GetRow().data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static std::shared_ptr<sdk::SQLBatchRequestResultSet> NewResultSet(int64_t rows) {
+    ::hybridse::codec::Schema schema;
+    for (const auto& kv : COLUMNS) {
+        auto col = schema.Add();
+        col->set_name(kv.first);
+        switch (kv.second) {
+            case ::openmldb::type::kString:
+                col->set_type(::hybridse::type::kVarchar);
+                break;
+            case ::openmldb::type::kInt:
+                col->set_type(::hybridse::type::kInt32);
+                break;
+            case ::openmldb::type::kBigInt:
+                col->set_type(::hybridse::type::kInt64);
+                break;
+            case ::openmldb::type::kFloat:
+                col->set_type(::hybridse::type::kFloat);
+                break;
+            case ::openmldb::type::kDouble:
+                col->set_type(::hybridse::type::kDouble);
+                break;
+            case ::openmldb::type::kTimestamp:
+                col->set_type(::hybridse::type::kTimestamp);
+                break;
+            default:
+                col->set_type(::hybridse::type::kDate);
+                break;
+        }
+    }
+    auto response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
+    auto cntl = std::make_shared<brpc::Controller>();
+    response->set_code(0);
+    response->set_count(rows);
+    ::hybridse::codec::SchemaCodec::Encode(schema, response->mutable_schema());
+    ::hybridse::codec::RowBuilder builder(schema);
+    for (int64_t i = 0; i < rows; i++) {
+        std::string card = "card_" + std::to_string(i);
+        std::string merchant = "merchant_" + std::to_string(i % 50);
+        std::string buf(builder.CalTotalLength(card.size() + merchant.size()), '\0');
+        builder.SetBuffer(reinterpret_cast<int8_t*>(&buf[0]), buf.size());
+        builder.AppendString(card.data(), card.size());
+        builder.AppendInt32(i % 100);
+        builder.AppendInt64(i * 13);
+        builder.AppendFloat(1.5);
+        builder.AppendDouble(i * 1.25 + 0.5);
+        builder.AppendTimestamp(1590738989000 + i);
+        builder.AppendDate(2021, 5, i % 28 + 1);
+        builder.AppendString(merchant.data(), merchant.size());
+        response->add_row_sizes(buf.size());
+        cntl->response_attachment().append(buf);
+    }
+    auto rs = std::make_shared<sdk::SQLBatchRequestResultSet>(response, cntl);
+    if (!rs->Init()) {
+        return {};
+    }
+    return rs;
+}
+
+// the response path before the direct encoder: the virtual calls of ResultSet for every cell
+static void BM_WriteRowsByResultSet(benchmark::State& state) {  // NOLINT
+    auto rs = NewResultSet(state.range(0));
+    if (!rs) {
+        state.SkipWithError("init result set failed");
+        return;
+    }
+    std::shared_ptr<hybridse::sdk::ResultSet> base_rs = rs;
+    auto& schema = *rs->GetSchema();
+    for (auto _ : state) {
+        JsonWriter writer;
+        writer.StartArray();
+        base_rs->Reset();
+        while (base_rs->Next()) {
+            writer.StartArray();
+            for (int i = 0; i < schema.GetColumnCnt(); i++) {
+                WriteValue(writer, base_rs, i);
+            }
+            writer.EndArray();
+        }
+        writer.EndArray();
+        benchmark::DoNotOptimize(writer.GetString());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_WriteBatchRequestRows(benchmark::State& state) {  // NOLINT
+    auto rs = NewResultSet(state.range(0));
+    if (!rs) {
+        state.SkipWithError("init result set failed");
+        return;
+    }
+    auto& schema = *rs->GetSchema();
+    for (auto _ : state) {
+        JsonWriter writer;
+        writer.StartArray();
+        WriteBatchRequestRows(writer, rs.get(), schema, false, false);
+        writer.EndArray();
+        benchmark::DoNotOptimize(writer.GetString());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BuildRowsByDom)->Args({1})->Args({100});
+BENCHMARK(BM_BuildRowsBySax)->Args({1})->Args({100});
+BENCHMARK(BM_WriteRowsByResultSet)->Args({1})->Args({100});
+BENCHMARK(BM_WriteBatchRequestRows)->Args({1})->Args({100});
+
+}  // namespace apiserver
+}  // namespace openmldb
+
+BENCHMARK_MAIN();
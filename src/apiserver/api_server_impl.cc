@@ -16,17 +16,23 @@
 
 #include "apiserver/api_server_impl.h"
 
+#include <cstdio>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "apiserver/interface_provider.h"
 #include "brpc/server.h"
+#include "codec/fe_row_codec.h"
 
 namespace openmldb {
 namespace apiserver {
 
+static const char BINARY_CONTENT_TYPE[] = "application/octet-stream";
+
 APIServerImpl::~APIServerImpl() = default;
 
 bool APIServerImpl::Init(const sdk::ClusterOptions& options) {
@@ -66,6 +72,8 @@ void APIServerImpl::Refresh() {
     if (sql_router_) {
         sql_router_->RefreshCatalog();
     }
+    std::lock_guard<std::mutex> lock(mu_);
+    procedure_inputs_.clear();
 }
 
 void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const HttpRequest*, HttpResponse*,
@@ -79,8 +87,12 @@ void APIServerImpl::Process(google::protobuf::RpcController* cntl_base, const Ht
     DLOG(INFO) << "unresolved path: " << unresolved_path << ", method: " << HttpMethod2Str(method);
     const butil::IOBuf& req_body = cntl->request_attachment();
 
+    // only the media type is used to choose the handler, e.g. "application/octet-stream" for binary requests
+    const auto& content_type = cntl->http_request().content_type();
+    auto media_type = content_type.substr(0, content_type.find(';'));
+
     JsonWriter writer;
-    provider_.handle(unresolved_path, method, req_body, writer);
+    provider_.handle(unresolved_path, method, media_type, req_body, writer);
 
     cntl->response_attachment().append(writer.GetString());
 }
@@ -152,48 +164,6 @@ void APIServerImpl::RegisterQuery() {
     });
 }
 
-bool APIServerImpl::Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                       const butil::rapidjson::Value& common_cols_v,
-                                       std::shared_ptr<openmldb::sdk::SQLRequestRow> row) {
-    auto sch = row->GetSchema();
-
-    // scan all strings to init the total string length
-    decltype(common_cols_v.Size()) str_len_sum = 0;
-    decltype(common_cols_v.Size()) non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        // if element is null, GetStringLength() will get 0
-        if (sch->IsConstant(i)) {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += common_cols_v[common_idx].GetStringLength();
-            }
-            ++common_idx;
-        } else {
-            if (sch->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += non_common_cols_v[non_common_idx].GetStringLength();
-            }
-            ++non_common_idx;
-        }
-    }
-    row->Init(static_cast<int32_t>(str_len_sum));
-
-    non_common_idx = 0, common_idx = 0;
-    for (decltype(sch->GetColumnCnt()) i = 0; i < sch->GetColumnCnt(); ++i) {
-        if (sch->IsConstant(i)) {
-            if (!AppendJsonValue(common_cols_v[common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i), row)) {
-                return false;
-            }
-            ++common_idx;
-        } else {
-            if (!AppendJsonValue(non_common_cols_v[non_common_idx], sch->GetColumnType(i), sch->IsColumnNotNull(i),
-                                 row)) {
-                return false;
-            }
-            ++non_common_idx;
-        }
-    }
-    return true;
-}
-
 template <typename T>
 bool APIServerImpl::AppendJsonValue(const butil::rapidjson::Value& v, hybridse::sdk::DataType type, bool is_not_null,
                                     T row) {
@@ -296,48 +266,51 @@ void APIServerImpl::RegisterPut() {
         }
 
         const auto& value = document["value"];
-        // value should be an array, and multi put is not supported now
-        if (!value.IsArray() || value.Empty() || value.Size() > 1 || !value[0].IsArray()) {
-            writer << resp.Set("Invalid value in body, only support to put one row");
+        // value should be an array of rows, all the rows are put by one batch insert
+        if (!value.IsArray() || value.Empty() || !value[0].IsArray()) {
+            writer << resp.Set("Invalid value in body");
             return;
         }
-        const auto& arr = value[0];
         std::string holders;
-        for (decltype(arr.Size()) i = 0; i < arr.Size(); ++i) {
+        for (decltype(value[0].Size()) i = 0; i < value[0].Size(); ++i) {
             holders += ((i == 0) ? "?" : ",?");
         }
         hybridse::sdk::Status status;
         std::string insert_placeholder = "insert into " + table + " values(" + holders + ");";
-        auto row = sql_router_->GetInsertRow(db, insert_placeholder, &status);
-        if (!row) {
+        auto rows = sql_router_->GetInsertRows(db, insert_placeholder, &status);
+        if (!rows) {
             writer << resp.Set(status.msg);
             return;
         }
-        auto schema = row->GetSchema();
+        auto schema = rows->GetSchema();
         auto cnt = schema->GetColumnCnt();
-        if (cnt != static_cast<int>(arr.Size())) {
-            writer << resp.Set("column size != schema size");
-            return;
-        }
+        for (decltype(value.Size()) r = 0; r < value.Size(); ++r) {
+            const auto& arr = value[r];
+            if (!arr.IsArray() || cnt != static_cast<int>(arr.Size())) {
+                writer << resp.Set("column size != schema size");
+                return;
+            }
 
-        // scan all strings , calc the sum, to init SQLInsertRow's string length
-        decltype(arr.Size()) str_len_sum = 0;
-        for (int i = 0; i < cnt; ++i) {
-            // if null, GetStringLength() will get 0
-            if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
-                str_len_sum += arr[i].GetStringLength();
+            // scan all strings , calc the sum, to init SQLInsertRow's string length
+            decltype(arr.Size()) str_len_sum = 0;
+            for (int i = 0; i < cnt; ++i) {
+                // if null, GetStringLength() will get 0
+                if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
+                    str_len_sum += arr[i].GetStringLength();
+                }
             }
-        }
-        row->Init(static_cast<int>(str_len_sum));
+            auto row = rows->NewRow();
+            row->Init(static_cast<int>(str_len_sum));
 
-        for (int i = 0; i < cnt; ++i) {
-            if (!AppendJsonValue(arr[i], schema->GetColumnType(i), schema->IsColumnNotNull(i), row)) {
-                writer << resp.Set("Translate to insert row failed");
-                return;
+            for (int i = 0; i < cnt; ++i) {
+                if (!AppendJsonValue(arr[i], schema->GetColumnType(i), schema->IsColumnNotNull(i), row)) {
+                    writer << resp.Set("Translate to insert row failed");
+                    return;
+                }
             }
         }
 
-        sql_router_->ExecuteInsert(db, insert_placeholder, row, &status);
+        sql_router_->ExecuteInsert(db, insert_placeholder, rows, &status);
         writer << resp.Set(status.code, status.msg);
     });
 }
@@ -346,12 +319,20 @@ void APIServerImpl::RegisterExecDeployment() {
     provider_.post("/dbs/:db_name/deployments/:sp_name",
                    std::bind(&APIServerImpl::ExecuteProcedure, this, false, std::placeholders::_1,
                              std::placeholders::_2, std::placeholders::_3));
+    provider_.post("/dbs/:db_name/deployments/:sp_name",
+                   std::bind(&APIServerImpl::ExecuteProcedureBinary, this, false, std::placeholders::_1,
+                             std::placeholders::_2, std::placeholders::_3),
+                   BINARY_CONTENT_TYPE);
 }
 
 void APIServerImpl::RegisterExecSP() {
     provider_.post("/dbs/:db_name/procedures/:sp_name",
                    std::bind(&APIServerImpl::ExecuteProcedure, this, true, std::placeholders::_1, std::placeholders::_2,
                              std::placeholders::_3));
+    provider_.post("/dbs/:db_name/procedures/:sp_name",
+                   std::bind(&APIServerImpl::ExecuteProcedureBinary, this, true, std::placeholders::_1,
+                             std::placeholders::_2, std::placeholders::_3),
+                   BINARY_CONTENT_TYPE);
 }
 
 void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param,
@@ -366,34 +347,21 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
     auto db = db_it->second;
     auto sp = sp_it->second;
 
-    Document document;
-    if (document.Parse(req_body.to_string().c_str()).HasParseError()) {
+    // parse in situ, the strings of the request point to the body
+    std::string body = req_body.to_string();
+    ProcedureRequest req;
+    if (!req.Parse(&body[0])) {
         writer << resp.Set("Json parse failed");
         return;
     }
-
-    butil::rapidjson::Value common_cols_v;
-    if (has_common_col) {
-        auto common_cols = document.FindMember("common_cols");
-        if (common_cols != document.MemberEnd()) {
-            common_cols_v = common_cols->value;  // move
-            if (!common_cols_v.IsArray()) {
-                writer << resp.Set("common_cols is not array");
-                return;
-            }
-        } else {
-            common_cols_v.SetArray();  // If there's no common cols, no need to add this field in request
-        }
-    } else {
-        common_cols_v.SetArray();
+    if (has_common_col && req.GetCommonColsState() == ProcedureRequest::kNotArray) {
+        writer << resp.Set("common_cols is not array");
+        return;
     }
-
-    auto input = document.FindMember("input");
-    if (input == document.MemberEnd() || !input->value.IsArray() || input->value.Empty()) {
+    if (req.GetInputState() != ProcedureRequest::kArray || (req.GetRowCnt() == 0 && !req.HasInvalidRow())) {
         writer << resp.Set("Invalid input");
         return;
     }
-    const auto& rows = input->value;
 
     hybridse::sdk::Status status;
     // We need to use ShowProcedure to get input schema(should know which column is constant).
@@ -403,48 +371,94 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
         writer << resp.Set(status.msg);
         return;
     }
-
-    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
-    // Hard copy, and RequestRow needs shared schema
-    auto input_schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
-    auto common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(input_schema);
-    decltype(common_cols_v.Size()) expected_common_size = 0;
-    if (has_common_col) {
-        for (int i = 0; i < input_schema->GetColumnCnt(); ++i) {
-            if (input_schema->IsConstant(i)) {
-                common_column_indices->AddCommonColumnIdx(i);
-                ++expected_common_size;
-            }
-        }
-        if (common_cols_v.Size() != expected_common_size) {
-            writer << resp.Set("Invalid common cols size");
-            return;
-        }
+    auto input = GetProcedureInput(db, sp, has_common_col, sp_info);
+    // If there's no common cols, no need to add this field in request
+    if (has_common_col && req.GetCommonCols().size() != input->common_cnt) {
+        writer << resp.Set("Invalid common cols size");
+        return;
+    }
+    auto expected_input_size = input->types.size() - input->common_cnt;
+    if (req.HasInvalidRow()) {
+        writer << resp.Set("Invalid input data row");
+        return;
     }
-    auto expected_input_size = input_schema->GetColumnCnt() - expected_common_size;
 
     // TODO(hw): SQLRequestRowBatch should add common & non-common cols directly
-    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input_schema, common_column_indices);
-    std::set<std::string> col_set;
-    for (decltype(rows.Size()) i = 0; i < rows.Size(); ++i) {
-        if (!rows[i].IsArray() || rows[i].Size() != expected_input_size) {
+    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input->schema, input->common_column_indices);
+    for (size_t i = 0; i < req.GetRowCnt(); ++i) {
+        if (req.GetRowSize(i) != expected_input_size) {
             writer << resp.Set("Invalid input data row");
             return;
         }
-        auto row = std::make_shared<sdk::SQLRequestRow>(input_schema, col_set);
-
+        auto row = std::make_shared<sdk::SQLRequestRow>(input->schema, input->record_cols);
         // sizes have been checked
-        if (!Json2SQLRequestRow(rows[i], common_cols_v, row)) {
+        if (!BuildRequestRow(*input, req.GetCommonCols().data(), req.GetRow(i), row.get())) {
             writer << resp.Set("Translate to request row failed");
             return;
         }
         row->Build();
         row_batch->AddRow(row);
     }
+    ExecuteRowBatch(db, sp, sp_info, row_batch, req.NeedSchema(), writer);
+}
+
+void APIServerImpl::ExecuteProcedureBinary(bool has_common_col, const InterfaceProvider::Params& param,
+                                           const butil::IOBuf& req_body, JsonWriter& writer) {
+    auto resp = GeneralResp();
+    auto db_it = param.find("db_name");
+    auto sp_it = param.find("sp_name");
+    if (db_it == param.end() || sp_it == param.end()) {
+        writer << resp.Set("Invalid path");
+        return;
+    }
+    auto db = db_it->second;
+    auto sp = sp_it->second;
+    if (req_body.empty()) {
+        writer << resp.Set("Invalid input");
+        return;
+    }
+
+    hybridse::sdk::Status status;
+    auto sp_info = sql_router_->ShowProcedure(db, sp, &status);
+    if (!sp_info) {
+        writer << resp.Set(status.msg);
+        return;
+    }
+    auto input = GetProcedureInput(db, sp, has_common_col, sp_info);
+
+    // The body is the rows encoded by the input schema one by one, every row has all the columns. The common cols of a
+    // procedure are read from the first row
+    std::string body = req_body.to_string();
+    auto row_batch = std::make_shared<sdk::SQLRequestRowBatch>(input->schema, input->common_column_indices);
+    size_t pos = 0;
+    while (pos < body.size()) {
+        const char* row = body.data() + pos;
+        uint32_t size = 0;
+        if (body.size() - pos > hybridse::codec::HEADER_LENGTH) {
+            memcpy(&size, row + hybridse::codec::VERSION_LENGTH, sizeof(size));
+        }
+        if (size == 0 || size > body.size() - pos ||
+            !CheckRequestRow(*input, reinterpret_cast<const int8_t*>(row), size)) {
+            writer << resp.Set("Invalid input data row");
+            return;
+        }
+        if (!row_batch->AddRow(row, size)) {
+            writer << resp.Set("Translate to request row failed");
+            return;
+        }
+        pos += size;
+    }
+    ExecuteRowBatch(db, sp, sp_info, row_batch, false, writer);
+}
 
+void APIServerImpl::ExecuteRowBatch(const std::string& db, const std::string& sp,
+                                    const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                    const std::shared_ptr<sdk::SQLRequestRowBatch>& row_batch, bool need_schema,
+                                    JsonWriter& writer) {
+    hybridse::sdk::Status status;
     auto rs = sql_router_->CallSQLBatchRequestProcedure(db, sp, row_batch, &status);
     if (!rs) {
-        writer << resp.Set(status.msg);
+        writer << GeneralResp().Set(status.msg);
         return;
     }
 
@@ -452,13 +466,29 @@ void APIServerImpl::ExecuteProcedure(bool has_common_col, const InterfaceProvide
     // output schema in sp_info is needed for encoding data, so we need a bool in ExecSPResp to know whether to
     // print schema
     sp_resp.sp_info = sp_info;
-    if (document.HasMember("need_schema") && document["need_schema"].IsBool() && document["need_schema"].GetBool()) {
-        sp_resp.need_schema = true;
-    }
+    sp_resp.need_schema = need_schema;
     sp_resp.rs = rs;
     writer << sp_resp;
 }
 
+std::shared_ptr<ProcedureInput> APIServerImpl::GetProcedureInput(
+    const std::string& db, const std::string& sp, bool has_common_col,
+    const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info) {
+    auto key = std::make_tuple(db, sp, has_common_col);
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = procedure_inputs_.find(key);
+        // the procedure info is replaced when the procedure is recreated
+        if (it != procedure_inputs_.end() && it->second->sp_info == sp_info) {
+            return it->second;
+        }
+    }
+    auto input = std::make_shared<ProcedureInput>(sp_info, has_common_col);
+    std::lock_guard<std::mutex> lock(mu_);
+    procedure_inputs_[key] = input;
+    return input;
+}
+
 void APIServerImpl::RegisterGetSP() {
     provider_.get("/dbs/:db_name/procedures/:sp_name",
                   [this](const InterfaceProvider::Params& param, const butil::IOBuf& req_body, JsonWriter& writer) {
@@ -854,21 +884,145 @@ void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, in
             int32_t year = 0;
             int32_t month = 0;
             int32_t day = 0;
-            std::stringstream ss;
             rs->GetDate(i, &year, &month, &day);
-            ss << year << "-" << month << "-" << day;
-            ar& ss.str();
+            char buf[32];
+            int len = snprintf(buf, sizeof(buf), "%d-%d-%d", year, month, day);
+            ar.String(buf, len);
             break;
         }
         case hybridse::sdk::kTypeBool: {
             bool value = false;
             rs->GetBool(i, &value);
-            ar&(value ? "true" : "false");
+            ar& value;
             break;
         }
         default: {
             LOG(ERROR) << "Invalid Column Type";
-            ar & "NA";
+            ar.String("NA", 2);
+            break;
+        }
+    }
+}
+
+static void WriteField(JsonWriter& ar, hybridse::codec::RowView* view, uint32_t idx,  // NOLINT
+                       hybridse::sdk::DataType type) {
+    switch (type) {
+        case hybridse::sdk::kTypeInt32: {
+            int32_t value = 0;
+            view->GetInt32(idx, &value);
+            ar& value;
+            break;
+        }
+        case hybridse::sdk::kTypeInt64: {
+            int64_t value = 0;
+            view->GetInt64(idx, &value);
+            ar& value;
+            break;
+        }
+        case hybridse::sdk::kTypeInt16: {
+            int16_t value = 0;
+            view->GetInt16(idx, &value);
+            ar& static_cast<int>(value);
+            break;
+        }
+        case hybridse::sdk::kTypeFloat: {
+            float value = 0;
+            view->GetFloat(idx, &value);
+            ar& static_cast<double>(value);
+            break;
+        }
+        case hybridse::sdk::kTypeDouble: {
+            double value = 0;
+            view->GetDouble(idx, &value);
+            ar& value;
+            break;
+        }
+        case hybridse::sdk::kTypeString: {
+            const char* str = nullptr;
+            uint32_t len = 0;
+            view->GetString(idx, &str, &len);
+            ar.String(str, len);
+            break;
+        }
+        case hybridse::sdk::kTypeTimestamp: {
+            int64_t ts = 0;
+            view->GetTimestamp(idx, &ts);
+            ar& ts;
+            break;
+        }
+        case hybridse::sdk::kTypeDate: {
+            int32_t year = 0;
+            int32_t month = 0;
+            int32_t day = 0;
+            view->GetDate(idx, &year, &month, &day);
+            char buf[32];
+            int len = snprintf(buf, sizeof(buf), "%d-%d-%d", year, month, day);
+            ar.String(buf, len);
+            break;
+        }
+        case hybridse::sdk::kTypeBool: {
+            bool value = false;
+            view->GetBool(idx, &value);
+            ar& value;
+            break;
+        }
+        default: {
+            LOG(ERROR) << "Invalid Column Type";
+            ar.String("NA", 2);
+            break;
+        }
+    }
+}
+
+void WriteBatchRequestRows(JsonWriter& ar, sdk::SQLBatchRequestResultSet* rs,  // NOLINT
+                           const hybridse::sdk::Schema& schema, bool constant, bool first_only) {
+    struct Column {
+        hybridse::sdk::DataType type;
+        bool not_null;
+        bool common;
+        uint32_t idx;  // the index in the common row or the non common row
+    };
+    std::vector<Column> cols;
+    // the rows are copied to flat buffers, so the fields are read by RowView without walking through the IOBuf
+    std::string common_buf;
+    std::string buf;
+    hybridse::codec::RowView common_view(rs->GetCommonSchema());
+    hybridse::codec::RowView view(rs->GetNonCommonSchema());
+    bool first = true;
+    rs->Reset();
+    while (rs->Next()) {
+        if (first) {
+            // the column mapping is valid only if the result has rows
+            for (int i = 0; i < schema.GetColumnCnt(); i++) {
+                if (schema.IsConstant(i) == constant) {
+                    cols.push_back({schema.GetColumnType(i), schema.IsColumnNotNull(i), rs->IsCommonColumn(i),
+                                    static_cast<uint32_t>(rs->GetMappedIndex(i))});
+                }
+            }
+            rs->GetCommonRowBuf().copy_to(&common_buf);
+            if (!common_buf.empty()) {
+                common_view.Reset(reinterpret_cast<const int8_t*>(common_buf.data()), common_buf.size());
+            }
+            first = false;
+        }
+        rs->GetNonCommonRowBuf().copy_to(&buf);
+        if (!buf.empty()) {
+            view.Reset(reinterpret_cast<const int8_t*>(buf.data()), buf.size());
+        }
+        ar.StartArray();
+        for (const auto& col : cols) {
+            auto* row_view = col.common ? &common_view : &view;
+            if (row_view->IsNULL(col.idx)) {
+                if (col.not_null) {
+                    LOG(ERROR) << "Value in column " << col.idx << " is null but it can't be null";
+                }
+                ar.SetNull();
+            } else {
+                WriteField(ar, row_view, col.idx, col.type);
+            }
+        }
+        ar.EndArray();  // one row end
+        if (first_only) {
             break;
         }
     }
@@ -893,15 +1047,20 @@ JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s) {  // NOLINT
     ar.Member("data");
     ar.StartArray();
     auto& rs = s.rs;
-    rs->Reset();
-    while (rs->Next()) {
-        ar.StartArray();
-        for (decltype(schema.GetColumnCnt()) i = 0; i < schema.GetColumnCnt(); i++) {
-            if (!schema.IsConstant(i)) {
-                WriteValue(ar, rs, i);
+    auto* batch_rs = dynamic_cast<sdk::SQLBatchRequestResultSet*>(rs.get());
+    if (batch_rs != nullptr) {
+        WriteBatchRequestRows(ar, batch_rs, schema, false, false);
+    } else {
+        rs->Reset();
+        while (rs->Next()) {
+            ar.StartArray();
+            for (decltype(schema.GetColumnCnt()) i = 0; i < schema.GetColumnCnt(); i++) {
+                if (!schema.IsConstant(i)) {
+                    WriteValue(ar, rs, i);
+                }
             }
+            ar.EndArray();  // one row end
         }
-        ar.EndArray();  // one row end
     }
     ar.EndArray();
 
@@ -909,7 +1068,9 @@ JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s) {  // NOLINT
     if (s.sp_info->GetType() == hybridse::sdk::kReqProcedure) {
         ar.Member("common_cols_data");
         rs->Reset();
-        if (rs->Next()) {
+        if (batch_rs != nullptr) {
+            WriteBatchRequestRows(ar, batch_rs, schema, true, true);
+        } else if (rs->Next()) {
             ar.StartArray();
             for (decltype(schema.GetColumnCnt()) i = 0; i < schema.GetColumnCnt(); i++) {
                 if (schema.IsConstant(i)) {
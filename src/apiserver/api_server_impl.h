@@ -18,15 +18,20 @@
 #define SRC_APISERVER_API_SERVER_IMPL_H_
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "apiserver/interface_provider.h"
 #include "apiserver/json_helper.h"
+#include "apiserver/procedure_request.h"
 #include "json2pb/rapidjson.h"  // rapidjson's DOM-style API
 #include "proto/api_server.pb.h"
+#include "sdk/batch_request_result_set_sql.h"
 #include "sdk/sql_cluster_router.h"
 #include "sdk/sql_request_row.h"
 
@@ -67,10 +72,19 @@ class APIServerImpl : public APIServer {
 
     void ExecuteProcedure(bool has_common_col, const InterfaceProvider::Params& param, const butil::IOBuf& req_body,
                           JsonWriter& writer);  // NOLINT
+    // the body is the rows which have been encoded in the row format by the input schema
+    void ExecuteProcedureBinary(bool has_common_col, const InterfaceProvider::Params& param,
+                                const butil::IOBuf& req_body, JsonWriter& writer);  // NOLINT
+    void ExecuteRowBatch(const std::string& db, const std::string& sp,
+                         const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                         const std::shared_ptr<sdk::SQLRequestRowBatch>& row_batch, bool need_schema,
+                         JsonWriter& writer);  // NOLINT
+
+    // get the cached input of the procedure, it's rebuilt if the procedure info has been changed
+    std::shared_ptr<ProcedureInput> GetProcedureInput(const std::string& db, const std::string& sp,
+                                                      bool has_common_col,
+                                                      const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info);
 
-    static bool Json2SQLRequestRow(const butil::rapidjson::Value& non_common_cols_v,
-                                   const butil::rapidjson::Value& common_cols_v,
-                                   std::shared_ptr<openmldb::sdk::SQLRequestRow> row);
     template <typename T>
     static bool AppendJsonValue(const butil::rapidjson::Value& v, hybridse::sdk::DataType type, bool is_not_null,
                                 T row);
@@ -80,6 +94,9 @@ class APIServerImpl : public APIServer {
     InterfaceProvider provider_;
     // cluster_sdk_ is not owned by this class.
     ::openmldb::sdk::DBSDK* cluster_sdk_ = nullptr;
+    std::mutex mu_;
+    // key is {db, sp_name, has_common_col}
+    std::map<std::tuple<std::string, std::string, bool>, std::shared_ptr<ProcedureInput>> procedure_inputs_;
 };
 
 struct QueryReq {
@@ -106,6 +123,11 @@ void WriteSchema(JsonWriter& ar, const std::string& name, const hybridse::sdk::S
 
 void WriteValue(JsonWriter& ar, std::shared_ptr<hybridse::sdk::ResultSet> rs, int i);  // NOLINT
 
+// Write the rows of a batch request result, only the columns whose IsConstant() is `constant` in `schema` are written.
+// The row buffers are decoded by codec::RowView directly, instead of the virtual calls of ResultSet for every cell
+void WriteBatchRequestRows(JsonWriter& ar, sdk::SQLBatchRequestResultSet* rs,  // NOLINT
+                           const hybridse::sdk::Schema& schema, bool constant, bool first_only);
+
 // ExecSPResp reading is unsupported now, cuz we decode ResultSet with Schema here, it's irreversible
 JsonWriter& operator&(JsonWriter& ar, ExecSPResp& s);  // NOLINT
 
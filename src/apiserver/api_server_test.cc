@@ -145,6 +145,67 @@ TEST_F(APIServerTest, jsonFormat) {
     ASSERT_EQ(butil::rapidjson::kNullType, arr[6].GetType());
 }
 
+TEST_F(APIServerTest, parseProcedureRequest) {
+    std::string body = R"({
+        "other": {"input": [1]},
+        "common_cols": ["bb", 23, 1590738994000],
+        "input": [[123, 5.1, "str", null, false], [-1, 1e3, {"k": [1]}, 18446744073709551615, true]],
+        "need_schema": true
+    })";
+    ProcedureRequest req;
+    ASSERT_TRUE(req.Parse(&body[0]));
+    ASSERT_EQ(ProcedureRequest::kArray, req.GetCommonColsState());
+    ASSERT_EQ(ProcedureRequest::kArray, req.GetInputState());
+    ASSERT_FALSE(req.HasInvalidRow());
+    ASSERT_TRUE(req.NeedSchema());
+
+    const auto& common_cols = req.GetCommonCols();
+    ASSERT_EQ(3, common_cols.size());
+    ASSERT_EQ(JsonCell::kString, common_cols[0].kind);
+    ASSERT_EQ("bb", std::string(common_cols[0].str, common_cols[0].len));
+    ASSERT_EQ(JsonCell::kInt, common_cols[1].kind);
+    ASSERT_EQ(23, common_cols[1].i);
+    ASSERT_EQ(1590738994000, common_cols[2].i);
+
+    ASSERT_EQ(2, req.GetRowCnt());
+    ASSERT_EQ(5, req.GetRowSize(0));
+    ASSERT_EQ(5, req.GetRowSize(1));
+    auto row = req.GetRow(0);
+    ASSERT_EQ(123, row[0].i);
+    ASSERT_EQ(JsonCell::kDouble, row[1].kind);
+    ASSERT_DOUBLE_EQ(5.1, row[1].d);
+    ASSERT_EQ("str", std::string(row[2].str, row[2].len));
+    ASSERT_EQ(JsonCell::kNull, row[3].kind);
+    ASSERT_EQ(JsonCell::kBool, row[4].kind);
+    ASSERT_FALSE(row[4].b);
+    row = req.GetRow(1);
+    ASSERT_EQ(-1, row[0].i);
+    ASSERT_EQ(JsonCell::kDouble, row[1].kind);
+    // objects and the numbers out of int64 can't be appended to any column
+    ASSERT_EQ(JsonCell::kInvalid, row[2].kind);
+    ASSERT_EQ(JsonCell::kInvalid, row[3].kind);
+    ASSERT_TRUE(row[4].b);
+
+    std::string invalid_row = R"({"input": [[1], 2]})";
+    ProcedureRequest invalid_row_req;
+    ASSERT_TRUE(invalid_row_req.Parse(&invalid_row[0]));
+    ASSERT_EQ(ProcedureRequest::kMissing, invalid_row_req.GetCommonColsState());
+    ASSERT_TRUE(invalid_row_req.HasInvalidRow());
+    ASSERT_FALSE(invalid_row_req.NeedSchema());
+
+    std::string not_array = R"({"common_cols": {}, "input": 1})";
+    ProcedureRequest not_array_req;
+    ASSERT_TRUE(not_array_req.Parse(&not_array[0]));
+    ASSERT_EQ(ProcedureRequest::kNotArray, not_array_req.GetCommonColsState());
+    ASSERT_EQ(ProcedureRequest::kNotArray, not_array_req.GetInputState());
+
+    std::string bad_json = R"({"input": [[1, 2]})";
+    ProcedureRequest bad_req;
+    ASSERT_FALSE(bad_req.Parse(&bad_json[0]));
+    std::string not_object = R"([[1, 2]])";
+    ASSERT_FALSE(bad_req.Parse(&not_object[0]));
+}
+
 TEST_F(APIServerTest, query) {
     const auto env = APIServerTestEnv::Instance();
 
@@ -400,6 +461,40 @@ TEST_F(APIServerTest, validPut) {
         ASSERT_STREQ("ok", resp.msg.c_str());
     }
 
+    // put multi rows by one request
+    {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_PUT);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/tables/" + table;
+        cntl.request_attachment().append(R"({"value": [
+            ["m0", 111, 1.4, "2021-04-27", 1620471840256, true, "more str", null],
+            ["m1", 112, 1.5, "2021-04-28", 1620471840257, false, null, 2]
+        ]})");
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        GeneralResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(0, resp.code) << resp.msg;
+        insert_cnt += 2;
+    }
+    // a row of wrong size fails the whole request
+    {
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_PUT);
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/tables/" + table;
+        cntl.request_attachment().append(R"({"value": [
+            ["m2", 111, 1.4, "2021-04-27", 1620471840256, true, "more str", null],
+            ["m3", 112]
+        ]})");
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        GeneralResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(-1, resp.code);
+    }
+
     // Check data
     std::string select_all = "select * from " + table + ";";
     auto rs = env->cluster_remote->ExecuteSQL(env->db, select_all, &status);
@@ -719,6 +814,57 @@ TEST_F(APIServerTest, no_common) {
         ASSERT_EQ(0, document["data"]["common_cols_data"].Size());
     }
 
+    // call deployment with the rows encoded by the input schema
+    {
+        auto sp_info = env->cluster_remote->ShowProcedure(env->db, sp_name, &status);
+        ASSERT_TRUE(sp_info) << status.msg;
+        ProcedureInput input(sp_info, false);
+        std::string body;
+        for (int64_t c4 : {123, 234}) {
+            sdk::SQLRequestRow row(input.schema, input.record_cols);
+            ASSERT_TRUE(row.Init(2));
+            ASSERT_TRUE(row.AppendString("bb"));
+            ASSERT_TRUE(row.AppendInt32(23));
+            ASSERT_TRUE(row.AppendInt64(c4));
+            ASSERT_TRUE(row.AppendFloat(5.1));
+            ASSERT_TRUE(row.AppendDouble(6.1));
+            ASSERT_TRUE(row.AppendTimestamp(1590738994000));
+            ASSERT_TRUE(row.AppendDate(2021, 8, 1));
+            ASSERT_TRUE(row.Build());
+            ASSERT_TRUE(CheckRequestRow(input, reinterpret_cast<const int8_t*>(row.GetRow().data()),
+                                        row.GetRow().size()));
+            body += row.GetRow();
+        }
+
+        brpc::Controller cntl;
+        cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+        cntl.http_request().set_content_type("application/octet-stream");
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/deployments/" + sp_name;
+        cntl.request_attachment().append(body);
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        if (document.Parse(cntl.response_attachment().to_string().c_str()).HasParseError()) {
+            ASSERT_TRUE(false) << "response parse failed with code " << document.GetParseError()
+                               << ", raw resp: " << cntl.response_attachment().to_string();
+        }
+        ASSERT_EQ(0, document["code"].GetInt()) << document["msg"].GetString();
+        ASSERT_EQ(2, document["data"]["data"].Size());
+        ASSERT_EQ(23, document["data"]["data"][1][1].GetInt());
+
+        // a truncated row is rejected
+        cntl.Reset();
+        cntl.http_request().set_method(brpc::HTTP_METHOD_POST);
+        cntl.http_request().set_content_type("application/octet-stream");
+        cntl.http_request().uri() = "http://127.0.0.1:8010/dbs/" + env->db + "/deployments/" + sp_name;
+        cntl.request_attachment().append(body.substr(0, body.size() - 1));
+        env->http_channel.CallMethod(NULL, &cntl, NULL, NULL, NULL);
+        ASSERT_FALSE(cntl.Failed()) << cntl.ErrorText();
+        GeneralResp resp;
+        JsonReader reader(cntl.response_attachment().to_string().c_str());
+        reader >> resp;
+        ASSERT_EQ(-1, resp.code);
+    }
+
     // drop procedure and table
     std::string drop_sp_sql = "drop procedure " + sp_name + ";";
     ASSERT_TRUE(env->cluster_remote->ExecuteDDL(env->db, drop_sp_sql, &status));
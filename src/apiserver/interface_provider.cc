@@ -107,8 +107,9 @@ InterfaceProvider& InterfaceProvider::put(const std::string& path, std::function
     return *this;
 }
 
-InterfaceProvider& InterfaceProvider::post(const std::string& path, std::function<func> callback) {
-    registerRequest(brpc::HttpMethod::HTTP_METHOD_POST, path, std::move(callback));
+InterfaceProvider& InterfaceProvider::post(const std::string& path, std::function<func> callback,
+                                           const std::string& content_type) {
+    registerRequest(brpc::HttpMethod::HTTP_METHOD_POST, path, std::move(callback), content_type);
     return *this;
 }
 
@@ -147,18 +148,19 @@ std::unordered_map<std::string, std::string> InterfaceProvider::extractParameter
     return map;
 }
 
-void InterfaceProvider::registerRequest(brpc::HttpMethod type, std::string const& url, std::function<func>&& callback) {
+void InterfaceProvider::registerRequest(brpc::HttpMethod type, std::string const& url, std::function<func>&& callback,
+                                        const std::string& content_type) {
     Url parsed;
     if (!ReducedUrlParser::parse(url, &parsed)) {
         LOG(ERROR) << "Fail to parse url " << url;
         return;
     }
-    BuiltRequest req{parsed, callback};
+    BuiltRequest req{parsed, callback, content_type};
     requests_[type].push_back(req);
 }
 
-bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
-                               JsonWriter& writer) {
+bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod& method,
+                               const std::string& content_type, const butil::IOBuf& req_body, JsonWriter& writer) {
     auto err = GeneralResp();
     Url url;
 
@@ -180,9 +182,17 @@ bool InterfaceProvider::handle(const std::string& path, const brpc::HttpMethod&
         return false;
     }
 
-    // is there a registered request, that matches the url?
+    // is there a registered request, that matches the url and the content type? If not, try the default one
     auto request = std::find_if(std::begin(requestList->second), std::end(requestList->second),
-                                [&, this](BuiltRequest const& request) { return matching(url, request.url); });
+                                [&, this](BuiltRequest const& request) {
+                                    return request.content_type == content_type && matching(url, request.url);
+                                });
+    if (request == std::end(requestList->second) && !content_type.empty()) {
+        request = std::find_if(std::begin(requestList->second), std::end(requestList->second),
+                               [&, this](BuiltRequest const& request) {
+                                   return request.content_type.empty() && matching(url, request.url);
+                               });
+    }
 
     if (request == std::end(requestList->second)) {
         writer << err.Set("no match method");
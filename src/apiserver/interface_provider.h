@@ -140,24 +140,29 @@ class InterfaceProvider {
      *
      *  @param path The url to listen on. The syntax of is quite complex and documented elsewhere.
      *  @param callback The function called when a client sends a request on the url.
+     *  @param content_type The handler only accepts the requests with this content type, e.g. a binary body. The
+     *  handler with an empty content type accepts the requests whose content type has no handler.
      *
      */
-    InterfaceProvider& post(std::string const& path, std::function<func> callback);
+    InterfaceProvider& post(std::string const& path, std::function<func> callback,
+                            const std::string& content_type = "");
 
-    bool handle(const std::string& path, const brpc::HttpMethod& method, const butil::IOBuf& req_body,
-                JsonWriter& writer);  // NOLINT
+    bool handle(const std::string& path, const brpc::HttpMethod& method, const std::string& content_type,
+                const butil::IOBuf& req_body, JsonWriter& writer);  // NOLINT
 
  private:
     struct BuiltRequest {
         Url url;
         std::function<func> callback;
+        std::string content_type;
     };
 
     static bool matching(const Url& received, const Url& registered);
     static std::unordered_map<std::string, std::string> extractParameters(const Url& received, const Url& registered);
 
  private:
-    void registerRequest(brpc::HttpMethod, const std::string& path, std::function<func>&& callback);
+    void registerRequest(brpc::HttpMethod, const std::string& path, std::function<func>&& callback,
+                         const std::string& content_type = "");
 
  private:
     std::unordered_map<int, std::vector<BuiltRequest>> requests_;
@@ -354,6 +354,11 @@ JsonWriter& JsonWriter::operator&(const std::string& s) {
     return *this;
 }
 
+JsonWriter& JsonWriter::String(const char* str, size_t length) {
+    WRITER->String(str, static_cast<SizeType>(length));
+    return *this;
+}
+
 JsonWriter& JsonWriter::SetNull() {
     WRITER->Null();
     return *this;
@@ -117,6 +117,7 @@ class JsonWriter {
     JsonWriter& operator&(uint64_t i);
     JsonWriter& operator&(const double& d);
     JsonWriter& operator&(const std::string& s);
+    JsonWriter& String(const char* str, size_t length);  // write a string without copying it to std::string
     JsonWriter& SetNull();
 
     static const bool IsReader = false;
@@ -0,0 +1,337 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "apiserver/procedure_request.h"
+
+#include <cstring>
+#include <limits>
+
+#include "codec/fe_row_codec.h"
+#include "codec/field_codec.h"
+#include "json2pb/rapidjson.h"
+
+namespace openmldb {
+namespace apiserver {
+
+using butil::rapidjson::BaseReaderHandler;
+using butil::rapidjson::InsituStringStream;
+using butil::rapidjson::Reader;
+using butil::rapidjson::SizeType;
+using butil::rapidjson::UTF8;
+
+// The SAX handler of ProcedureRequest. depth_ is the level of the containers we are walking through, the containers
+// we don't care about are skipped by skip_, e.g. an object in a row or an unknown member of the request.
+class ProcedureRequestHandler : public BaseReaderHandler<UTF8<>, ProcedureRequestHandler> {
+ public:
+    explicit ProcedureRequestHandler(ProcedureRequest* req) : req_(req) {}
+
+    bool Null() { return OnCell(JsonCell::kNull); }
+    bool Bool(bool b) {
+        if (skip_ == 0 && depth_ == 1 && member_ == kNeedSchema) {
+            req_->need_schema_ = b;
+            return true;
+        }
+        auto* cell = OnCell(JsonCell::kBool);
+        if (cell != nullptr) {
+            cell->b = b;
+        }
+        return true;
+    }
+    bool Int(int i) { return Int64(i); }
+    bool Uint(unsigned u) { return Int64(u); }
+    bool Int64(int64_t i) {
+        auto* cell = OnCell(JsonCell::kInt);
+        if (cell != nullptr) {
+            cell->i = i;
+        }
+        return true;
+    }
+    bool Uint64(uint64_t u) {
+        if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+            OnCell(JsonCell::kInvalid);
+            return true;
+        }
+        return Int64(static_cast<int64_t>(u));
+    }
+    bool Double(double d) {
+        auto* cell = OnCell(JsonCell::kDouble);
+        if (cell != nullptr) {
+            cell->d = d;
+        }
+        return true;
+    }
+    bool String(const char* str, SizeType len, bool) {
+        auto* cell = OnCell(JsonCell::kString);
+        if (cell != nullptr) {
+            cell->str = str;
+            cell->len = len;
+        }
+        return true;
+    }
+
+    bool StartObject() { return StartContainer(false); }
+    bool Key(const char* str, SizeType len, bool) {
+        if (skip_ == 0 && depth_ == 1) {
+            if (len == 11 && memcmp(str, "common_cols", len) == 0) {
+                member_ = kCommonCols;
+            } else if (len == 5 && memcmp(str, "input", len) == 0) {
+                member_ = kInput;
+            } else if (len == 11 && memcmp(str, "need_schema", len) == 0) {
+                member_ = kNeedSchema;
+            } else {
+                member_ = kOther;
+            }
+        }
+        return true;
+    }
+    bool EndObject(SizeType) { return EndContainer(); }
+    bool StartArray() { return StartContainer(true); }
+    bool EndArray(SizeType) { return EndContainer(); }
+
+ private:
+    enum Member { kOther, kCommonCols, kInput, kNeedSchema };
+
+    bool StartContainer(bool is_array) {
+        if (skip_ > 0) {
+            skip_++;
+            return true;
+        }
+        if (depth_ == 0) {
+            // the request must be an object
+            depth_ = 1;
+            return !is_array;
+        }
+        if (is_array && depth_ == 1 && member_ == kCommonCols) {
+            req_->common_state_ = ProcedureRequest::kArray;
+            depth_++;
+            return true;
+        }
+        if (is_array && depth_ == 1 && member_ == kInput) {
+            req_->input_state_ = ProcedureRequest::kArray;
+            depth_++;
+            return true;
+        }
+        if (is_array && depth_ == 2 && member_ == kInput) {
+            req_->row_begins_.push_back(req_->cells_.size());
+            depth_++;
+            return true;
+        }
+        OnCell(JsonCell::kInvalid);
+        skip_ = 1;
+        return true;
+    }
+
+    bool EndContainer() {
+        if (skip_ > 0) {
+            skip_--;
+        } else {
+            depth_--;
+        }
+        return true;
+    }
+
+    // returns the cell to fill if the value is an element of common_cols or a row
+    JsonCell* OnCell(JsonCell::Kind kind) {
+        if (skip_ > 0) {
+            return nullptr;
+        }
+        if (depth_ == 1) {
+            if (member_ == kCommonCols) {
+                req_->common_state_ = ProcedureRequest::kNotArray;
+            } else if (member_ == kInput) {
+                req_->input_state_ = ProcedureRequest::kNotArray;
+            }
+            return nullptr;
+        }
+        if (depth_ == 2 && member_ == kCommonCols) {
+            req_->common_cols_.emplace_back();
+            req_->common_cols_.back().kind = kind;
+            return &req_->common_cols_.back();
+        }
+        if (depth_ == 2 && member_ == kInput) {
+            req_->invalid_row_ = true;
+            return nullptr;
+        }
+        if (depth_ == 3 && member_ == kInput) {
+            req_->cells_.emplace_back();
+            req_->cells_.back().kind = kind;
+            return &req_->cells_.back();
+        }
+        return nullptr;
+    }
+
+    ProcedureRequest* req_;
+    uint32_t depth_ = 0;
+    uint32_t skip_ = 0;
+    Member member_ = kOther;
+};
+
+bool ProcedureRequest::Parse(char* body) {
+    ProcedureRequestHandler handler(this);
+    Reader reader;
+    InsituStringStream ss(body);
+    return !reader.Parse<butil::rapidjson::kParseInsituFlag>(ss, handler).IsError();
+}
+
+ProcedureInput::ProcedureInput(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& info, bool has_common_col)
+    : sp_info(info) {
+    const auto& schema_impl = dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(sp_info->GetInputSchema());
+    schema = std::make_shared<::hybridse::sdk::SchemaImpl>(schema_impl.GetSchema());
+    common_column_indices = std::make_shared<openmldb::sdk::ColumnIndicesSet>(schema);
+    fixed_length = hybridse::codec::HEADER_LENGTH + hybridse::codec::BitMapSize(schema->GetColumnCnt());
+    for (int i = 0; i < schema->GetColumnCnt(); ++i) {
+        types.push_back(schema->GetColumnType(i));
+        switch (types.back()) {
+            case hybridse::sdk::kTypeBool:
+                fixed_length += sizeof(bool);
+                break;
+            case hybridse::sdk::kTypeInt16:
+                fixed_length += sizeof(int16_t);
+                break;
+            case hybridse::sdk::kTypeInt32:
+            case hybridse::sdk::kTypeDate:
+            case hybridse::sdk::kTypeFloat:
+                fixed_length += sizeof(int32_t);
+                break;
+            case hybridse::sdk::kTypeString:
+                str_cnt++;
+                break;
+            default:
+                fixed_length += sizeof(int64_t);
+                break;
+        }
+        not_null.push_back(schema->IsColumnNotNull(i));
+        bool common = has_common_col && schema->IsConstant(i);
+        is_common.push_back(common);
+        if (common) {
+            common_column_indices->AddCommonColumnIdx(i);
+            ++common_cnt;
+        }
+    }
+}
+
+bool CheckRequestRow(const ProcedureInput& input, const int8_t* row, uint32_t size) {
+    if (size < input.fixed_length) {
+        return false;
+    }
+    uint32_t row_size = 0;
+    memcpy(&row_size, row + hybridse::codec::VERSION_LENGTH, sizeof(row_size));
+    if (row_size != size) {
+        return false;
+    }
+    for (size_t i = 0; i < input.not_null.size(); i++) {
+        if (input.not_null[i] && (row[hybridse::codec::HEADER_LENGTH + (i >> 3)] & (1 << (i & 0x07)))) {
+            return false;
+        }
+    }
+    // the address of every string follows the fixed fields, a string ends at the address of the next one
+    uint8_t addr_length = hybridse::codec::GetAddrLength(size);
+    uint64_t str_begin = input.fixed_length + static_cast<uint64_t>(input.str_cnt) * addr_length;
+    if (str_begin > size) {
+        return false;
+    }
+    const uint8_t* addr = reinterpret_cast<const uint8_t*>(row) + input.fixed_length;
+    uint32_t last = static_cast<uint32_t>(str_begin);
+    for (uint32_t i = 0; i < input.str_cnt; i++) {
+        const uint8_t* ptr = addr + i * addr_length;
+        uint32_t offset = 0;
+        if (addr_length == 1) {
+            offset = *ptr;
+        } else if (addr_length == 2) {
+            uint16_t val = 0;
+            memcpy(&val, ptr, sizeof(val));
+            offset = val;
+        } else if (addr_length == 3) {
+            // the same as RowBuilder, the high byte is first
+            offset = (static_cast<uint32_t>(ptr[0]) << 16) | (static_cast<uint32_t>(ptr[1]) << 8) | ptr[2];
+        } else {
+            memcpy(&offset, ptr, sizeof(offset));
+        }
+        if (offset < last || offset > size) {
+            return false;
+        }
+        last = offset;
+    }
+    return true;
+}
+
+static bool AppendCell(const JsonCell& cell, hybridse::sdk::DataType type, bool is_not_null,
+                       openmldb::sdk::SQLRequestRow* row) {
+    if (cell.kind == JsonCell::kNull) {
+        if (is_not_null) {
+            return false;
+        }
+        return row->AppendNULL();
+    }
+    // the number kinds are the same as the checks of rapidjson's DOM, e.g. a float column needs a number with a
+    // decimal point or an exponent
+    switch (type) {
+        case hybridse::sdk::kTypeBool:
+            return cell.kind == JsonCell::kBool && row->AppendBool(cell.b);
+        case hybridse::sdk::kTypeInt16:
+            return cell.kind == JsonCell::kInt && cell.i >= std::numeric_limits<int16_t>::min() &&
+                   cell.i <= std::numeric_limits<int16_t>::max() && row->AppendInt16(static_cast<int16_t>(cell.i));
+        case hybridse::sdk::kTypeInt32:
+            return cell.kind == JsonCell::kInt && cell.i >= std::numeric_limits<int32_t>::min() &&
+                   cell.i <= std::numeric_limits<int32_t>::max() && row->AppendInt32(static_cast<int32_t>(cell.i));
+        case hybridse::sdk::kTypeInt64:
+            return cell.kind == JsonCell::kInt && row->AppendInt64(cell.i);
+        case hybridse::sdk::kTypeFloat:
+            return cell.kind == JsonCell::kDouble && row->AppendFloat(static_cast<float>(cell.d));
+        case hybridse::sdk::kTypeDouble:
+            return cell.kind == JsonCell::kDouble && row->AppendDouble(cell.d);
+        case hybridse::sdk::kTypeString:
+            return cell.kind == JsonCell::kString && row->AppendString(cell.str, cell.len);
+        case hybridse::sdk::kTypeDate: {
+            int32_t year = 0, mon = 0, day = 0;
+            return cell.kind == JsonCell::kString &&
+                   ::openmldb::codec::ParseDate(absl::string_view(cell.str, cell.len), &year, &mon, &day) &&
+                   row->AppendDate(year, mon, day);
+        }
+        case hybridse::sdk::kTypeTimestamp:
+            return cell.kind == JsonCell::kInt && row->AppendTimestamp(cell.i);
+        default:
+            return false;
+    }
+}
+
+bool BuildRequestRow(const ProcedureInput& input, const JsonCell* common_cols, const JsonCell* cells,
+                     openmldb::sdk::SQLRequestRow* row) {
+    size_t cnt = input.types.size();
+    // scan all strings to init the total string length, a string column with a value of other kinds will fail later
+    uint32_t str_len_sum = 0;
+    size_t common_idx = 0, non_common_idx = 0;
+    for (size_t i = 0; i < cnt; ++i) {
+        const auto& cell = input.is_common[i] ? common_cols[common_idx++] : cells[non_common_idx++];
+        if (input.types[i] == hybridse::sdk::kTypeString && cell.kind == JsonCell::kString) {
+            str_len_sum += cell.len;
+        }
+    }
+    if (!row->Init(static_cast<int32_t>(str_len_sum))) {
+        return false;
+    }
+    common_idx = 0, non_common_idx = 0;
+    for (size_t i = 0; i < cnt; ++i) {
+        const auto& cell = input.is_common[i] ? common_cols[common_idx++] : cells[non_common_idx++];
+        if (!AppendCell(cell, input.types[i], input.not_null[i], row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace apiserver
+}  // namespace openmldb
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_APISERVER_PROCEDURE_REQUEST_H_
+#define SRC_APISERVER_PROCEDURE_REQUEST_H_
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sdk/base.h"
+#include "sdk/base_impl.h"
+#include "sdk/sql_request_row.h"
+
+namespace openmldb {
+namespace apiserver {
+
+// A scalar in the request json. A string points to the request body, which is parsed in situ, so no copy is needed.
+// Objects, arrays and the numbers that can't be stored in int64 are kInvalid, they can't be appended to any column
+struct JsonCell {
+    enum Kind : uint8_t { kNull, kBool, kInt, kDouble, kString, kInvalid };
+    Kind kind = kInvalid;
+    bool b = false;
+    int64_t i = 0;
+    double d = 0;
+    const char* str = nullptr;
+    uint32_t len = 0;
+};
+
+// The body of a procedure/deployment call:
+//   {"common_cols": [v1, v2], "input": [[v3, v4], [v3, v4]], "need_schema": true}
+// It's parsed by the SAX reader of rapidjson without building a DOM, the cells of all rows are stored in one vector.
+class ProcedureRequest {
+ public:
+    enum ArrayState { kMissing, kNotArray, kArray };
+
+    // `body` must be null terminated and outlive the request, it's modified by the in situ parsing.
+    // Only the json syntax is checked here, the members are checked by the caller
+    bool Parse(char* body);
+
+    ArrayState GetCommonColsState() const { return common_state_; }
+    ArrayState GetInputState() const { return input_state_; }
+    // an element of input is not an array
+    bool HasInvalidRow() const { return invalid_row_; }
+    bool NeedSchema() const { return need_schema_; }
+
+    const std::vector<JsonCell>& GetCommonCols() const { return common_cols_; }
+    size_t GetRowCnt() const { return row_begins_.size(); }
+    const JsonCell* GetRow(size_t idx) const { return cells_.data() + row_begins_[idx]; }
+    size_t GetRowSize(size_t idx) const {
+        return (idx + 1 < row_begins_.size() ? row_begins_[idx + 1] : cells_.size()) - row_begins_[idx];
+    }
+
+ private:
+    friend class ProcedureRequestHandler;
+
+    ArrayState common_state_ = kMissing;
+    ArrayState input_state_ = kMissing;
+    bool invalid_row_ = false;
+    bool need_schema_ = false;
+    std::vector<JsonCell> common_cols_;
+    std::vector<JsonCell> cells_;
+    std::vector<size_t> row_begins_;
+};
+
+// The input schema of a procedure and the column info to build request rows. It only depends on the procedure info,
+// so the api server caches it to avoid copying the schema and building the column indices for every call
+struct ProcedureInput {
+    // `has_common_col` is false for deployments, all the columns are read from the input rows
+    ProcedureInput(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& info, bool has_common_col);
+
+    std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info;
+    // hard copy, RequestRow needs shared schema
+    std::shared_ptr<::hybridse::sdk::SchemaImpl> schema;
+    std::shared_ptr<openmldb::sdk::ColumnIndicesSet> common_column_indices;
+    std::vector<hybridse::sdk::DataType> types;
+    std::vector<bool> not_null;
+    std::vector<bool> is_common;
+    uint32_t common_cnt = 0;
+    // the length of the header, the null bitmap and the fields which are not string in a row
+    uint32_t fixed_length = 0;
+    uint32_t str_cnt = 0;
+    // always empty, SQLRequestRow needs it
+    std::set<std::string> record_cols;
+};
+
+// Build a request row from the cells of the common cols and an input row, the sizes must have been checked.
+// The string length is calculated first, so the row buffer is allocated only once
+bool BuildRequestRow(const ProcedureInput& input, const JsonCell* common_cols, const JsonCell* cells,
+                     openmldb::sdk::SQLRequestRow* row);
+
+// Check a row encoded in the row format by the input schema, e.g. a row of a binary request. The size in the header
+// must be `size`, the strings must be inside the row and the not null columns must have values
+bool CheckRequestRow(const ProcedureInput& input, const int8_t* row, uint32_t size);
+
+}  // namespace apiserver
+}  // namespace openmldb
+
+#endif  // SRC_APISERVER_PROCEDURE_REQUEST_H_
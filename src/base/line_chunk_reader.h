@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_BASE_LINE_CHUNK_READER_H_
+#define SRC_BASE_LINE_CHUNK_READER_H_
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+namespace openmldb {
+namespace base {
+
+// LineChunkReader reads a text file by large blocks and returns the whole lines of every block as a chunk,
+// the partial line at the end of a block is carried to the next chunk. The last chunk may end without '\n'
+class LineChunkReader {
+ public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    explicit LineChunkReader(size_t block_size = DEFAULT_BLOCK_SIZE)
+        : file_(nullptr), block_(block_size > 0 ? block_size : DEFAULT_BLOCK_SIZE), remain_(), error_(false) {}
+
+    ~LineChunkReader() {
+        if (file_ != nullptr) {
+            fclose(file_);
+        }
+    }
+
+    // open the file and skip `offset` bytes
+    bool Open(const std::string& path, uint64_t offset) {
+        file_ = fopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            return false;
+        }
+        return fseeko(file_, static_cast<off_t>(offset), SEEK_SET) == 0;
+    }
+
+    // return false at the end of the file or if the read failed, see HasError
+    bool Next(std::string* chunk) {
+        if (file_ == nullptr || error_) {
+            return false;
+        }
+        while (true) {
+            size_t len = fread(block_.data(), 1, block_.size(), file_);
+            if (len == 0) {
+                error_ = ferror(file_) != 0;
+                if (error_ || remain_.empty()) {
+                    return false;
+                }
+                chunk->clear();
+                chunk->swap(remain_);
+                return true;
+            }
+            const char* begin = block_.data();
+            const char* end = begin + len;
+            const char* cut = end;
+            while (cut > begin && cut[-1] != '\n') {
+                --cut;
+            }
+            if (cut == begin) {
+                // no line break in the whole block
+                remain_.append(begin, len);
+                continue;
+            }
+            chunk->clear();
+            chunk->reserve(remain_.size() + (cut - begin));
+            chunk->swap(remain_);
+            chunk->append(begin, cut);
+            remain_.assign(cut, end);
+            return true;
+        }
+    }
+
+    bool HasError() const { return error_; }
+
+    LineChunkReader(const LineChunkReader&) = delete;
+    LineChunkReader& operator=(const LineChunkReader&) = delete;
+
+ private:
+    FILE* file_;
+    std::vector<char> block_;
+    std::string remain_;
+    bool error_;
+};
+
+}  // namespace base
+}  // namespace openmldb
+#endif  // SRC_BASE_LINE_CHUNK_READER_H_
@@ -218,6 +218,8 @@ class PartitionClientManager {
 
     std::shared_ptr<TabletAccessor> GetFollower();
 
+    inline const std::vector<std::shared_ptr<TabletAccessor>>& GetFollowers() const { return followers_; }
+
  private:
     uint32_t pid_;
     std::shared_ptr<TabletAccessor> leader_;
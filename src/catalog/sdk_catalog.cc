@@ -114,6 +114,14 @@ std::shared_ptr<TabletAccessor> SDKTableHandler::GetTablet(uint32_t pid) {
     return table_client_manager_->GetTablet(pid);
 }
 
+std::vector<std::shared_ptr<TabletAccessor>> SDKTableHandler::GetFollowers(uint32_t pid) {
+    auto partition_manager = table_client_manager_->GetPartitionClientManager(pid);
+    if (!partition_manager) {
+        return {};
+    }
+    return partition_manager->GetFollowers();
+}
+
 bool SDKTableHandler::GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets) {
     if (tablets == nullptr) {
         return false;
@@ -131,6 +139,7 @@ bool SDKTableHandler::GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* ta
 }
 
 bool SDKCatalog::Init(const std::vector<::openmldb::nameserver::TableInfo>& tables, const Procedures& db_sp_map) {
+    std::vector<std::shared_ptr<SDKTableHandler>> handlers;
     for (size_t i = 0; i < tables.size(); i++) {
         const ::openmldb::nameserver::TableInfo& table_meta = tables[i];
         std::shared_ptr<SDKTableHandler> table = std::make_shared<SDKTableHandler>(table_meta, *client_manager_);
@@ -138,6 +147,14 @@ bool SDKCatalog::Init(const std::vector<::openmldb::nameserver::TableInfo>& tabl
             LOG(WARNING) << "fail to init table " << table_meta.name();
             return false;
         }
+        handlers.push_back(table);
+    }
+    Init(handlers, db_sp_map);
+    return true;
+}
+
+void SDKCatalog::Init(const std::vector<std::shared_ptr<SDKTableHandler>>& tables, const Procedures& db_sp_map) {
+    for (const auto& table : tables) {
         auto db_it = tables_.find(table->GetDatabase());
         if (db_it == tables_.end()) {
             auto result_pair = tables_.insert(
@@ -147,7 +164,6 @@ bool SDKCatalog::Init(const std::vector<::openmldb::nameserver::TableInfo>& tabl
         db_it->second.insert(std::make_pair(table->GetName(), table));
     }
     db_sp_map_ = db_sp_map;
-    return true;
 }
 
 std::shared_ptr<::hybridse::vm::TableHandler> SDKCatalog::GetTable(const std::string& db,
@@ -84,6 +84,9 @@ class SDKTableHandler : public ::hybridse::vm::TableHandler {
 
     bool GetTablet(std::vector<std::shared_ptr<TabletAccessor>>* tablets);
 
+    // the alive followers of the partition, the ones which are not connected are skipped
+    std::vector<std::shared_ptr<TabletAccessor>> GetFollowers(uint32_t pid);
+
     inline uint32_t GetTid() const { return meta_.tid(); }
 
     inline uint32_t GetPartitionNum() const { return meta_.table_partition_size(); }
@@ -120,6 +123,9 @@ class SDKCatalog : public ::hybridse::vm::Catalog {
 
     bool Init(const std::vector<::openmldb::nameserver::TableInfo>& tables, const Procedures& db_sp_map);
 
+    // the handlers must have been initialized, e.g. the handlers of the unchanged tables in the previous catalog
+    void Init(const std::vector<std::shared_ptr<SDKTableHandler>>& tables, const Procedures& db_sp_map);
+
     std::shared_ptr<::hybridse::type::Database> GetDatabase(const std::string& db) override {
         return std::shared_ptr<::hybridse::type::Database>();
     }
@@ -16,6 +16,7 @@
 
 #include "catalog/tablet_catalog.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <set>
@@ -38,6 +39,10 @@ TabletTableHandler::TabletTableHandler(const ::openmldb::api::TableMeta& meta,
       schema_(),
       table_st_(meta),
       tables_(std::make_shared<Tables>()),
+      follower_tables_(std::make_shared<Tables>()),
+      all_tables_(std::make_shared<Tables>()),
+      mu_(),
+      follower_read_handler_(),
       types_(),
       index_pos_(0),
       index_hint_vec_(),
@@ -50,6 +55,10 @@ TabletTableHandler::TabletTableHandler(const ::openmldb::nameserver::TableInfo&
       schema_(),
       table_st_(meta),
       tables_(std::make_shared<Tables>()),
+      follower_tables_(std::make_shared<Tables>()),
+      all_tables_(std::make_shared<Tables>()),
+      mu_(),
+      follower_read_handler_(),
       types_(),
       index_pos_(0),
       index_hint_vec_(),
@@ -128,6 +137,11 @@ std::unique_ptr<::hybridse::codec::RowIterator> TabletTableHandler::GetIterator(
 }
 
 std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindowIterator(const std::string& idx_name) {
+    return GetWindowIterator(idx_name, false);
+}
+
+std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindowIterator(const std::string& idx_name,
+                                                                                         bool follower_read) {
     const auto& index_hint = GetIndex();
     auto iter = index_hint.find(idx_name);
     if (iter == index_hint.end()) {
@@ -135,7 +149,7 @@ std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindow
         return std::unique_ptr<::hybridse::codec::WindowIterator>();
     }
     DLOG(INFO) << "get window it with index " << idx_name;
-    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    auto tables = std::atomic_load_explicit(follower_read ? &all_tables_ : &tables_, std::memory_order_acquire);
     if (!tables) {
         LOG(WARNING) << " tables is null";
         return {};
@@ -154,6 +168,64 @@ std::unique_ptr<::hybridse::codec::WindowIterator> TabletTableHandler::GetWindow
             iter->second.index, idx_name, tablet_clients);
 }
 
+bool TabletTableHandler::GetIndexStatistics(const std::string& index_name, ::hybridse::vm::IndexStatistics* stat) {
+    if (stat == nullptr) {
+        return false;
+    }
+    const auto& index_hint = GetIndex();
+    auto iter = index_hint.find(index_name);
+    if (iter == index_hint.end()) {
+        return false;
+    }
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (!tables || tables->empty()) {
+        return false;
+    }
+    uint64_t pk_cnt = 0;
+    uint64_t row_cnt = 0;
+    uint32_t table_cnt = 0;
+    for (const auto& kv : *tables) {
+        uint64_t cur_pk_cnt = 0;
+        uint64_t cur_row_cnt = 0;
+        if (!kv.second->GetIndexStat(iter->second.index, &cur_pk_cnt, &cur_row_cnt)) {
+            continue;
+        }
+        pk_cnt += cur_pk_cnt;
+        row_cnt += cur_row_cnt;
+        table_cnt++;
+    }
+    if (table_cnt == 0) {
+        return false;
+    }
+    // keys are distributed to partitions by hash, so the local partitions are a fair sample
+    uint32_t partition_num = std::max(partition_num_, table_cnt);
+    stat->pk_cnt = pk_cnt * partition_num / table_cnt;
+    stat->row_cnt = row_cnt * partition_num / table_cnt;
+    return true;
+}
+
+bool TabletTableHandler::GetKeyVersion(const std::string& index_name, const std::string& pk, uint64_t* version) {
+    const auto& index_hint = GetIndex();
+    auto iter = index_hint.find(index_name);
+    if (iter == index_hint.end()) {
+        return false;
+    }
+    uint32_t pid_num = table_st_.GetPartitionNum();
+    uint32_t pid = 0;
+    if (pid_num > 0) {
+        pid = (uint32_t)(::openmldb::base::hash64(pk) % pid_num);
+    }
+    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+    if (!tables) {
+        return false;
+    }
+    auto table_iter = tables->find(pid);
+    if (table_iter == tables->end()) {
+        return false;
+    }
+    return table_iter->second->GetKeyVersion(iter->second.index, pk, version);
+}
+
 // TODO(chenjing): optimize Get(int pos) base segment
 const ::hybridse::codec::Row TabletTableHandler::Get(int32_t pos) {
     auto iter = GetIterator();
@@ -163,8 +235,10 @@ const ::hybridse::codec::Row TabletTableHandler::Get(int32_t pos) {
     return iter->Valid() ? iter->GetValue() : ::hybridse::codec::Row();
 }
 
-::hybridse::codec::RowIterator* TabletTableHandler::GetRawIterator() {
-    auto tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
+::hybridse::codec::RowIterator* TabletTableHandler::GetRawIterator() { return GetRawIterator(false); }
+
+::hybridse::codec::RowIterator* TabletTableHandler::GetRawIterator(bool follower_read) {
+    auto tables = std::atomic_load_explicit(follower_read ? &all_tables_ : &tables_, std::memory_order_acquire);
     std::map<uint32_t, std::shared_ptr<openmldb::client::TabletClient>> tablet_clients;
     for (uint32_t pid = 0; pid < partition_num_; pid++) {
         if (tables->count(pid) == 0) {
@@ -205,28 +279,51 @@ std::shared_ptr<::hybridse::vm::PartitionHandler> TabletTableHandler::GetPartiti
 }
 
 void TabletTableHandler::AddTable(std::shared_ptr<::openmldb::storage::Table> table) {
-    std::shared_ptr<Tables> old_tables;
-    std::shared_ptr<Tables> new_tables;
-    do {
-        old_tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
-        new_tables = std::make_shared<Tables>(*old_tables);
-        new_tables->emplace(table->GetPid(), table);
-    } while (!atomic_compare_exchange_weak(&tables_, &old_tables, new_tables));
+    UpdateTables(table->GetPid(), table, true);
+}
+
+void TabletTableHandler::AddFollowerTable(std::shared_ptr<::openmldb::storage::Table> table) {
+    UpdateTables(table->GetPid(), table, false);
 }
 
 bool TabletTableHandler::HasLocalTable() {
-    return !std::atomic_load_explicit(&tables_, std::memory_order_acquire)->empty();
+    return !std::atomic_load_explicit(&all_tables_, std::memory_order_acquire)->empty();
 }
 
 int TabletTableHandler::DeleteTable(uint32_t pid) {
-    std::shared_ptr<Tables> old_tables;
-    std::shared_ptr<Tables> new_tables;
-    do {
-        old_tables = std::atomic_load_explicit(&tables_, std::memory_order_acquire);
-        new_tables = std::make_shared<Tables>(*old_tables);
-        new_tables->erase(pid);
-    } while (!atomic_compare_exchange_weak(&tables_, &old_tables, new_tables));
-    return new_tables->size();
+    UpdateTables(pid, nullptr, false);
+    return std::atomic_load_explicit(&all_tables_, std::memory_order_acquire)->size();
+}
+
+void TabletTableHandler::UpdateTables(uint32_t pid, std::shared_ptr<::openmldb::storage::Table> table, bool leader) {
+    std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
+    // the readers load the maps without lock, so they are copied on write
+    auto new_tables = std::make_shared<Tables>(*std::atomic_load_explicit(&tables_, std::memory_order_acquire));
+    auto new_follower_tables =
+        std::make_shared<Tables>(*std::atomic_load_explicit(&follower_tables_, std::memory_order_acquire));
+    auto new_all_tables = std::make_shared<Tables>(*std::atomic_load_explicit(&all_tables_, std::memory_order_acquire));
+    new_tables->erase(pid);
+    new_follower_tables->erase(pid);
+    new_all_tables->erase(pid);
+    if (table) {
+        (leader ? new_tables : new_follower_tables)->emplace(pid, table);
+        new_all_tables->emplace(pid, table);
+    }
+    std::atomic_store_explicit(&tables_, new_tables, std::memory_order_release);
+    std::atomic_store_explicit(&follower_tables_, new_follower_tables, std::memory_order_release);
+    std::atomic_store_explicit(&all_tables_, new_all_tables, std::memory_order_release);
+}
+
+std::shared_ptr<::hybridse::vm::TableHandler> TabletTableHandler::GetFollowerReadHandler() {
+    std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
+    // the follower read handler holds this handler, so only a weak pointer is kept here
+    auto handler = follower_read_handler_.lock();
+    if (!handler) {
+        handler = std::make_shared<FollowerReadTableHandler>(
+            std::dynamic_pointer_cast<TabletTableHandler>(shared_from_this()));
+        follower_read_handler_ = handler;
+    }
+    return handler;
 }
 
 void TabletTableHandler::Update(const ::openmldb::nameserver::TableInfo& meta, const ClientManager& client_manager) {
@@ -283,6 +380,33 @@ std::shared_ptr<::hybridse::vm::Tablet> TabletTableHandler::GetTablet(const std:
     return tablets_accessor;
 }
 
+const uint64_t FollowerReadTableHandler::GetCount() {
+    auto iter = GetIterator();
+    uint64_t cnt = 0;
+    while (iter->Valid()) {
+        iter->Next();
+        cnt++;
+    }
+    return cnt;
+}
+
+::hybridse::codec::Row FollowerReadTableHandler::At(uint64_t pos) {
+    auto iter = GetIterator();
+    while (pos-- > 0 && iter->Valid()) {
+        iter->Next();
+    }
+    return iter->Valid() ? iter->GetValue() : ::hybridse::codec::Row();
+}
+
+std::shared_ptr<::hybridse::vm::PartitionHandler> FollowerReadTableHandler::GetPartition(
+    const std::string& index_name) {
+    if (GetIndex().count(index_name) == 0) {
+        LOG(WARNING) << "fail to get partition for follower read table handler, index name " << index_name;
+        return std::shared_ptr<::hybridse::vm::PartitionHandler>();
+    }
+    return std::make_shared<TabletPartitionHandler>(shared_from_this(), index_name);
+}
+
 TabletCatalog::TabletCatalog()
     : mu_(),
       tables_(),
@@ -326,6 +450,29 @@ bool TabletCatalog::AddTable(const ::openmldb::api::TableMeta& meta,
         LOG(WARNING) << "input table is null";
         return false;
     }
+    auto handler = GetOrCreateTableHandler(meta);
+    if (!handler) {
+        return false;
+    }
+    handler->AddTable(table);
+    return true;
+}
+
+bool TabletCatalog::AddFollowerTable(const ::openmldb::api::TableMeta& meta,
+                                     std::shared_ptr<::openmldb::storage::Table> table) {
+    if (!table) {
+        LOG(WARNING) << "input table is null";
+        return false;
+    }
+    auto handler = GetOrCreateTableHandler(meta);
+    if (!handler) {
+        return false;
+    }
+    handler->AddFollowerTable(table);
+    return true;
+}
+
+std::shared_ptr<TabletTableHandler> TabletCatalog::GetOrCreateTableHandler(const ::openmldb::api::TableMeta& meta) {
     const std::string& db_name = meta.db();
     std::shared_ptr<TabletTableHandler> handler;
     std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
@@ -340,14 +487,13 @@ bool TabletCatalog::AddTable(const ::openmldb::api::TableMeta& meta,
         handler = std::make_shared<TabletTableHandler>(meta, local_tablet_);
         if (!handler->Init(client_manager_)) {
             LOG(WARNING) << "tablet handler init failed";
-            return false;
+            return nullptr;
         }
         db_it->second.emplace(table_name, handler);
     } else {
         handler = it->second;
     }
-    handler->AddTable(table);
-    return true;
+    return handler;
 }
 
 bool TabletCatalog::AddDB(const ::hybridse::type::Database& db) {
@@ -526,6 +672,15 @@ std::shared_ptr<::hybridse::sdk::ProcedureInfo> TabletCatalog::GetProcedureInfo(
     return sp_it->second;
 }
 
+std::shared_ptr<::hybridse::vm::TableHandler> FollowerReadCatalog::GetTable(const std::string& db,
+                                                                            const std::string& table_name) {
+    auto handler = std::dynamic_pointer_cast<TabletTableHandler>(catalog_->GetTable(db, table_name));
+    if (!handler) {
+        return std::shared_ptr<::hybridse::vm::TableHandler>();
+    }
+    return handler->GetFollowerReadHandler();
+}
+
 const Procedures& TabletCatalog::GetProcedures() {
     std::lock_guard<::openmldb::base::SpinMutex> spin_lock(mu_);
     return db_sp_map_;
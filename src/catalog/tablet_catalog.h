@@ -163,6 +163,18 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
 
     std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name) override;
 
+    // read the local follower replicas as well as the leaders if `follower_read`
+    ::hybridse::codec::RowIterator *GetRawIterator(bool follower_read);
+    std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name,
+                                                                         bool follower_read);
+
+    // statistics of the local partitions, extrapolated to the whole table
+    bool GetIndexStatistics(const std::string &index_name, ::hybridse::vm::IndexStatistics *stat) override;
+
+    // version of `pk` in the index `index_name`, it changes after every write of the key.
+    // return false if the partition of `pk` is not local
+    bool GetKeyVersion(const std::string &index_name, const std::string &pk, uint64_t *version);
+
     const uint64_t GetCount() override;
 
     ::hybridse::codec::Row At(uint64_t pos) override;
@@ -178,10 +190,18 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
 
     void AddTable(std::shared_ptr<::openmldb::storage::Table> table);
 
+    // the follower replicas are only read by the handler of GetFollowerReadHandler
+    void AddFollowerTable(std::shared_ptr<::openmldb::storage::Table> table);
+
+    // whether any replica of the table is local, leader or follower
     bool HasLocalTable();
 
+    // delete the local replica of `pid`, return the count of local replicas left
     int DeleteTable(uint32_t pid);
 
+    // the handler for the deployments with read_policy follower, it reads the local follower replicas too
+    std::shared_ptr<::hybridse::vm::TableHandler> GetFollowerReadHandler();
+
     void Update(const ::openmldb::nameserver::TableInfo &meta, const ClientManager &client_manager);
 
  private:
@@ -193,11 +213,20 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
         return -1;
     }
 
+    // set the local replica of `pid` with its role, erase it if `table` is null
+    void UpdateTables(uint32_t pid, std::shared_ptr<::openmldb::storage::Table> table, bool leader);
+
  private:
     uint32_t partition_num_;
     ::hybridse::vm::Schema schema_;
     ::openmldb::storage::TableSt table_st_;
+    // the local leader replicas
     std::shared_ptr<Tables> tables_;
+    std::shared_ptr<Tables> follower_tables_;
+    // the local replicas of both roles
+    std::shared_ptr<Tables> all_tables_;
+    ::openmldb::base::SpinMutex mu_;
+    std::weak_ptr<::hybridse::vm::TableHandler> follower_read_handler_;
     ::hybridse::vm::Types types_;
     std::atomic<int32_t> index_pos_;
     std::vector<::hybridse::vm::IndexHint> index_hint_vec_;
@@ -205,6 +234,61 @@ class TabletTableHandler : public ::hybridse::vm::TableHandler,
     std::shared_ptr<hybridse::vm::Tablet> local_tablet_;
 };
 
+// The table read by the deployments with read_policy follower. It reads the local replicas of both roles and the
+// leaders of the partitions without local replica
+class FollowerReadTableHandler : public ::hybridse::vm::TableHandler,
+                                 public std::enable_shared_from_this<hybridse::vm::TableHandler> {
+ public:
+    explicit FollowerReadTableHandler(std::shared_ptr<TabletTableHandler> table_handler)
+        : TableHandler(), table_handler_(table_handler) {}
+
+    ~FollowerReadTableHandler() {}
+
+    const ::hybridse::vm::Schema *GetSchema() override { return table_handler_->GetSchema(); }
+
+    const std::string &GetName() override { return table_handler_->GetName(); }
+
+    const std::string &GetDatabase() override { return table_handler_->GetDatabase(); }
+
+    const ::hybridse::vm::Types &GetTypes() override { return table_handler_->GetTypes(); }
+
+    const ::hybridse::vm::IndexHint &GetIndex() override { return table_handler_->GetIndex(); }
+
+    std::unique_ptr<::hybridse::codec::RowIterator> GetIterator() override {
+        return std::unique_ptr<::hybridse::codec::RowIterator>(GetRawIterator());
+    }
+
+    ::hybridse::codec::RowIterator *GetRawIterator() override { return table_handler_->GetRawIterator(true); }
+
+    std::unique_ptr<::hybridse::codec::WindowIterator> GetWindowIterator(const std::string &idx_name) override {
+        return table_handler_->GetWindowIterator(idx_name, true);
+    }
+
+    bool GetIndexStatistics(const std::string &index_name, ::hybridse::vm::IndexStatistics *stat) override {
+        return table_handler_->GetIndexStatistics(index_name, stat);
+    }
+
+    const uint64_t GetCount() override;
+
+    ::hybridse::codec::Row At(uint64_t pos) override;
+
+    std::shared_ptr<::hybridse::vm::PartitionHandler> GetPartition(const std::string &index_name) override;
+
+    // sub queries of distributed sql still go to the leaders
+    std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name, const std::string &pk) override {
+        return table_handler_->GetTablet(index_name, pk);
+    }
+    std::shared_ptr<::hybridse::vm::Tablet> GetTablet(const std::string &index_name,
+                                                      const std::vector<std::string> &pks) override {
+        return table_handler_->GetTablet(index_name, pks);
+    }
+
+    const std::string GetHandlerTypeName() override { return "FollowerReadTableHandler"; }
+
+ private:
+    std::shared_ptr<TabletTableHandler> table_handler_;
+};
+
 typedef std::map<std::string, std::map<std::string, std::shared_ptr<TabletTableHandler>>> TabletTables;
 typedef std::map<std::string, std::shared_ptr<::hybridse::type::Database>> TabletDB;
 typedef std::map<std::string, std::map<std::string, std::shared_ptr<::hybridse::sdk::ProcedureInfo>>> Procedures;
@@ -221,6 +305,9 @@ class TabletCatalog : public ::hybridse::vm::Catalog {
 
     bool AddTable(const ::openmldb::api::TableMeta &meta, std::shared_ptr<::openmldb::storage::Table> table);
 
+    // add a follower replica, which is only read by the deployments with read_policy follower
+    bool AddFollowerTable(const ::openmldb::api::TableMeta &meta, std::shared_ptr<::openmldb::storage::Table> table);
+
     bool UpdateTableMeta(const ::openmldb::api::TableMeta &meta);
 
     bool UpdateTableInfo(const ::openmldb::nameserver::TableInfo& table_info);
@@ -264,6 +351,8 @@ class TabletCatalog : public ::hybridse::vm::Catalog {
     void RefreshAggrTables(const std::vector<::hybridse::vm::AggrTableInfo>& entries);
 
  private:
+    std::shared_ptr<TabletTableHandler> GetOrCreateTableHandler(const ::openmldb::api::TableMeta &meta);
+
     struct AggrTableKey {
         std::string base_db;
         std::string base_table;
@@ -308,6 +397,40 @@ class TabletCatalog : public ::hybridse::vm::Catalog {
     std::shared_ptr<AggrTableMap> aggr_tables_;
 };
 
+// The catalog of the deployments with read_policy follower, the tables are FollowerReadTableHandler
+class FollowerReadCatalog : public ::hybridse::vm::Catalog {
+ public:
+    explicit FollowerReadCatalog(std::shared_ptr<TabletCatalog> catalog) : catalog_(catalog) {}
+
+    ~FollowerReadCatalog() {}
+
+    std::shared_ptr<::hybridse::type::Database> GetDatabase(const std::string &db) override {
+        return catalog_->GetDatabase(db);
+    }
+
+    std::shared_ptr<::hybridse::vm::TableHandler> GetTable(const std::string &db,
+                                                           const std::string &table_name) override;
+
+    bool IndexSupport() override { return catalog_->IndexSupport(); }
+
+    std::shared_ptr<::hybridse::sdk::ProcedureInfo> GetProcedureInfo(const std::string &db,
+                                                                     const std::string &sp_name) override {
+        return catalog_->GetProcedureInfo(db, sp_name);
+    }
+
+    std::vector<::hybridse::vm::AggrTableInfo> GetAggrTables(const std::string &base_db, const std::string &base_table,
+                                                             const std::string &aggr_func, const std::string &aggr_col,
+                                                             const std::string &partition_cols,
+                                                             const std::string &order_col,
+                                                             const std::string &filter_col) override {
+        return catalog_->GetAggrTables(base_db, base_table, aggr_func, aggr_col, partition_cols, order_col,
+                                       filter_col);
+    }
+
+ private:
+    std::shared_ptr<TabletCatalog> catalog_;
+};
+
 }  // namespace catalog
 }  // namespace openmldb
 #endif  // SRC_CATALOG_TABLET_CATALOG_H_
@@ -31,15 +31,18 @@ DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
 DECLARE_uint32(latest_ttl_max);
 DECLARE_uint32(absolute_ttl_max);
+DECLARE_uint32(tablet_client_channel_num);
 
 namespace openmldb {
 namespace client {
 
 TabletClient::TabletClient(const std::string& endpoint, const std::string& real_endpoint)
-    : Client(endpoint, real_endpoint), client_(real_endpoint.empty() ? endpoint : real_endpoint) {}
+    : Client(endpoint, real_endpoint),
+      client_(real_endpoint.empty() ? endpoint : real_endpoint, false, FLAGS_tablet_client_channel_num) {}
 
 TabletClient::TabletClient(const std::string& endpoint, const std::string& real_endpoint, bool use_sleep_policy)
-    : Client(endpoint, real_endpoint), client_(real_endpoint.empty() ? endpoint : real_endpoint, use_sleep_policy) {}
+    : Client(endpoint, real_endpoint),
+      client_(real_endpoint.empty() ? endpoint : real_endpoint, use_sleep_policy, FLAGS_tablet_client_channel_num) {}
 
 TabletClient::~TabletClient() {}
 
@@ -71,13 +74,17 @@ bool TabletClient::Query(const std::string& db, const std::string& sql, const st
 bool TabletClient::Query(const std::string& db, const std::string& sql,
                          const std::vector<openmldb::type::DataType>& parameter_types,
                          const std::string& parameter_row,
-                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug) {
+                         brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug,
+                         const ::openmldb::api::ColumnarResult* columnar) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::QueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_batch(true);
     request.set_is_debug(is_debug);
+    if (columnar != nullptr) {
+        request.mutable_columnar()->CopyFrom(*columnar);
+    }
     request.set_parameter_row_size(parameter_row.size());
     request.set_parameter_row_slices(1);
     for (auto& type : parameter_types) {
@@ -129,12 +136,15 @@ static bool EncodeRowBatch(std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>
 bool TabletClient::SQLBatchRequestQuery(const std::string& db, const std::string& sql,
                                         std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch,
                                         brpc::Controller* cntl, ::openmldb::api::SQLBatchRequestQueryResponse* response,
-                                        const bool is_debug) {
+                                        const bool is_debug, const ::openmldb::api::ColumnarResult* columnar) {
     if (cntl == NULL || response == NULL) return false;
     ::openmldb::api::SQLBatchRequestQueryRequest request;
     request.set_sql(sql);
     request.set_db(db);
     request.set_is_debug(is_debug);
+    if (columnar != nullptr) {
+        request.mutable_columnar()->CopyFrom(*columnar);
+    }
 
     const std::set<size_t>& indices_set = row_batch->common_column_indices();
     for (size_t idx : indices_set) {
@@ -153,6 +163,33 @@ bool TabletClient::SQLBatchRequestQuery(const std::string& db, const std::string
     return true;
 }
 
+bool TabletClient::SQLBatchRequestQuery(
+    const std::string& db, const std::string& sql, std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch,
+    bool is_debug, uint64_t timeout_ms, openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback,
+    const ::openmldb::api::ColumnarResult* columnar) {
+    if (callback == nullptr) {
+        return false;
+    }
+    ::openmldb::api::SQLBatchRequestQueryRequest request;
+    request.set_sql(sql);
+    request.set_db(db);
+    request.set_is_debug(is_debug);
+    if (columnar != nullptr) {
+        request.mutable_columnar()->CopyFrom(*columnar);
+    }
+    for (size_t idx : row_batch->common_column_indices()) {
+        request.add_common_column_indices(idx);
+    }
+    auto& io_buf = callback->GetController()->request_attachment();
+    if (!EncodeRowBatch(row_batch, &request, &io_buf)) {
+        return false;
+    }
+
+    callback->GetController()->set_timeout_ms(timeout_ms);
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::SQLBatchRequestQuery,
+                               callback->GetController().get(), &request, callback->GetResponse().get(), callback);
+}
+
 bool TabletClient::CreateTable(const std::string& name, uint32_t tid, uint32_t pid, uint64_t abs_ttl, uint64_t lat_ttl,
                                bool leader, const std::vector<std::string>& endpoints,
                                const ::openmldb::type::TTLType& type, uint32_t seg_cnt, uint64_t term,
@@ -263,6 +300,32 @@ bool TabletClient::Put(uint32_t tid, uint32_t pid, uint64_t time, const std::str
     return false;
 }
 
+bool TabletClient::AsyncPut(const ::openmldb::api::PutRequest& request,
+                            openmldb::RpcCallback<openmldb::api::PutResponse>* callback) {
+    if (callback == nullptr) {
+        return false;
+    }
+    return client_.SendRequest(&::openmldb::api::TabletServer_Stub::Put, callback->GetController().get(), &request,
+                               callback->GetResponse().get(), callback);
+}
+
+base::Status TabletClient::LoadLocalFile(const ::openmldb::api::LoadLocalFileRequest& request, uint64_t timeout_ms,
+                                         uint64_t* row_cnt) {
+    ::openmldb::api::LoadLocalFileResponse response;
+    bool ok = client_.SendRequest(&::openmldb::api::TabletServer_Stub::LoadLocalFile, &request, &response,
+                                  timeout_ms, 1);
+    if (!ok) {
+        return {base::ReturnCode::kError, "send load local file request to " + endpoint_ + " failed"};
+    }
+    if (row_cnt != nullptr) {
+        *row_cnt = response.row_cnt();
+    }
+    if (response.code() != 0) {
+        return {response.code(), response.msg()};
+    }
+    return {};
+}
+
 bool TabletClient::Put(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, const std::string& value) {
     ::openmldb::api::PutRequest request;
     auto dim = request.add_dimensions();
@@ -1217,7 +1280,7 @@ bool TabletClient::CallSQLBatchRequestProcedure(const std::string& db, const std
                                                 std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch,
                                                 brpc::Controller* cntl,
                                                 openmldb::api::SQLBatchRequestQueryResponse* response, bool is_debug,
-                                                uint64_t timeout_ms) {
+                                                uint64_t timeout_ms, const ::openmldb::api::ColumnarResult* columnar) {
     if (cntl == NULL || response == NULL) {
         return false;
     }
@@ -1226,6 +1289,9 @@ bool TabletClient::CallSQLBatchRequestProcedure(const std::string& db, const std
     request.set_is_procedure(true);
     request.set_db(db);
     request.set_is_debug(is_debug);
+    if (columnar != nullptr) {
+        request.mutable_columnar()->CopyFrom(*columnar);
+    }
     cntl->set_timeout_ms(timeout_ms);
 
     auto& io_buf = cntl->request_attachment();
@@ -1256,7 +1322,8 @@ bool TabletClient::DropProcedure(const std::string& db_name, const std::string&
 
 bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_name, const std::string& row,
                                  uint64_t timeout_ms, bool is_debug,
-                                 openmldb::RpcCallback<openmldb::api::QueryResponse>* callback) {
+                                 openmldb::RpcCallback<openmldb::api::QueryResponse>* callback,
+                                 const ::openmldb::api::FollowerRead* follower_read) {
     if (callback == nullptr) {
         return false;
     }
@@ -1268,6 +1335,9 @@ bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_na
     request.set_is_procedure(true);
     request.set_row_size(row.size());
     request.set_row_slices(1);
+    if (follower_read != nullptr) {
+        request.mutable_follower_read()->CopyFrom(*follower_read);
+    }
     auto& io_buf = callback->GetController()->request_attachment();
     if (!codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(), &io_buf)) {
         LOG(WARNING) << "Encode row buf failed";
@@ -1280,7 +1350,8 @@ bool TabletClient::CallProcedure(const std::string& db, const std::string& sp_na
 
 bool TabletClient::CallSQLBatchRequestProcedure(
     const std::string& db, const std::string& sp_name, std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch,
-    bool is_debug, uint64_t timeout_ms, openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback) {
+    bool is_debug, uint64_t timeout_ms, openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback,
+    const ::openmldb::api::ColumnarResult* columnar) {
     if (callback == nullptr) {
         return false;
     }
@@ -1289,6 +1360,9 @@ bool TabletClient::CallSQLBatchRequestProcedure(
     request.set_is_procedure(true);
     request.set_db(db);
     request.set_is_debug(is_debug);
+    if (columnar != nullptr) {
+        request.mutable_columnar()->CopyFrom(*columnar);
+    }
 
     auto& io_buf = callback->GetController()->request_attachment();
     if (!EncodeRowBatch(row_batch, &request, &io_buf)) {
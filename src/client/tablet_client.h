@@ -65,22 +65,38 @@ class TabletClient : public Client {
                                     const openmldb::common::VersionPair& pair,
                                     std::string& msg);  // NOLINT
 
+    // the result is in the columnar encoding if `columnar` is set, see codec/columnar_codec.h
     bool Query(const std::string& db, const std::string& sql,
                const std::vector<openmldb::type::DataType>& parameter_types, const std::string& parameter_row,
-               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false);
+               brpc::Controller* cntl, ::openmldb::api::QueryResponse* response, const bool is_debug = false,
+               const ::openmldb::api::ColumnarResult* columnar = nullptr);
 
     bool Query(const std::string& db, const std::string& sql, const std::string& row, brpc::Controller* cntl,
                ::openmldb::api::QueryResponse* response, const bool is_debug = false);
 
     bool SQLBatchRequestQuery(const std::string& db, const std::string& sql,
                               std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>, brpc::Controller* cntl,
-                              ::openmldb::api::SQLBatchRequestQueryResponse* response, const bool is_debug = false);
+                              ::openmldb::api::SQLBatchRequestQueryResponse* response, const bool is_debug = false,
+                              const ::openmldb::api::ColumnarResult* columnar = nullptr);
+
+    bool SQLBatchRequestQuery(const std::string& db, const std::string& sql,
+                              std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch, bool is_debug,
+                              uint64_t timeout_ms,
+                              openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback,
+                              const ::openmldb::api::ColumnarResult* columnar = nullptr);
 
     bool Put(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, const std::string& value);
 
     bool Put(uint32_t tid, uint32_t pid, uint64_t time, const std::string& value,
              const std::vector<std::pair<std::string, uint32_t>>& dimensions);
 
+    bool AsyncPut(const ::openmldb::api::PutRequest& request,
+                  openmldb::RpcCallback<openmldb::api::PutResponse>* callback);
+
+    // the tablet loads the whole file in the request, so the timeout should be long enough
+    base::Status LoadLocalFile(const ::openmldb::api::LoadLocalFileRequest& request, uint64_t timeout_ms,
+                               uint64_t* row_cnt);
+
     bool Get(uint32_t tid, uint32_t pid, const std::string& pk, uint64_t time, std::string& value,  // NOLINT
              uint64_t& ts,                                                                          // NOLINT
              std::string& msg);                        ;                                             // NOLINT
@@ -236,7 +252,7 @@ class TabletClient : public Client {
     bool CallSQLBatchRequestProcedure(const std::string& db, const std::string& sp_name,
                                       std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch>, brpc::Controller* cntl,
                                       openmldb::api::SQLBatchRequestQueryResponse* response, bool is_debug,
-                                      uint64_t timeout_ms);
+                                      uint64_t timeout_ms, const ::openmldb::api::ColumnarResult* columnar = nullptr);
 
     bool DropProcedure(const std::string& db_name, const std::string& sp_name);
 
@@ -252,13 +268,16 @@ class TabletClient : public Client {
 
     bool DropFunction(const ::openmldb::common::ExternalFun& fun, std::string* msg);
 
+    // `follower_read` is set if the request may be served by a follower
     bool CallProcedure(const std::string& db, const std::string& sp_name, const std::string& row, uint64_t timeout_ms,
-                       bool is_debug, openmldb::RpcCallback<openmldb::api::QueryResponse>* callback);
+                       bool is_debug, openmldb::RpcCallback<openmldb::api::QueryResponse>* callback,
+                       const ::openmldb::api::FollowerRead* follower_read = nullptr);
 
     bool CallSQLBatchRequestProcedure(const std::string& db, const std::string& sp_name,
                                       std::shared_ptr<::openmldb::sdk::SQLRequestRowBatch> row_batch, bool is_debug,
                                       uint64_t timeout_ms,
-                                      openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback);
+                                      openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback,
+                                      const ::openmldb::api::ColumnarResult* columnar = nullptr);
 
     bool CreateAggregator(const ::openmldb::api::TableMeta& base_table_meta,
                           uint32_t aggr_tid, uint32_t aggr_pid, uint32_t index_pos,
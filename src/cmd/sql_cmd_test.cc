@@ -433,6 +433,70 @@ TEST_F(SqlCmdTest, LoadData) {
     unlink(file_name.c_str());
 }
 
+TEST_F(SqlCmdTest, LoadDataMultiThread) {
+    sr = standalone_cli.sr;
+    cs = standalone_cli.cs;
+    HandleSQL("create database test1;");
+    HandleSQL("use test1;");
+    std::string create_sql = "create table trans (c1 string, c2 int, c3 bigint);";
+    HandleSQL(create_sql);
+    std::string file_name = "./myfile_multi_thread.csv";
+    std::ofstream ofile;
+    ofile.open(file_name);
+    for (int i = 0; i < 10000; i++) {
+        ofile << "aa" << i % 100 << "|" << i << "|" << (i % 7 == 0 ? "NA" : std::to_string(i));
+        // the last line has no line break
+        if (i != 9999) {
+            ofile << std::endl;
+        }
+    }
+    ofile.close();
+    std::string load_sql = "LOAD DATA INFILE '" + file_name +
+                           "' INTO TABLE trans OPTIONS(header=false, delimiter='|', null_value='NA', thread=4);";
+    hybridse::sdk::Status status;
+    sr->ExecuteSQL(load_sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    ASSERT_EQ(0u, status.msg.find("Load 10000 rows")) << status.msg;
+    auto result = sr->ExecuteSQL("select * from trans;", &status);
+    ASSERT_TRUE(status.IsOK());
+    ASSERT_EQ(10000, result->Size());
+    int null_cnt = 0;
+    while (result->Next()) {
+        if (result->IsNULL(2)) {
+            null_cnt++;
+        }
+    }
+    ASSERT_EQ(1429, null_cnt);
+
+    // the tablet reads the file and writes the rows itself
+    HandleSQL("create table trans2 (c1 string, c2 int, c3 bigint);");
+    sr->ExecuteSQL("LOAD DATA INFILE '" + file_name +
+                       "' INTO TABLE trans2 OPTIONS(header=false, delimiter='|', null_value='NA', thread=4, "
+                       "load_mode='tablet');",
+                   &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    ASSERT_EQ(0u, status.msg.find("Load 10000 rows")) << status.msg;
+    result = sr->ExecuteSQL("select * from trans2;", &status);
+    ASSERT_TRUE(status.IsOK());
+    ASSERT_EQ(10000, result->Size());
+    sr->ExecuteSQL("LOAD DATA INFILE '" + file_name + "' INTO TABLE trans2 OPTIONS(load_mode='server');", &status);
+    ASSERT_FALSE(status.IsOK());
+    HandleSQL("drop table trans2;");
+
+    // the error reports the line number
+    ofile.open(file_name);
+    ofile << "bb|1|1" << std::endl << "bb|2" << std::endl;
+    ofile.close();
+    sr->ExecuteSQL(load_sql, &status);
+    ASSERT_FALSE(status.IsOK());
+    ASSERT_NE(std::string::npos, status.msg.find("line 2")) << status.msg;
+    sr->ExecuteSQL("LOAD DATA INFILE '" + file_name + "' INTO TABLE trans OPTIONS(thread=0);", &status);
+    ASSERT_FALSE(status.IsOK());
+    HandleSQL("drop table trans;");
+    HandleSQL("drop database test1;");
+    unlink(file_name.c_str());
+}
+
 TEST_P(DBSDKTest, Deploy) {
     auto cli = GetParam();
     cs = cli->cs;
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "boost/container/deque.hpp"
+#include "codec/field_codec.h"
 #include "codec/row_codec.h"
 #include "gtest/gtest.h"
 #include "proto/common.pb.h"
@@ -543,6 +544,58 @@ TEST_F(CodecTest, RowBuilderSet) {
     ASSERT_EQ(ret, st);
 }
 
+// records the appended values as strings
+struct MockInsertRow {
+    std::vector<std::string> vals;
+    bool AppendNULL() { return Append("NULL"); }
+    bool AppendBool(bool v) { return Append(v ? "true" : "false"); }
+    bool AppendInt16(int16_t v) { return Append(std::to_string(v)); }
+    bool AppendInt32(int32_t v) { return Append(std::to_string(v)); }
+    bool AppendInt64(int64_t v) { return Append(std::to_string(v)); }
+    bool AppendTimestamp(int64_t v) { return Append(std::to_string(v)); }
+    bool AppendFloat(float v) { return Append(std::to_string(v)); }
+    bool AppendDouble(double v) { return Append(std::to_string(v)); }
+    bool AppendString(const char* v, uint32_t len) { return Append(std::string(v, len)); }
+    bool AppendDate(uint32_t year, uint32_t month, uint32_t day) {
+        return Append(std::to_string(year) + "/" + std::to_string(month) + "/" + std::to_string(day));
+    }
+    bool Append(const std::string& v) {
+        vals.push_back(v);
+        return true;
+    }
+};
+
+TEST_F(CodecTest, AppendColumnValue) {
+    MockInsertRow row;
+    auto append = [&row](const std::string& v, hybridse::sdk::DataType type) {
+        return AppendColumnValue(v, type, false, "null", &row);
+    };
+    ASSERT_TRUE(append("TRUE", hybridse::sdk::kTypeBool));
+    ASSERT_TRUE(append("-32768", hybridse::sdk::kTypeInt16));
+    ASSERT_TRUE(append("+12", hybridse::sdk::kTypeInt32));
+    ASSERT_TRUE(append("9223372036854775807", hybridse::sdk::kTypeInt64));
+    ASSERT_TRUE(append("1.5", hybridse::sdk::kTypeFloat));
+    ASSERT_TRUE(append("-2.25e2", hybridse::sdk::kTypeDouble));
+    ASSERT_TRUE(append("", hybridse::sdk::kTypeString));
+    ASSERT_TRUE(append("2021-05-20", hybridse::sdk::kTypeDate));
+    ASSERT_TRUE(append("1635247427000", hybridse::sdk::kTypeTimestamp));
+    ASSERT_TRUE(append("null", hybridse::sdk::kTypeInt32));
+    std::vector<std::string> expect = {"true", "-32768", "12", "9223372036854775807", "1.500000", "-225.000000",
+                                       "", "2021/5/20", "1635247427000", "NULL"};
+    ASSERT_EQ(expect, row.vals);
+
+    ASSERT_FALSE(append("yes", hybridse::sdk::kTypeBool));
+    ASSERT_FALSE(append("32768", hybridse::sdk::kTypeInt16));
+    ASSERT_FALSE(append("12a", hybridse::sdk::kTypeInt32));
+    ASSERT_FALSE(append("+-1", hybridse::sdk::kTypeInt64));
+    ASSERT_FALSE(append("", hybridse::sdk::kTypeInt64));
+    ASSERT_FALSE(append("1.5x", hybridse::sdk::kTypeDouble));
+    ASSERT_FALSE(append("2021-05", hybridse::sdk::kTypeDate));
+    ASSERT_FALSE(append("2021-05-20-1", hybridse::sdk::kTypeDate));
+    ASSERT_FALSE(AppendColumnValue("null", hybridse::sdk::kTypeInt32, true, "null", &row));
+    ASSERT_EQ(expect.size(), row.vals.size());
+}
+
 }  // namespace codec
 }  // namespace openmldb
 
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/columnar_codec.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <set>
+
+#include "glog/logging.h"
+
+namespace openmldb {
+namespace codec {
+
+static constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+
+static inline size_t Align(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+static inline size_t GetBitmapSize(size_t row_cnt) { return (row_cnt + 7) >> 3; }
+
+// append zeros up to the next multiple of 8 bytes and return the offset of the section
+static inline size_t AppendSection(std::string* buf, size_t size) {
+    size_t offset = Align(buf->size());
+    buf->resize(offset + size, '\0');
+    return offset;
+}
+
+ColumnarEncoder::ColumnarEncoder(const hybridse::codec::Schema& schema, const std::vector<size_t>& common_indices) {
+    std::set<size_t> common(common_indices.begin(), common_indices.end());
+    for (int i = 0; i < schema.size(); i++) {
+        uint32_t slice = common.empty() || common.count(i) > 0 ? 0 : 1;
+        columns_.push_back({schema.Get(i).type(), slice, static_cast<uint32_t>(slice_schemas_[slice].size())});
+        *slice_schemas_[slice].Add() = schema.Get(i);
+    }
+    views_.emplace_back(slice_schemas_[0]);
+    views_.emplace_back(slice_schemas_[1]);
+}
+
+bool ColumnarEncoder::Encode(const std::vector<hybridse::codec::Row>& rows, size_t count, std::string* buf) const {
+    if (buf == nullptr || count > rows.size()) {
+        return false;
+    }
+    buf->clear();
+    uint32_t header[2] = {static_cast<uint32_t>(count), static_cast<uint32_t>(columns_.size())};
+    buf->append(reinterpret_cast<const char*>(header), HEADER_SIZE);
+    size_t offsets_pos = buf->size();
+    buf->resize(offsets_pos + columns_.size() * sizeof(uint64_t), '\0');
+    for (size_t i = 0; i < columns_.size(); i++) {
+        uint64_t offset = Align(buf->size());
+        memcpy(&(*buf)[offsets_pos + i * sizeof(uint64_t)], &offset, sizeof(uint64_t));
+        if (!EncodeColumn(columns_[i], rows, count, buf)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ColumnarEncoder::EncodeColumn(const Column& column, const std::vector<hybridse::codec::Row>& rows, size_t count,
+                                   std::string* buf) const {
+    uint32_t value_size = ColumnarView::GetValueSize(column.type);
+    if (value_size == 0) {
+        LOG(WARNING) << "type " << ::hybridse::type::Type_Name(column.type) << " isn't supported in columnar encoding";
+        return false;
+    }
+    const auto& view = views_[column.slice];
+    size_t bitmap_pos = AppendSection(buf, GetBitmapSize(count));
+    bool is_string = column.type == ::hybridse::type::kVarchar;
+    size_t values_pos = AppendSection(buf, (is_string ? count + 1 : count) * value_size);
+    uint32_t str_offset = 0;
+    for (size_t r = 0; r < count; r++) {
+        const auto& row = rows[r];
+        if (row.GetRowPtrCnt() <= static_cast<int32_t>(column.slice) || row.buf(column.slice) == nullptr) {
+            LOG(WARNING) << "the row " << r << " doesn't have slice " << column.slice;
+            return false;
+        }
+        const int8_t* ptr = row.buf(column.slice);
+        int32_t ret = 0;
+        if (is_string) {
+            const char* str = nullptr;
+            uint32_t len = 0;
+            ret = view.GetValue(ptr, column.idx, &str, &len);
+            if (ret == 0) {
+                if (static_cast<uint64_t>(str_offset) + len > UINT32_MAX) {
+                    LOG(WARNING) << "the string data is too large";
+                    return false;
+                }
+                buf->append(str, len);
+                str_offset += len;
+            }
+            memcpy(&(*buf)[values_pos + (r + 1) * sizeof(uint32_t)], &str_offset, sizeof(uint32_t));
+        } else {
+            ret = view.GetValue(ptr, column.idx, column.type, &(*buf)[values_pos + r * value_size]);
+        }
+        if (ret == 1) {
+            (*buf)[bitmap_pos + (r >> 3)] |= static_cast<char>(1 << (r & 0x07));
+        } else if (ret != 0) {
+            LOG(WARNING) << "fail to get the value of column " << column.idx << " in row " << r;
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t ColumnarView::GetValueSize(::hybridse::type::Type type) {
+    switch (type) {
+        case ::hybridse::type::kBool:
+            return sizeof(bool);
+        case ::hybridse::type::kInt16:
+            return sizeof(int16_t);
+        case ::hybridse::type::kInt32:
+        case ::hybridse::type::kDate:
+            return sizeof(int32_t);
+        case ::hybridse::type::kFloat:
+            return sizeof(float);
+        case ::hybridse::type::kInt64:
+        case ::hybridse::type::kTimestamp:
+            return sizeof(int64_t);
+        case ::hybridse::type::kDouble:
+            return sizeof(double);
+        case ::hybridse::type::kVarchar:
+            return sizeof(uint32_t);
+        default:
+            return 0;
+    }
+}
+
+bool ColumnarView::Init(const int8_t* buf, size_t size, const hybridse::codec::Schema& schema) {
+    if (buf == nullptr || size < HEADER_SIZE) {
+        return false;
+    }
+    uint32_t header[2];
+    memcpy(header, buf, HEADER_SIZE);
+    uint32_t col_cnt = header[1];
+    if (col_cnt != static_cast<uint32_t>(schema.size()) || size < HEADER_SIZE + col_cnt * sizeof(uint64_t)) {
+        LOG(WARNING) << "the columns don't match the schema";
+        return false;
+    }
+    row_cnt_ = header[0];
+    bitmaps_.clear();
+    values_.clear();
+    data_.clear();
+    const auto* offsets = reinterpret_cast<const uint64_t*>(buf + HEADER_SIZE);
+    for (uint32_t i = 0; i < col_cnt; i++) {
+        auto type = schema.Get(i).type();
+        uint32_t value_size = GetValueSize(type);
+        bool is_string = type == ::hybridse::type::kVarchar;
+        if (offsets[i] >= size) {
+            LOG(WARNING) << "invalid offset of column " << i;
+            return false;
+        }
+        size_t bitmap_pos = offsets[i];
+        size_t values_pos = Align(bitmap_pos + GetBitmapSize(row_cnt_));
+        size_t end = values_pos + (is_string ? row_cnt_ + 1 : row_cnt_) * static_cast<size_t>(value_size);
+        if (value_size == 0 || bitmap_pos % 8 != 0 || end > size) {
+            LOG(WARNING) << "invalid column " << i;
+            return false;
+        }
+        bitmaps_.push_back(reinterpret_cast<const uint8_t*>(buf + bitmap_pos));
+        values_.push_back(buf + values_pos);
+        if (is_string) {
+            const auto* str_offsets = reinterpret_cast<const uint32_t*>(buf + values_pos);
+            for (uint32_t r = 0; r < row_cnt_; r++) {
+                if (str_offsets[r] > str_offsets[r + 1]) {
+                    LOG(WARNING) << "invalid string offsets of column " << i;
+                    return false;
+                }
+            }
+            if (str_offsets[0] != 0 || end + str_offsets[row_cnt_] > size) {
+                LOG(WARNING) << "invalid string column " << i;
+                return false;
+            }
+            data_.push_back(reinterpret_cast<const char*>(buf + end));
+        } else {
+            data_.push_back(nullptr);
+        }
+    }
+    return true;
+}
+
+}  // namespace codec
+}  // namespace openmldb
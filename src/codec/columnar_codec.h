@@ -0,0 +1,98 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_CODEC_COLUMNAR_CODEC_H_
+#define SRC_CODEC_COLUMNAR_CODEC_H_
+
+#include <string>
+#include <vector>
+
+#include "codec/fe_row_codec.h"
+#include "codec/row.h"
+
+namespace openmldb {
+namespace codec {
+
+/**
+ * The columnar encoding of the result rows, the values of a column are stored together as a typed array instead of
+ * in a row buffer per row. The numbers are little endian and every section starts at a multiple of 8 bytes.
+ *   header: uint32 row count | uint32 column count | uint64 offsets of the columns[column count]
+ *   column: null bitmap, a bit per row which is set if the value is null | values
+ * The values of a string column are uint32 offsets[row count + 1] in the data followed by the data, the values of
+ * the other columns are sizeof(type) bytes per row, bool takes a byte, date is int32 and timestamp is int64 as the
+ * row format. The value of a null is 0 or empty.
+ */
+class ColumnarEncoder {
+ public:
+    // The columns in `common_indices` are in the first slice of the rows and the others are in the second slice, as
+    // the output rows of the batch request mode. It's empty if all the columns are in the only slice
+    ColumnarEncoder(const hybridse::codec::Schema& schema, const std::vector<size_t>& common_indices);
+
+    // encode the first `count` rows, false if some type isn't supported or some row doesn't match the schema
+    bool Encode(const std::vector<hybridse::codec::Row>& rows, size_t count, std::string* buf) const;
+
+ private:
+    struct Column {
+        ::hybridse::type::Type type;
+        uint32_t slice;
+        uint32_t idx;
+    };
+
+    bool EncodeColumn(const Column& column, const std::vector<hybridse::codec::Row>& rows, size_t count,
+                      std::string* buf) const;
+
+    std::vector<Column> columns_;
+    hybridse::codec::Schema slice_schemas_[2];
+    std::vector<hybridse::codec::RowView> views_;
+};
+
+// Read the columns in place, no value is copied
+class ColumnarView {
+ public:
+    ColumnarView() : row_cnt_(0), bitmaps_(), values_(), data_() {}
+
+    // `buf` should be aligned to 8 bytes and outlive the view
+    bool Init(const int8_t* buf, size_t size, const hybridse::codec::Schema& schema);
+
+    uint32_t GetRowCount() const { return row_cnt_; }
+    uint32_t GetColumnCount() const { return bitmaps_.size(); }
+
+    bool IsNULL(uint32_t col, uint32_t row) const { return bitmaps_[col][row >> 3] & (1 << (row & 0x07)); }
+    const uint8_t* GetNullBitmap(uint32_t col) const { return bitmaps_[col]; }
+
+    // the values of a column which isn't a string one, T must be the type of the column as the encoding
+    template <typename T>
+    const T* GetValues(uint32_t col) const {
+        return reinterpret_cast<const T*>(values_[col]);
+    }
+
+    const uint32_t* GetStringOffsets(uint32_t col) const { return reinterpret_cast<const uint32_t*>(values_[col]); }
+    const char* GetStringData(uint32_t col) const { return data_[col]; }
+
+    // the bytes of a value in the values, it's the size of an offset for string, 0 if the type isn't supported
+    static uint32_t GetValueSize(::hybridse::type::Type type);
+
+ private:
+    uint32_t row_cnt_;
+    std::vector<const uint8_t*> bitmaps_;
+    std::vector<const int8_t*> values_;
+    // null if it's not a string column
+    std::vector<const char*> data_;
+};
+
+}  // namespace codec
+}  // namespace openmldb
+#endif  // SRC_CODEC_COLUMNAR_CODEC_H_
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "codec/columnar_codec.h"
+
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+
+namespace openmldb {
+namespace codec {
+
+class ColumnarCodecTest : public ::testing::Test {};
+
+static void AddColumn(hybridse::codec::Schema* schema, const std::string& name, hybridse::type::Type type) {
+    auto* column = schema->Add();
+    column->set_name(name);
+    column->set_type(type);
+}
+
+static hybridse::codec::Row BuildRow(const hybridse::codec::Schema& schema, int32_t i, bool null) {
+    hybridse::codec::RowBuilder builder(schema);
+    std::string str = "str" + std::to_string(i);
+    uint32_t size = builder.CalTotalLength(null ? 0 : str.size());
+    auto* buf = reinterpret_cast<int8_t*>(malloc(size));
+    builder.SetBuffer(buf, size);
+    for (const auto& column : schema) {
+        if (null) {
+            builder.AppendNULL();
+            continue;
+        }
+        switch (column.type()) {
+            case hybridse::type::kInt32:
+                builder.AppendInt32(i);
+                break;
+            case hybridse::type::kInt64:
+                builder.AppendInt64(i * 10L);
+                break;
+            case hybridse::type::kDouble:
+                builder.AppendDouble(i + 0.5);
+                break;
+            case hybridse::type::kBool:
+                builder.AppendBool(i % 2 == 0);
+                break;
+            case hybridse::type::kVarchar:
+                builder.AppendString(str.data(), str.size());
+                break;
+            default:
+                break;
+        }
+    }
+    return hybridse::codec::Row(hybridse::base::RefCountedSlice::CreateManaged(buf, size));
+}
+
+TEST_F(ColumnarCodecTest, EncodeSingleSlice) {
+    hybridse::codec::Schema schema;
+    AddColumn(&schema, "c1", hybridse::type::kInt32);
+    AddColumn(&schema, "c2", hybridse::type::kVarchar);
+    AddColumn(&schema, "c3", hybridse::type::kInt64);
+    AddColumn(&schema, "c4", hybridse::type::kDouble);
+    AddColumn(&schema, "c5", hybridse::type::kBool);
+    std::vector<hybridse::codec::Row> rows;
+    for (int32_t i = 0; i < 20; i++) {
+        rows.push_back(BuildRow(schema, i, i % 7 == 3));
+    }
+    ColumnarEncoder encoder(schema, {});
+    std::string buf;
+    // the rows after count are left out
+    ASSERT_TRUE(encoder.Encode(rows, 18, &buf));
+
+    ColumnarView view;
+    ASSERT_TRUE(view.Init(reinterpret_cast<const int8_t*>(buf.data()), buf.size(), schema));
+    ASSERT_EQ(18u, view.GetRowCount());
+    ASSERT_EQ(5u, view.GetColumnCount());
+    const auto* c1 = view.GetValues<int32_t>(0);
+    const auto* c3 = view.GetValues<int64_t>(2);
+    const auto* c4 = view.GetValues<double>(3);
+    const auto* c5 = view.GetValues<bool>(4);
+    const auto* offsets = view.GetStringOffsets(1);
+    for (int32_t i = 0; i < 18; i++) {
+        bool null = i % 7 == 3;
+        for (uint32_t col = 0; col < 5; col++) {
+            ASSERT_EQ(null, view.IsNULL(col, i));
+        }
+        if (null) {
+            ASSERT_EQ(0, c1[i]);
+            ASSERT_EQ(offsets[i], offsets[i + 1]);
+            continue;
+        }
+        ASSERT_EQ(i, c1[i]);
+        ASSERT_EQ(i * 10L, c3[i]);
+        ASSERT_DOUBLE_EQ(i + 0.5, c4[i]);
+        ASSERT_EQ(i % 2 == 0, c5[i]);
+        ASSERT_EQ("str" + std::to_string(i),
+                  std::string(view.GetStringData(1) + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+}
+
+TEST_F(ColumnarCodecTest, EncodeCommonSlice) {
+    hybridse::codec::Schema schema;
+    AddColumn(&schema, "c1", hybridse::type::kInt32);
+    AddColumn(&schema, "c2", hybridse::type::kVarchar);
+    AddColumn(&schema, "c3", hybridse::type::kInt64);
+    // c2 is in the common slice
+    hybridse::codec::Schema common_schema;
+    AddColumn(&common_schema, "c2", hybridse::type::kVarchar);
+    hybridse::codec::Schema non_common_schema;
+    AddColumn(&non_common_schema, "c1", hybridse::type::kInt32);
+    AddColumn(&non_common_schema, "c3", hybridse::type::kInt64);
+    auto common_row = BuildRow(common_schema, 100, false);
+    std::vector<hybridse::codec::Row> rows;
+    for (int32_t i = 0; i < 3; i++) {
+        rows.emplace_back(1, common_row, 1, BuildRow(non_common_schema, i, false));
+    }
+    ColumnarEncoder encoder(schema, {1});
+    std::string buf;
+    ASSERT_TRUE(encoder.Encode(rows, rows.size(), &buf));
+
+    ColumnarView view;
+    ASSERT_TRUE(view.Init(reinterpret_cast<const int8_t*>(buf.data()), buf.size(), schema));
+    ASSERT_EQ(3u, view.GetRowCount());
+    for (int32_t i = 0; i < 3; i++) {
+        ASSERT_EQ(i, view.GetValues<int32_t>(0)[i]);
+        ASSERT_EQ(i * 10L, view.GetValues<int64_t>(2)[i]);
+        const auto* offsets = view.GetStringOffsets(1);
+        ASSERT_EQ("str100", std::string(view.GetStringData(1) + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+
+    // the view doesn't read out of the buffer
+    ASSERT_FALSE(view.Init(reinterpret_cast<const int8_t*>(buf.data()), buf.size() - 1, schema));
+    hybridse::codec::Schema other_schema;
+    AddColumn(&other_schema, "c1", hybridse::type::kInt32);
+    ASSERT_FALSE(view.Init(reinterpret_cast<const int8_t*>(buf.data()), buf.size(), other_schema));
+}
+
+}  // namespace codec
+}  // namespace openmldb
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    return RUN_ALL_TESTS();
+}
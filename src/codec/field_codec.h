@@ -20,9 +20,14 @@
 #include <string.h>
 
 #include <algorithm>
+#include <charconv>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
 #include "base/endianconv.h"
 #include "base/glog_wrapper.h"
 #include "base/strings.h"
@@ -33,9 +38,39 @@
 namespace openmldb {
 namespace codec {
 
+// the parsers below convert a field of a text file without any allocation, the whole field must be consumed
 template <typename T>
-static bool AppendColumnValue(const std::string& v, hybridse::sdk::DataType type, bool is_not_null,
-                       const std::string& null_value, T row) {
+static bool ParseInteger(absl::string_view v, T* val) {
+    static_assert(std::is_integral<T>::value, "integer type required");
+    const char* begin = v.data();
+    const char* end = v.data() + v.size();
+    if (begin != end && *begin == '+') {
+        ++begin;
+        if (begin != end && *begin == '-') {
+            return false;
+        }
+    }
+    auto res = std::from_chars(begin, end, *val);
+    return res.ec == std::errc() && res.ptr == end;
+}
+
+// date in format yyyy-mm-dd
+static inline bool ParseDate(absl::string_view v, int32_t* year, int32_t* month, int32_t* day) {
+    size_t pos1 = v.find('-');
+    if (pos1 == absl::string_view::npos) {
+        return false;
+    }
+    size_t pos2 = v.find('-', pos1 + 1);
+    if (pos2 == absl::string_view::npos || v.find('-', pos2 + 1) != absl::string_view::npos) {
+        return false;
+    }
+    return ParseInteger(v.substr(0, pos1), year) && ParseInteger(v.substr(pos1 + 1, pos2 - pos1 - 1), month) &&
+           ParseInteger(v.substr(pos2 + 1), day);
+}
+
+template <typename T>
+static bool AppendColumnValue(absl::string_view v, hybridse::sdk::DataType type, bool is_not_null,
+                              absl::string_view null_value, T row) {
     // check if null
     if (v == null_value) {
         if (is_not_null) {
@@ -43,57 +78,49 @@ static bool AppendColumnValue(const std::string& v, hybridse::sdk::DataType type
         }
         return row->AppendNULL();
     }
-    try {
-        switch (type) {
-            case hybridse::sdk::kTypeBool: {
-                bool ok = false;
-                std::string b_val = v;
-                std::transform(b_val.begin(), b_val.end(), b_val.begin(), ::tolower);
-                if (b_val == "true") {
-                    ok = row->AppendBool(true);
-                } else if (b_val == "false") {
-                    ok = row->AppendBool(false);
-                }
-                return ok;
-            }
-            case hybridse::sdk::kTypeInt16: {
-                return row->AppendInt16(boost::lexical_cast<int16_t>(v));
-            }
-            case hybridse::sdk::kTypeInt32: {
-                return row->AppendInt32(boost::lexical_cast<int32_t>(v));
-            }
-            case hybridse::sdk::kTypeInt64: {
-                return row->AppendInt64(boost::lexical_cast<int64_t>(v));
-            }
-            case hybridse::sdk::kTypeFloat: {
-                return row->AppendFloat(boost::lexical_cast<float>(v));
-            }
-            case hybridse::sdk::kTypeDouble: {
-                return row->AppendDouble(boost::lexical_cast<double>(v));
-            }
-            case hybridse::sdk::kTypeString: {
-                return row->AppendString(v);
-            }
-            case hybridse::sdk::kTypeDate: {
-                std::vector<std::string> parts;
-                ::openmldb::base::SplitString(v, "-", parts);
-                if (parts.size() != 3) {
-                    return false;
-                }
-                auto year = boost::lexical_cast<int32_t>(parts[0]);
-                auto mon = boost::lexical_cast<int32_t>(parts[1]);
-                auto day = boost::lexical_cast<int32_t>(parts[2]);
-                return row->AppendDate(year, mon, day);
-            }
-            case hybridse::sdk::kTypeTimestamp: {
-                return row->AppendTimestamp(boost::lexical_cast<int64_t>(v));
-            }
-            default: {
-                return false;
+    switch (type) {
+        case hybridse::sdk::kTypeBool: {
+            if (absl::EqualsIgnoreCase(v, "true")) {
+                return row->AppendBool(true);
+            } else if (absl::EqualsIgnoreCase(v, "false")) {
+                return row->AppendBool(false);
             }
+            return false;
+        }
+        case hybridse::sdk::kTypeInt16: {
+            int16_t val = 0;
+            return ParseInteger(v, &val) && row->AppendInt16(val);
+        }
+        case hybridse::sdk::kTypeInt32: {
+            int32_t val = 0;
+            return ParseInteger(v, &val) && row->AppendInt32(val);
+        }
+        case hybridse::sdk::kTypeInt64: {
+            int64_t val = 0;
+            return ParseInteger(v, &val) && row->AppendInt64(val);
+        }
+        case hybridse::sdk::kTypeFloat: {
+            float val = 0;
+            return absl::SimpleAtof(v, &val) && row->AppendFloat(val);
+        }
+        case hybridse::sdk::kTypeDouble: {
+            double val = 0;
+            return absl::SimpleAtod(v, &val) && row->AppendDouble(val);
+        }
+        case hybridse::sdk::kTypeString: {
+            return row->AppendString(v.data(), static_cast<uint32_t>(v.size()));
+        }
+        case hybridse::sdk::kTypeDate: {
+            int32_t year = 0, mon = 0, day = 0;
+            return ParseDate(v, &year, &mon, &day) && row->AppendDate(year, mon, day);
+        }
+        case hybridse::sdk::kTypeTimestamp: {
+            int64_t val = 0;
+            return ParseInteger(v, &val) && row->AppendTimestamp(val);
+        }
+        default: {
+            return false;
         }
-    } catch (std::exception const& e) {
-        return false;
     }
 }
 
@@ -70,6 +70,23 @@ DEFINE_bool(use_name, false, "enable or disable use server name");
 DEFINE_string(data_dir, "./data", "the path of data dir");
 DEFINE_bool(enable_distsql, false, "enable or disable distribute sql");
 DEFINE_bool(enable_localtablet, true, "enable or disable local tablet opt when distribute sql circumstance");
+DEFINE_bool(enable_sql_literal_parameterize, false,
+            "replace the literals compared in WHERE clauses of online batch queries with parameters, "
+            "so the queries differ only in these literals share one compiling result");
+DEFINE_bool(enable_tiered_compile, false,
+            "compile online batch queries without llvm optimization first, and recompile them with optimization "
+            "in background once they are hit tiered_compile_threshold times in the compile cache");
+DEFINE_uint32(tiered_compile_threshold, 10, "the compile cache hit count to optimize a fast compiled query");
+DEFINE_bool(enable_window_column_pruning, false,
+            "project the table rows of online request windows to the columns referenced by the window, "
+            "the projected rows are shared by the windows over the same index during a request");
+DEFINE_bool(enable_index_statistics, false,
+            "choose among the indexes partially matching the keys of a query by the index statistics of the local "
+            "partitions, the index expected to read less rows per key wins. The chosen index may change as the "
+            "data changes");
+DEFINE_uint64(deploy_result_cache_max_bytes, 256 * 1024 * 1024,
+              "the memory limit of the results cached for the deployments with option result_cache_ttl. "
+              "0 disables the cache");
 DEFINE_string(bucket_size, "1d", "the default bucket size in pre-aggr table");
 
 // scan configuration
@@ -79,11 +96,19 @@ DEFINE_uint32(preview_limit_max_num, 1000, "config the max num of preview limit"
 DEFINE_uint32(preview_default_limit, 100, "config the default limit of preview");
 // binlog configuration
 DEFINE_int32(binlog_single_file_max_size, 1024 * 4, "the max size of single binlog file");
-DEFINE_int32(binlog_sync_batch_size, 32, "the batch size of sync binlog");
+DEFINE_int32(binlog_sync_batch_size, 32, "the max entry count of one sync binlog batch");
+DEFINE_int32(binlog_sync_batch_max_bytes, 1024 * 1024,
+             "the max bytes of one sync binlog batch. unit is byte, 0 means no limit");
+DEFINE_int32(binlog_sync_max_inflight, 4, "the max count of unacked sync binlog batches for one follower");
+DEFINE_string(binlog_sync_compression, "off", "Type of sync binlog request compression, can be off, snappy, zlib");
 DEFINE_bool(binlog_notify_on_put, false, "config the sync log to follower strategy");
 DEFINE_bool(binlog_enable_crc, false, "enable crc");
+DEFINE_bool(read_file_with_mmap, true, "read binlog and snapshot files through mmap");
 DEFINE_int32(binlog_coffee_time, 1000, "config the coffee time. unit is milliseconds");
 DEFINE_int32(binlog_sync_wait_time, 100, "config the sync log wait time. unit is milliseconds");
+DEFINE_int32(follower_read_max_idle_ms, 10000,
+             "a follower rejects the follower reads if it hasn't heard from the leader for this long, the leader sends "
+             "an empty sync request to an idle follower every half of it. unit is milliseconds, 0 means no limit");
 DEFINE_int32(binlog_sync_to_disk_interval, 20000,
              "config the interval of sync binlog to disk time. unit is milliseconds");
 DEFINE_int32(binlog_delete_interval, 60000, "config the interval of delete binlog. unit is milliseconds");
@@ -94,6 +119,9 @@ DEFINE_uint32(go_back_max_try_cnt, 10, "config max try time of go back");
 
 DEFINE_uint32(put_slow_log_threshold, 50000, "config the threshold of put slow log");
 DEFINE_uint32(query_slow_log_threshold, 50000, "config the threshold of query slow log");
+DEFINE_uint32(request_max_parallelism, 1,
+              "the max count of bthreads running the independent sub plans of one request query concurrently, "
+              "1 means run the query sequentially");
 
 // local db config
 DEFINE_string(db_root_path, "/tmp/", "the root path of db");
@@ -106,6 +134,8 @@ DEFINE_int32(request_max_retry, 3, "max retry time when request error");
 DEFINE_int32(request_timeout_ms, 20000,
              "rpc request timeout of misc. unit is milliseconds");
 DEFINE_int32(request_sleep_time, 1000, "the sleep time when request error. unit is milliseconds");
+DEFINE_uint32(tablet_client_channel_num, 1,
+              "the number of connections from a tablet client to its tablet, a call is sent by the less loaded one");
 
 DEFINE_uint32(max_traverse_pk_cnt, 5000, "max traverse iter pk cnt");
 DEFINE_uint32(max_traverse_cnt, 50000, "max traverse iter loop cnt");
@@ -130,8 +160,14 @@ DEFINE_uint32(make_snapshot_max_deleted_keys, 1000000, "config the max deleted k
 DEFINE_uint32(make_snapshot_offline_interval, 60 * 60 * 24,
               "config tablet self makesnapshot when how long time do not "
               "makesnapshot from ns. unit is second");
-DEFINE_string(snapshot_compression, "off", "Type of snapshot compression, can be off, snappy, zlib");
+DEFINE_string(snapshot_compression, "off", "Type of snapshot compression, can be off, snappy, zlib, zstd");
+DEFINE_int32(snapshot_compress_level, 3, "the compression level of zstd snapshot");
+DEFINE_uint32(snapshot_compress_dict_size, 32 * 1024,
+              "the max size of zstd dictionary trained for every snapshot, 0 means compress without dictionary");
 DEFINE_int32(snapshot_pool_size, 1, "the size of tablet thread pool for making snapshot");
+DEFINE_uint32(snapshot_max_delta_num, 0,
+              "the max count of delta snapshots before merging them into a new base snapshot, "
+              "0 means always make the full snapshot");
 
 DEFINE_uint32(load_index_max_wait_time, 120 * 60 * 1000,
               "config the max wait time of load index. unit is milliseconds");
@@ -164,6 +200,11 @@ DEFINE_bool(verify_compression, false, "For debug");
 // load table resouce control
 DEFINE_uint32(load_table_batch, 30, "set laod table batch size");
 DEFINE_uint32(load_table_thread_num, 3, "set load tabale thread pool size");
+DEFINE_uint32(binlog_apply_thread_num, 1,
+              "the thread num of applying binlog entries on follower and in recovery. 1 means apply sequentially. "
+              "The entries are partitioned by their keys, an entry whose keys fall into different partitions "
+              "is applied after the entries before it");
+DEFINE_uint32(binlog_apply_batch_size, 64, "the entry count of one apply task");
 DEFINE_uint32(load_table_queue_size, 1000, "set load tabale queue size");
 
 // multiple data center
@@ -25,6 +25,11 @@
 #include <snappy.h>
 #include <stdio.h>
 #include <zlib.h>
+#ifdef OPENMLDB_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
 
 #include "base/endianconv.h"
 #include "base/glog_wrapper.h"
@@ -47,6 +52,7 @@ Reader::Reader(SequentialFile* file, Reporter* reporter, bool checksum, uint64_t
     : file_(file),
       reporter_(reporter),
       checksum_(checksum),
+      backing_store_size_(0),
       buffer_(),
       last_record_offset_(0),
       last_record_end_offset_(0),
@@ -55,7 +61,9 @@ Reader::Reader(SequentialFile* file, Reporter* reporter, bool checksum, uint64_t
       initial_offset_(initial_offset),
       resyncing_(initial_offset > 0),
       compressed_(compressed),
-      uncompress_buf_(nullptr) {
+      uncompress_buf_(nullptr),
+      zstd_dctx_(nullptr),
+      zstd_ddict_(nullptr) {
     if (compressed_) {
         block_size_ = kCompressBlockSize;
         uncompress_buf_ = new char[block_size_];
@@ -64,7 +72,16 @@ Reader::Reader(SequentialFile* file, Reporter* reporter, bool checksum, uint64_t
         block_size_ = kBlockSize;
         header_size_ = kHeaderSize;
     }
-    backing_store_ = new char[block_size_];
+    backing_store_size_ = block_size_;
+    if (compressed_) {
+        // an incompressible block is larger after compression
+        backing_store_size_ = std::max<size_t>(backing_store_size_, snappy::MaxCompressedLength(block_size_));
+        backing_store_size_ = std::max<size_t>(backing_store_size_, compressBound(block_size_));
+#ifdef OPENMLDB_WITH_ZSTD
+        backing_store_size_ = std::max<size_t>(backing_store_size_, ZSTD_compressBound(block_size_));
+#endif
+    }
+    backing_store_ = new char[backing_store_size_];
     DLOG(INFO) << "block_size_: " << block_size_ << ", "
                << "header_size_: " << header_size_ << ", "
                << "compressed_: " << compressed_;
@@ -75,6 +92,25 @@ Reader::~Reader() {
     if (uncompress_buf_) {
         delete[] uncompress_buf_;
     }
+#ifdef OPENMLDB_WITH_ZSTD
+    ZSTD_freeDDict(zstd_ddict_);
+    ZSTD_freeDCtx(zstd_dctx_);
+#endif
+}
+
+void Reader::SetCompressDict(const std::string& dict) {
+#ifdef OPENMLDB_WITH_ZSTD
+    if (dict.empty()) {
+        return;
+    }
+    ZSTD_DDict* ddict = ZSTD_createDDict(dict.data(), dict.size());
+    if (ddict == nullptr) {
+        PDLOG(WARNING, "fail to create zstd dict, dict size %lu", dict.size());
+        return;
+    }
+    ZSTD_freeDDict(zstd_ddict_);
+    zstd_ddict_ = ddict;
+#endif
 }
 
 bool Reader::SkipToInitialBlock() {
@@ -296,6 +332,12 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, uint64_t& offset) {
             memcpy(static_cast<void*>(&compress_type), data + sizeof(uint32_t), 1);
             DLOG(INFO) << "compress_len: " << compress_len << ", "
                        << "compress_type: " << compress_type;
+            if (compress_len > backing_store_size_) {
+                PDLOG(WARNING, "bad record when reading block, compress_len: %u, buffer size: %lu", compress_len,
+                      backing_store_size_);
+                ReportCorruption(compress_len, "compressed block too large");
+                return kBadRecord;
+            }
             // read compressed data
             Slice block;
             status = file_->Read(compress_len, &block, backing_store_);
@@ -332,6 +374,27 @@ unsigned int Reader::ReadPhysicalRecord(Slice* result, uint64_t& offset) {
                     }
                     break;
                 }
+#ifdef OPENMLDB_WITH_ZSTD
+                case kZstd: {
+                    if (zstd_dctx_ == nullptr) {
+                        zstd_dctx_ = ZSTD_createDCtx();
+                    }
+                    size_t res = 0;
+                    if (zstd_ddict_ != nullptr) {
+                        res = ZSTD_decompress_usingDDict(zstd_dctx_, uncompress_buf_, block_size_, block_data,
+                                                         compress_len, zstd_ddict_);
+                    } else {
+                        res = ZSTD_decompressDCtx(zstd_dctx_, uncompress_buf_, block_size_, block_data, compress_len);
+                    }
+                    if (ZSTD_isError(res)) {
+                        PDLOG(WARNING, "bad record when uncompress block, msg: %s, compress type: %d",
+                              ZSTD_getErrorName(res), compress_type);
+                        return kBadRecord;
+                    }
+                    uncompress_len = static_cast<int32_t>(res);
+                    break;
+                }
+#endif
                 default: {
                     PDLOG(WARNING, "unsupported compress type: %d", compress_type);
                     return kBadRecord;
@@ -594,7 +657,7 @@ int LogReader::OpenSeqFile(const std::string& path) {
         sf_ = NULL;
     }
     PDLOG(INFO, "open log file %s", path.c_str());
-    sf_ = ::openmldb::log::NewSeqFile(path, fd);
+    sf_ = ::openmldb::log::NewSeqFileByFlag(path, fd);
     return 0;
 }
 
@@ -32,6 +32,9 @@
 
 using ::openmldb::base::Slice;
 
+struct ZSTD_DCtx_s;
+struct ZSTD_DDict_s;
+
 namespace openmldb {
 namespace log {
 
@@ -83,6 +86,9 @@ class Reader {
 
     inline bool GetCompressed() { return compressed_; }
 
+    // the zstd dictionary the blocks were compressed with
+    void SetCompressDict(const std::string& dict);
+
     inline uint32_t GetBlockSize() { return block_size_; }
 
     inline uint32_t GetHeaderSize() { return header_size_; }
@@ -92,6 +98,8 @@ class Reader {
     Reporter* const reporter_;
     bool const checksum_;
     char* backing_store_;
+    // large enough for a compressed block
+    size_t backing_store_size_;
     Slice buffer_;
 
     // Offset of the last record returned by ReadRecord.
@@ -115,6 +123,8 @@ class Reader {
     uint32_t header_size_;
     // buffer for uncompressed block
     char* uncompress_buf_;
+    ZSTD_DCtx_s* zstd_dctx_;
+    ZSTD_DDict_s* zstd_ddict_;
 
     // Extend record types with the following special values
     enum {
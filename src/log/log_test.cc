@@ -26,6 +26,7 @@
 
 #include "base/file_util.h"
 #include "base/glog_wrapper.h"
+#include "common/timer.h"
 #include "config.h"  // NOLINT
 #include "log/coding.h"
 #include "log/crc32c.h"
@@ -141,6 +142,8 @@ std::string GetWritePath(const std::string& path) {
         return path + openmldb::log::ZLIB_COMPRESS_SUFFIX;
     } else if (FLAGS_snapshot_compression == "snappy") {
         return path + openmldb::log::SNAPPY_COMPRESS_SUFFIX;
+    } else if (FLAGS_snapshot_compression == "zstd") {
+        return path + openmldb::log::ZSTD_COMPRESS_SUFFIX;
     } else {
         return path;
     }
@@ -345,6 +348,258 @@ TEST_F(LogWRTest, TestWait) {
     }
 }
 
+TEST_F(LogWRTest, TestMmapRead) {
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    std::string fname = "test.log";
+    std::string full_path = GetWritePath(log_dir + "/" + fname);
+    FILE* fd_w = fopen(full_path.c_str(), "ab+");
+    ASSERT_TRUE(fd_w != NULL);
+    WritableFile* wf = NewWritableFile(fname, fd_w);
+    Writer writer(FLAGS_snapshot_compression, wf);
+    FILE* fd_r = fopen(full_path.c_str(), "rb");
+    ASSERT_TRUE(fd_r != NULL);
+    SequentialFile* rf = NewMmapSeqFile(fname, fd_r);
+    Reader reader(rf, NULL, true, 0, compressed_);
+    // the small one is in one block and the large one is fragmented
+    std::vector<std::string> values{"hello", std::string(block_size_ * 2, 'a'), "world"};
+    for (const auto& value : values) {
+        ASSERT_TRUE(writer.AddRecord(value).ok());
+    }
+    if (FLAGS_snapshot_compression != "off") {
+        writer.EndLog();
+    }
+    std::string scratch;
+    Slice record;
+    for (const auto& value : values) {
+        Status status = reader.ReadRecord(&record, &scratch);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_EQ(value, record.ToString());
+        if (FLAGS_snapshot_compression == "off" && value.size() < block_size_) {
+            // points into the mapping without copy
+            ASSERT_TRUE(scratch.empty());
+        }
+    }
+    if (FLAGS_snapshot_compression != "off") {
+        delete rf;
+        delete wf;
+        return;
+    }
+    // the data appended after the file has been mapped can be read
+    Status status = reader.ReadRecord(&record, &scratch);
+    ASSERT_TRUE(status.IsWaitRecord());
+    ASSERT_TRUE(writer.AddRecord("appended").ok());
+    status = reader.ReadRecord(&record, &scratch);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    ASSERT_EQ("appended", record.ToString());
+    delete rf;
+    delete wf;
+}
+
+TEST_F(LogWRTest, TestMmapReadRemap) {
+    if (FLAGS_snapshot_compression != "off") {
+        return;
+    }
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    std::string fname = "test.log";
+    std::string full_path = GetWritePath(log_dir + "/" + fname);
+    FILE* fd_w = fopen(full_path.c_str(), "ab+");
+    ASSERT_TRUE(fd_w != NULL);
+    WritableFile* wf = NewWritableFile(fname, fd_w);
+    Writer writer(FLAGS_snapshot_compression, wf);
+    FILE* fd_r = fopen(full_path.c_str(), "rb");
+    ASSERT_TRUE(fd_r != NULL);
+    SequentialFile* rf = NewMmapSeqFile(fname, fd_r);
+    Reader reader(rf, NULL, true, 0, compressed_);
+    std::string scratch;
+    Slice record;
+    // the file grows beyond the reserved mapping while it's read, so it's remapped
+    for (uint32_t i = 0; i < 1200; i++) {
+        std::string value(64 * 1024, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(writer.AddRecord(value).ok());
+        Status status = reader.ReadRecord(&record, &scratch);
+        ASSERT_TRUE(status.ok()) << status.ToString();
+        ASSERT_EQ(value, record.ToString());
+    }
+    delete rf;
+    delete wf;
+    ::openmldb::base::RemoveDirRecursive(log_dir);
+}
+
+TEST_F(LogWRTest, BenchMarkMmapRead) {
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    std::string fname = "test.log";
+    std::string full_path = GetWritePath(log_dir + "/" + fname);
+    FILE* fd_w = fopen(full_path.c_str(), "ab+");
+    ASSERT_TRUE(fd_w != NULL);
+    WritableFile* wf = NewWritableFile(fname, fd_w);
+    Writer writer(FLAGS_snapshot_compression, wf);
+    // about 256 MB, enlarge it to benchmark the large binlogs
+    uint64_t record_num = 1024 * 1024;
+    std::string value(256, 'v');
+    for (uint64_t i = 0; i < record_num; i++) {
+        ASSERT_TRUE(writer.AddRecord(value).ok());
+    }
+    writer.EndLog();
+    delete wf;
+    for (bool use_mmap : {false, true}) {
+        FILE* fd_r = fopen(full_path.c_str(), "rb");
+        ASSERT_TRUE(fd_r != NULL);
+        SequentialFile* rf = use_mmap ? NewMmapSeqFile(fname, fd_r) : NewSeqFile(fname, fd_r);
+        Reader reader(rf, NULL, false, 0, compressed_);
+        std::string scratch;
+        Slice record;
+        uint64_t cnt = 0;
+        uint64_t bytes = 0;
+        uint64_t start = ::baidu::common::timer::get_micros();
+        while (reader.ReadRecord(&record, &scratch).ok()) {
+            cnt++;
+            bytes += record.size();
+        }
+        uint64_t consumed = ::baidu::common::timer::get_micros() - start;
+        std::cout << (use_mmap ? "mmap" : "fread") << " read " << cnt << " records " << bytes << " bytes in "
+                  << consumed << " us" << std::endl;
+        ASSERT_EQ(record_num, cnt);
+        delete rf;
+    }
+    ::openmldb::base::RemoveDirRecursive(log_dir);
+}
+
+// log entries of a table with some similar rows
+static void GenLogEntries(uint64_t num, std::vector<std::string>* records, uint64_t* bytes) {
+    const char* cities[] = {"beijing", "shanghai", "hangzhou", "shenzhen"};
+    *bytes = 0;
+    for (uint64_t i = 0; i < num; i++) {
+        ::openmldb::api::LogEntry entry;
+        entry.set_log_index(i + 1);
+        entry.set_term(1);
+        entry.set_ts(1650000000000 + i * 1000);
+        auto dimension = entry.add_dimensions();
+        dimension->set_key("card_" + std::to_string(i % 1000));
+        dimension->set_idx(0);
+        std::string row;
+        row.append("card_" + std::to_string(i % 1000));
+        row.append("|merchant_" + std::to_string(i % 97));
+        row.append("|" + std::string(cities[i % 4]));
+        row.append("|" + std::to_string(static_cast<double>(i % 5000) / 100));
+        row.append("|" + std::to_string(1650000000000 + i * 1000));
+        entry.set_value(row);
+        records->push_back(entry.SerializeAsString());
+        *bytes += records->back().size();
+    }
+}
+
+TEST_F(LogWRTest, BenchMarkCompressRatio) {
+    if (FLAGS_snapshot_compression != "off") {
+        return;
+    }
+    std::vector<std::string> records;
+    uint64_t raw_bytes = 0;
+    // about 100 MB, enlarge it to benchmark the large snapshots
+    GenLogEntries(1000000, &records, &raw_bytes);
+    std::vector<std::string> types{"snappy", "zlib"};
+#ifdef OPENMLDB_WITH_ZSTD
+    types.push_back("zstd");
+#endif
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    for (const auto& type : types) {
+        for (uint32_t dict_size : {0u, 32u * 1024}) {
+            if (dict_size > 0 && type != "zstd") {
+                continue;
+            }
+            std::string fname = "test_" + type + "_" + std::to_string(dict_size) + ".log";
+            std::string full_path = log_dir + fname;
+            FILE* fd_w = fopen(full_path.c_str(), "ab+");
+            ASSERT_TRUE(fd_w != NULL);
+            WritableFile* wf = NewWritableFile(fname, fd_w);
+            Writer writer(type, wf);
+            writer.SetTrainDictSize(dict_size);
+            uint64_t start = ::baidu::common::timer::get_micros();
+            for (const auto& record : records) {
+                ASSERT_TRUE(writer.AddRecord(record).ok());
+            }
+            writer.EndLog();
+            uint64_t write_time = ::baidu::common::timer::get_micros() - start;
+            uint64_t file_size = wf->GetSize();
+            delete wf;
+
+            FILE* fd_r = fopen(full_path.c_str(), "rb");
+            ASSERT_TRUE(fd_r != NULL);
+            SequentialFile* rf = NewSeqFile(fname, fd_r);
+            Reader reader(rf, NULL, false, 0, true);
+            reader.SetCompressDict(writer.GetCompressDict());
+            std::string scratch;
+            Slice record;
+            uint64_t cnt = 0;
+            start = ::baidu::common::timer::get_micros();
+            while (reader.ReadRecord(&record, &scratch).ok()) {
+                cnt++;
+            }
+            uint64_t read_time = ::baidu::common::timer::get_micros() - start;
+            ASSERT_EQ(records.size(), cnt);
+            delete rf;
+            std::cout << type << " dict " << writer.GetCompressDict().size() << " bytes, ratio "
+                      << static_cast<double>(raw_bytes) / file_size << ", write " << raw_bytes / write_time
+                      << " MB/s, read " << raw_bytes / read_time << " MB/s" << std::endl;
+        }
+    }
+    ::openmldb::base::RemoveDirRecursive(log_dir);
+}
+
+#ifdef OPENMLDB_WITH_ZSTD
+TEST_F(LogWRTest, TestZstdDict) {
+    std::vector<std::string> records;
+    uint64_t raw_bytes = 0;
+    GenLogEntries(100000, &records, &raw_bytes);
+    std::string log_dir = "/tmp/" + GenRand() + "/";
+    ::openmldb::base::MkdirRecur(log_dir);
+    std::string fname = "test.log" + ZSTD_COMPRESS_SUFFIX;
+    std::string full_path = log_dir + fname;
+    FILE* fd_w = fopen(full_path.c_str(), "ab+");
+    ASSERT_TRUE(fd_w != NULL);
+    WritableFile* wf = NewWritableFile(fname, fd_w);
+    Writer writer("zstd", wf);
+    writer.SetTrainDictSize(16 * 1024);
+    for (const auto& record : records) {
+        ASSERT_TRUE(writer.AddRecord(record).ok());
+    }
+    writer.EndLog();
+    delete wf;
+    std::string dict = writer.GetCompressDict();
+    ASSERT_FALSE(dict.empty());
+    ASSERT_LE(dict.size(), 16u * 1024);
+    for (bool with_dict : {true, false}) {
+        FILE* fd_r = fopen(full_path.c_str(), "rb");
+        ASSERT_TRUE(fd_r != NULL);
+        SequentialFile* rf = NewSeqFile(fname, fd_r);
+        Reader reader(rf, NULL, true, 0, true);
+        if (with_dict) {
+            reader.SetCompressDict(dict);
+        }
+        std::string scratch;
+        Slice record;
+        uint64_t cnt = 0;
+        Status status;
+        while ((status = reader.ReadRecord(&record, &scratch)).ok()) {
+            ASSERT_EQ(records[cnt], record.ToString());
+            cnt++;
+        }
+        if (with_dict) {
+            ASSERT_EQ(records.size(), cnt);
+        } else {
+            // the blocks can not be decoded without the dictionary
+            ASSERT_EQ(0u, cnt);
+            ASSERT_FALSE(status.IsEof());
+        }
+        delete rf;
+    }
+    ::openmldb::base::RemoveDirRecursive(log_dir);
+}
+#endif
+
 TEST_F(LogWRTest, TestGoBack) {
     std::string log_dir = "/tmp/" + GenRand() + "/";
     ::openmldb::base::MkdirRecur(log_dir);
@@ -419,6 +674,9 @@ int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     int ret = 0;
     std::vector<std::string> vec{"off", "zlib", "snappy"};
+#ifdef OPENMLDB_WITH_ZSTD
+    vec.push_back("zstd");
+#endif
     for (size_t i = 0; i < vec.size(); i++) {
         std::cout << "compress type: " << vec[i] << std::endl;
         FLAGS_snapshot_compression = vec[i];
@@ -20,15 +20,22 @@
 
 #include "log/log_writer.h"
 
+#include <gflags/gflags.h>
 #include <snappy.h>
 #include <stdint.h>
 #include <zlib.h>
+#ifdef OPENMLDB_WITH_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
 
 #include "base/endianconv.h"
 #include "base/glog_wrapper.h"
 #include "log/coding.h"
 #include "log/crc32c.h"
 
+DECLARE_int32(snapshot_compress_level);
+
 namespace openmldb {
 namespace log {
 
@@ -45,15 +52,15 @@ Writer::Writer(const std::string& compress_type, WritableFile* dest)
       compress_type_(GetCompressType(compress_type)),
       header_size_(compress_type_ != kNoCompress ? kHeaderSizeForCompress : kHeaderSize),
       buffer_(nullptr),
-      compress_buf_(nullptr) {
+      compress_buf_(nullptr),
+      compress_buf_size_(0),
+      sample_sizes_(),
+      train_dict_size_(0),
+      compress_dict_(),
+      zstd_cctx_(nullptr),
+      zstd_cdict_(nullptr) {
     InitTypeCrc(type_crc_);
-    if (compress_type_ != kNoCompress) {
-        block_size_ = kCompressBlockSize;
-        buffer_ = new char[block_size_];
-        compress_buf_ = new char[block_size_];
-    } else {
-        block_size_ = kBlockSize;
-    }
+    InitCompressBuffer();
     DLOG(INFO) << "block_size_: " << block_size_ << ", "
                << "header_size_: " << header_size_ << ", "
                << "compress_type_: " << compress_type_;
@@ -64,15 +71,15 @@ Writer::Writer(const std::string& compress_type, WritableFile* dest, uint64_t de
       compress_type_(GetCompressType(compress_type)),
       header_size_(compress_type_ != kNoCompress ? kHeaderSizeForCompress : kHeaderSize),
       buffer_(nullptr),
-      compress_buf_(nullptr) {
+      compress_buf_(nullptr),
+      compress_buf_size_(0),
+      sample_sizes_(),
+      train_dict_size_(0),
+      compress_dict_(),
+      zstd_cctx_(nullptr),
+      zstd_cdict_(nullptr) {
     InitTypeCrc(type_crc_);
-    if (compress_type_ != kNoCompress) {
-        block_size_ = kCompressBlockSize;
-        buffer_ = new char[block_size_];
-        compress_buf_ = new char[block_size_];
-    } else {
-        block_size_ = kBlockSize;
-    }
+    InitCompressBuffer();
     block_offset_ = dest_length % block_size_;
     DLOG(INFO) << "block_size_: " << block_size_ << ", "
                << "header_size_: " << header_size_ << ", "
@@ -86,6 +93,63 @@ Writer::~Writer() {
     if (compress_buf_) {
         delete[] compress_buf_;
     }
+#ifdef OPENMLDB_WITH_ZSTD
+    ZSTD_freeCDict(zstd_cdict_);
+    ZSTD_freeCCtx(zstd_cctx_);
+#endif
+}
+
+void Writer::InitCompressBuffer() {
+    if (compress_type_ == kNoCompress) {
+        block_size_ = kBlockSize;
+        return;
+    }
+    block_size_ = kCompressBlockSize;
+    buffer_ = new char[block_size_];
+    compress_buf_size_ = block_size_;
+#ifdef OPENMLDB_WITH_ZSTD
+    if (compress_type_ == kZstd) {
+        // incompressible block may be larger after compression
+        compress_buf_size_ = ZSTD_compressBound(block_size_);
+        zstd_cctx_ = ZSTD_createCCtx();
+    }
+#endif
+    compress_buf_ = new char[compress_buf_size_];
+}
+
+void Writer::SetCompressDict(const std::string& dict) {
+#ifdef OPENMLDB_WITH_ZSTD
+    if (compress_type_ != kZstd || dict.empty()) {
+        return;
+    }
+    ZSTD_CDict* cdict = ZSTD_createCDict(dict.data(), dict.size(), FLAGS_snapshot_compress_level);
+    if (cdict == nullptr) {
+        PDLOG(WARNING, "fail to create zstd dict, dict size %lu", dict.size());
+        return;
+    }
+    ZSTD_freeCDict(zstd_cdict_);
+    zstd_cdict_ = cdict;
+    compress_dict_ = dict;
+    train_dict_size_ = 0;
+    sample_sizes_.clear();
+#endif
+}
+
+void Writer::TrainDict() {
+#ifdef OPENMLDB_WITH_ZSTD
+    std::string dict(train_dict_size_, '\0');
+    train_dict_size_ = 0;
+    size_t res = ZDICT_trainFromBuffer(&dict[0], dict.size(), buffer_, sample_sizes_.data(), sample_sizes_.size());
+    if (ZDICT_isError(res)) {
+        // too few samples, e.g. a small snapshot, compress without dict
+        PDLOG(INFO, "skip zstd dict, sample count %lu, msg: %s", sample_sizes_.size(), ZDICT_getErrorName(res));
+        sample_sizes_.clear();
+        return;
+    }
+    dict.resize(res);
+    SetCompressDict(dict);
+    PDLOG(INFO, "train zstd dict done, dict size %lu", dict.size());
+#endif
 }
 
 Status Writer::EndLog() {
@@ -224,6 +288,9 @@ Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
     } else {
         memcpy(buffer_ + block_offset_, &buf, header_size_);
         memcpy(buffer_ + block_offset_ + header_size_, ptr, n);
+        if (train_dict_size_ > 0) {
+            sample_sizes_.push_back(header_size_ + n);
+        }
         block_offset_ += header_size_ + n;
         // fill the trailer if kEofType
         if (t == kEofType) {
@@ -264,6 +331,28 @@ Status Writer::CompressRecord() {
             compress_len = static_cast<int32_t>(dest_len);
             break;
         }
+#ifdef OPENMLDB_WITH_ZSTD
+        case kZstd: {
+            if (train_dict_size_ > 0) {
+                TrainDict();
+            }
+            size_t res = 0;
+            if (zstd_cdict_ != nullptr) {
+                res = ZSTD_compress_usingCDict(zstd_cctx_, compress_buf_, compress_buf_size_, buffer_, block_size_,
+                                               zstd_cdict_);
+            } else {
+                res = ZSTD_compressCCtx(zstd_cctx_, compress_buf_, compress_buf_size_, buffer_, block_size_,
+                                        FLAGS_snapshot_compress_level);
+            }
+            if (ZSTD_isError(res)) {
+                s = Status::InvalidRecord(Slice(ZSTD_getErrorName(res)));
+                PDLOG(WARNING, "write error, compress_type: %d, msg: %s", compress_type_, s.ToString().c_str());
+                return s;
+            }
+            compress_len = static_cast<int32_t>(res);
+            break;
+        }
+#endif
         default: {
             s = Status::InvalidRecord(Slice("unsupported compress type: " + compress_type_));
             PDLOG(WARNING, "write error, compress_type: %d, msg: %s", compress_type_, s.ToString().c_str());
@@ -302,6 +391,14 @@ CompressType Writer::GetCompressType(const std::string& compress_type) {
         return kZlib;
     } else if (compress_type == "snappy") {
         return kSnappy;
+    } else if (compress_type == "zstd") {
+#ifdef OPENMLDB_WITH_ZSTD
+        return kZstd;
+#else
+        // the reader decodes every block by the type in its header, so the file is still readable
+        PDLOG(WARNING, "zstd is not supported in this build, use snappy instead");
+        return kSnappy;
+#endif
     } else {
         return kNoCompress;
     }
@@ -24,6 +24,7 @@
 #include <stdint.h>
 
 #include <string>
+#include <vector>
 
 #include "base/slice.h"
 #include "log/status.h"
@@ -32,6 +33,9 @@
 
 using ::openmldb::base::Slice;
 
+struct ZSTD_CCtx_s;
+struct ZSTD_CDict_s;
+
 namespace openmldb {
 namespace log {
 
@@ -60,6 +64,16 @@ class Writer {
 
     CompressType GetCompressType(const std::string& compress_type);
 
+    // Compress the blocks with a zstd dictionary, it must be set before the first block is written
+    void SetCompressDict(const std::string& dict);
+
+    // Train a zstd dictionary of at most dict_size bytes from the records of the first block
+    inline void SetTrainDictSize(uint32_t dict_size) {
+        train_dict_size_ = (compress_type_ == kZstd && compress_dict_.empty()) ? dict_size : 0;
+    }
+
+    inline const std::string& GetCompressDict() const { return compress_dict_; }
+
  private:
     WritableFile* dest_;
     uint32_t block_offset_;  // Current offset in block
@@ -76,7 +90,16 @@ class Writer {
     char* buffer_;
     // buffer for compressed block
     char* compress_buf_;
+    uint32_t compress_buf_size_;
+    // sizes of the physical records in the first block, they are the samples of dict training
+    std::vector<size_t> sample_sizes_;
+    uint32_t train_dict_size_;
+    std::string compress_dict_;
+    ZSTD_CCtx_s* zstd_cctx_;
+    ZSTD_CDict_s* zstd_cdict_;
     Status CompressRecord();
+    void TrainDict();
+    void InitCompressBuffer();
     Status AppendInternal(WritableFile* wf, int leftover);
 
     Status EmitPhysicalRecord(RecordType type, const char* ptr, size_t length);
@@ -102,6 +125,10 @@ struct WriteHandle {
 
     Status EndLog() { return lw_->EndLog(); }
 
+    void SetTrainDictSize(uint32_t dict_size) { lw_->SetTrainDictSize(dict_size); }
+
+    const std::string& GetCompressDict() const { return lw_->GetCompressDict(); }
+
     uint64_t GetSize() { return wf_->GetSize(); }
 
     ~WriteHandle() {
@@ -21,12 +21,19 @@
 #include "log/sequential_file.h"
 
 #include <errno.h>
+#include <gflags/gflags.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
 
 #include "base/glog_wrapper.h"
 #include "base/slice.h"
 #include "log/status.h"
 
+DECLARE_bool(read_file_with_mmap);
+
 using ::openmldb::base::Slice;
 using ::openmldb::log::Status;
 
@@ -91,7 +98,126 @@ class PosixSequentialFile : public SequentialFile {
     }
 };
 
+class MmapSequentialFile : public SequentialFile {
+ private:
+    // reserve more address space than the file size, so that the appended data
+    // can be read without remapping every time
+    static constexpr uint64_t kMmapReserveSize = 64 * 1024 * 1024;
+
+    std::string filename_;
+    FILE* file_;
+    char* base_;
+    uint64_t map_size_;
+    // the mapping replaced by the last remap, the slices read before may still point into it
+    char* retired_base_;
+    uint64_t retired_size_;
+    uint64_t file_size_;
+    uint64_t pos_;
+
+    // the slices of the reads before the last one are not used any more once the reader moves on
+    void ReleaseRetired() {
+        if (retired_base_ != NULL) {
+            munmap(retired_base_, retired_size_);
+            retired_base_ = NULL;
+            retired_size_ = 0;
+        }
+    }
+
+    // refresh the file size and remap if the file has grown beyond the mapping
+    Status Refresh() {
+        struct stat st;
+        if (fstat(fileno(file_), &st) != 0) {
+            return Status::IOError(filename_, strerror(errno));
+        }
+        file_size_ = static_cast<uint64_t>(st.st_size);
+        if (file_size_ <= map_size_) {
+            return Status::OK();
+        }
+        uint64_t new_size = (file_size_ / kMmapReserveSize + 1) * kMmapReserveSize;
+        void* base = mmap(NULL, new_size, PROT_READ, MAP_SHARED, fileno(file_), 0);
+        if (base == MAP_FAILED) {
+            return Status::IOError(filename_, strerror(errno));
+        }
+        madvise(base, new_size, MADV_SEQUENTIAL);
+        // the old mapping is unmapped after the next read, skip or seek
+        ReleaseRetired();
+        retired_base_ = base_;
+        retired_size_ = map_size_;
+        base_ = reinterpret_cast<char*>(base);
+        map_size_ = new_size;
+        DEBUGLOG("mmap file %s with size %lu", filename_.c_str(), map_size_);
+        return Status::OK();
+    }
+
+ public:
+    MmapSequentialFile(const std::string& fname, FILE* f)
+        : filename_(fname),
+          file_(f),
+          base_(NULL),
+          map_size_(0),
+          retired_base_(NULL),
+          retired_size_(0),
+          file_size_(0),
+          pos_(0) {}
+
+    virtual ~MmapSequentialFile() {
+        ReleaseRetired();
+        if (base_ != NULL) {
+            munmap(base_, map_size_);
+        }
+        fclose(file_);
+    }
+
+    virtual Status Read(size_t n, Slice* result, char* scratch) {
+        ReleaseRetired();
+        if (pos_ + n > file_size_) {
+            Status s = Refresh();
+            if (!s.ok()) {
+                *result = Slice(scratch, 0);
+                return s;
+            }
+        }
+        if (pos_ >= file_size_) {
+            *result = Slice(scratch, 0);
+            return Status::OK();
+        }
+        size_t r = std::min(static_cast<uint64_t>(n), file_size_ - pos_);
+        *result = Slice(base_ + pos_, r);
+        pos_ += r;
+        return Status::OK();
+    }
+
+    virtual Status Skip(uint64_t n) {
+        ReleaseRetired();
+        pos_ += n;
+        return Status::OK();
+    }
+
+    virtual Status Tell(uint64_t* pos) {
+        if (pos == NULL) {
+            return Status::InvalidArgument("invalid pos arg");
+        }
+        *pos = pos_;
+        return Status::OK();
+    }
+
+    virtual Status Seek(uint64_t pos) {
+        ReleaseRetired();
+        pos_ = pos;
+        return Status::OK();
+    }
+};
+
 SequentialFile* NewSeqFile(const std::string& fname, FILE* f) { return new PosixSequentialFile(fname, f); }
 
+SequentialFile* NewMmapSeqFile(const std::string& fname, FILE* f) { return new MmapSequentialFile(fname, f); }
+
+SequentialFile* NewSeqFileByFlag(const std::string& fname, FILE* f) {
+    if (FLAGS_read_file_with_mmap) {
+        return NewMmapSeqFile(fname, f);
+    }
+    return NewSeqFile(fname, f);
+}
+
 }  // namespace log
 }  // namespace openmldb
@@ -66,6 +66,14 @@ class SequentialFile {
 
 SequentialFile* NewSeqFile(const std::string& fname, FILE* f);
 
+// The file is read through a read only mapping, the result of Read points into the
+// mapping instead of scratch, so the records which are not fragmented are not copied.
+// The mapping grows when the file is appended by others.
+SequentialFile* NewMmapSeqFile(const std::string& fname, FILE* f);
+
+// Create a mmap file if FLAGS_read_file_with_mmap is true, otherwise a buffered one
+SequentialFile* NewSeqFileByFlag(const std::string& fname, FILE* f);
+
 }  // namespace log
 }  // namespace openmldb
 #endif  // SRC_LOG_SEQUENTIAL_FILE_H_
@@ -36,6 +36,7 @@
 DECLARE_int32(binlog_single_file_max_size);
 DECLARE_int32(binlog_name_length);
 DECLARE_string(zk_cluster);
+DECLARE_int32(follower_read_max_idle_ms);
 
 namespace openmldb {
 namespace replica {
@@ -59,7 +60,11 @@ LogReplicator::LogReplicator(uint32_t tid, uint32_t pid, const std::string& path
       term_(0),
       mu_(),
       cv_(),
-      wmu_() {
+      wmu_(),
+      follower_apply_mu_(),
+      applied_offset_(0),
+      leader_offset_(UINT64_MAX),
+      leader_contact_time_(0) {
     binlog_index_ = 0;
     snapshot_log_part_index_.store(-1, std::memory_order_relaxed);
     snapshot_last_offset_.store(0, std::memory_order_relaxed);
@@ -83,6 +88,35 @@ void LogReplicator::SetRole(const ReplicatorRole& role) {
     role_ = role;
 }
 
+void LogReplicator::SetFollowerOffsets(uint64_t applied_offset, uint64_t leader_offset, bool reset) {
+    applied_offset_.store(applied_offset, std::memory_order_relaxed);
+    leader_contact_time_.store(::baidu::common::timer::get_micros() / 1000, std::memory_order_relaxed);
+    if (reset) {
+        leader_offset_.store(leader_offset, std::memory_order_relaxed);
+        return;
+    }
+    // the batches of the pipelined leader may be sent with an older offset
+    uint64_t cur = leader_offset_.load(std::memory_order_relaxed);
+    while ((cur == UINT64_MAX || cur < leader_offset) &&
+           !leader_offset_.compare_exchange_weak(cur, leader_offset, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LogReplicator::GetFollowerLag() {
+    uint64_t leader_offset = leader_offset_.load(std::memory_order_relaxed);
+    if (leader_offset == UINT64_MAX) {
+        return UINT64_MAX;
+    }
+    // the offset of a leader which is gone or partitioned away never increases
+    if (FLAGS_follower_read_max_idle_ms > 0 &&
+        ::baidu::common::timer::get_micros() / 1000 >
+            leader_contact_time_.load(std::memory_order_relaxed) + FLAGS_follower_read_max_idle_ms) {
+        return UINT64_MAX;
+    }
+    uint64_t applied_offset = applied_offset_.load(std::memory_order_relaxed);
+    return leader_offset > applied_offset ? leader_offset - applied_offset : 0;
+}
+
 void LogReplicator::SyncToDisk() {
     std::lock_guard<std::mutex> lock(wmu_);
     if (wh_ != NULL) {
@@ -206,7 +240,7 @@ bool LogReplicator::Recover() {
             PDLOG(WARNING, "fail to get offset from file %s", full_path.c_str());
             continue;
         }
-        ok = entry.ParseFromString(record.ToString());
+        ok = entry.ParseFromArray(record.data(), record.size());
         if (!ok) {
             PDLOG(WARNING, "fail to parse log entry %s ", ::openmldb::base::DebugString(record.ToString()).c_str());
             return false;
@@ -412,6 +446,21 @@ void LogReplicator::GetReplicateInfo(std::map<std::string, uint64_t>& info_map)
     }
 }
 
+void LogReplicator::GetFollowerLagStatus(::openmldb::api::TableStatus* status) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    if (role_ != kLeaderNode) {
+        return;
+    }
+    for (const auto& node : nodes_) {
+        ::openmldb::api::FollowerLagStatus* lag = status->add_follower_lag();
+        lag->set_endpoint(node->GetEndPoint());
+        lag->set_offset(node->GetLastSyncOffset());
+        lag->set_lag_entries(node->GetLagEntries());
+        lag->set_lag_bytes(node->GetLagBytes());
+        lag->set_inflight_batch_cnt(node->GetInflightBatchCnt());
+    }
+}
+
 bool LogReplicator::DelAllReplicateNode() {
     std::vector<std::shared_ptr<ReplicateNode>> copied_nodes = nodes_;
     {
@@ -435,6 +484,28 @@ bool LogReplicator::DelAllReplicateNode() {
 
 bool LogReplicator::AppendEntry(LogEntry& entry, ::google::protobuf::Closure* done) {
     std::lock_guard<std::mutex> lock(wmu_);
+    std::string buffer;
+    if (!AppendEntryUnLock(&entry, &buffer)) {
+        return false;
+    }
+    if (done) {
+        done->Run();
+    }
+    return true;
+}
+
+bool LogReplicator::AppendEntries(std::vector<LogEntry>* entries) {
+    std::lock_guard<std::mutex> lock(wmu_);
+    std::string buffer;
+    for (auto& entry : *entries) {
+        if (!AppendEntryUnLock(&entry, &buffer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogReplicator::AppendEntryUnLock(LogEntry* entry, std::string* buffer) {
     if (wh_ == NULL || wh_->GetSize() / (1024 * 1024) > (uint32_t)FLAGS_binlog_single_file_max_size) {
         bool ok = RollWLogFile();
         if (!ok) {
@@ -442,10 +513,10 @@ bool LogReplicator::AppendEntry(LogEntry& entry, ::google::protobuf::Closure* do
         }
     }
     uint64_t cur_offset = log_offset_.load(std::memory_order_relaxed);
-    entry.set_log_index(1 + cur_offset);
-    std::string buffer;
-    entry.SerializeToString(&buffer);
-    ::openmldb::base::Slice slice(buffer);
+    entry->set_log_index(1 + cur_offset);
+    buffer->clear();
+    entry->SerializeToString(buffer);
+    ::openmldb::base::Slice slice(*buffer);
     ::openmldb::log::Status status = wh_->Write(slice);
     if (!status.ok()) {
         PDLOG(WARNING, "fail to write replication log in dir %s for %s", path_.c_str(), status.ToString().c_str());
@@ -456,9 +527,6 @@ bool LogReplicator::AppendEntry(LogEntry& entry, ::google::protobuf::Closure* do
                                      // sync to remote replica
         follower_offset_.store(cur_offset + 1, std::memory_order_relaxed);
     }
-    if (done) {
-        done->Run();
-    }
     return true;
 }
 
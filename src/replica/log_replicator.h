@@ -66,6 +66,9 @@ class LogReplicator {
     // the master node append entry
     bool AppendEntry(::openmldb::api::LogEntry& entry, ::google::protobuf::Closure* done = nullptr);  // NOLINT
 
+    // the master node append a batch of entries under one lock, the log indexes of entries are continuous
+    bool AppendEntries(std::vector<::openmldb::api::LogEntry>* entries);
+
     //  data to slave nodes
     void Notify();
     // recover logs meta
@@ -84,6 +87,8 @@ class LogReplicator {
 
     void GetReplicateInfo(std::map<std::string, uint64_t>& info_map);  // NOLINT
 
+    void GetFollowerLagStatus(::openmldb::api::TableStatus* status);
+
     void MatchLogOffset();
 
     void ReplicateToNode(const std::string& endpoint);
@@ -110,9 +115,23 @@ class LogReplicator {
 
     const std::string& GetLogPath() {return log_path_;}
 
+    // the pipelined leader may send several AppendEntries concurrently, the follower applies them one by one
+    bthread::Mutex* GetFollowerApplyMutex() { return &follower_apply_mu_; }
+
+    // the follower sets them after the entries from the leader are put into the table. The offset of the leader only
+    // increases unless `reset`, which is set when a leader starts to sync with the follower
+    void SetFollowerOffsets(uint64_t applied_offset, uint64_t leader_offset, bool reset);
+
+    // the entries which the follower is behind the leader, UINT64_MAX if no offset of the leader is known or the
+    // follower hasn't heard from the leader for follower_read_max_idle_ms
+    uint64_t GetFollowerLag();
+
  private:
     bool OpenSeqFile(const std::string& path, SequentialFile** sf);
 
+    // write one entry to the binlog, wmu_ must be held
+    bool AppendEntryUnLock(::openmldb::api::LogEntry* entry, std::string* buffer);
+
  private:
     // the replicator root data path
     uint32_t tid_;
@@ -139,6 +158,11 @@ class LogReplicator {
     std::atomic<uint64_t> snapshot_last_offset_;
 
     std::mutex wmu_;
+    bthread::Mutex follower_apply_mu_;
+    std::atomic<uint64_t> applied_offset_;
+    std::atomic<uint64_t> leader_offset_;
+    // the time in milliseconds when the follower heard from the leader last
+    std::atomic<uint64_t> leader_contact_time_;
 };
 
 }  // namespace replica
@@ -47,7 +47,10 @@ using ::openmldb::storage::Table;
 using ::openmldb::storage::TableIterator;
 using ::openmldb::storage::Ticket;
 
+DECLARE_int32(binlog_coffee_time);
 DECLARE_int32(binlog_single_file_max_size);
+DECLARE_int32(binlog_sync_batch_max_bytes);
+DECLARE_int32(binlog_sync_max_inflight);
 
 namespace openmldb {
 namespace replica {
@@ -85,7 +88,19 @@ class MockTabletImpl : public ::openmldb::api::TabletServer {
 
     void AppendEntries(RpcController* controller, const ::openmldb::api::AppendEntriesRequest* request,
                        ::openmldb::api::AppendEntriesResponse* response, Closure* done) {
+        if (request->entries_size() > 0 && delay_first_batch_.exchange(false)) {
+            // the later batches overtake this one
+            bthread_usleep(300 * 1000);
+        }
+        std::lock_guard<bthread::Mutex> lock(*replicator_.GetFollowerApplyMutex());
         uint64_t last_log_offset = replicator_.GetOffset();
+        if (request->pre_log_index() > last_log_offset) {
+            response->set_code(::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator);
+            response->set_msg("pre log index mismatch");
+            response->set_log_offset(last_log_offset);
+            done->Run();
+            return;
+        }
         for (int32_t i = 0; i < request->entries_size(); i++) {
             if (request->entries(i).log_index() <= last_log_offset) {
                 continue;
@@ -105,6 +120,8 @@ class MockTabletImpl : public ::openmldb::api::TabletServer {
 
     void SetMode(bool follower) { follower_.store(follower); }
 
+    void DelayFirstBatch() { delay_first_batch_.store(true); }
+
     bool GetMode() { return follower_.load(std::memory_order_relaxed); }
 
  private:
@@ -114,6 +131,7 @@ class MockTabletImpl : public ::openmldb::api::TabletServer {
     std::map<std::string, std::string> real_ep_map_;
     LogReplicator replicator_;
     std::atomic<bool> follower_;
+    std::atomic<bool> delay_first_batch_{false};
 };
 
 bool ReceiveEntry(const ::openmldb::api::LogEntry& entry) { return true; }
@@ -549,6 +567,107 @@ TEST_F(LogReplicatorTest, LeaderAndFollower) {
     }
 }
 
+TEST_F(LogReplicatorTest, PipelinedSync) {
+    // small batches so that several of them are inflight at the same time
+    FLAGS_binlog_sync_batch_max_bytes = 256;
+    FLAGS_binlog_sync_max_inflight = 4;
+    absl::Cleanup reset_flags = []() {
+        FLAGS_binlog_sync_batch_max_bytes = 1024 * 1024;
+        FLAGS_binlog_sync_max_inflight = 4;
+    };
+    brpc::ServerOptions options;
+    brpc::Server server0;
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx", 0));
+    std::shared_ptr<MemTable> t7 =
+        std::make_shared<MemTable>("test", 1, 1, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+    t7->Init();
+    std::string follower_addr = "127.0.0.1:18530";
+    {
+        std::string folder = "/tmp/" + GenRand() + "/";
+        MockTabletImpl* follower = new MockTabletImpl(kFollowerNode, folder, g_endpoints, t7);
+        ASSERT_TRUE(follower->Init());
+        ASSERT_EQ(0, server0.AddService(follower, brpc::SERVER_OWNS_SERVICE));
+        ASSERT_EQ(0, server0.Start(follower_addr.c_str(), &options));
+    }
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator leader(1, 1, folder, g_endpoints, kLeaderNode);
+    ASSERT_TRUE(leader.Init());
+    std::map<std::string, std::string> map;
+    map.insert(std::make_pair(follower_addr, ""));
+    ASSERT_EQ(0, leader.AddReplicateNode(map));
+    int num = 1000;
+    for (int i = 0; i < num; i++) {
+        ::openmldb::api::LogEntry entry;
+        ::openmldb::test::AddDimension(0, "test_pk", &entry);
+        entry.set_value(::openmldb::test::EncodeKV("test_pk", "value" + std::to_string(i)));
+        entry.set_ts(i + 1);
+        ASSERT_TRUE(leader.AppendEntry(entry));
+    }
+    leader.Notify();
+    sleep(3);
+    ::openmldb::api::TableStatus status;
+    leader.GetFollowerLagStatus(&status);
+    ASSERT_EQ(1, status.follower_lag_size());
+    ASSERT_EQ(follower_addr, status.follower_lag(0).endpoint());
+    ASSERT_EQ(num, (int64_t)status.follower_lag(0).offset());
+    ASSERT_EQ(0u, status.follower_lag(0).lag_entries());
+    ASSERT_EQ(0u, status.follower_lag(0).lag_bytes());
+    leader.DelAllReplicateNode();
+    ASSERT_EQ(num, (int64_t)t7->GetRecordCnt());
+}
+
+TEST_F(LogReplicatorTest, PipelinedSyncReordered) {
+    FLAGS_binlog_sync_batch_max_bytes = 256;
+    FLAGS_binlog_sync_max_inflight = 4;
+    // a reordered batch is resent at once, the sync should not wait for the coffee time
+    FLAGS_binlog_coffee_time = 10 * 1000;
+    absl::Cleanup reset_flags = []() {
+        FLAGS_binlog_sync_batch_max_bytes = 1024 * 1024;
+        FLAGS_binlog_sync_max_inflight = 4;
+        FLAGS_binlog_coffee_time = 1000;
+    };
+    brpc::ServerOptions options;
+    brpc::Server server0;
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx", 0));
+    std::shared_ptr<MemTable> t8 =
+        std::make_shared<MemTable>("test", 1, 1, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+    t8->Init();
+    std::string follower_addr = "127.0.0.1:18531";
+    {
+        std::string folder = "/tmp/" + GenRand() + "/";
+        MockTabletImpl* follower = new MockTabletImpl(kFollowerNode, folder, g_endpoints, t8);
+        ASSERT_TRUE(follower->Init());
+        follower->DelayFirstBatch();
+        ASSERT_EQ(0, server0.AddService(follower, brpc::SERVER_OWNS_SERVICE));
+        ASSERT_EQ(0, server0.Start(follower_addr.c_str(), &options));
+    }
+    std::string folder = "/tmp/" + GenRand() + "/";
+    LogReplicator leader(1, 1, folder, g_endpoints, kLeaderNode);
+    ASSERT_TRUE(leader.Init());
+    int num = 100;
+    for (int i = 0; i < num; i++) {
+        ::openmldb::api::LogEntry entry;
+        ::openmldb::test::AddDimension(0, "test_pk", &entry);
+        entry.set_value(::openmldb::test::EncodeKV("test_pk", "value" + std::to_string(i)));
+        entry.set_ts(i + 1);
+        ASSERT_TRUE(leader.AppendEntry(entry));
+    }
+    std::map<std::string, std::string> map;
+    map.insert(std::make_pair(follower_addr, ""));
+    ASSERT_EQ(0, leader.AddReplicateNode(map));
+    leader.Notify();
+    sleep(3);
+    ::openmldb::api::TableStatus status;
+    leader.GetFollowerLagStatus(&status);
+    ASSERT_EQ(1, status.follower_lag_size());
+    ASSERT_EQ(num, (int64_t)status.follower_lag(0).offset());
+    ASSERT_EQ(0u, status.follower_lag(0).lag_entries());
+    leader.DelAllReplicateNode();
+    ASSERT_EQ(num, (int64_t)t8->GetRecordCnt());
+}
+
 TEST_F(LogReplicatorTest, Leader_Remove_local_follower) {
     brpc::ServerOptions options;
     brpc::Server server0;
@@ -21,9 +21,15 @@
 #include <algorithm>
 
 #include "base/glog_wrapper.h"
+#include "base/status.h"
+#include "brpc/callback.h"
 #include "base/strings.h"
+#include "common/timer.h"
 
 DECLARE_int32(binlog_sync_batch_size);
+DECLARE_int32(binlog_sync_batch_max_bytes);
+DECLARE_int32(binlog_sync_max_inflight);
+DECLARE_string(binlog_sync_compression);
 DECLARE_int32(binlog_sync_wait_time);
 DECLARE_int32(binlog_coffee_time);
 DECLARE_int32(binlog_match_logoffset_interval);
@@ -31,6 +37,7 @@ DECLARE_int32(request_max_retry);
 DECLARE_int32(request_timeout_ms);
 DECLARE_string(zk_cluster);
 DECLARE_uint32(go_back_max_try_cnt);
+DECLARE_int32(follower_read_max_idle_ms);
 
 namespace openmldb {
 namespace replica {
@@ -46,19 +53,35 @@ static void* RunSyncTask(void* args) {
     return NULL;
 }
 
+// the entries of a batch are similar rows, compress the whole request instead of every entry
+static brpc::CompressType GetSyncCompressType() {
+    if (FLAGS_binlog_sync_compression == "snappy") {
+        return brpc::COMPRESS_TYPE_SNAPPY;
+    } else if (FLAGS_binlog_sync_compression == "zlib") {
+        return brpc::COMPRESS_TYPE_ZLIB;
+    }
+    return brpc::COMPRESS_TYPE_NONE;
+}
+
 ReplicateNode::ReplicateNode(const std::string& point, LogParts* logs, const std::string& log_path, uint32_t tid,
                              uint32_t pid, std::atomic<uint64_t>* term, std::atomic<uint64_t>* leader_log_offset,
                              bthread::Mutex* mu, bthread::ConditionVariable* cv, bool rep_follower,
                              std::atomic<uint64_t>* follower_offset, const std::string& real_point)
     : log_reader_(logs, log_path, false),
       cache_(),
+      inflight_(),
       endpoint_(point),
       last_sync_offset_(0),
+      last_send_time_(0),
+      read_offset_(0),
+      inflight_bytes_(0),
+      inflight_cnt_(0),
+      avg_entry_bytes_(0),
       log_matched_(false),
       tid_(tid),
       pid_(pid),
       term_(term),
-      rpc_client_(point),
+      rpc_client_(real_point.empty() ? point : real_point),
       worker_(),
       leader_log_offset_(leader_log_offset),
       is_running_(false),
@@ -66,11 +89,7 @@ ReplicateNode::ReplicateNode(const std::string& point, LogParts* logs, const std
       cv_(cv),
       go_back_cnt_(0),
       rep_node_(rep_follower),
-      follower_offset_(follower_offset) {
-    if (!real_point.empty()) {
-        rpc_client_ = openmldb::RpcClient<::openmldb::api::TabletServer_Stub>(real_point);
-    }
-}
+      follower_offset_(follower_offset) {}
 
 int ReplicateNode::Init() {
     int ok = rpc_client_.Init();
@@ -114,10 +133,12 @@ void ReplicateNode::SyncData() {
             bthread_usleep(coffee_time * 1000);
             coffee_time = 0;
         }
+        bool heartbeat = false;
         {
             std::unique_lock<bthread::Mutex> lock(*mu_);
             // no new data append and wait
-            while (last_sync_offset_ >= leader_log_offset_->load(std::memory_order_relaxed)) {
+            while (last_sync_offset_.load(std::memory_order_relaxed) >=
+                   leader_log_offset_->load(std::memory_order_relaxed)) {
                 cv_->wait_for(lock, FLAGS_binlog_sync_wait_time * 1000);
                 if (!is_running_.load(std::memory_order_relaxed)) {
                     PDLOG(INFO,
@@ -126,8 +147,16 @@ void ReplicateNode::SyncData() {
                           endpoint_.c_str(), tid_, pid_);
                     return;
                 }
+                if (NeedHeartbeat()) {
+                    heartbeat = true;
+                    break;
+                }
             }
         }
+        if (heartbeat) {
+            SendHeartbeat();
+            continue;
+        }
         int ret;
         if (rep_node_.load(std::memory_order_relaxed)) {
             ret = SyncData(follower_offset_->load(std::memory_order_relaxed));
@@ -136,8 +165,12 @@ void ReplicateNode::SyncData() {
         }
         if (ret == 1) {
             coffee_time = FLAGS_binlog_coffee_time;
+        } else if (ret == 2) {
+            // the record has not been flushed completely, it will be ready soon
+            coffee_time = FLAGS_binlog_sync_wait_time;
         }
     }
+    WaitInflight();
     PDLOG(INFO, "replicate log to endpoint %s for table #tid %u #pid %u exist", endpoint_.c_str(), tid_, pid_);
 }
 
@@ -147,9 +180,9 @@ bool ReplicateNode::IsLogMatched() { return log_matched_; }
 
 std::string ReplicateNode::GetEndPoint() { return endpoint_; }
 
-uint64_t ReplicateNode::GetLastSyncOffset() { return last_sync_offset_; }
+uint64_t ReplicateNode::GetLastSyncOffset() { return last_sync_offset_.load(std::memory_order_relaxed); }
 
-void ReplicateNode::SetLastSyncOffset(uint64_t offset) { last_sync_offset_ = offset; }
+void ReplicateNode::SetLastSyncOffset(uint64_t offset) { last_sync_offset_.store(offset, std::memory_order_relaxed); }
 
 int ReplicateNode::MatchLogOffsetFromNode() {
     ::openmldb::api::AppendEntriesRequest request;
@@ -157,14 +190,18 @@ int ReplicateNode::MatchLogOffsetFromNode() {
     request.set_pid(pid_);
     request.set_term(term_->load(std::memory_order_relaxed));
     request.set_pre_log_index(0);
+    request.set_leader_log_offset(GetLeaderOffset());
     ::openmldb::api::AppendEntriesResponse response;
     bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
                                        FLAGS_request_timeout_ms, FLAGS_request_max_retry);
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
     if (ret && response.code() == 0) {
-        last_sync_offset_ = response.log_offset();
+        uint64_t log_offset = response.log_offset();
+        last_sync_offset_.store(log_offset, std::memory_order_relaxed);
+        read_offset_ = log_offset;
         log_matched_ = true;
-        log_reader_.SetOffset(last_sync_offset_);
-        PDLOG(INFO, "match node %s log offset %lu for table tid %u pid %u", endpoint_.c_str(), last_sync_offset_, tid_,
+        log_reader_.SetOffset(log_offset);
+        PDLOG(INFO, "match node %s log offset %lu for table tid %u pid %u", endpoint_.c_str(), log_offset, tid_,
               pid_);
         return 0;
     }
@@ -172,85 +209,42 @@ int ReplicateNode::MatchLogOffsetFromNode() {
     return -1;
 }
 
-int ReplicateNode::SyncData(uint64_t log_offset) {
-    DEBUGLOG("node[%s] offset[%lu] log offset[%lu]", endpoint_.c_str(), last_sync_offset_, log_offset);
-    if (log_offset <= last_sync_offset_) {
-        PDLOG(WARNING, "log offset [%lu] le last sync offset [%lu], do nothing", log_offset, last_sync_offset_);
-        return 1;
+int ReplicateNode::ReadBatch(uint64_t log_offset, ::openmldb::api::AppendEntriesRequest* request, uint64_t* bytes) {
+    request->set_tid(tid_);
+    request->set_pid(pid_);
+    request->set_pre_log_index(read_offset_);
+    request->set_leader_log_offset(GetLeaderOffset());
+    if (!FLAGS_zk_cluster.empty()) {
+        request->set_term(term_->load(std::memory_order_relaxed));
     }
-    ::openmldb::api::AppendEntriesRequest request;
-    ::openmldb::api::AppendEntriesResponse response;
-    uint64_t sync_log_offset = last_sync_offset_;
-    bool request_from_cache = false;
-    bool need_wait = false;
-    if (cache_.size() > 0) {
-        request_from_cache = true;
-        request = cache_[0];
-        if (request.entries_size() <= 0) {
-            cache_.clear();
-            PDLOG(WARNING, "empty append entry request from node %s cache", endpoint_.c_str());
-            return -1;
-        }
-        const ::openmldb::api::LogEntry& entry = request.entries(request.entries_size() - 1);
-        if (entry.log_index() <= last_sync_offset_) {
-            DEBUGLOG("duplicate log index from node %s cache", endpoint_.c_str());
-            cache_.clear();
-            return -1;
-        }
-        PDLOG(INFO, "use cached request to send last index %lu. tid %u pid %u", entry.log_index(), tid_, pid_);
-        sync_log_offset = entry.log_index();
-    } else {
-        request.set_tid(tid_);
-        request.set_pid(pid_);
-        request.set_pre_log_index(last_sync_offset_);
-        if (!FLAGS_zk_cluster.empty()) {
-            request.set_term(term_->load(std::memory_order_relaxed));
-        }
-        uint32_t batchSize = log_offset - last_sync_offset_;
-        batchSize = std::min(batchSize, (uint32_t)FLAGS_binlog_sync_batch_size);
-        for (uint64_t i = 0; i < batchSize;) {
-            std::string buffer;
-            ::openmldb::base::Slice record;
-            ::openmldb::log::Status status = log_reader_.ReadNextRecord(&record, &buffer);
-            if (status.ok()) {
-                ::openmldb::api::LogEntry* entry = request.add_entries();
-                if (!entry->ParseFromString(record.ToString())) {
-                    PDLOG(WARNING, "bad protobuf format %s size %ld. tid %u pid %u",
-                          ::openmldb::base::DebugString(record.ToString()).c_str(), record.ToString().size(), tid_,
-                          pid_);
-                    request.mutable_entries()->RemoveLast();
-                    break;
-                }
-                DEBUGLOG("entry val %s log index %lld", entry->value().c_str(), entry->log_index());
-                if (entry->log_index() <= sync_log_offset) {
-                    DEBUGLOG("skip duplicate log offset %lld", entry->log_index());
-                    request.mutable_entries()->RemoveLast();
-                    continue;
-                }
-                // the log index should incr by 1
-                if ((sync_log_offset + 1) != entry->log_index()) {
-                    PDLOG(WARNING, "log missing expect offset %lu but %ld. tid %u pid %u", sync_log_offset + 1,
-                          entry->log_index(), tid_, pid_);
-                    request.mutable_entries()->RemoveLast();
-                    if (go_back_cnt_ > FLAGS_go_back_max_try_cnt) {
-                        log_reader_.GoBackToStart();
-                        go_back_cnt_ = 0;
-                        PDLOG(WARNING, "go back to start. tid %u pid %u endpoint %s", tid_, pid_, endpoint_.c_str());
-                    } else {
-                        log_reader_.GoBackToLastBlock();
-                        go_back_cnt_++;
-                    }
-                    need_wait = true;
-                    break;
-                }
-                sync_log_offset = entry->log_index();
-            } else if (status.IsWaitRecord()) {
-                DEBUGLOG("got a coffee time for[%s]", endpoint_.c_str());
-                need_wait = true;
+    uint64_t batch_size = log_offset - read_offset_;
+    batch_size = std::min(batch_size, (uint64_t)FLAGS_binlog_sync_batch_size);
+    uint64_t max_bytes = FLAGS_binlog_sync_batch_max_bytes > 0 ? FLAGS_binlog_sync_batch_max_bytes : UINT64_MAX;
+    *bytes = 0;
+    int ret = 0;
+    for (uint64_t i = 0; i < batch_size && *bytes < max_bytes;) {
+        std::string buffer;
+        ::openmldb::base::Slice record;
+        ::openmldb::log::Status status = log_reader_.ReadNextRecord(&record, &buffer);
+        if (status.ok()) {
+            ::openmldb::api::LogEntry* entry = request->add_entries();
+            if (!entry->ParseFromArray(record.data(), record.size())) {
+                PDLOG(WARNING, "bad protobuf format %s size %ld. tid %u pid %u",
+                      ::openmldb::base::DebugString(record.ToString()).c_str(), record.size(), tid_, pid_);
+                request->mutable_entries()->RemoveLast();
                 break;
-            } else if (status.IsInvalidRecord()) {
-                DEBUGLOG("fail to get record. %s. tid %u pid %u", status.ToString().c_str(), tid_, pid_);
-                need_wait = true;
+            }
+            DEBUGLOG("entry val %s log index %lld", entry->value().c_str(), entry->log_index());
+            if (entry->log_index() <= read_offset_) {
+                DEBUGLOG("skip duplicate log offset %lld", entry->log_index());
+                request->mutable_entries()->RemoveLast();
+                continue;
+            }
+            // the log index should incr by 1
+            if ((read_offset_ + 1) != entry->log_index()) {
+                PDLOG(WARNING, "log missing expect offset %lu but %ld. tid %u pid %u", read_offset_ + 1,
+                      entry->log_index(), tid_, pid_);
+                request->mutable_entries()->RemoveLast();
                 if (go_back_cnt_ > FLAGS_go_back_max_try_cnt) {
                     log_reader_.GoBackToStart();
                     go_back_cnt_ = 0;
@@ -259,43 +253,228 @@ int ReplicateNode::SyncData(uint64_t log_offset) {
                     log_reader_.GoBackToLastBlock();
                     go_back_cnt_++;
                 }
+                ret = 1;
                 break;
-            } else {
-                PDLOG(WARNING, "fail to get record: %s. tid %u pid %u", status.ToString().c_str(), tid_, pid_);
-                need_wait = true;
-                break;
-            }
-            i++;
-            go_back_cnt_ = 0;
-        }
-    }
-    if (request.entries_size() > 0) {
-        bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
-                                           FLAGS_request_timeout_ms, FLAGS_request_max_retry);
-        if (ret && response.code() == 0) {
-            DEBUGLOG("sync log to node[%s] to offset %lld", endpoint_.c_str(), sync_log_offset);
-            last_sync_offset_ = sync_log_offset;
-            if (!rep_node_.load(std::memory_order_relaxed) &&
-                (last_sync_offset_ > follower_offset_->load(std::memory_order_relaxed))) {
-                follower_offset_->store(last_sync_offset_, std::memory_order_relaxed);
             }
-            if (request_from_cache) {
-                cache_.clear();
+            read_offset_ = entry->log_index();
+            *bytes += record.size();
+        } else if (status.IsWaitRecord()) {
+            DEBUGLOG("got a coffee time for[%s]", endpoint_.c_str());
+            ret = 2;
+            break;
+        } else if (status.IsInvalidRecord()) {
+            DEBUGLOG("fail to get record. %s. tid %u pid %u", status.ToString().c_str(), tid_, pid_);
+            ret = 1;
+            if (go_back_cnt_ > FLAGS_go_back_max_try_cnt) {
+                log_reader_.GoBackToStart();
+                go_back_cnt_ = 0;
+                PDLOG(WARNING, "go back to start. tid %u pid %u endpoint %s", tid_, pid_, endpoint_.c_str());
+            } else {
+                log_reader_.GoBackToLastBlock();
+                go_back_cnt_++;
             }
+            break;
         } else {
-            if (!request_from_cache) {
-                cache_.push_back(request);
-            }
-            need_wait = true;
-            PDLOG(WARNING, "fail to sync log to node %s. tid %u pid %u", endpoint_.c_str(), tid_, pid_);
+            PDLOG(WARNING, "fail to get record: %s. tid %u pid %u", status.ToString().c_str(), tid_, pid_);
+            ret = 1;
+            break;
         }
+        i++;
+        go_back_cnt_ = 0;
+    }
+    if (request->entries_size() > 0) {
+        // moving average of the entry size, used to estimate lag bytes
+        uint64_t avg = *bytes / request->entries_size();
+        uint64_t old_avg = avg_entry_bytes_.load(std::memory_order_relaxed);
+        avg_entry_bytes_.store(old_avg == 0 ? avg : (old_avg * 7 + avg) / 8, std::memory_order_relaxed);
     }
-    if (need_wait) {
+    return ret;
+}
+
+int ReplicateNode::SyncCachedData() {
+    ::openmldb::api::AppendEntriesRequest& request = cache_.front();
+    if (request.entries_size() <= 0) {
+        cache_.clear();
+        PDLOG(WARNING, "empty append entry request from node %s cache", endpoint_.c_str());
         return 1;
     }
+    uint64_t sync_log_offset = request.entries(request.entries_size() - 1).log_index();
+    if (sync_log_offset <= last_sync_offset_.load(std::memory_order_relaxed)) {
+        DEBUGLOG("duplicate log index from node %s cache", endpoint_.c_str());
+        cache_.erase(cache_.begin());
+        return 0;
+    }
+    PDLOG(INFO, "use cached request to send last index %lu. tid %u pid %u", sync_log_offset, tid_, pid_);
+    ::openmldb::api::AppendEntriesResponse response;
+    bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
+                                       FLAGS_request_timeout_ms, FLAGS_request_max_retry);
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
+    if (!ret || response.code() != 0) {
+        PDLOG(WARNING, "fail to sync log to node %s. tid %u pid %u", endpoint_.c_str(), tid_, pid_);
+        return 1;
+    }
+    last_sync_offset_.store(sync_log_offset, std::memory_order_relaxed);
+    if (!rep_node_.load(std::memory_order_relaxed) &&
+        (sync_log_offset > follower_offset_->load(std::memory_order_relaxed))) {
+        follower_offset_->store(sync_log_offset, std::memory_order_relaxed);
+    }
+    cache_.erase(cache_.begin());
     return 0;
 }
 
+void ReplicateNode::WaitInflight() {
+    for (auto& batch : inflight_) {
+        brpc::Join(batch->cntl.call_id());
+    }
+    inflight_.clear();
+    inflight_bytes_.store(0, std::memory_order_relaxed);
+    inflight_cnt_.store(0, std::memory_order_relaxed);
+}
+
+void ReplicateNode::SendBatch(const std::shared_ptr<InflightBatch>& batch, bool front) {
+    batch->cntl.set_log_id(batch->end_offset);
+    batch->cntl.set_timeout_ms(FLAGS_request_timeout_ms);
+    batch->cntl.set_max_retry(FLAGS_request_max_retry);
+    batch->cntl.set_request_compress_type(GetSyncCompressType());
+    rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &batch->cntl, &batch->request,
+                            &batch->response, brpc::DoNothing());
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
+    if (front) {
+        inflight_.push_front(batch);
+    } else {
+        inflight_.push_back(batch);
+    }
+    inflight_bytes_.fetch_add(batch->bytes, std::memory_order_relaxed);
+    inflight_cnt_.store(inflight_.size(), std::memory_order_relaxed);
+}
+
+int ReplicateNode::SyncData(uint64_t log_offset) {
+    uint64_t last_sync_offset = last_sync_offset_.load(std::memory_order_relaxed);
+    DEBUGLOG("node[%s] offset[%lu] read offset[%lu] log offset[%lu]", endpoint_.c_str(), last_sync_offset,
+             read_offset_, log_offset);
+    if (!cache_.empty()) {
+        // the requests failed before should be resent in order
+        return SyncCachedData();
+    }
+    if (log_offset <= last_sync_offset) {
+        PDLOG(WARNING, "log offset [%lu] le last sync offset [%lu], do nothing", log_offset, last_sync_offset);
+        return 1;
+    }
+    uint32_t max_inflight = FLAGS_binlog_sync_max_inflight > 0 ? FLAGS_binlog_sync_max_inflight : 1;
+    int read_ret = 0;
+    // fill the window, the follower rejects a batch whose pre_log_index is beyond its offset
+    while (inflight_.size() < max_inflight && read_offset_ < log_offset) {
+        std::shared_ptr<InflightBatch> batch = std::make_shared<InflightBatch>();
+        read_ret = ReadBatch(log_offset, &batch->request, &batch->bytes);
+        if (batch->request.entries_size() <= 0) {
+            break;
+        }
+        batch->end_offset = read_offset_;
+        SendBatch(batch, false);
+        if (read_ret != 0) {
+            break;
+        }
+    }
+    if (inflight_.empty()) {
+        return read_ret == 0 ? 1 : read_ret;
+    }
+    // the batches are acked in order, the later ones keep flowing while waiting for the oldest one
+    std::shared_ptr<InflightBatch> batch = inflight_.front();
+    inflight_.pop_front();
+    brpc::Join(batch->cntl.call_id());
+    inflight_bytes_.fetch_sub(batch->bytes, std::memory_order_relaxed);
+    inflight_cnt_.store(inflight_.size(), std::memory_order_relaxed);
+    if (!batch->cntl.Failed() && batch->response.code() == 0) {
+        DEBUGLOG("sync log to node[%s] to offset %lld", endpoint_.c_str(), batch->end_offset);
+        last_sync_offset_.store(batch->end_offset, std::memory_order_relaxed);
+        if (!rep_node_.load(std::memory_order_relaxed) &&
+            (batch->end_offset > follower_offset_->load(std::memory_order_relaxed))) {
+            follower_offset_->store(batch->end_offset, std::memory_order_relaxed);
+        }
+        if (read_ret == 2 && inflight_.empty()) {
+            return 2;
+        }
+        return read_ret == 1 ? 1 : 0;
+    }
+    if (!batch->cntl.Failed() && !batch->resent &&
+        batch->response.code() == ::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator &&
+        batch->response.has_log_offset() && batch->response.log_offset() < batch->request.pre_log_index() &&
+        batch->request.pre_log_index() <= last_sync_offset_.load(std::memory_order_relaxed)) {
+        // the batch overtook the one before it, which has been acked now. Only this batch is resent and the later
+        // ones keep flowing, each of them is resent in the same way if it's rejected too
+        DEBUGLOG("resend the reordered batch to node[%s] pre log index %lu", endpoint_.c_str(),
+                 batch->request.pre_log_index());
+        batch->cntl.Reset();
+        batch->response.Clear();
+        batch->resent = true;
+        SendBatch(batch, true);
+        return 0;
+    }
+    if (batch->cntl.Failed()) {
+        PDLOG(WARNING, "fail to sync log to node %s. tid %u pid %u, error %s", endpoint_.c_str(), tid_, pid_,
+              batch->cntl.ErrorText().c_str());
+    } else {
+        PDLOG(WARNING, "fail to sync log to node %s. tid %u pid %u, code %d msg %s", endpoint_.c_str(), tid_, pid_,
+              batch->response.code(), batch->response.msg().c_str());
+    }
+    // keep the unacked batches and resend them one by one, the follower skips the entries it has got
+    cache_.push_back(batch->request);
+    for (auto& cur_batch : inflight_) {
+        cache_.push_back(cur_batch->request);
+    }
+    WaitInflight();
+    return 1;
+}
+
+bool ReplicateNode::NeedHeartbeat() {
+    if (FLAGS_follower_read_max_idle_ms <= 0 || !log_matched_ || !cache_.empty() || !inflight_.empty()) {
+        return false;
+    }
+    return ::baidu::common::timer::get_micros() / 1000 >= last_send_time_ + FLAGS_follower_read_max_idle_ms / 2;
+}
+
+void ReplicateNode::SendHeartbeat() {
+    ::openmldb::api::AppendEntriesRequest request;
+    request.set_tid(tid_);
+    request.set_pid(pid_);
+    request.set_pre_log_index(last_sync_offset_.load(std::memory_order_relaxed));
+    request.set_leader_log_offset(GetLeaderOffset());
+    if (!FLAGS_zk_cluster.empty()) {
+        request.set_term(term_->load(std::memory_order_relaxed));
+    }
+    ::openmldb::api::AppendEntriesResponse response;
+    bool ret = rpc_client_.SendRequest(&::openmldb::api::TabletServer_Stub::AppendEntries, &request, &response,
+                                       FLAGS_request_timeout_ms, 1);
+    last_send_time_ = ::baidu::common::timer::get_micros() / 1000;
+    if (!ret || response.code() != 0) {
+        DEBUGLOG("fail to send heartbeat to node[%s]. tid %u pid %u", endpoint_.c_str(), tid_, pid_);
+    }
+}
+
+uint64_t ReplicateNode::GetLeaderOffset() {
+    return rep_node_.load(std::memory_order_relaxed) ? follower_offset_->load(std::memory_order_relaxed)
+                                                     : leader_log_offset_->load(std::memory_order_relaxed);
+}
+
+uint64_t ReplicateNode::GetLagEntries() {
+    uint64_t leader_offset = GetLeaderOffset();
+    uint64_t sync_offset = last_sync_offset_.load(std::memory_order_relaxed);
+    return leader_offset > sync_offset ? leader_offset - sync_offset : 0;
+}
+
+uint64_t ReplicateNode::GetLagBytes() {
+    uint64_t inflight_bytes = inflight_bytes_.load(std::memory_order_relaxed);
+    uint64_t avg_entry_bytes = avg_entry_bytes_.load(std::memory_order_relaxed);
+    uint64_t lag_entries = GetLagEntries();
+    uint64_t unsent_entries = 0;
+    if (avg_entry_bytes > 0 && inflight_bytes / avg_entry_bytes < lag_entries) {
+        unsent_entries = lag_entries - inflight_bytes / avg_entry_bytes;
+    }
+    return inflight_bytes + unsent_entries * avg_entry_bytes;
+}
+
+uint32_t ReplicateNode::GetInflightBatchCnt() { return inflight_cnt_.load(std::memory_order_relaxed); }
+
 void ReplicateNode::Stop() {
     is_running_.store(false, std::memory_order_relaxed);
     if (worker_ == 0) {
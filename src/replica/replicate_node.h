@@ -18,12 +18,15 @@
 #define SRC_REPLICA_REPLICATE_NODE_H_
 
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/skiplist.h"
 #include "bthread/bthread.h"
 #include "bthread/condition_variable.h"
+#include "brpc/controller.h"
 #include "log/log_reader.h"
 #include "log/log_writer.h"
 #include "log/sequential_file.h"
@@ -36,6 +39,17 @@ namespace replica {
 using ::openmldb::log::LogReader;
 typedef ::openmldb::base::Skiplist<uint32_t, uint64_t, ::openmldb::base::DefaultComparator> LogParts;
 
+// a batch of entries which has been sent to follower and not acked yet
+struct InflightBatch {
+    ::openmldb::api::AppendEntriesRequest request;
+    ::openmldb::api::AppendEntriesResponse response;
+    brpc::Controller cntl;
+    uint64_t end_offset = 0;
+    uint64_t bytes = 0;
+    // it has been resent because it overtook the batch before it
+    bool resent = false;
+};
+
 class ReplicateNode {
  public:
     ReplicateNode(const std::string& point, LogParts* logs, const std::string& log_path, uint32_t tid, uint32_t pid,
@@ -51,6 +65,7 @@ class ReplicateNode {
     // sync data to follower node
     void SyncData();
 
+    // return 0 if ok, 1 if need coffee time, 2 if the record is not ready yet
     int SyncData(uint64_t log_offset);
 
     void SetLastSyncOffset(uint64_t offset);
@@ -63,6 +78,14 @@ class ReplicateNode {
 
     int GetLogIndex();
 
+    // the count of entries which follower is behind leader
+    uint64_t GetLagEntries();
+
+    // estimated by the inflight bytes and the average entry size
+    uint64_t GetLagBytes();
+
+    uint32_t GetInflightBatchCnt();
+
     void Stop();
 
     ReplicateNode(const ReplicateNode&) = delete;
@@ -72,11 +95,39 @@ class ReplicateNode {
  private:
     int MatchLogOffsetFromNode();
 
+    // read entries after read_offset_ into request, bounded by entry count and bytes
+    int ReadBatch(uint64_t log_offset, ::openmldb::api::AppendEntriesRequest* request, uint64_t* bytes);
+
+    int SyncCachedData();
+
+    // the offset which the node should catch up with
+    uint64_t GetLeaderOffset();
+
+    void WaitInflight();
+
+    // send the batch asynchronously and append it to the window
+    void SendBatch(const std::shared_ptr<InflightBatch>& batch, bool front);
+
+    // whether the follower has been idle for half of follower_read_max_idle_ms, it keeps the follower readable
+    bool NeedHeartbeat();
+
+    // send an empty request which carries the offset of the leader
+    void SendHeartbeat();
+
  private:
     LogReader log_reader_;
     std::vector<::openmldb::api::AppendEntriesRequest> cache_;
+    std::deque<std::shared_ptr<InflightBatch>> inflight_;
     std::string endpoint_;
-    uint64_t last_sync_offset_;
+    // written by the sync thread, read by the lag reporting
+    std::atomic<uint64_t> last_sync_offset_;
+    // the time in milliseconds when a request was sent last
+    uint64_t last_send_time_;
+    // the last log index which has been read and sent
+    uint64_t read_offset_;
+    std::atomic<uint64_t> inflight_bytes_;
+    std::atomic<uint32_t> inflight_cnt_;
+    std::atomic<uint64_t> avg_entry_bytes_;
     bool log_matched_;
     uint32_t tid_;
     uint32_t pid_;
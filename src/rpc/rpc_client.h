@@ -37,10 +37,12 @@
 #include <brpc/retry_policy.h>
 #include <gflags/gflags.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "base/glog_wrapper.h"
 #include "proto/tablet.pb.h"
@@ -71,50 +73,95 @@ class SleepRetryPolicy : public brpc::RetryPolicy {
 
 static SleepRetryPolicy sleep_retry_policy;
 
+// Count the in-flight calls of a pooled channel, the original closure is run after the count is decreased
+class InflightClosure : public google::protobuf::Closure {
+ public:
+    InflightClosure(std::atomic<uint32_t>* inflight, google::protobuf::Closure* done) : inflight_(inflight), done_(done) {
+        inflight_->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Run() override {
+        inflight_->fetch_sub(1, std::memory_order_relaxed);
+        if (done_ != NULL) {
+            done_->Run();
+        }
+        delete this;
+    }
+
+ private:
+    std::atomic<uint32_t>* inflight_;
+    google::protobuf::Closure* done_;
+};
+
 template <class T>
 class RpcClient {
  public:
-    explicit RpcClient(const std::string& endpoint)
-        : endpoint_(endpoint), use_sleep_policy_(false), log_id_(0), stub_(NULL), channel_(NULL) {}
-    RpcClient(const std::string& endpoint, bool use_sleep_policy)
-        : endpoint_(endpoint), use_sleep_policy_(use_sleep_policy), log_id_(0), stub_(NULL), channel_(NULL) {}
-    ~RpcClient() {
-        delete channel_;
-        delete stub_;
-    }
+    explicit RpcClient(const std::string& endpoint) : RpcClient(endpoint, false) {}
+    RpcClient(const std::string& endpoint, bool use_sleep_policy) : RpcClient(endpoint, use_sleep_policy, 1) {}
+    // `channel_num` channels are created and every one has its own connection, a call is sent by the less loaded one
+    // of two random channels
+    RpcClient(const std::string& endpoint, bool use_sleep_policy, uint32_t channel_num)
+        : endpoint_(endpoint),
+          use_sleep_policy_(use_sleep_policy),
+          channel_num_(channel_num > 0 ? channel_num : 1),
+          log_id_(0),
+          channels_(),
+          next_(0) {}
+    ~RpcClient() {}
 
     int Init() {
-        channel_ = new brpc::Channel();
-        brpc::ChannelOptions options;
-        if (use_sleep_policy_) {
-            options.retry_policy = &sleep_retry_policy;
-        }
-        if (channel_->Init(endpoint_.c_str(), "", &options) != 0) {
-            return -1;
+        channels_.clear();
+        for (uint32_t i = 0; i < channel_num_; i++) {
+            auto channel = std::make_unique<PooledChannel>();
+            brpc::ChannelOptions options;
+            if (use_sleep_policy_) {
+                options.retry_policy = &sleep_retry_policy;
+            }
+            // the single connections of different groups are not shared
+            if (channel_num_ > 1) {
+                options.connection_group = "pool_" + std::to_string(i);
+            }
+            if (channel->channel.Init(endpoint_.c_str(), "", &options) != 0) {
+                channels_.clear();
+                return -1;
+            }
+            channel->stub = std::make_unique<T>(&channel->channel);
+            channels_.push_back(std::move(channel));
         }
-        stub_ = new T(channel_);
         return 0;
     }
 
+    uint32_t GetChannelNum() const { return channel_num_; }
+
     template <class Request, class Response, class Callback>
     bool SendRequest(void (T::*func)(google::protobuf::RpcController*, const Request*, Response*, Callback*),
                      brpc::Controller* cntl, const Request* request, Response* response, Callback* callback) {
-        if (stub_ == NULL) {
+        auto* channel = Select();
+        if (channel == NULL) {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, callback);
+        if (callback == NULL) {
+            InflightGuard guard(channel);
+            (channel->stub.get()->*func)(cntl, request, response, NULL);
+        } else {
+            (channel->stub.get()->*func)(cntl, request, response, Track(channel, callback));
+        }
         return true;
     }
 
     template <class Request, class Response, class Callback>
     bool SendRequest(void (T::*func)(google::protobuf::RpcController*, const Request*, Response*, Callback*),
                      brpc::Controller* cntl, const Request* request, Response* response) {
-        if (stub_ == NULL) {
+        auto* channel = Select();
+        if (channel == NULL) {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, NULL);
+        {
+            InflightGuard guard(channel);
+            (channel->stub.get()->*func)(cntl, request, response, NULL);
+        }
         if (!cntl->Failed()) {
             return true;
         }
@@ -132,11 +179,15 @@ class RpcClient {
         if (retry_times > 0) {
             cntl.set_max_retry(retry_times);
         }
-        if (stub_ == NULL) {
+        auto* channel = Select();
+        if (channel == NULL) {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(&cntl, request, response, NULL);
+        {
+            InflightGuard guard(channel);
+            (channel->stub.get()->*func)(&cntl, request, response, NULL);
+        }
         if (!cntl.Failed()) {
             return true;
         }
@@ -157,11 +208,15 @@ class RpcClient {
         if (retry_times > 0) {
             cntl.set_max_retry(retry_times);
         }
-        if (stub_ == NULL) {
+        auto* channel = Select();
+        if (channel == NULL) {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(&cntl, request, response, NULL);
+        {
+            InflightGuard guard(channel);
+            (channel->stub.get()->*func)(&cntl, request, response, NULL);
+        }
         if (cntl.Failed()) {
             PDLOG(WARNING, "request error. %s", cntl.ErrorText().c_str());
             return false;
@@ -175,20 +230,68 @@ class RpcClient {
                                      google::protobuf::Closure*),
                      brpc::Controller* cntl, const Request* request, Response* response,
                      google::protobuf::Closure* callback) {
-        if (stub_ == NULL) {
+        auto* channel = Select();
+        if (channel == NULL) {
             PDLOG(WARNING, "stub is null. client must be init before send request");
             return false;
         }
-        (stub_->*func)(cntl, request, response, callback);
+        if (callback == NULL) {
+            InflightGuard guard(channel);
+            (channel->stub.get()->*func)(cntl, request, response, NULL);
+        } else {
+            (channel->stub.get()->*func)(cntl, request, response, Track(channel, callback));
+        }
         return true;
     }
 
  private:
+    struct PooledChannel {
+        brpc::Channel channel;
+        std::unique_ptr<T> stub;
+        std::atomic<uint32_t> inflight{0};
+    };
+
+    class InflightGuard {
+     public:
+        explicit InflightGuard(PooledChannel* channel) : channel_(channel) {
+            channel_->inflight.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~InflightGuard() { channel_->inflight.fetch_sub(1, std::memory_order_relaxed); }
+
+     private:
+        PooledChannel* channel_;
+    };
+
+    // power of two choices, the two candidates are picked round robin so no random generator is shared
+    PooledChannel* Select() {
+        if (channels_.empty()) {
+            return NULL;
+        }
+        if (channels_.size() == 1) {
+            return channels_[0].get();
+        }
+        uint32_t n = next_.fetch_add(1, std::memory_order_relaxed);
+        auto* first = channels_[n % channels_.size()].get();
+        auto* second = channels_[(n + channels_.size() / 2) % channels_.size()].get();
+        return second->inflight.load(std::memory_order_relaxed) < first->inflight.load(std::memory_order_relaxed)
+                   ? second
+                   : first;
+    }
+
+    // the async calls are counted until the done closure runs
+    google::protobuf::Closure* Track(PooledChannel* channel, google::protobuf::Closure* done) {
+        if (channels_.size() == 1) {
+            return done;
+        }
+        return new InflightClosure(&channel->inflight, done);
+    }
+
     std::string endpoint_;
     bool use_sleep_policy_;
+    uint32_t channel_num_;
     uint64_t log_id_;
-    T* stub_;
-    brpc::Channel* channel_;
+    std::vector<std::unique_ptr<PooledChannel>> channels_;
+    std::atomic<uint32_t> next_;
 };
 
 template <class Response>
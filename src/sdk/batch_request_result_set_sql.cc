@@ -120,10 +120,10 @@ bool SQLBatchRequestResultSet::Next() {
         uint32_t row_size = 0;
         cntl_->response_attachment().copy_to(&row_size, 4, position_ + 2);
         DLOG(INFO) << "row size " << row_size << " position " << position_ << " byte size " << byte_size_;
-        butil::IOBuf tmp;
-        cntl_->response_attachment().append_to(&tmp, row_size, position_);
+        non_common_buf_.clear();
+        cntl_->response_attachment().append_to(&non_common_buf_, row_size, position_);
         position_ += row_size;
-        bool ok = non_common_row_view_->Reset(tmp);
+        bool ok = non_common_row_view_->Reset(non_common_buf_);
         if (!ok) {
             LOG(WARNING) << "reset row buf failed";
             return false;
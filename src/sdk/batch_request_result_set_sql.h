@@ -72,6 +72,16 @@ class SQLBatchRequestResultSet : public ::hybridse::sdk::ResultSet {
 
     inline int32_t Size() { return response_->count(); }
 
+    // The raw rows for the callers which decode all the columns by themselves, e.g. the json encoder of api server.
+    // Column `index` of the result is column `GetMappedIndex(index)` of the common row or the non common row
+    bool IsCommonColumn(uint32_t index) const { return IsCommonColumnIdx(index); }
+    size_t GetMappedIndex(uint32_t index) const { return column_remap_[index]; }
+    const ::hybridse::codec::Schema& GetCommonSchema() const { return common_schema_; }
+    const ::hybridse::codec::Schema& GetNonCommonSchema() const { return non_common_schema_; }
+    const butil::IOBuf& GetCommonRowBuf() const { return common_buf_; }
+    // the current row, valid after Next() returns true
+    const butil::IOBuf& GetNonCommonRowBuf() const { return non_common_buf_; }
+
  private:
     inline uint32_t GetRecordSize() { return response_->count(); }
 
@@ -97,6 +107,7 @@ class SQLBatchRequestResultSet : public ::hybridse::sdk::ResultSet {
 
     size_t common_buf_size_ = 0;
     butil::IOBuf common_buf_;
+    butil::IOBuf non_common_buf_;
     std::shared_ptr<brpc::Controller> cntl_;
 };
 
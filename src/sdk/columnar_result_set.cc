@@ -0,0 +1,164 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/columnar_result_set.h"
+
+#include <snappy.h>
+#include <string.h>
+
+#include "base/status.h"
+#include "codec/fe_schema_codec.h"
+#include "glog/logging.h"
+
+namespace openmldb {
+namespace sdk {
+
+ColumnarResultSet::ColumnarResultSet(const ::hybridse::vm::Schema& schema,
+                                     const ::openmldb::api::ColumnarResult& columnar,
+                                     const std::shared_ptr<brpc::Controller>& cntl)
+    : schema_(schema), columnar_(columnar), cntl_(cntl), external_schema_(), buf_(), view_(), index_(-1) {}
+
+template <typename Response>
+static std::shared_ptr<::hybridse::sdk::ResultSet> MakeColumnarResultSet(const std::shared_ptr<Response>& response,
+                                                                         const std::shared_ptr<brpc::Controller>& cntl,
+                                                                         ::hybridse::sdk::Status* status) {
+    if (!status || !response || !cntl) {
+        return {};
+    }
+    ::hybridse::vm::Schema schema;
+    if (!::hybridse::codec::SchemaCodec::Decode(response->schema(), &schema)) {
+        *status = {::hybridse::common::StatusCode::kCmdError, "request error, fail to decodec schema"};
+        return {};
+    }
+    auto rs = std::make_shared<ColumnarResultSet>(schema, response->columnar(), cntl);
+    if (!rs->Init()) {
+        *status = {::hybridse::common::StatusCode::kCmdError, "request error, ColumnarResultSet init failed"};
+        return {};
+    }
+    return rs;
+}
+
+std::shared_ptr<::hybridse::sdk::ResultSet> ColumnarResultSet::MakeResultSet(
+    const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+    ::hybridse::sdk::Status* status) {
+    return MakeColumnarResultSet(response, cntl, status);
+}
+
+std::shared_ptr<::hybridse::sdk::ResultSet> ColumnarResultSet::MakeResultSet(
+    const std::shared_ptr<::openmldb::api::SQLBatchRequestQueryResponse>& response,
+    const std::shared_ptr<brpc::Controller>& cntl, ::hybridse::sdk::Status* status) {
+    return MakeColumnarResultSet(response, cntl, status);
+}
+
+bool ColumnarResultSet::Init() {
+    external_schema_.SetSchema(schema_);
+    const auto& attachment = cntl_->response_attachment();
+    size_t raw_size = attachment.size();
+    if (columnar_.compress_type() == ::openmldb::type::CompressType::kSnappy) {
+        std::string compressed = attachment.to_string();
+        if (!::snappy::GetUncompressedLength(compressed.data(), compressed.size(), &raw_size) ||
+            raw_size != columnar_.raw_size()) {
+            LOG(WARNING) << "invalid compressed columnar result";
+            return false;
+        }
+        buf_.resize((raw_size + 7) / 8);
+        if (!::snappy::RawUncompress(compressed.data(), compressed.size(), reinterpret_cast<char*>(buf_.data()))) {
+            LOG(WARNING) << "fail to uncompress the columnar result";
+            return false;
+        }
+    } else {
+        buf_.resize((raw_size + 7) / 8);
+        attachment.copy_to(buf_.data(), raw_size);
+    }
+    if (!view_.Init(reinterpret_cast<const int8_t*>(buf_.data()), raw_size, schema_)) {
+        LOG(WARNING) << "invalid columnar result";
+        return false;
+    }
+    index_ = -1;
+    return true;
+}
+
+bool ColumnarResultSet::IsNULL(int index) {
+    if (index < 0 || !IsValidRow(index)) {
+        LOG(WARNING) << "column idx out of bound " << index;
+        return false;
+    }
+    return view_.IsNULL(index, index_);
+}
+
+bool ColumnarResultSet::GetString(uint32_t index, std::string* str) {
+    if (str == nullptr || !IsValidRow(index) || schema_.Get(index).type() != ::hybridse::type::kVarchar ||
+        view_.IsNULL(index, index_)) {
+        return false;
+    }
+    const uint32_t* offsets = view_.GetStringOffsets(index);
+    str->assign(view_.GetStringData(index) + offsets[index_], offsets[index_ + 1] - offsets[index_]);
+    return true;
+}
+
+bool ColumnarResultSet::GetChar(uint32_t index, char* result) {
+    std::string str;
+    if (result == nullptr || !GetString(index, &str) || str.empty()) {
+        return false;
+    }
+    *result = str[0];
+    return true;
+}
+
+bool ColumnarResultSet::GetDate(uint32_t index, int32_t* year, int32_t* month, int32_t* day) {
+    int32_t date = 0;
+    if (year == nullptr || month == nullptr || day == nullptr || !GetDate(index, &date)) {
+        return false;
+    }
+    *day = date & 0x0000000FF;
+    date = date >> 8;
+    *month = 1 + (date & 0x0000FF);
+    *year = 1900 + (date >> 8);
+    return true;
+}
+
+uint32_t ColumnarResultSet::GetColumnByteSize(uint32_t index) const {
+    if (!IsValidColumn(index)) {
+        return 0;
+    }
+    auto type = schema_.Get(index).type();
+    uint32_t row_cnt = view_.GetRowCount();
+    if (type == ::hybridse::type::kVarchar) {
+        return (row_cnt + 1) * sizeof(uint32_t) + view_.GetStringOffsets(index)[row_cnt];
+    }
+    return row_cnt * ::openmldb::codec::ColumnarView::GetValueSize(type);
+}
+
+bool ColumnarResultSet::CopyColumn(uint32_t index, char* string_buffer_var_name, uint32_t length) const {
+    uint32_t size = GetColumnByteSize(index);
+    if (string_buffer_var_name == nullptr || !IsValidColumn(index) || length < size) {
+        return false;
+    }
+    // the data of a string column follows its offsets
+    memcpy(string_buffer_var_name, view_.GetValues<char>(index), size);
+    return true;
+}
+
+bool ColumnarResultSet::CopyNullBitmap(uint32_t index, char* string_buffer_var_name, uint32_t length) const {
+    if (string_buffer_var_name == nullptr || !IsValidColumn(index) || length < GetNullBitmapSize()) {
+        return false;
+    }
+    memcpy(string_buffer_var_name, view_.GetNullBitmap(index), GetNullBitmapSize());
+    return true;
+}
+
+}  // namespace sdk
+}  // namespace openmldb
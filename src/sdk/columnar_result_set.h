@@ -0,0 +1,159 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_COLUMNAR_RESULT_SET_H_
+#define SRC_SDK_COLUMNAR_RESULT_SET_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/controller.h"
+#include "codec/columnar_codec.h"
+#include "proto/tablet.pb.h"
+#include "sdk/base_impl.h"
+#include "sdk/result_set.h"
+
+namespace openmldb {
+namespace sdk {
+
+// The result set of a response in the columnar encoding, see codec/columnar_codec.h. Besides the row-wise getters,
+// the columns can be read as a whole: the pointer getters read in place, the copy methods copy a column into a buffer
+// of the caller, which is a byte array in java
+class ColumnarResultSet : public ::hybridse::sdk::ResultSet {
+ public:
+    ColumnarResultSet(const ::hybridse::vm::Schema& schema, const ::openmldb::api::ColumnarResult& columnar,
+                      const std::shared_ptr<brpc::Controller>& cntl);
+
+    ~ColumnarResultSet() {}
+
+    static std::shared_ptr<::hybridse::sdk::ResultSet> MakeResultSet(
+        const std::shared_ptr<::openmldb::api::QueryResponse>& response, const std::shared_ptr<brpc::Controller>& cntl,
+        ::hybridse::sdk::Status* status);
+
+    static std::shared_ptr<::hybridse::sdk::ResultSet> MakeResultSet(
+        const std::shared_ptr<::openmldb::api::SQLBatchRequestQueryResponse>& response,
+        const std::shared_ptr<brpc::Controller>& cntl, ::hybridse::sdk::Status* status);
+
+    // null if `rs` is not in the columnar encoding
+    static std::shared_ptr<ColumnarResultSet> Cast(const std::shared_ptr<::hybridse::sdk::ResultSet>& rs) {
+        return std::dynamic_pointer_cast<ColumnarResultSet>(rs);
+    }
+
+    bool Init();
+
+    bool Reset() override {
+        index_ = -1;
+        return true;
+    }
+
+    bool Next() override { return ++index_ < static_cast<int32_t>(view_.GetRowCount()); }
+
+    bool IsNULL(int index) override;
+
+    bool GetString(uint32_t index, std::string* str) override;
+
+    bool GetBool(uint32_t index, bool* result) override { return GetValue(index, ::hybridse::type::kBool, result); }
+
+    bool GetChar(uint32_t index, char* result) override;
+
+    bool GetInt16(uint32_t index, int16_t* result) override {
+        return GetValue(index, ::hybridse::type::kInt16, result);
+    }
+
+    bool GetInt32(uint32_t index, int32_t* result) override {
+        return GetValue(index, ::hybridse::type::kInt32, result);
+    }
+
+    bool GetInt64(uint32_t index, int64_t* result) override {
+        return GetValue(index, ::hybridse::type::kInt64, result);
+    }
+
+    bool GetFloat(uint32_t index, float* result) override { return GetValue(index, ::hybridse::type::kFloat, result); }
+
+    bool GetDouble(uint32_t index, double* result) override {
+        return GetValue(index, ::hybridse::type::kDouble, result);
+    }
+
+    bool GetDate(uint32_t index, int32_t* date) override { return GetValue(index, ::hybridse::type::kDate, date); }
+
+    bool GetDate(uint32_t index, int32_t* year, int32_t* month, int32_t* day) override;
+
+    bool GetTime(uint32_t index, int64_t* mills) override {
+        return GetValue(index, ::hybridse::type::kTimestamp, mills);
+    }
+
+    const ::hybridse::sdk::Schema* GetSchema() override { return &external_schema_; }
+
+    int32_t Size() override { return view_.GetRowCount(); }
+
+    // the null bitmap of a column, the bit of row i is `bitmap[i / 8] & (1 << (i % 8))`, it's set if the value is null
+    const uint8_t* GetNullBitmap(uint32_t index) const { return view_.GetNullBitmap(index); }
+
+    uint32_t GetNullBitmapSize() const { return (view_.GetRowCount() + 7) / 8; }
+
+    // the values of a column which isn't a string one, T must be the type of the column, e.g. int32_t for date and
+    // int64_t for timestamp. The value of a null is 0
+    template <typename T>
+    const T* GetValues(uint32_t index) const {
+        return view_.GetValues<T>(index);
+    }
+
+    // the value of row i in a string column is the data in [offsets[i], offsets[i + 1])
+    const uint32_t* GetStringOffsets(uint32_t index) const { return view_.GetStringOffsets(index); }
+
+    const char* GetStringData(uint32_t index) const { return view_.GetStringData(index); }
+
+    // The bytes of the values of a column. The offsets[row count + 1] and the data of a string column are copied
+    // together, the offsets are uint32 and the data starts at (row count + 1) * 4
+    uint32_t GetColumnByteSize(uint32_t index) const;
+
+    // copy the values of a column, `length` should be at least GetColumnByteSize(index)
+    bool CopyColumn(uint32_t index, char* string_buffer_var_name, uint32_t length) const;
+
+    // copy the null bitmap of a column, `length` should be at least GetNullBitmapSize()
+    bool CopyNullBitmap(uint32_t index, char* string_buffer_var_name, uint32_t length) const;
+
+ private:
+    template <typename T>
+    bool GetValue(uint32_t index, ::hybridse::type::Type type, T* result) {
+        if (result == nullptr || !IsValidRow(index) || schema_.Get(index).type() != type ||
+            view_.IsNULL(index, index_)) {
+            return false;
+        }
+        *result = view_.GetValues<T>(index)[index_];
+        return true;
+    }
+
+    bool IsValidColumn(uint32_t index) const { return index < static_cast<uint32_t>(schema_.size()); }
+
+    bool IsValidRow(uint32_t index) const {
+        return IsValidColumn(index) && index_ >= 0 && index_ < static_cast<int32_t>(view_.GetRowCount());
+    }
+
+    ::hybridse::vm::Schema schema_;
+    ::openmldb::api::ColumnarResult columnar_;
+    std::shared_ptr<brpc::Controller> cntl_;
+    ::hybridse::sdk::SchemaImpl external_schema_;
+    // the uncompressed result, the elements are uint64_t so the sections are aligned
+    std::vector<uint64_t> buf_;
+    ::openmldb::codec::ColumnarView view_;
+    int32_t index_;
+};
+
+}  // namespace sdk
+}  // namespace openmldb
+#endif  // SRC_SDK_COLUMNAR_RESULT_SET_H_
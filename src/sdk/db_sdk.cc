@@ -26,16 +26,25 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include "base/hash.h"
+#include "base/random.h"
 #include "base/strings.h"
 #include "glog/logging.h"
 #include "schema/schema_adapter.h"
 
 namespace openmldb::sdk {
 
+// every thread has its own generator, so the concurrent callers don't write the same seed
+static uint32_t RandomPartition(uint32_t pid_num) {
+    static thread_local ::openmldb::base::Random rand(
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    return rand.Uniform(pid_num);
+}
+
 std::shared_ptr<::openmldb::client::NsClient> DBSDK::GetNsClient() {
     auto ns_client = std::atomic_load_explicit(&ns_client_, std::memory_order_relaxed);
     if (ns_client) return ns_client;
@@ -218,9 +227,9 @@ bool ClusterSDK::Init() {
     ::hybridse::vm::EngineOptions eopt;
     eopt.SetCompileOnly(true);
     eopt.SetPlanOnly(true);
-    engine_ = new ::hybridse::vm::Engine(catalog_, eopt);
+    engine_ = new ::hybridse::vm::Engine(GetCatalog(), eopt);
 
-    ok = BuildCatalog();
+    ok = Refresh();
     if (!ok) return false;
     CheckZk();
     if (!InitExternalFun()) {
@@ -297,85 +306,102 @@ bool ClusterSDK::GetTaskManagerAddress(std::string* endpoint, std::string* real_
     return true;
 }
 
-// TODO(hw): refactor
 bool ClusterSDK::UpdateCatalog(const std::vector<std::string>& table_datas, const std::vector<std::string>& sp_datas) {
-    std::vector<::openmldb::nameserver::TableInfo> tables;
-    std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> mapping;
-    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
+    auto old_routing_table = GetRoutingTable();
+    std::map<std::string, std::pair<int64_t, std::shared_ptr<::openmldb::nameserver::TableInfo>>> table_nodes;
+    std::vector<std::shared_ptr<::openmldb::catalog::SDKTableHandler>> tables;
+    TableInfoMap mapping;
+    uint32_t changed_cnt = 0;
     for (const auto& table_data : table_datas) {
         if (table_data.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(table_root_path_ + "/" + table_data, value);
-        if (!ok) {
-            LOG(WARNING) << "fail to get table data " << table_root_path_ << "/" << table_data;
+        std::string path = table_root_path_ + "/" + table_data;
+        Stat stat;
+        if (!zk_client_->GetNodeStat(path, &stat)) {
+            LOG(WARNING) << "fail to get table data " << path;
             continue;
         }
-        std::shared_ptr<::openmldb::nameserver::TableInfo> table_info(new ::openmldb::nameserver::TableInfo());
-        ok = table_info->ParseFromString(value);
-        if (!ok) {
-            LOG(WARNING) << "fail to parse table proto with " << value;
-            continue;
+        std::shared_ptr<::openmldb::nameserver::TableInfo> table_info;
+        auto it = table_nodes_.find(table_data);
+        if (it != table_nodes_.end() && it->second.first == stat.mzxid) {
+            table_info = it->second.second;
+        } else {
+            std::string value;
+            if (!zk_client_->GetNodeValueAndStat(path.c_str(), &value, &stat)) {
+                LOG(WARNING) << "fail to get table data " << path;
+                continue;
+            }
+            table_info = std::make_shared<::openmldb::nameserver::TableInfo>();
+            if (!table_info->ParseFromString(value)) {
+                LOG(WARNING) << "fail to parse table proto with " << value;
+                continue;
+            }
+            DLOG(INFO) << "parse table " << table_info->name() << " ok";
+            changed_cnt++;
         }
-        DLOG(INFO) << "parse table " << table_info->name() << " ok";
+        table_nodes.emplace(table_data, std::make_pair(stat.mzxid, table_info));
         if (table_info->format_version() != 1) {
             continue;
         }
-        tables.push_back(*(table_info));
-        auto it = mapping.find(table_info->db());
-        if (it == mapping.end()) {
-            std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>> table_in_db;
-            table_in_db.insert(std::make_pair(table_info->name(), table_info));
-            mapping.insert(std::make_pair(table_info->db(), table_in_db));
+        // reuse the handler of the unchanged table, unless some leader wasn't connected when it was built
+        std::shared_ptr<::openmldb::catalog::SDKTableHandler> handler;
+        const auto* route = old_routing_table->GetTable(table_info->db(), table_info->name());
+        if (route != nullptr && route->table_info == table_info &&
+            std::find(route->leaders.begin(), route->leaders.end(), nullptr) == route->leaders.end()) {
+            handler = route->handler;
         } else {
-            it->second.insert(std::make_pair(table_info->name(), table_info));
+            handler = std::make_shared<::openmldb::catalog::SDKTableHandler>(*table_info, *client_manager_);
+            if (!handler->Init()) {
+                LOG(WARNING) << "fail to init table " << table_info->name();
+                return false;
+            }
         }
+        tables.push_back(handler);
+        mapping[table_info->db()].emplace(table_info->name(), table_info);
         DLOG(INFO) << "load table info with name " << table_info->name() << " in db " << table_info->db();
     }
 
+    std::map<std::string, std::pair<int64_t, std::shared_ptr<hybridse::sdk::ProcedureInfo>>> sp_nodes;
     Procedures db_sp_map;
     for (const auto& node : sp_datas) {
         if (node.empty()) continue;
-        std::string value;
-        bool ok = zk_client_->GetNodeValue(sp_root_path_ + "/" + node, value);
-        if (!ok) {
+        std::string path = sp_root_path_ + "/" + node;
+        Stat stat;
+        if (!zk_client_->GetNodeStat(path, &stat)) {
             LOG(WARNING) << "fail to get procedure data. node: " << node;
             continue;
         }
-        std::string uncompressed;
-        ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
-        ::openmldb::api::ProcedureInfo sp_info_pb;
-        ok = sp_info_pb.ParseFromString(uncompressed);
-        if (!ok) {
-            LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
-            continue;
-        }
-        DLOG(INFO) << "parse procedure " << sp_info_pb.sp_name() << " ok";
-        auto sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
-        if (!sp_info) {
-            LOG(WARNING) << "convert procedure info failed, sp_name: " << sp_info_pb.sp_name()
-                         << " db: " << sp_info_pb.db_name();
-            continue;
-        }
-        auto it = db_sp_map.find(sp_info->GetDbName());
-        if (it == db_sp_map.end()) {
-            std::map<std::string, std::shared_ptr<hybridse::sdk::ProcedureInfo>> sp_in_db = {
-                {sp_info->GetSpName(), sp_info}};
-            db_sp_map.insert(std::make_pair(sp_info->GetDbName(), sp_in_db));
+        std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info;
+        auto it = sp_nodes_.find(node);
+        if (it != sp_nodes_.end() && it->second.first == stat.mzxid) {
+            sp_info = it->second.second;
         } else {
-            it->second.insert(std::make_pair(sp_info->GetSpName(), sp_info));
+            std::string value;
+            if (!zk_client_->GetNodeValueAndStat(path.c_str(), &value, &stat)) {
+                LOG(WARNING) << "fail to get procedure data. node: " << node;
+                continue;
+            }
+            std::string uncompressed;
+            ::snappy::Uncompress(value.c_str(), value.length(), &uncompressed);
+            ::openmldb::api::ProcedureInfo sp_info_pb;
+            if (!sp_info_pb.ParseFromString(uncompressed)) {
+                LOG(WARNING) << "fail to parse procedure proto. node: " << node << " value: " << value;
+                continue;
+            }
+            DLOG(INFO) << "parse procedure " << sp_info_pb.sp_name() << " ok";
+            sp_info = std::make_shared<openmldb::catalog::ProcedureInfoImpl>(sp_info_pb);
+            changed_cnt++;
         }
+        sp_nodes.emplace(node, std::make_pair(stat.mzxid, sp_info));
+        db_sp_map[sp_info->GetDbName()].emplace(sp_info->GetSpName(), sp_info);
         DLOG(INFO) << "load procedure info with sp name " << sp_info->GetSpName() << " in db " << sp_info->GetDbName();
     }
-    if (!new_catalog->Init(tables, db_sp_map)) {
-        LOG(WARNING) << "fail to init catalog";
-        return false;
-    }
-    {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        table_to_tablets_ = mapping;
-        catalog_ = new_catalog;
-    }
-    engine_->UpdateCatalog(new_catalog);
+    auto new_catalog = std::make_shared<::openmldb::catalog::SDKCatalog>(client_manager_);
+    new_catalog->Init(tables, db_sp_map);
+    table_nodes_.swap(table_nodes);
+    sp_nodes_.swap(sp_nodes);
+    UpdateRoutingTable(new_catalog, std::move(mapping));
+    LOG(INFO) << "update catalog to version " << GetClusterVersion() << ", " << changed_cnt
+              << " tables and procedures are changed";
     return true;
 }
 
@@ -429,31 +455,37 @@ bool ClusterSDK::BuildCatalog() {
 }
 
 uint32_t DBSDK::GetTableId(const std::string& db, const std::string& tname) {
-    auto table_handler = GetCatalog()->GetTable(db, tname);
-    auto* sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-    return sdk_table_handler->GetTid();
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, tname);
+    return route != nullptr ? route->handler->GetTid() : 0;
+}
+
+void DBSDK::UpdateRoutingTable(const std::shared_ptr<::openmldb::catalog::SDKCatalog>& catalog, TableInfoMap tables) {
+    // the version is only changed here, and BuildCatalog is called by one thread at a time
+    uint64_t version = cluster_version_.load(std::memory_order_relaxed) + 1;
+    std::shared_ptr<const RoutingTable> routing_table =
+        std::make_shared<RoutingTable>(version, catalog, std::move(tables));
+    std::atomic_store_explicit(&routing_table_, routing_table, std::memory_order_release);
+    cluster_version_.store(version, std::memory_order_relaxed);
+    engine_->UpdateCatalog(catalog);
 }
 
 std::shared_ptr<::openmldb::nameserver::TableInfo> DBSDK::GetTableInfo(const std::string& db,
                                                                        const std::string& tname) {
-    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-    auto it = table_to_tablets_.find(db);
-    if (it == table_to_tablets_.end()) {
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, tname);
+    if (route == nullptr) {
         return {};
     }
-    auto sit = it->second.find(tname);
-    if (sit == it->second.end()) {
-        return {};
-    }
-    auto table_info = sit->second;
-    return table_info;
+    return route->table_info;
 }
 
 std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>> DBSDK::GetTables(const std::string& db) {
-    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+    auto routing_table = GetRoutingTable();
     std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>> tables;
-    auto it = table_to_tablets_.find(db);
-    if (it == table_to_tablets_.end()) {
+    const auto& table_infos = routing_table->GetTableInfos();
+    auto it = table_infos.find(db);
+    if (it == table_infos.end()) {
         return tables;
     }
     auto iit = it->second.begin();
@@ -464,22 +496,22 @@ std::vector<std::shared_ptr<::openmldb::nameserver::TableInfo>> DBSDK::GetTables
 }
 
 std::vector<std::string> DBSDK::GetAllTables() {
-    std::map<std::string, std::shared_ptr<nameserver::TableInfo>> table_map;
+    auto routing_table = GetRoutingTable();
     std::vector<std::string> all_tables;
-    for (auto db_name_iter = table_to_tablets_.begin(); db_name_iter != table_to_tablets_.end(); db_name_iter++) {
-        table_map = db_name_iter->second;
-        for (auto table_name_iter = table_map.begin(); table_name_iter != table_map.end(); table_name_iter++) {
-            all_tables.push_back(table_name_iter->first);
+    for (const auto& db_kv : routing_table->GetTableInfos()) {
+        for (const auto& table_kv : db_kv.second) {
+            all_tables.push_back(table_kv.first);
         }
     }
     return all_tables;
 }
 
 std::vector<std::string> DBSDK::GetTableNames(const std::string& db) {
-    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
+    auto routing_table = GetRoutingTable();
     std::vector<std::string> tableNames;
-    auto it = table_to_tablets_.find(db);
-    if (it == table_to_tablets_.end()) {
+    const auto& table_infos = routing_table->GetTableInfos();
+    auto it = table_infos.find(db);
+    if (it == table_infos.end()) {
         return tableNames;
     }
     auto iit = it->second.begin();
@@ -519,60 +551,113 @@ std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> DBSDK::GetAllT
 }
 
 std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std::string& db, const std::string& name) {
-    auto table_handler = GetCatalog()->GetTable(db, name);
-    if (table_handler) {
-        auto* sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-        if (sdk_table_handler) {
-            uint32_t pid_num = sdk_table_handler->GetPartitionNum();
-            uint32_t pid = 0;
-            if (pid_num > 0) {
-                pid = rand_.Uniform(pid_num);
-            }
-            return sdk_table_handler->GetTablet(pid);
-        }
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, name);
+    if (route == nullptr || route->leaders.empty()) {
+        return {};
     }
-    return {};
+    return route->leaders[RandomPartition(route->leaders.size())];
 }
 
 bool DBSDK::GetTablet(const std::string& db, const std::string& name,
                       std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>>* tablets) {
-    auto table_handler = GetCatalog()->GetTable(db, name);
-    if (table_handler) {
-        auto* sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-        if (sdk_table_handler) {
-            return sdk_table_handler->GetTablet(tablets);
+    if (tablets == nullptr) {
+        return false;
+    }
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, name);
+    if (route == nullptr) {
+        return false;
+    }
+    tablets->clear();
+    for (uint32_t pid = 0; pid < route->leaders.size(); pid++) {
+        if (!route->leaders[pid]) {
+            LOG(WARNING) << "fail to get tablet for pid " << pid;
+            return false;
         }
+        tablets->push_back(route->leaders[pid]);
     }
-    return false;
+    return true;
 }
 
 std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std::string& db, const std::string& name,
                                                                       uint32_t pid) {
-    auto table_handler = GetCatalog()->GetTable(db, name);
-    if (table_handler) {
-        auto* sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-        if (sdk_table_handler) {
-            return sdk_table_handler->GetTablet(pid);
-        }
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, name);
+    if (route == nullptr || pid >= route->leaders.size()) {
+        return {};
     }
-    return {};
+    return route->leaders[pid];
 }
 
 std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetTablet(const std::string& db, const std::string& name,
                                                                       const std::string& pk) {
-    auto table_handler = GetCatalog()->GetTable(db, name);
-    if (table_handler) {
-        auto sdk_table_handler = dynamic_cast<::openmldb::catalog::SDKTableHandler*>(table_handler.get());
-        if (sdk_table_handler) {
-            uint32_t pid_num = sdk_table_handler->GetPartitionNum();
-            uint32_t pid = 0;
-            if (pid_num > 0) {
-                pid = ::openmldb::base::hash64(pk) % pid_num;
-            }
-            return sdk_table_handler->GetTablet(pid);
-        }
+    auto routing_table = GetRoutingTable();
+    const auto* route = routing_table->GetTable(db, name);
+    if (route == nullptr || route->leaders.empty()) {
+        return {};
     }
-    return {};
+    return route->leaders[::openmldb::base::hash64(pk) % route->leaders.size()];
+}
+
+// the pid of the main table's partition which the request row is sent to, -1 if the deployment can't be routed
+static int32_t RouteProcedure(const RoutingTable& routing_table, const std::string& db, const std::string& sp_name,
+                              const std::string& row, const TableRoute** main_table, std::string* msg) {
+    const auto* deployment = routing_table.GetDeployment(db, sp_name);
+    if (deployment == nullptr) {
+        *msg = sp_name + " does not exist in " + db;
+        return -1;
+    }
+    *main_table = deployment->GetMainTable();
+    if (*main_table == nullptr || (*main_table)->leaders.empty()) {
+        *msg = "main table " + deployment->GetProcedureInfo()->GetMainTable() + " is not found";
+        return -1;
+    }
+    int32_t pid = -1;
+    if (!row.empty()) {
+        pid = deployment->GetPartition(reinterpret_cast<const int8_t*>(row.data()), row.size());
+    }
+    if (pid < 0 || !(*main_table)->leaders[pid]) {
+        pid = RandomPartition((*main_table)->leaders.size());
+    }
+    return pid;
+}
+
+std::shared_ptr<::openmldb::catalog::TabletAccessor> DBSDK::GetProcedureTablet(const std::string& db,
+                                                                               const std::string& sp_name,
+                                                                               const std::string& row,
+                                                                               std::string* msg) {
+    if (msg == nullptr) {
+        return {};
+    }
+    auto routing_table = GetRoutingTable();
+    const TableRoute* main_table = nullptr;
+    int32_t pid = RouteProcedure(*routing_table, db, sp_name, row, &main_table, msg);
+    if (pid < 0) {
+        return {};
+    }
+    return main_table->leaders[pid];
+}
+
+bool DBSDK::GetProcedureRoute(const std::string& db, const std::string& sp_name, const std::string& row,
+                              ProcedureRoute* route, std::string* msg) {
+    if (route == nullptr || msg == nullptr) {
+        return false;
+    }
+    auto routing_table = GetRoutingTable();
+    const TableRoute* main_table = nullptr;
+    int32_t pid = RouteProcedure(*routing_table, db, sp_name, row, &main_table, msg);
+    if (pid < 0) {
+        return false;
+    }
+    const auto* deployment = routing_table->GetDeployment(db, sp_name);
+    route->tid = main_table->handler->GetTid();
+    route->pid = pid;
+    route->leader = main_table->leaders[pid];
+    route->followers = main_table->followers[pid];
+    route->follower_read = deployment->IsFollowerRead();
+    route->max_follower_lag = deployment->GetMaxFollowerLag();
+    return true;
 }
 
 std::shared_ptr<hybridse::sdk::ProcedureInfo> DBSDK::GetProcedureInfo(const std::string& db, const std::string& sp_name,
@@ -584,13 +669,13 @@ std::shared_ptr<hybridse::sdk::ProcedureInfo> DBSDK::GetProcedureInfo(const std:
         *msg = "db or sp_name is empty";
         return {};
     } else {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        auto sp = catalog_->GetProcedureInfo(db, sp_name);
-        if (!sp) {
+        auto routing_table = GetRoutingTable();
+        const auto* deployment = routing_table->GetDeployment(db, sp_name);
+        if (deployment == nullptr) {
             *msg = sp_name + " does not exist in " + db;
             return {};
         }
-        return sp;
+        return deployment->GetProcedureInfo();
     }
 }
 
@@ -599,8 +684,8 @@ std::vector<std::shared_ptr<hybridse::sdk::ProcedureInfo>> DBSDK::GetProcedureIn
     if (msg == nullptr) {
         return std::move(sp_infos);
     }
-    std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-    auto& db_sp_map = catalog_->GetProcedures();
+    auto catalog = GetCatalog();
+    auto& db_sp_map = catalog->GetProcedures();
     for (const auto& db_kv : db_sp_map) {
         for (const auto& sp_kv : db_kv.second) {
             sp_infos.push_back(sp_kv.second);
@@ -617,7 +702,7 @@ bool StandAloneSDK::Init() {
     ::hybridse::vm::EngineOptions opt;
     opt.SetCompileOnly(true);
     opt.SetPlanOnly(true);
-    engine_ = new ::hybridse::vm::Engine(catalog_, opt);
+    engine_ = new ::hybridse::vm::Engine(GetCatalog(), opt);
     if (!InitExternalFun()) {
         return false;
     }
@@ -646,7 +731,7 @@ bool StandAloneSDK::BuildCatalog() {
         LOG(WARNING) << "show all table from ns failed, msg: " << msg;
         return false;
     }
-    std::map<std::string, std::map<std::string, std::shared_ptr<nameserver::TableInfo>>> mapping;
+    TableInfoMap mapping;
     auto new_catalog = std::make_shared<catalog::SDKCatalog>(client_manager_);
     for (const auto& table : tables) {
         auto& db_map = mapping[table.db()];
@@ -675,12 +760,7 @@ bool StandAloneSDK::BuildCatalog() {
         LOG(WARNING) << "fail to init catalog";
         return false;
     }
-    {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        table_to_tablets_ = mapping;
-        catalog_ = new_catalog;
-    }
-    engine_->UpdateCatalog(new_catalog);
+    UpdateRoutingTable(new_catalog, std::move(mapping));
     return true;
 }
 }  // namespace openmldb::sdk
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "client/tablet_client.h"
 #include "client/taskmanager_client.h"
 #include "common/thread_pool.h"
+#include "sdk/routing_table.h"
 #include "vm/catalog.h"
 #include "vm/engine.h"
 #include "zk/zk_client.h"
@@ -63,13 +65,21 @@ class DBSDK {
 
     virtual zk::ZkClient* GetZkClient() = 0;
 
-    bool Refresh() { return BuildCatalog(); }
+    bool Refresh() {
+        std::lock_guard<std::mutex> lock(refresh_mu_);
+        return BuildCatalog();
+    }
 
+    // the version of the routing table, it's increased in every catalog update
     inline uint64_t GetClusterVersion() { return cluster_version_.load(std::memory_order_relaxed); }
 
-    inline std::shared_ptr<::openmldb::catalog::SDKCatalog> GetCatalog() {
-        std::lock_guard<::openmldb::base::SpinMutex> lock(mu_);
-        return catalog_;
+    // The snapshot is never modified, hold it to read the tables and the procedures of one version
+    inline std::shared_ptr<const RoutingTable> GetRoutingTable() const {
+        return std::atomic_load_explicit(&routing_table_, std::memory_order_acquire);
+    }
+
+    inline std::shared_ptr<::openmldb::catalog::SDKCatalog> GetCatalog() const {
+        return GetRoutingTable()->GetCatalog();
     }
     inline ::hybridse::vm::Engine* GetEngine() { return engine_; }
 
@@ -91,6 +101,14 @@ class DBSDK {
                                                                    uint32_t pid);
     std::shared_ptr<::openmldb::catalog::TabletAccessor> GetTablet(const std::string& db, const std::string& name,
                                                                    const std::string& pk);
+    // The leader of the main table's partition which holds the key of the encoded request `row`. A random partition is
+    // used if the row is empty or can't be routed by its key
+    std::shared_ptr<::openmldb::catalog::TabletAccessor> GetProcedureTablet(const std::string& db,
+                                                                            const std::string& sp_name,
+                                                                            const std::string& row, std::string* msg);
+    // The replicas of the partition which is chosen like GetProcedureTablet, and the read policy of the deployment
+    bool GetProcedureRoute(const std::string& db, const std::string& sp_name, const std::string& row,
+                           ProcedureRoute* route, std::string* msg);
 
     std::shared_ptr<hybridse::sdk::ProcedureInfo> GetProcedureInfo(const std::string& db, const std::string& sp_name,
                                                                    std::string* msg);
@@ -107,19 +125,26 @@ class DBSDK {
     // build client_manager, then create a new catalog, replace the catalog in engine
     virtual bool BuildCatalog() = 0;
 
-    DBSDK() : client_manager_(new catalog::ClientManager), catalog_(new catalog::SDKCatalog(client_manager_)) {}
+    DBSDK()
+        : client_manager_(new catalog::ClientManager),
+          routing_table_(std::make_shared<RoutingTable>(0, std::make_shared<catalog::SDKCatalog>(client_manager_),
+                                                        TableInfoMap())) {}
+
+    // publish the new catalog with a new version, it's called by BuildCatalog
+    void UpdateRoutingTable(const std::shared_ptr<::openmldb::catalog::SDKCatalog>& catalog, TableInfoMap tables);
 
     static std::string GetFunSignature(const openmldb::common::ExternalFun& fun);
     bool InitExternalFun();
 
  protected:
     std::atomic<uint64_t> cluster_version_{0};
-    ::openmldb::base::Random rand_{0xdeadbeef};
 
     ::openmldb::base::SpinMutex mu_;
+    // BuildCatalog is called by one thread at a time
+    std::mutex refresh_mu_;
     std::shared_ptr<::openmldb::catalog::ClientManager> client_manager_;
-    std::shared_ptr<::openmldb::catalog::SDKCatalog> catalog_;
-    std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>> table_to_tablets_;
+    // only accessed by the atomic functions
+    std::shared_ptr<const RoutingTable> routing_table_;
 
     ::hybridse::vm::Engine* engine_ = nullptr;
     std::map<std::string, std::shared_ptr<openmldb::common::ExternalFun>> external_fun_;
@@ -170,6 +195,10 @@ class ClusterSDK : public DBSDK {
 
     ::openmldb::zk::ZkClient* zk_client_;
     ::baidu::common::ThreadPool pool_;
+    // the parsed values of the table and procedure nodes with their modified zxid. The catalog update only fetches
+    // and parses the changed nodes, it's guarded by refresh_mu_
+    std::map<std::string, std::pair<int64_t, std::shared_ptr<::openmldb::nameserver::TableInfo>>> table_nodes_;
+    std::map<std::string, std::pair<int64_t, std::shared_ptr<hybridse::sdk::ProcedureInfo>>> sp_nodes_;
 };
 
 class StandAloneSDK : public DBSDK {
@@ -217,7 +246,7 @@ class StandAloneSDK : public DBSDK {
 
  private:
     bool PeriodicRefresh() {
-        auto ok = BuildCatalog();
+        auto ok = Refresh();
         // periodic refreshing
         pool_.DelayTask(2000, [this] { PeriodicRefresh(); });
         return ok;
@@ -110,7 +110,17 @@ TEST_F(DBSDKTest, smokeTest) {
     auto ns_ptr = sdk.GetNsClient();
     ASSERT_TRUE(ns_ptr);
     ASSERT_EQ(ns_ptr->GetEndpoint(), mc_->GetNsClient()->GetEndpoint());
+
+    auto routing_table = sdk.GetRoutingTable();
+    ASSERT_EQ(routing_table->GetVersion(), sdk.GetClusterVersion());
+    const auto* route = routing_table->GetTable(db_name_, table_name_);
+    ASSERT_TRUE(route != nullptr);
+    ASSERT_EQ(tablet[3], routing_table->GetTablet(tid, 3));
     ASSERT_TRUE(sdk.Refresh());
+    // a new version is published, the unchanged table is not built again
+    auto new_routing_table = sdk.GetRoutingTable();
+    ASSERT_GT(new_routing_table->GetVersion(), routing_table->GetVersion());
+    ASSERT_EQ(route->handler, new_routing_table->GetTable(db_name_, table_name_)->handler);
 }
 
 // TODO(hw): StandAlone sdk can access cluster, but it's not a good test. Better to access StandAlone server.
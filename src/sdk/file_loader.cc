@@ -0,0 +1,228 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/file_loader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "base/line_chunk_reader.h"
+#include "base/taskpool.hpp"
+#include "codec/field_codec.h"
+#include "common/timer.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "sdk/split.h"
+
+DECLARE_int32(request_timeout_ms);
+
+namespace openmldb::sdk {
+
+FileLoader::FileLoader(const std::shared_ptr<InsertSQLCache>& insert_cache,
+                       const std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>>& tablets,
+                       const ReadFileOptionsParser& options, uint32_t thread_num, uint32_t max_inflight)
+    : insert_cache_(insert_cache),
+      tablets_(tablets),
+      options_(options),
+      str_cols_idx_(),
+      thread_num_(thread_num > 0 ? thread_num : 1),
+      max_inflight_(max_inflight > 0 ? max_inflight : 1),
+      row_cnt_(0),
+      failed_(false),
+      mu_(),
+      error_msg_() {
+    auto schema = insert_cache_->GetSchema();
+    for (int i = 0; i < schema->GetColumnCnt(); ++i) {
+        if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
+            str_cols_idx_.emplace_back(i);
+        }
+    }
+}
+
+hybridse::sdk::Status FileLoader::Load(const std::string& file_path, uint64_t offset, uint64_t first_line) {
+    ::openmldb::base::LineChunkReader reader;
+    if (!reader.Open(file_path, offset)) {
+        return {::hybridse::common::StatusCode::kCmdError, "open file failed"};
+    }
+    // the queue only holds a few chunks, the reader is blocked if the workers fall behind
+    ::openmldb::base::TaskPool pool(thread_num_, thread_num_ * 2);
+    uint64_t line_no = first_line;
+    while (!failed_.load(std::memory_order_relaxed)) {
+        auto chunk = std::make_shared<Chunk>();
+        if (!reader.Next(&chunk->data)) {
+            break;
+        }
+        chunk->first_line = line_no;
+        line_no += std::count(chunk->data.begin(), chunk->data.end(), '\n');
+        pool.AddTask([this, chunk]() { LoadChunk(chunk.get()); });
+    }
+    // the queued chunks are loaded before the workers exit
+    pool.Stop();
+    if (reader.HasError()) {
+        SetError("read from file failed");
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return {::hybridse::common::StatusCode::kCmdError, error_msg_};
+    }
+    return {};
+}
+
+void FileLoader::LoadChunk(Chunk* chunk) {
+    if (failed_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::vector<char*> cols;
+    std::deque<PendingPut> pending;
+    uint64_t line_no = chunk->first_line;
+    uint64_t row_cnt = 0;
+    // the lines are split in place, the data of a string is always null terminated
+    char* line = &chunk->data[0];
+    char* data_end = line + chunk->data.size();
+    bool ok = true;
+    while (line < data_end && ok) {
+        char* line_end = static_cast<char*>(memchr(line, '\n', data_end - line));
+        if (line_end == nullptr) {
+            line_end = data_end;
+        } else {
+            *line_end = '\0';
+        }
+        std::shared_ptr<SQLInsertRow> row;
+        if (!BuildRow(line, line_end - line, &cols, &row)) {
+            SetError("line " + std::to_string(line_no) + " insert failed, translate to insert row failed");
+            ok = false;
+        } else if (!PutRow(line_no, row, &pending)) {
+            ok = false;
+        } else {
+            row_cnt++;
+        }
+        line = line_end + 1;
+        line_no++;
+        if (failed_.load(std::memory_order_relaxed)) {
+            ok = false;
+        }
+    }
+    // wait for the rest requests even if failed, the callbacks must not outlive the loader
+    while (!pending.empty()) {
+        WaitPut(pending.front());
+        pending.pop_front();
+    }
+    row_cnt_.fetch_add(row_cnt, std::memory_order_relaxed);
+}
+
+bool FileLoader::BuildRow(char* line, size_t len, std::vector<char*>* cols, std::shared_ptr<SQLInsertRow>* row) {
+    cols->clear();
+    SplitLineWithDelimiter(line, len, options_.GetDelimiter().c_str(), cols, options_.GetQuote());
+    auto schema = insert_cache_->GetSchema();
+    int cnt = schema->GetColumnCnt();
+    if (cnt != static_cast<int>(cols->size())) {
+        return false;
+    }
+    const auto& null_value = options_.GetNullValue();
+    // scan all strings, calc the sum, to init SQLInsertRow's string length
+    size_t str_len_sum = 0;
+    for (auto idx : str_cols_idx_) {
+        if (null_value != (*cols)[idx]) {
+            str_len_sum += strlen((*cols)[idx]);
+        }
+    }
+    *row = std::make_shared<SQLInsertRow>(insert_cache_->GetTableInfo(), schema, insert_cache_->GetDefaultValue(),
+                                          insert_cache_->GetStrLength(), insert_cache_->GetHoleIdxArr());
+    (*row)->Init(static_cast<int>(str_len_sum));
+    for (int i = 0; i < cnt; ++i) {
+        if (!::openmldb::codec::AppendColumnValue((*cols)[i], schema->GetColumnType(i), schema->IsColumnNotNull(i),
+                                                  null_value, *row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FileLoader::PutRow(uint64_t line, const std::shared_ptr<SQLInsertRow>& row, std::deque<PendingPut>* pending) {
+    const auto& dimensions = row->GetDimensions();
+    uint64_t cur_ts = ::baidu::common::timer::get_micros() / 1000;
+    for (const auto& kv : dimensions) {
+        uint32_t pid = kv.first;
+        std::shared_ptr<::openmldb::client::TabletClient> client;
+        if (pid < tablets_.size() && tablets_[pid]) {
+            client = tablets_[pid]->GetClient();
+        }
+        if (!client) {
+            SetError("line " + std::to_string(line) + " insert failed, fail to get tablet client. pid " +
+                     std::to_string(pid));
+            return false;
+        }
+        ::openmldb::api::PutRequest request;
+        request.set_time(cur_ts);
+        request.set_value(row->GetRow());
+        request.set_tid(insert_cache_->GetTableId());
+        request.set_pid(pid);
+        for (const auto& dim : kv.second) {
+            ::openmldb::api::Dimension* d = request.add_dimensions();
+            d->set_key(dim.first);
+            d->set_idx(dim.second);
+        }
+        auto cntl = std::make_shared<brpc::Controller>();
+        cntl->set_timeout_ms(FLAGS_request_timeout_ms);
+        auto callback = new openmldb::RpcCallback<openmldb::api::PutResponse>(
+            std::make_shared<openmldb::api::PutResponse>(), cntl);
+        // one reference for the rpc and one for the waiter
+        callback->Ref();
+        if (!client->AsyncPut(request, callback)) {
+            callback->UnRef();
+            callback->UnRef();
+            SetError("line " + std::to_string(line) + " insert failed, fail to send put request to " +
+                     client->GetEndpoint());
+            return false;
+        }
+        pending->push_back({callback, line});
+        if (pending->size() >= max_inflight_) {
+            bool ok = WaitPut(pending->front());
+            pending->pop_front();
+            if (!ok) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool FileLoader::WaitPut(const PendingPut& put) {
+    auto* callback = put.callback;
+    brpc::Join(callback->GetController()->call_id());
+    bool ok = false;
+    if (callback->GetController()->Failed()) {
+        SetError("line " + std::to_string(put.line) + " insert failed, " + callback->GetController()->ErrorText());
+    } else if (callback->GetResponse()->code() != 0) {
+        SetError("line " + std::to_string(put.line) + " insert failed, " + callback->GetResponse()->msg());
+    } else {
+        ok = true;
+    }
+    callback->UnRef();
+    return ok;
+}
+
+void FileLoader::SetError(const std::string& msg) {
+    LOG(WARNING) << msg;
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!failed_.load(std::memory_order_relaxed)) {
+        error_msg_ = msg;
+        failed_.store(true, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace openmldb::sdk
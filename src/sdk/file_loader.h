@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_FILE_LOADER_H_
+#define SRC_SDK_FILE_LOADER_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "catalog/client_manager.h"
+#include "proto/tablet.pb.h"
+#include "rpc/rpc_client.h"
+#include "sdk/base.h"
+#include "sdk/file_option_parser.h"
+#include "sdk/sql_cache.h"
+#include "sdk/sql_insert_row.h"
+
+namespace openmldb::sdk {
+
+// FileLoader inserts the lines of a local csv file into an online table. The file is read by
+// large blocks which are cut into chunks on line boundaries. `thread_num` workers split the lines
+// of the chunks and encode the rows, then put the rows to the tablets asynchronously, every worker
+// keeps at most `max_inflight` put requests on the fly
+class FileLoader {
+ public:
+    // the put requests on the fly of each worker, enough to hide the latency of a round trip
+    static constexpr uint32_t DEFAULT_MAX_INFLIGHT = 64;
+
+    FileLoader(const std::shared_ptr<InsertSQLCache>& insert_cache,
+               const std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>>& tablets,
+               const ReadFileOptionsParser& options, uint32_t thread_num, uint32_t max_inflight);
+
+    // load the lines from `offset` of the file to the end, `first_line` is the line number at `offset`
+    hybridse::sdk::Status Load(const std::string& file_path, uint64_t offset, uint64_t first_line);
+
+    uint64_t GetRowCnt() const { return row_cnt_.load(std::memory_order_relaxed); }
+
+    FileLoader(const FileLoader&) = delete;
+    FileLoader& operator=(const FileLoader&) = delete;
+
+ private:
+    struct Chunk {
+        std::string data;
+        uint64_t first_line;
+    };
+
+    struct PendingPut {
+        openmldb::RpcCallback<openmldb::api::PutResponse>* callback;
+        uint64_t line;
+    };
+
+    void LoadChunk(Chunk* chunk);
+    bool BuildRow(char* line, size_t len, std::vector<char*>* cols, std::shared_ptr<SQLInsertRow>* row);
+    bool PutRow(uint64_t line, const std::shared_ptr<SQLInsertRow>& row, std::deque<PendingPut>* pending);
+    bool WaitPut(const PendingPut& put);
+    void SetError(const std::string& msg);
+
+    std::shared_ptr<InsertSQLCache> insert_cache_;
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets_;
+    const ReadFileOptionsParser& options_;
+    std::vector<int> str_cols_idx_;
+    const uint32_t thread_num_;
+    const uint32_t max_inflight_;
+
+    std::atomic<uint64_t> row_cnt_;
+    std::atomic<bool> failed_;
+    std::mutex mu_;
+    // the first error
+    std::string error_msg_;
+};
+
+}  // namespace openmldb::sdk
+#endif  // SRC_SDK_FILE_LOADER_H_
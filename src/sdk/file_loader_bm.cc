@@ -0,0 +1,117 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gflags/gflags.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <map>
+
+#include "benchmark/benchmark.h"
+#include "schema/schema_adapter.h"
+#include "sdk/db_sdk.h"
+#include "sdk/file_loader.h"
+#include "sdk/mini_cluster.h"
+#include "sdk/sql_router.h"
+#include "test/util.h"
+#include "vm/engine.h"
+
+::openmldb::sdk::MiniCluster* mc;
+
+static void GenerateCsv(const std::string& file_name, int64_t rows) {
+    std::ofstream ofile(file_name);
+    for (int64_t i = 0; i < rows; i++) {
+        ofile << "card" << i % 1000 << ",mcc" << i % 50 << "," << i << "," << i * 1.5 << "," << 1590738989000 + i
+              << "\n";
+    }
+}
+
+// load a generated csv of state.range(0) rows with state.range(1) threads
+static void BM_FileLoader(benchmark::State& state) {  // NOLINT
+    int64_t rows = state.range(0);
+    uint32_t thread_num = static_cast<uint32_t>(state.range(1));
+    std::string db = "db" + ::openmldb::test::GenRand();
+    std::string name = "test" + ::openmldb::test::GenRand();
+    ::openmldb::sdk::SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc->GetZkCluster();
+    sql_opt.zk_path = mc->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    if (!router) {
+        state.SkipWithError("fail to create router");
+        return;
+    }
+    ::hybridse::sdk::Status status;
+    router->CreateDB(db, &status);
+    std::string ddl = "create table " + name +
+                      " (card string, mcc string, amt bigint, price double, ts timestamp,"
+                      " index(key=card, ts=ts), index(key=mcc, ts=ts)) options(partitionnum=8);";
+    if (!router->ExecuteDDL(db, ddl, &status)) {
+        state.SkipWithError("fail to create table");
+        return;
+    }
+    router->RefreshCatalog();
+    std::string file_name = "/tmp/file_loader_bm_" + ::openmldb::test::GenRand() + ".csv";
+    GenerateCsv(file_name, rows);
+
+    ::openmldb::sdk::ClusterOptions option;
+    option.zk_cluster = mc->GetZkCluster();
+    option.zk_path = mc->GetZkPath();
+    ::openmldb::sdk::ClusterSDK sdk(option);
+    sdk.Init();
+    auto table_info = sdk.GetTableInfo(db, name);
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    if (!table_info || !sdk.GetTablet(db, name, &tablets)) {
+        state.SkipWithError("fail to get table");
+        return;
+    }
+    auto schema = ::openmldb::schema::SchemaAdapter::ConvertSchema(table_info->column_desc());
+    auto default_map = std::make_shared<std::map<uint32_t, std::shared_ptr<::hybridse::node::ConstNode>>>();
+    auto insert_cache = std::make_shared<::openmldb::sdk::InsertSQLCache>(
+        table_info, schema, default_map, 0, ::openmldb::sdk::SQLInsertRow::GetHoleIdxArr(default_map, {}, schema));
+    ::openmldb::sdk::ReadFileOptionsParser options;
+    for (auto _ : state) {
+        ::openmldb::sdk::FileLoader loader(insert_cache, tablets, options, thread_num,
+                                           ::openmldb::sdk::FileLoader::DEFAULT_MAX_INFLIGHT);
+        auto st = loader.Load(file_name, 0, 1);
+        if (!st.IsOK()) {
+            state.SkipWithError(st.msg.c_str());
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    unlink(file_name.c_str());
+}
+
+BENCHMARK(BM_FileLoader)
+    ->Args({100000, 1})
+    ->Args({100000, 4})
+    ->Args({100000, 8})
+    ->Args({1000000, 8})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    ::hybridse::vm::Engine::InitializeGlobalLLVM();
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::openmldb::sdk::MiniCluster mini_cluster(6181);
+    mc = &mini_cluster;
+    mini_cluster.SetUp(2);
+    sleep(2);
+    ::benchmark::RunSpecifiedBenchmarks();
+    mini_cluster.Close();
+}
@@ -145,7 +145,37 @@ class FileOptionsParser {
 
 class ReadFileOptionsParser : public FileOptionsParser {
  public:
-    ReadFileOptionsParser() { quote_ = '\0'; }
+    ReadFileOptionsParser() {
+        quote_ = '\0';
+        check_map_.emplace("thread", std::make_pair(CheckThread(), hybridse::node::kInt32));
+        check_map_.emplace("load_mode", std::make_pair(CheckLoadMode(), hybridse::node::kVarchar));
+    }
+    uint32_t GetThread() const { return thread_; }
+    const std::string& GetLoadMode() const { return load_mode_; }
+
+ private:
+    // the count of threads to parse and insert the rows
+    uint32_t thread_ = 1;
+    // client: the client reads the file and puts the rows to tablets
+    // tablet: the tablet reads the file on its local disk and writes the rows to the table directly
+    std::string load_mode_ = "client";
+    std::function<bool(const hybridse::node::ConstNode* node)> CheckLoadMode() {
+        return [this](const hybridse::node::ConstNode* node) {
+            load_mode_ = node->GetAsString();
+            boost::to_lower(load_mode_);
+            return load_mode_ == "client" || load_mode_ == "tablet";
+        };
+    }
+    std::function<bool(const hybridse::node::ConstNode* node)> CheckThread() {
+        return [this](const hybridse::node::ConstNode* node) {
+            int32_t thread = node->GetAsInt32();
+            if (thread <= 0) {
+                return false;
+            }
+            thread_ = static_cast<uint32_t>(thread);
+            return true;
+        };
+    }
 };
 
 class WriteFileOptionsParser : public FileOptionsParser {
@@ -0,0 +1,276 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/request_coalescer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <vector>
+
+#include "base/status.h"
+#include "glog/logging.h"
+#include "proto/tablet.pb.h"
+#include "rpc/rpc_client.h"
+#include "sdk/batch_request_result_set_sql.h"
+
+namespace openmldb::sdk {
+
+using BatchCallback = openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>;
+
+struct CoalescedBatch {
+    CoalescedBatch(const std::shared_ptr<hybridse::sdk::Schema>& schema, int64_t timeout)
+        : rows(std::make_shared<SQLRequestRowBatch>(schema, std::make_shared<ColumnIndicesSet>(schema))),
+          timeout_ms(timeout) {}
+
+    ~CoalescedBatch() {
+        if (callback) {
+            callback->UnRef();
+        }
+    }
+
+    // `cb` holds a reference for the batch, it's null if the request is not sent
+    void SetSent(BatchCallback* cb, const std::string& msg) {
+        std::lock_guard<std::mutex> lock(mu);
+        callback = cb;
+        error = msg;
+        sent.store(true, std::memory_order_release);
+        cv.notify_all();
+    }
+
+    bool WaitSent(hybridse::sdk::Status* status) {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [this] { return sent.load(std::memory_order_acquire); });
+        if (callback == nullptr) {
+            status->code = hybridse::common::kRpcError;
+            status->msg = error;
+            return false;
+        }
+        return true;
+    }
+
+    // Find the rows of the callers in the response. See SQLBatchRequestResultSet, the common row is the first one if
+    // there are common columns, and there is no other row if all the columns are common
+    bool Split() {
+        const auto& response = *callback->GetResponse();
+        const auto& buf = callback->GetController()->response_attachment();
+        if (response.count() != static_cast<uint32_t>(rows->Size())) {
+            LOG(WARNING) << "row count mismatch, request " << rows->Size() << ", response " << response.count();
+            return false;
+        }
+        size_t pos = 0;
+        uint32_t size = 0;
+        if (response.common_column_indices_size() > 0) {
+            if (buf.copy_to(&size, sizeof(size), 2) != sizeof(size) || size == 0 || size > buf.size()) {
+                return false;
+            }
+            common_size = size;
+            pos = size;
+        }
+        while (pos < buf.size()) {
+            if (buf.copy_to(&size, sizeof(size), pos + 2) != sizeof(size) || size == 0 || size > buf.size() - pos) {
+                return false;
+            }
+            row_ranges.emplace_back(pos, size);
+            pos += size;
+        }
+        return row_ranges.size() == response.count() || (row_ranges.empty() && common_size > 0);
+    }
+
+    // a result set of one row, it shares the blocks of the response attachment
+    std::shared_ptr<hybridse::sdk::ResultSet> GetResultSet(uint32_t idx, hybridse::sdk::Status* status) const {
+        const auto& src = *callback->GetResponse();
+        const auto& buf = callback->GetController()->response_attachment();
+        auto response = std::make_shared<openmldb::api::SQLBatchRequestQueryResponse>();
+        response->set_code(src.code());
+        response->set_msg(src.msg());
+        response->set_count(1);
+        response->set_schema(src.schema());
+        *response->mutable_common_column_indices() = src.common_column_indices();
+        auto cntl = std::make_shared<brpc::Controller>();
+        if (common_size > 0) {
+            buf.append_to(&cntl->response_attachment(), common_size, 0);
+            response->add_row_sizes(common_size);
+        }
+        if (!row_ranges.empty()) {
+            buf.append_to(&cntl->response_attachment(), row_ranges[idx].second, row_ranges[idx].first);
+            response->add_row_sizes(row_ranges[idx].second);
+        }
+        auto rs = std::make_shared<SQLBatchRequestResultSet>(response, cntl);
+        if (!rs->Init()) {
+            status->code = -1;
+            status->msg = "request error, resuletSetSQL init failed";
+            return nullptr;
+        }
+        return rs;
+    }
+
+    std::shared_ptr<SQLRequestRowBatch> rows;
+    int64_t timeout_ms;
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::atomic<bool> sent{false};
+    std::string error;
+    BatchCallback* callback = nullptr;
+
+    std::once_flag split_once;
+    bool split_ok = false;
+    uint32_t common_size = 0;
+    // the offset and the size of every row
+    std::vector<std::pair<size_t, uint32_t>> row_ranges;
+};
+
+class CoalescedQueryFuture : public QueryFuture {
+ public:
+    CoalescedQueryFuture(const std::shared_ptr<CoalescedBatch>& batch, uint32_t idx) : batch_(batch), idx_(idx) {}
+
+    std::shared_ptr<hybridse::sdk::ResultSet> GetResultSet(hybridse::sdk::Status* status) override {
+        if (!status) {
+            return nullptr;
+        }
+        if (!batch_->WaitSent(status)) {
+            return nullptr;
+        }
+        auto* callback = batch_->callback;
+        brpc::Join(callback->GetController()->call_id());
+        if (callback->GetController()->Failed()) {
+            status->code = hybridse::common::kRpcError;
+            status->msg = "request error, " + callback->GetController()->ErrorText();
+            return nullptr;
+        }
+        if (callback->GetResponse()->code() != ::openmldb::base::kOk) {
+            status->code = callback->GetResponse()->code();
+            status->msg = "request error, " + callback->GetResponse()->msg();
+            return nullptr;
+        }
+        std::call_once(batch_->split_once, [this] { batch_->split_ok = batch_->Split(); });
+        if (!batch_->split_ok) {
+            status->code = -1;
+            status->msg = "request error, invalid rows in the response of the coalesced request";
+            return nullptr;
+        }
+        return batch_->GetResultSet(idx_, status);
+    }
+
+    bool IsDone() const override {
+        if (!batch_->sent.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return batch_->callback == nullptr || batch_->callback->IsDone();
+    }
+
+ private:
+    std::shared_ptr<CoalescedBatch> batch_;
+    uint32_t idx_;
+};
+
+RequestCoalescer::RequestCoalescer(uint32_t window_ms, uint32_t max_rows, bool is_debug, TabletGetter tablet_getter)
+    : window_ms_(window_ms),
+      max_rows_(max_rows > 0 ? max_rows : 1),
+      is_debug_(is_debug),
+      tablet_getter_(std::move(tablet_getter)),
+      mu_(),
+      pending_() {}
+
+RequestCoalescer::~RequestCoalescer() {
+    // the delayed flushes are dropped, so the pending batches are sent here
+    pool_.Stop(false);
+    std::map<Key, std::shared_ptr<CoalescedBatch>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        pending.swap(pending_);
+    }
+    for (const auto& kv : pending) {
+        Send(kv.first, kv.second);
+    }
+}
+
+std::shared_ptr<QueryFuture> RequestCoalescer::Call(const std::string& db, const std::string& sp_name,
+                                                    const std::shared_ptr<hybridse::sdk::Schema>& schema,
+                                                    const std::string& row, int64_t timeout_ms,
+                                                    hybridse::sdk::Status* status) {
+    if (status == nullptr) {
+        return {};
+    }
+    Key key(db, sp_name);
+    std::shared_ptr<CoalescedBatch> batch;
+    uint32_t idx = 0;
+    bool is_new = false;
+    bool is_full = false;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto& pending = pending_[key];
+        if (!pending) {
+            pending = std::make_shared<CoalescedBatch>(schema, timeout_ms);
+            is_new = true;
+        }
+        batch = pending;
+        idx = batch->rows->Size();
+        // no common column, so the row is added as it is
+        batch->rows->AddRow(row.data(), row.size());
+        // the batch should be finished before the earliest deadline of the callers
+        batch->timeout_ms = std::min(batch->timeout_ms, timeout_ms);
+        if (static_cast<uint32_t>(batch->rows->Size()) >= max_rows_) {
+            pending_.erase(key);
+            is_full = true;
+        }
+    }
+    if (is_full) {
+        Send(key, batch);
+    } else if (is_new) {
+        pool_.DelayTask(window_ms_, [this, key, batch] { FlushIfPending(key, batch); });
+    }
+    return std::make_shared<CoalescedQueryFuture>(batch, idx);
+}
+
+void RequestCoalescer::FlushIfPending(const Key& key, const std::shared_ptr<CoalescedBatch>& batch) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = pending_.find(key);
+        // the batch has been sent because it's full
+        if (it == pending_.end() || it->second != batch) {
+            return;
+        }
+        pending_.erase(it);
+    }
+    Send(key, batch);
+}
+
+void RequestCoalescer::Send(const Key& key, const std::shared_ptr<CoalescedBatch>& batch) {
+    hybridse::sdk::Status status;
+    auto tablet = tablet_getter_(key.first, key.second, &status);
+    if (!tablet) {
+        batch->SetSent(nullptr, "fail to get tablet, " + status.msg);
+        return;
+    }
+    auto cntl = std::make_shared<brpc::Controller>();
+    auto response = std::make_shared<openmldb::api::SQLBatchRequestQueryResponse>();
+    auto* callback = new BatchCallback(response, cntl);
+    // one reference for the rpc and one for the batch
+    callback->Ref();
+    if (!tablet->CallSQLBatchRequestProcedure(key.first, key.second, batch->rows, is_debug_, batch->timeout_ms,
+                                              callback)) {
+        callback->UnRef();
+        callback->UnRef();
+        batch->SetSent(nullptr, "request server error, fail to send request to " + tablet->GetEndpoint());
+        return;
+    }
+    DLOG(INFO) << "send " << batch->rows->Size() << " coalesced rows of " << key.first << "." << key.second;
+    batch->SetSent(callback, "");
+}
+
+}  // namespace openmldb::sdk
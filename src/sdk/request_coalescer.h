@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_REQUEST_COALESCER_H_
+#define SRC_SDK_REQUEST_COALESCER_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+
+#include "client/tablet_client.h"
+#include "common/thread_pool.h"
+#include "sdk/sql_request_row.h"
+#include "sdk/sql_router.h"
+
+namespace openmldb::sdk {
+
+struct CoalescedBatch;
+
+// Coalesce the concurrent async calls of a deployment into one SQLBatchRequestQuery. The rows which arrive in the
+// window are sent together, every caller gets a future of its own row. Only the deployments without common columns
+// can be coalesced, the rows of different callers may have different values in every column.
+class RequestCoalescer {
+ public:
+    using TabletGetter = std::function<std::shared_ptr<::openmldb::client::TabletClient>(
+        const std::string& db, const std::string& sp_name, hybridse::sdk::Status* status)>;
+
+    RequestCoalescer(uint32_t window_ms, uint32_t max_rows, bool is_debug, TabletGetter tablet_getter);
+    // the pending batches are sent before the coalescer is destroyed
+    ~RequestCoalescer();
+
+    // `schema` is the input schema of the deployment, `row` must be encoded by it
+    std::shared_ptr<QueryFuture> Call(const std::string& db, const std::string& sp_name,
+                                      const std::shared_ptr<hybridse::sdk::Schema>& schema, const std::string& row,
+                                      int64_t timeout_ms, hybridse::sdk::Status* status);
+
+ private:
+    using Key = std::pair<std::string, std::string>;
+
+    void FlushIfPending(const Key& key, const std::shared_ptr<CoalescedBatch>& batch);
+    void Send(const Key& key, const std::shared_ptr<CoalescedBatch>& batch);
+
+    uint32_t window_ms_;
+    uint32_t max_rows_;
+    bool is_debug_;
+    TabletGetter tablet_getter_;
+    std::mutex mu_;
+    // the batch of a deployment which is waiting for the end of the window
+    std::map<Key, std::shared_ptr<CoalescedBatch>> pending_;
+    ::baidu::common::ThreadPool pool_{1};
+};
+
+}  // namespace openmldb::sdk
+#endif  // SRC_SDK_REQUEST_COALESCER_H_
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/request_hedger.h"
+
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <vector>
+
+#include "base/status.h"
+#include "common/timer.h"
+#include "glog/logging.h"
+#include "proto/tablet.pb.h"
+#include "rpc/rpc_client.h"
+#include "sdk/result_set_sql.h"
+
+namespace openmldb::sdk {
+
+using QueryCallback = openmldb::RpcCallback<openmldb::api::QueryResponse>;
+
+// never destroyed, the callbacks may run while the process exits
+static bvar::Adder<uint64_t>& HedgeIssued() {
+    static auto* issued = new bvar::Adder<uint64_t>("sdk_hedged_request_count");
+    return *issued;
+}
+
+static bvar::Adder<uint64_t>& HedgeWon() {
+    static auto* won = new bvar::Adder<uint64_t>("sdk_hedged_request_win_count");
+    return *won;
+}
+
+struct HedgedCall {
+    explicit HedgedCall(const std::shared_ptr<bvar::LatencyRecorder>& recorder)
+        : latency(recorder), start_us(::baidu::common::timer::get_micros()) {}
+
+    ~HedgedCall() {
+        if (result) {
+            result->UnRef();
+        }
+        if (failed) {
+            failed->UnRef();
+        }
+    }
+
+    // the first successful response is taken, a failure is taken only if all the calls have failed
+    void OnDone(QueryCallback* callback, bool is_hedge) {
+        bool ok = !callback->GetController()->Failed() && callback->GetResponse()->code() == ::openmldb::base::kOk;
+        std::vector<brpc::CallId> to_cancel;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            pending--;
+            if (result != nullptr) {
+                return;
+            }
+            callback->Ref();
+            if (ok) {
+                result = callback;
+                to_cancel.swap(call_ids);
+                if (is_hedge) {
+                    HedgeWon() << 1;
+                }
+                *latency << ::baidu::common::timer::get_micros() - start_us;
+            } else if (failed == nullptr) {
+                failed = callback;
+            } else {
+                callback->UnRef();
+            }
+            FinishIfAllFailed();
+            if (result != nullptr) {
+                cv.notify_all();
+            }
+        }
+        // the finished calls are not affected
+        for (const auto& id : to_cancel) {
+            brpc::StartCancel(id);
+        }
+    }
+
+    // the lock must be held
+    void FinishIfAllFailed() {
+        if (result == nullptr && pending == 0) {
+            result = failed;
+            failed = nullptr;
+        }
+    }
+
+    QueryCallback* Wait() {
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [this] { return result != nullptr; });
+        return result;
+    }
+
+    bool IsDone() {
+        std::lock_guard<std::mutex> lock(mu);
+        return result != nullptr;
+    }
+
+    std::shared_ptr<bvar::LatencyRecorder> latency;
+    int64_t start_us;
+
+    std::mutex mu;
+    std::condition_variable cv;
+    // the calls which are sent and not done
+    uint32_t pending = 0;
+    std::vector<brpc::CallId> call_ids;
+    // the callbacks hold a reference for the call
+    QueryCallback* result = nullptr;
+    QueryCallback* failed = nullptr;
+};
+
+class HedgedCallback : public QueryCallback {
+ public:
+    HedgedCallback(const std::shared_ptr<HedgedCall>& call, bool is_hedge)
+        : QueryCallback(std::make_shared<openmldb::api::QueryResponse>(), std::make_shared<brpc::Controller>()),
+          call_(call),
+          is_hedge_(is_hedge) {}
+
+    void Run() override {
+        // the callback may be deleted in QueryCallback::Run
+        auto call = std::move(call_);
+        call->OnDone(this, is_hedge_);
+        QueryCallback::Run();
+    }
+
+ private:
+    std::shared_ptr<HedgedCall> call_;
+    bool is_hedge_;
+};
+
+class HedgedQueryFuture : public QueryFuture {
+ public:
+    explicit HedgedQueryFuture(const std::shared_ptr<HedgedCall>& call) : call_(call) {}
+
+    std::shared_ptr<hybridse::sdk::ResultSet> GetResultSet(hybridse::sdk::Status* status) override {
+        if (!status) {
+            return nullptr;
+        }
+        auto* callback = call_->Wait();
+        if (callback->GetController()->Failed()) {
+            status->code = hybridse::common::kRpcError;
+            status->msg = "request error, " + callback->GetController()->ErrorText();
+            return nullptr;
+        }
+        if (callback->GetResponse()->code() != ::openmldb::base::kOk) {
+            status->code = callback->GetResponse()->code();
+            status->msg = "request error, " + callback->GetResponse()->msg();
+            return nullptr;
+        }
+        return ResultSetSQL::MakeResultSet(callback->GetResponse(), callback->GetController(), status);
+    }
+
+    bool IsDone() const override { return call_->IsDone(); }
+
+ private:
+    std::shared_ptr<HedgedCall> call_;
+};
+
+// send the request to `tablet` unless the call has been finished. The callback is registered before it's sent, so
+// it's canceled if the other call wins in the meantime
+static bool Send(const std::shared_ptr<HedgedCall>& call, bool is_hedge, const std::string& db,
+                 const std::string& sp_name, const std::string& row, int64_t timeout_ms, bool is_debug,
+                 const std::shared_ptr<::openmldb::client::TabletClient>& tablet,
+                 const ::openmldb::api::FollowerRead* follower_read) {
+    auto* callback = new HedgedCallback(call, is_hedge);
+    {
+        std::lock_guard<std::mutex> lock(call->mu);
+        if (call->result != nullptr) {
+            callback->UnRef();
+            return true;
+        }
+        call->pending++;
+        call->call_ids.push_back(callback->GetController()->call_id());
+    }
+    if (is_hedge) {
+        HedgeIssued() << 1;
+        DLOG(INFO) << "hedge the call of " << db << "." << sp_name << " to " << tablet->GetEndpoint();
+    }
+    if (!tablet->CallProcedure(db, sp_name, row, timeout_ms, is_debug, callback, follower_read)) {
+        callback->UnRef();
+        std::lock_guard<std::mutex> lock(call->mu);
+        call->pending--;
+        call->FinishIfAllFailed();
+        if (call->result != nullptr) {
+            call->cv.notify_all();
+        }
+        return false;
+    }
+    return true;
+}
+
+RequestHedger::RequestHedger(uint32_t min_delay_ms, bool is_debug)
+    : min_delay_ms_(min_delay_ms), is_debug_(is_debug), mu_(), latencies_() {
+    // expose the counters before the first hedge
+    HedgeIssued();
+    HedgeWon();
+}
+
+RequestHedger::~RequestHedger() { pool_.Stop(false); }
+
+std::shared_ptr<QueryFuture> RequestHedger::Call(const std::string& db, const std::string& sp_name,
+                                                 const std::string& row, int64_t timeout_ms,
+                                                 const std::shared_ptr<::openmldb::client::TabletClient>& primary,
+                                                 const std::shared_ptr<::openmldb::client::TabletClient>& backup,
+                                                 const ::openmldb::api::FollowerRead* follower_read,
+                                                 hybridse::sdk::Status* status) {
+    if (status == nullptr) {
+        return {};
+    }
+    auto latency = GetLatency(Key(db, sp_name));
+    auto call = std::make_shared<HedgedCall>(latency);
+    if (!Send(call, false, db, sp_name, row, timeout_ms, is_debug_, primary, nullptr)) {
+        status->code = -1;
+        status->msg = "request server error, fail to send request to " + primary->GetEndpoint();
+        LOG(WARNING) << status->msg;
+        return {};
+    }
+    uint32_t delay_ms = GetDelay(*latency);
+    // the hedge must have some time to finish before the deadline of the caller
+    bool can_serve = backup == primary || follower_read != nullptr;
+    if (backup && can_serve && timeout_ms > static_cast<int64_t>(delay_ms)) {
+        bool is_debug = is_debug_;
+        std::shared_ptr<::openmldb::api::FollowerRead> backup_read;
+        if (follower_read != nullptr) {
+            backup_read = std::make_shared<::openmldb::api::FollowerRead>(*follower_read);
+        }
+        pool_.DelayTask(delay_ms, [call, backup, backup_read, db, sp_name, row, timeout_ms, delay_ms, is_debug] {
+            Send(call, true, db, sp_name, row, timeout_ms - delay_ms, is_debug, backup, backup_read.get());
+        });
+    }
+    return std::make_shared<HedgedQueryFuture>(call);
+}
+
+uint32_t RequestHedger::GetDelay(const std::string& db, const std::string& sp_name) {
+    return GetDelay(*GetLatency(Key(db, sp_name)));
+}
+
+uint32_t RequestHedger::GetDelay(const bvar::LatencyRecorder& latency) const {
+    // 0 if there is no response in the window
+    int64_t p95_ms = latency.latency_percentile(0.95) / 1000;
+    return std::max(min_delay_ms_, static_cast<uint32_t>(p95_ms));
+}
+
+uint64_t RequestHedger::GetIssuedCount() { return HedgeIssued().get_value(); }
+
+uint64_t RequestHedger::GetWonCount() { return HedgeWon().get_value(); }
+
+std::shared_ptr<bvar::LatencyRecorder> RequestHedger::GetLatency(const Key& key) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto& latency = latencies_[key];
+    if (!latency) {
+        latency = std::make_shared<bvar::LatencyRecorder>();
+    }
+    return latency;
+}
+
+}  // namespace openmldb::sdk
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_REQUEST_HEDGER_H_
+#define SRC_SDK_REQUEST_HEDGER_H_
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+
+#include "bvar/bvar.h"
+#include "client/tablet_client.h"
+#include "common/thread_pool.h"
+#include "sdk/sql_router.h"
+
+namespace openmldb::sdk {
+
+// Hedge the deployment calls against a slow tablet. The request is sent to the leader of the partition first, if the
+// response doesn't arrive in the hedge delay, the same request is sent again and the caller gets the response which
+// arrives first, the other call is canceled. The hedge goes to a follower of a deployment with read_policy follower,
+// which serves it on its local replica, and to the leader again otherwise. The hedge delay is the p95 latency of the
+// deployment in the recent window, and not less than `min_delay_ms`.
+class RequestHedger {
+ public:
+    RequestHedger(uint32_t min_delay_ms, bool is_debug);
+    // the hedges which are not sent yet are dropped
+    ~RequestHedger();
+
+    // `backup` may be null, then the call is not hedged. A hedge to another tablet than `primary` is sent only with
+    // `follower_read`, so the follower rejects the hedge when it lags behind, and the primary call is taken
+    std::shared_ptr<QueryFuture> Call(const std::string& db, const std::string& sp_name, const std::string& row,
+                                      int64_t timeout_ms,
+                                      const std::shared_ptr<::openmldb::client::TabletClient>& primary,
+                                      const std::shared_ptr<::openmldb::client::TabletClient>& backup,
+                                      const ::openmldb::api::FollowerRead* follower_read,
+                                      hybridse::sdk::Status* status);
+
+    // the hedge delay of the deployment in milliseconds
+    uint32_t GetDelay(const std::string& db, const std::string& sp_name);
+
+    // the counters of all the hedgers in the process, they are exposed as bvars too
+    static uint64_t GetIssuedCount();
+    static uint64_t GetWonCount();
+
+ private:
+    using Key = std::pair<std::string, std::string>;
+
+    std::shared_ptr<bvar::LatencyRecorder> GetLatency(const Key& key);
+    uint32_t GetDelay(const bvar::LatencyRecorder& latency) const;
+
+    uint32_t min_delay_ms_;
+    bool is_debug_;
+    std::mutex mu_;
+    // the latency of the responses which are taken by the callers, in microseconds
+    std::map<Key, std::shared_ptr<bvar::LatencyRecorder>> latencies_;
+    ::baidu::common::ThreadPool pool_{1};
+};
+
+}  // namespace openmldb::sdk
+#endif  // SRC_SDK_REQUEST_HEDGER_H_
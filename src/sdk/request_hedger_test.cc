@@ -0,0 +1,164 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/request_hedger.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "base/status.h"
+#include "brpc/server.h"
+#include "bthread/bthread.h"
+#include "client/tablet_client.h"
+#include "codec/fe_row_codec.h"
+#include "codec/fe_schema_codec.h"
+#include "codec/sql_rpc_row_codec.h"
+#include "gtest/gtest.h"
+#include "proto/tablet.pb.h"
+
+namespace openmldb::sdk {
+
+// responds to the deployment calls with a row of its id after the delay
+class MockTabletImpl : public ::openmldb::api::TabletServer {
+ public:
+    MockTabletImpl(int64_t id, uint32_t delay_ms) : id_(id), delay_ms_(delay_ms) {}
+
+    void Query(::google::protobuf::RpcController* controller, const ::openmldb::api::QueryRequest* request,
+               ::openmldb::api::QueryResponse* response, ::google::protobuf::Closure* done) override {
+        brpc::ClosureGuard done_guard(done);
+        call_cnt_.fetch_add(1, std::memory_order_relaxed);
+        if (request->has_follower_read()) {
+            follower_read_cnt_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (delay_ms_ > 0) {
+            bthread_usleep(delay_ms_ * 1000);
+        }
+        ::hybridse::vm::Schema schema;
+        auto column = schema.Add();
+        column->set_name("id");
+        column->set_type(::hybridse::type::kInt64);
+        std::string encoded_schema;
+        ::hybridse::codec::SchemaCodec::Encode(schema, &encoded_schema);
+        ::hybridse::codec::RowBuilder builder(schema);
+        uint32_t size = builder.CalTotalLength(0);
+        std::string row;
+        row.resize(size);
+        builder.SetBuffer(reinterpret_cast<int8_t*>(&(row[0])), size);
+        builder.AppendInt64(id_);
+        auto* cntl = static_cast<brpc::Controller*>(controller);
+        ::openmldb::codec::EncodeRpcRow(reinterpret_cast<const int8_t*>(row.data()), row.size(),
+                                        &cntl->response_attachment());
+        response->set_schema(encoded_schema);
+        response->set_byte_size(row.size());
+        response->set_count(1);
+        response->set_row_slices(1);
+        response->set_code(::openmldb::base::kOk);
+    }
+
+    uint32_t GetCallCount() const { return call_cnt_.load(std::memory_order_relaxed); }
+    uint32_t GetFollowerReadCount() const { return follower_read_cnt_.load(std::memory_order_relaxed); }
+
+ private:
+    int64_t id_;
+    uint32_t delay_ms_;
+    std::atomic<uint32_t> call_cnt_{0};
+    std::atomic<uint32_t> follower_read_cnt_{0};
+};
+
+class RequestHedgerTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        // the leader is delayed much longer than the hedge delay
+        leader_ = new MockTabletImpl(1, 2000);
+        follower_ = new MockTabletImpl(2, 0);
+        ASSERT_EQ(0, leader_server_.AddService(leader_, brpc::SERVER_OWNS_SERVICE));
+        ASSERT_EQ(0, follower_server_.AddService(follower_, brpc::SERVER_OWNS_SERVICE));
+        ASSERT_EQ(0, leader_server_.Start(LEADER_ENDPOINT, nullptr));
+        ASSERT_EQ(0, follower_server_.Start(FOLLOWER_ENDPOINT, nullptr));
+        leader_client_ = std::make_shared<::openmldb::client::TabletClient>(LEADER_ENDPOINT, "");
+        follower_client_ = std::make_shared<::openmldb::client::TabletClient>(FOLLOWER_ENDPOINT, "");
+        ASSERT_EQ(0, leader_client_->Init());
+        ASSERT_EQ(0, follower_client_->Init());
+    }
+
+    void TearDown() override {
+        leader_server_.Stop(0);
+        follower_server_.Stop(0);
+        leader_server_.Join();
+        follower_server_.Join();
+    }
+
+    static int64_t GetId(const std::shared_ptr<QueryFuture>& future) {
+        hybridse::sdk::Status status;
+        auto rs = future->GetResultSet(&status);
+        if (!rs || !rs->Next()) {
+            return -1;
+        }
+        return rs->GetInt64Unsafe(0);
+    }
+
+ protected:
+    static constexpr const char* LEADER_ENDPOINT = "127.0.0.1:19537";
+    static constexpr const char* FOLLOWER_ENDPOINT = "127.0.0.1:19538";
+
+    brpc::Server leader_server_;
+    brpc::Server follower_server_;
+    MockTabletImpl* leader_;
+    MockTabletImpl* follower_;
+    std::shared_ptr<::openmldb::client::TabletClient> leader_client_;
+    std::shared_ptr<::openmldb::client::TabletClient> follower_client_;
+};
+
+TEST_F(RequestHedgerTest, HedgeWinsWhenLeaderDelayed) {
+    RequestHedger hedger(10, false);
+    ::openmldb::api::FollowerRead follower_read;
+    follower_read.set_tid(1);
+    follower_read.set_pid(0);
+    follower_read.set_max_lag(10);
+    uint64_t issued = RequestHedger::GetIssuedCount();
+    uint64_t won = RequestHedger::GetWonCount();
+    hybridse::sdk::Status status;
+    auto future = hedger.Call("db", "d1", "row", 5000, leader_client_, follower_client_, &follower_read, &status);
+    ASSERT_TRUE(future) << status.msg;
+    // the follower serves the hedge long before the leader responds
+    ASSERT_EQ(2, GetId(future));
+    ASSERT_EQ(1u, leader_->GetCallCount());
+    ASSERT_EQ(0u, leader_->GetFollowerReadCount());
+    ASSERT_EQ(1u, follower_->GetCallCount());
+    ASSERT_EQ(1u, follower_->GetFollowerReadCount());
+    ASSERT_EQ(issued + 1, RequestHedger::GetIssuedCount());
+    ASSERT_EQ(won + 1, RequestHedger::GetWonCount());
+}
+
+TEST_F(RequestHedgerTest, NoFollowerHedgeWithoutFollowerRead) {
+    RequestHedger hedger(10, false);
+    uint64_t issued = RequestHedger::GetIssuedCount();
+    hybridse::sdk::Status status;
+    // a follower can't serve the call without FollowerRead, so it isn't hedged to
+    auto future = hedger.Call("db", "d1", "row", 5000, leader_client_, follower_client_, nullptr, &status);
+    ASSERT_TRUE(future) << status.msg;
+    ASSERT_EQ(1, GetId(future));
+    ASSERT_EQ(0u, follower_->GetCallCount());
+    ASSERT_EQ(issued, RequestHedger::GetIssuedCount());
+}
+
+}  // namespace openmldb::sdk
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -28,6 +28,7 @@
 #include "codec/row_codec.h"
 #include "glog/logging.h"
 #include "schema/schema_adapter.h"
+#include "sdk/columnar_result_set.h"
 
 namespace openmldb {
 namespace sdk {
@@ -71,6 +72,9 @@ std::shared_ptr<::hybridse::sdk::ResultSet> ResultSetSQL::MakeResultSet(
     if (!status || !response || !cntl) {
         return {};
     }
+    if (response->has_columnar()) {
+        return ColumnarResultSet::MakeResultSet(response, cntl, status);
+    }
     ::hybridse::vm::Schema schema;
     bool ok = ::hybridse::codec::SchemaCodec::Decode(response->schema(), &schema);
     if (!ok) {
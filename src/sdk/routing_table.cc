@@ -0,0 +1,213 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sdk/routing_table.h"
+
+#include <utility>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "base/hash.h"
+#include "glog/logging.h"
+#include "sdk/base_impl.h"
+
+namespace openmldb::sdk {
+
+// the key must be the same as the dimension which is built by SQLInsertRow
+static bool AppendKey(const ::hybridse::codec::RowView& view, const int8_t* row, uint32_t idx,
+                      ::hybridse::type::Type type, std::string* key) {
+    int32_t ret = 0;
+    switch (type) {
+        case ::hybridse::type::kBool: {
+            bool v = false;
+            ret = view.GetValue(row, idx, type, &v);
+            if (ret == 0) key->append(v ? "true" : "false");
+            break;
+        }
+        case ::hybridse::type::kInt16: {
+            int16_t v = 0;
+            ret = view.GetValue(row, idx, type, &v);
+            if (ret == 0) key->append(std::to_string(v));
+            break;
+        }
+        case ::hybridse::type::kInt32:
+        case ::hybridse::type::kDate: {
+            int32_t v = 0;
+            ret = view.GetValue(row, idx, type, &v);
+            if (ret == 0) key->append(std::to_string(v));
+            break;
+        }
+        case ::hybridse::type::kInt64:
+        case ::hybridse::type::kTimestamp: {
+            int64_t v = 0;
+            ret = view.GetValue(row, idx, type, &v);
+            if (ret == 0) key->append(std::to_string(v));
+            break;
+        }
+        case ::hybridse::type::kVarchar: {
+            const char* v = nullptr;
+            uint32_t len = 0;
+            ret = view.GetValue(row, idx, &v, &len);
+            if (ret == 0) {
+                if (len == 0) {
+                    key->append(::hybridse::codec::EMPTY_STRING);
+                } else {
+                    key->append(v, len);
+                }
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+    if (ret == 1) {
+        key->append(::hybridse::codec::NONETOKEN);
+        return true;
+    }
+    return ret == 0;
+}
+
+DeploymentRoute::DeploymentRoute(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                 const TableRoute* main_table)
+    : sp_info_(sp_info),
+      main_table_(main_table),
+      key_cols_(),
+      key_types_(),
+      row_view_(),
+      follower_read_(false),
+      max_follower_lag_(DEFAULT_MAX_FOLLOWER_LAG) {
+    const auto* policy = sp_info_->GetOption(READ_POLICY);
+    follower_read_ = policy != nullptr && absl::EqualsIgnoreCase(*policy, READ_POLICY_FOLLOWER);
+    const auto* max_lag = sp_info_->GetOption(MAX_FOLLOWER_LAG);
+    if (max_lag != nullptr && !absl::SimpleAtoi(*max_lag, &max_follower_lag_)) {
+        LOG(WARNING) << "invalid " << MAX_FOLLOWER_LAG << " " << *max_lag << " of deployment " << sp_info_->GetSpName();
+        follower_read_ = false;
+    }
+    if (main_table_ == nullptr || main_table_->leaders.empty()) {
+        return;
+    }
+    const auto* input_schema = dynamic_cast<const ::hybridse::sdk::SchemaImpl*>(&sp_info_->GetInputSchema());
+    if (input_schema == nullptr) {
+        return;
+    }
+    const auto& schema = input_schema->GetSchema();
+    for (const auto& column_key : main_table_->table_info->column_key()) {
+        if (column_key.flag() != 0) {
+            continue;
+        }
+        for (const auto& name : column_key.col_name()) {
+            int32_t pos = 0;
+            while (pos < schema.size() && schema.Get(pos).name() != name) {
+                pos++;
+            }
+            if (pos == schema.size() || schema.Get(pos).type() == ::hybridse::type::kFloat ||
+                schema.Get(pos).type() == ::hybridse::type::kDouble) {
+                key_cols_.clear();
+                key_types_.clear();
+                return;
+            }
+            key_cols_.push_back(pos);
+            key_types_.push_back(schema.Get(pos).type());
+        }
+        break;
+    }
+    if (!key_cols_.empty()) {
+        row_view_ = std::make_unique<::hybridse::codec::RowView>(schema);
+    }
+}
+
+int32_t DeploymentRoute::GetPartition(const int8_t* row, uint32_t size) const {
+    if (key_cols_.empty() || row == nullptr || size <= ::hybridse::codec::HEADER_LENGTH ||
+        ::hybridse::codec::RowView::GetSize(row) > size) {
+        return -1;
+    }
+    std::string key;
+    for (size_t i = 0; i < key_cols_.size(); i++) {
+        if (i > 0) {
+            key.push_back('|');
+        }
+        if (!AppendKey(*row_view_, row, key_cols_[i], key_types_[i], &key)) {
+            return -1;
+        }
+    }
+    return static_cast<int32_t>(::openmldb::base::hash64(key) % main_table_->leaders.size());
+}
+
+RoutingTable::RoutingTable(uint64_t version, const std::shared_ptr<::openmldb::catalog::SDKCatalog>& catalog,
+                           TableInfoMap table_infos)
+    : version_(version), catalog_(catalog), table_infos_(std::move(table_infos)) {
+    for (const auto& db_kv : table_infos_) {
+        for (const auto& table_kv : db_kv.second) {
+            auto table = catalog_->GetTable(db_kv.first, table_kv.first);
+            auto handler = std::dynamic_pointer_cast<::openmldb::catalog::SDKTableHandler>(table);
+            if (!handler) {
+                LOG(WARNING) << "table " << db_kv.first << "." << table_kv.first << " is not in the catalog";
+                continue;
+            }
+            auto& route = tables_[db_kv.first][table_kv.first];
+            route.table_info = table_kv.second;
+            route.handler = handler;
+            for (uint32_t pid = 0; pid < handler->GetPartitionNum(); pid++) {
+                auto tablet = handler->GetTablet(pid);
+                partitions_.emplace(PartitionKey(handler->GetTid(), pid), tablet);
+                route.leaders.push_back(std::move(tablet));
+                route.followers.push_back(handler->GetFollowers(pid));
+            }
+        }
+    }
+    for (const auto& db_kv : catalog_->GetProcedures()) {
+        for (const auto& sp_kv : db_kv.second) {
+            const auto& sp_info = sp_kv.second;
+            const std::string& main_db = sp_info->GetMainDb().empty() ? db_kv.first : sp_info->GetMainDb();
+            deployments_[db_kv.first][sp_kv.first] =
+                std::make_unique<DeploymentRoute>(sp_info, GetTable(main_db, sp_info->GetMainTable()));
+        }
+    }
+}
+
+const TableRoute* RoutingTable::GetTable(const std::string& db, const std::string& name) const {
+    auto db_it = tables_.find(db);
+    if (db_it == tables_.end()) {
+        return nullptr;
+    }
+    auto it = db_it->second.find(name);
+    if (it == db_it->second.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::shared_ptr<::openmldb::catalog::TabletAccessor> RoutingTable::GetTablet(uint32_t tid, uint32_t pid) const {
+    auto it = partitions_.find(PartitionKey(tid, pid));
+    if (it == partitions_.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+const DeploymentRoute* RoutingTable::GetDeployment(const std::string& db, const std::string& sp_name) const {
+    auto db_it = deployments_.find(db);
+    if (db_it == deployments_.end()) {
+        return nullptr;
+    }
+    auto it = db_it->second.find(sp_name);
+    if (it == db_it->second.end()) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+}  // namespace openmldb::sdk
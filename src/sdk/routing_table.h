@@ -0,0 +1,124 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_SDK_ROUTING_TABLE_H_
+#define SRC_SDK_ROUTING_TABLE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/sdk_catalog.h"
+#include "codec/fe_row_codec.h"
+#include "proto/name_server.pb.h"
+#include "sdk/base.h"
+
+namespace openmldb::sdk {
+
+using TableInfoMap =
+    std::map<std::string, std::map<std::string, std::shared_ptr<::openmldb::nameserver::TableInfo>>>;
+
+// The deploy options of the read policy, e.g. `DEPLOY d OPTIONS(read_policy="follower", max_follower_lag=1000) ...`.
+// With the follower policy, the requests are spread across the leader and the followers of the partition, a follower
+// serves the request only if it's not behind the leader by more than max_follower_lag log entries
+inline constexpr const char* READ_POLICY = "read_policy";
+inline constexpr const char* READ_POLICY_LEADER = "leader";
+inline constexpr const char* READ_POLICY_FOLLOWER = "follower";
+inline constexpr const char* MAX_FOLLOWER_LAG = "max_follower_lag";
+inline constexpr uint64_t DEFAULT_MAX_FOLLOWER_LAG = 1000;
+
+struct TableRoute {
+    std::shared_ptr<::openmldb::nameserver::TableInfo> table_info;
+    std::shared_ptr<::openmldb::catalog::SDKTableHandler> handler;
+    // indexed by pid, an element is null if the leader of the partition is not connected
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> leaders;
+    // indexed by pid, the alive and connected followers of the partition
+    std::vector<std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>>> followers;
+};
+
+// the replicas of the main table's partition which a request row of a deployment is routed to
+struct ProcedureRoute {
+    uint32_t tid = 0;
+    uint32_t pid = 0;
+    // may be null if it's not connected
+    std::shared_ptr<::openmldb::catalog::TabletAccessor> leader;
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> followers;
+    // the read policy of the deployment, the followers can serve the requests only if it's true
+    bool follower_read = false;
+    uint64_t max_follower_lag = 0;
+};
+
+// The route of a deployment. The request row is sent to the leader of the partition which holds its key in the first
+// index of the main table, so the tablet can read the window of the main table locally. The positions of the key
+// columns in the input schema are found when the routing table is built, only the key columns of the row are read
+class DeploymentRoute {
+ public:
+    DeploymentRoute(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info, const TableRoute* main_table);
+
+    const std::shared_ptr<hybridse::sdk::ProcedureInfo>& GetProcedureInfo() const { return sp_info_; }
+    // null if the main table is not found
+    const TableRoute* GetMainTable() const { return main_table_; }
+    // the pid of the encoded request row in the main table, -1 if the row can't be routed by its key
+    int32_t GetPartition(const int8_t* row, uint32_t size) const;
+    bool IsFollowerRead() const { return follower_read_; }
+    uint64_t GetMaxFollowerLag() const { return max_follower_lag_; }
+
+ private:
+    std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info_;
+    const TableRoute* main_table_;
+    // empty if some key column is not in the input schema or its type can't be a key
+    std::vector<uint32_t> key_cols_;
+    std::vector<::hybridse::type::Type> key_types_;
+    // only the const methods are used, so it's shared by the callers
+    std::unique_ptr<::hybridse::codec::RowView> row_view_;
+    bool follower_read_;
+    uint64_t max_follower_lag_;
+};
+
+// An immutable snapshot of the tables, the partition leaders and the procedures. The sdk builds a new one in every
+// catalog update and publishes it by an atomic store, the readers hold the snapshot and look up without any lock
+class RoutingTable {
+ public:
+    RoutingTable(uint64_t version, const std::shared_ptr<::openmldb::catalog::SDKCatalog>& catalog,
+                 TableInfoMap table_infos);
+
+    uint64_t GetVersion() const { return version_; }
+    const std::shared_ptr<::openmldb::catalog::SDKCatalog>& GetCatalog() const { return catalog_; }
+    const TableInfoMap& GetTableInfos() const { return table_infos_; }
+
+    const TableRoute* GetTable(const std::string& db, const std::string& name) const;
+    std::shared_ptr<::openmldb::catalog::TabletAccessor> GetTablet(uint32_t tid, uint32_t pid) const;
+    const DeploymentRoute* GetDeployment(const std::string& db, const std::string& sp_name) const;
+
+ private:
+    template <typename T>
+    using NameMap = std::unordered_map<std::string, std::unordered_map<std::string, T>>;
+
+    static uint64_t PartitionKey(uint32_t tid, uint32_t pid) { return static_cast<uint64_t>(tid) << 32 | pid; }
+
+    uint64_t version_;
+    std::shared_ptr<::openmldb::catalog::SDKCatalog> catalog_;
+    TableInfoMap table_infos_;
+    // the elements are not moved after the build, DeploymentRoute points to them
+    NameMap<TableRoute> tables_;
+    std::unordered_map<uint64_t, std::shared_ptr<::openmldb::catalog::TabletAccessor>> partitions_;
+    NameMap<std::unique_ptr<DeploymentRoute>> deployments_;
+};
+
+}  // namespace openmldb::sdk
+#endif  // SRC_SDK_ROUTING_TABLE_H_
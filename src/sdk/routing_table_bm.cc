@@ -0,0 +1,195 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/hash.h"
+#include "base/spinlock.h"
+#include "benchmark/benchmark.h"
+#include "catalog/base.h"
+#include "codec/fe_row_codec.h"
+#include "sdk/base_impl.h"
+#include "sdk/routing_table.h"
+
+namespace openmldb {
+namespace sdk {
+
+static constexpr uint32_t TABLE_CNT = 64;
+static constexpr uint32_t PID_NUM = 8;
+static constexpr uint32_t ENDPOINT_CNT = 4;
+static constexpr uint32_t KEY_CNT = 1024;
+
+// The routing state of a cluster with TABLE_CNT tables and a deployment on every table. The clients are never
+// connected, only the lookups are measured
+struct RoutingEnv {
+    RoutingEnv() : client_manager(std::make_shared<catalog::ClientManager>()) {
+        std::map<std::string, std::shared_ptr<client::TabletClient>> clients;
+        for (uint32_t i = 0; i < ENDPOINT_CNT; i++) {
+            std::string endpoint = "127.0.0.1:" + std::to_string(10921 + i);
+            clients.emplace(endpoint, std::make_shared<client::TabletClient>(endpoint, endpoint));
+        }
+        client_manager->UpdateClient(clients);
+
+        std::vector<nameserver::TableInfo> tables;
+        catalog::Procedures procedures;
+        TableInfoMap table_infos;
+        for (uint32_t i = 0; i < TABLE_CNT; i++) {
+            auto table_info = std::make_shared<nameserver::TableInfo>();
+            table_info->set_db("db");
+            table_info->set_name("t" + std::to_string(i));
+            table_info->set_tid(i + 1);
+            table_info->set_format_version(1);
+            api::ProcedureInfo sp;
+            sp.set_db_name("db");
+            sp.set_sp_name("d" + std::to_string(i));
+            sp.set_main_db("db");
+            sp.set_main_table(table_info->name());
+            sp.set_type(type::kReqDeployment);
+            for (const auto& kv : std::vector<std::pair<std::string, type::DataType>>{
+                     {"card", type::kString}, {"amt", type::kBigInt}, {"ts", type::kTimestamp}}) {
+                auto col = table_info->add_column_desc();
+                col->set_name(kv.first);
+                col->set_data_type(kv.second);
+                *sp.add_input_schema() = *col;
+                *sp.add_output_schema() = *col;
+            }
+            auto index = table_info->add_column_key();
+            index->set_index_name("index0");
+            index->add_col_name("card");
+            index->set_ts_name("ts");
+            for (uint32_t pid = 0; pid < PID_NUM; pid++) {
+                auto partition = table_info->add_table_partition();
+                partition->set_pid(pid);
+                auto meta = partition->add_partition_meta();
+                meta->set_endpoint("127.0.0.1:" + std::to_string(10921 + (i + pid) % ENDPOINT_CNT));
+                meta->set_is_leader(true);
+                meta->set_is_alive(true);
+            }
+            tables.push_back(*table_info);
+            table_infos["db"].emplace(table_info->name(), table_info);
+            procedures["db"].emplace(sp.sp_name(), std::make_shared<catalog::ProcedureInfoImpl>(sp));
+            table_names.push_back(table_info->name());
+            sp_names.push_back(sp.sp_name());
+        }
+        catalog = std::make_shared<catalog::SDKCatalog>(client_manager);
+        catalog->Init(tables, procedures);
+        routing_table = std::make_shared<RoutingTable>(1, catalog, table_infos);
+
+        const auto& input_schema =
+            dynamic_cast<const ::hybridse::sdk::SchemaImpl&>(procedures["db"]["d0"]->GetInputSchema());
+        ::hybridse::codec::RowBuilder builder(input_schema.GetSchema());
+        for (uint32_t i = 0; i < KEY_CNT; i++) {
+            keys.push_back("card_" + std::to_string(i));
+            std::string row(builder.CalTotalLength(keys.back().size()), '\0');
+            builder.SetBuffer(reinterpret_cast<int8_t*>(&row[0]), row.size());
+            builder.AppendString(keys.back().data(), keys.back().size());
+            builder.AppendInt64(i * 13);
+            builder.AppendTimestamp(1590738989000 + i);
+            rows.push_back(std::move(row));
+        }
+    }
+
+    std::shared_ptr<catalog::ClientManager> client_manager;
+    // the catalog which is guarded by a lock, the way before the routing table
+    base::SpinMutex mu;
+    std::shared_ptr<catalog::SDKCatalog> catalog;
+    std::shared_ptr<const RoutingTable> routing_table;
+    std::vector<std::string> table_names;
+    std::vector<std::string> sp_names;
+    std::vector<std::string> keys;
+    std::vector<std::string> rows;
+};
+
+static RoutingEnv* GetEnv() {
+    static RoutingEnv env;
+    return &env;
+}
+
+// lock the catalog, then find the handler in the maps and route the key by it
+static void BM_RouteByLockedCatalog(benchmark::State& state) {  // NOLINT
+    auto* env = GetEnv();
+    uint32_t i = 0;
+    for (auto _ : state) {
+        std::shared_ptr<catalog::SDKCatalog> catalog;
+        {
+            std::lock_guard<base::SpinMutex> lock(env->mu);
+            catalog = env->catalog;
+        }
+        auto table = catalog->GetTable("db", env->table_names[i % TABLE_CNT]);
+        auto* handler = dynamic_cast<catalog::SDKTableHandler*>(table.get());
+        const auto& key = env->keys[i % KEY_CNT];
+        benchmark::DoNotOptimize(handler->GetTablet(base::hash64(key) % handler->GetPartitionNum()));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_RouteBySnapshot(benchmark::State& state) {  // NOLINT
+    auto* env = GetEnv();
+    uint32_t i = 0;
+    for (auto _ : state) {
+        auto routing_table = std::atomic_load_explicit(&env->routing_table, std::memory_order_acquire);
+        const auto* route = routing_table->GetTable("db", env->table_names[i % TABLE_CNT]);
+        const auto& key = env->keys[i % KEY_CNT];
+        benchmark::DoNotOptimize(route->leaders[base::hash64(key) % route->leaders.size()]);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_RouteByPartitionId(benchmark::State& state) {  // NOLINT
+    auto* env = GetEnv();
+    uint32_t i = 0;
+    for (auto _ : state) {
+        auto routing_table = std::atomic_load_explicit(&env->routing_table, std::memory_order_acquire);
+        benchmark::DoNotOptimize(routing_table->GetTablet(i % TABLE_CNT + 1, i % PID_NUM));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// the key is read from the encoded request row by the precomputed positions
+static void BM_RouteDeploymentRow(benchmark::State& state) {  // NOLINT
+    auto* env = GetEnv();
+    uint32_t i = 0;
+    for (auto _ : state) {
+        auto routing_table = std::atomic_load_explicit(&env->routing_table, std::memory_order_acquire);
+        const auto* deployment = routing_table->GetDeployment("db", env->sp_names[i % TABLE_CNT]);
+        const auto& row = env->rows[i % KEY_CNT];
+        int32_t pid = deployment->GetPartition(reinterpret_cast<const int8_t*>(row.data()), row.size());
+        if (pid < 0) {
+            state.SkipWithError("fail to route the row");
+            return;
+        }
+        benchmark::DoNotOptimize(deployment->GetMainTable()->leaders[pid]);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RouteByLockedCatalog)->Threads(1)->Threads(64)->UseRealTime();
+BENCHMARK(BM_RouteBySnapshot)->Threads(1)->Threads(64)->UseRealTime();
+BENCHMARK(BM_RouteByPartitionId)->Threads(1)->Threads(64)->UseRealTime();
+BENCHMARK(BM_RouteDeploymentRow)->Threads(1)->Threads(64)->UseRealTime();
+
+}  // namespace sdk
+}  // namespace openmldb
+
+BENCHMARK_MAIN();
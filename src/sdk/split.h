@@ -21,6 +21,8 @@
 #ifndef SRC_SDK_SPLIT_H_
 #define SRC_SDK_SPLIT_H_
 
+#include <string.h>
+
 #include <string>
 #include <vector>
 
@@ -94,8 +96,30 @@ static char* strdup_with_new(const char* the_string) {
 // See //util/csv/parser.h for more complete documentation.
 //
 // ----------------------------------------------------------------------
-static void SplitLineWithDelimiter(char* line, const char* delimiter, std::vector<char*>* cols, const char enclosed) {
-    char* end_of_line = line + strlen(line);
+// find the first delimiter in [begin, end), return end if not found. memchr is vectorized by the libc,
+// so the bytes between the delimiters are skipped by blocks rather than one by one
+static inline char* FindDelimiter(char* begin, char* end, const char* delimiter, size_t delimiter_len) {
+    if (delimiter_len == 1) {
+        auto pos = static_cast<char*>(memchr(begin, delimiter[0], end - begin));
+        return pos == nullptr ? end : pos;
+    }
+    while (static_cast<size_t>(end - begin) >= delimiter_len) {
+        auto pos = static_cast<char*>(memchr(begin, delimiter[0], end - begin - delimiter_len + 1));
+        if (pos == nullptr) {
+            break;
+        }
+        if (memcmp(pos, delimiter, delimiter_len) == 0) {
+            return pos;
+        }
+        begin = pos + 1;
+    }
+    return end;
+}
+
+// split the line of `len` bytes, line[len] must be '\0'
+static void SplitLineWithDelimiter(char* line, size_t len, const char* delimiter, std::vector<char*>* cols,
+                                   const char enclosed) {
+    char* end_of_line = line + len;
     char* end;
     char* start;
     size_t delimiter_len = strlen(delimiter);
@@ -107,22 +131,16 @@ static void SplitLineWithDelimiter(char* line, const char* delimiter, std::vecto
         if (enclosed != '\0' && *line == enclosed) {  // Quoted value...
             start = ++line;
             // Will get line until end if only one enclosed ['"']
-            for (; *line; line++) {
-                // TODO(zekai): Support \ , so we can load data like "abc\"def\"ghi"
-                if (*line == enclosed) {
-                    line++;
-                    break;
-                }
-            }
+            // TODO(zekai): Support \ , so we can load data like "abc\"def\"ghi"
+            line = static_cast<char*>(memchr(line, enclosed, end_of_line - line));
+            line = line == nullptr ? end_of_line : line + 1;
             end = line - 1;
             // All characters after the closing quote and before the comma
             // are ignored.
-            line = strstr(line, delimiter);
-            if (!line) line = end_of_line;
+            line = FindDelimiter(line, end_of_line, delimiter, delimiter_len);
         } else {
             start = line;
-            line = strstr(line, delimiter);
-            if (!line) line = end_of_line;
+            line = FindDelimiter(line, end_of_line, delimiter, delimiter_len);
             // Skip all trailing whitespace
             for (end = line; end > start; --end) {
                 if (!absl::ascii_isspace(end[-1])) {
@@ -148,13 +166,17 @@ static void SplitLineWithDelimiter(char* line, const char* delimiter, std::vecto
     }
 }
 
+static void SplitLineWithDelimiter(char* line, const char* delimiter, std::vector<char*>* cols, const char enclosed) {
+    SplitLineWithDelimiter(line, strlen(line), delimiter, cols, enclosed);
+}
+
 static void SplitLineWithDelimiterForStrings(const std::string& line, const std::string& delimiter,
                                       std::vector<std::string>* cols, const char enclosed) {
     // Unfortunately, the interface requires char* instead of const char*
     // which requires copying the string.
     char* cline = strndup_with_new(line.c_str(), line.size());
     std::vector<char*> v;
-    SplitLineWithDelimiter(cline, delimiter.c_str(), &v, enclosed);
+    SplitLineWithDelimiter(cline, strlen(cline), delimiter.c_str(), &v, enclosed);
     for (auto& ci : v) {
         cols->push_back(ci);
     }
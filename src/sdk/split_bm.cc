@@ -0,0 +1,145 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "codec/codec.h"
+#include "codec/field_codec.h"
+#include "sdk/split.h"
+
+namespace openmldb {
+namespace sdk {
+
+static const std::vector<std::pair<std::string, hybridse::sdk::DataType>> COLUMNS = {
+    {"card", hybridse::sdk::kTypeString},  {"mcc", hybridse::sdk::kTypeString},
+    {"amt", hybridse::sdk::kTypeInt64},    {"price", hybridse::sdk::kTypeDouble},
+    {"ts", hybridse::sdk::kTypeTimestamp}, {"date", hybridse::sdk::kTypeDate},
+    {"cnt", hybridse::sdk::kTypeInt32},    {"flag", hybridse::sdk::kTypeBool},
+};
+
+static std::vector<std::string> GenerateLines(int64_t cnt) {
+    std::vector<std::string> lines;
+    for (int64_t i = 0; i < cnt; i++) {
+        lines.push_back("card_" + std::to_string(i % 10000) + ", mcc_" + std::to_string(i % 50) + "," +
+                        std::to_string(i * 13) + "," + std::to_string(i * 1.25) + "," +
+                        std::to_string(1590738989000 + i) + ",2021-05-" + std::to_string(i % 28 + 1) + "," +
+                        std::to_string(i % 100) + "," + (i % 2 == 0 ? "true" : "false"));
+    }
+    return lines;
+}
+
+static int64_t TotalBytes(const std::vector<std::string>& lines) {
+    int64_t bytes = 0;
+    for (const auto& line : lines) {
+        bytes += line.size() + 1;
+    }
+    return bytes;
+}
+
+static void BM_SplitLineForStrings(benchmark::State& state) {  // NOLINT
+    auto lines = GenerateLines(state.range(0));
+    std::vector<std::string> cols;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            cols.clear();
+            SplitLineWithDelimiterForStrings(line, ",", &cols, '\0');
+            benchmark::DoNotOptimize(cols.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(lines));
+}
+
+static void BM_SplitLineInPlace(benchmark::State& state) {  // NOLINT
+    auto lines = GenerateLines(state.range(0));
+    std::vector<char*> cols;
+    std::string buf;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            // the split writes to the line, copy it like the loader reads a chunk
+            buf.assign(line);
+            cols.clear();
+            SplitLineWithDelimiter(&buf[0], buf.size(), ",", &cols, '\0');
+            benchmark::DoNotOptimize(cols.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(lines));
+}
+
+// split the lines and encode them to rows
+static void BM_ParseRow(benchmark::State& state) {  // NOLINT
+    auto lines = GenerateLines(state.range(0));
+    ::openmldb::codec::Schema schema;
+    for (const auto& kv : COLUMNS) {
+        auto col = schema.Add();
+        col->set_name(kv.first);
+        switch (kv.second) {
+            case hybridse::sdk::kTypeString:
+                col->set_data_type(::openmldb::type::kString);
+                break;
+            case hybridse::sdk::kTypeInt64:
+                col->set_data_type(::openmldb::type::kBigInt);
+                break;
+            case hybridse::sdk::kTypeDouble:
+                col->set_data_type(::openmldb::type::kDouble);
+                break;
+            case hybridse::sdk::kTypeTimestamp:
+                col->set_data_type(::openmldb::type::kTimestamp);
+                break;
+            case hybridse::sdk::kTypeDate:
+                col->set_data_type(::openmldb::type::kDate);
+                break;
+            case hybridse::sdk::kTypeInt32:
+                col->set_data_type(::openmldb::type::kInt);
+                break;
+            default:
+                col->set_data_type(::openmldb::type::kBool);
+                break;
+        }
+    }
+    ::openmldb::codec::RowBuilder builder(schema);
+    std::vector<char*> cols;
+    std::string buf;
+    std::string row;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            buf.assign(line);
+            cols.clear();
+            SplitLineWithDelimiter(&buf[0], buf.size(), ",", &cols, '\0');
+            uint32_t str_len = strlen(cols[0]) + strlen(cols[1]);
+            row.resize(builder.CalTotalLength(str_len));
+            builder.SetBuffer(reinterpret_cast<int8_t*>(&row[0]), row.size());
+            for (size_t i = 0; i < COLUMNS.size(); i++) {
+                if (!::openmldb::codec::AppendColumnValue(cols[i], COLUMNS[i].second, false, "null", &builder)) {
+                    state.SkipWithError("parse failed");
+                    return;
+                }
+            }
+            benchmark::DoNotOptimize(row.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * TotalBytes(lines));
+}
+
+BENCHMARK(BM_SplitLineForStrings)->Args({1000});
+BENCHMARK(BM_SplitLineInPlace)->Args({1000});
+BENCHMARK(BM_ParseRow)->Args({1000});
+
+}  // namespace sdk
+}  // namespace openmldb
+
+BENCHMARK_MAIN();
@@ -51,6 +51,8 @@ static const std::vector<SplitTestCase> cases = {
     { { "ab", "cd", "ef" }, "ab cd ef", " ", '\0' },
     { { "ab", "", "cd", "", "ef" }, "ab  cd  ef", " ", '\0' },
     { { "ab ", "cd", "", "ef" }, "\"ab \" cd  ef", " ", '"' },
+    { { "a--b", "c-", "" }, "a--b---c- ---", "---", '\0' },
+    { { "a,b", "c" }, "\"a,b\" x,c", ",", '"' },
 };
 
 INSTANTIATE_TEST_SUITE_P(SplitLine, SplitTest, testing::ValuesIn(cases));
@@ -67,6 +69,19 @@ TEST_P(SplitTest, SplitLineWithDelimiterForStrings) {
     }
 }
 
+TEST_P(SplitTest, SplitLineWithDelimiterInPlace) {
+    auto& c = GetParam();
+    std::string line = c.input;
+    std::vector<char*> splited;
+    SplitLineWithDelimiter(&line[0], line.size(), c.delimit.c_str(), &splited, c.enclosed);
+
+    ASSERT_EQ(c.expect.size(), splited.size()) << "splited list size not match";
+
+    for (size_t i = 0; i < c.expect.size(); i++) {
+        EXPECT_STREQ(c.expect[i].c_str(), splited[i]);
+    }
+}
+
 }  // namespace sdk
 }  // namespace openmldb
 
@@ -16,14 +16,20 @@
 
 #include "sdk/sql_cluster_router.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/strip.h"
 #include "absl/strings/substitute.h"
@@ -45,6 +51,8 @@
 #include "sdk/base.h"
 #include "sdk/base_impl.h"
 #include "sdk/batch_request_result_set_sql.h"
+#include "sdk/columnar_result_set.h"
+#include "sdk/file_loader.h"
 #include "sdk/file_option_parser.h"
 #include "sdk/node_adapter.h"
 #include "sdk/result_set_sql.h"
@@ -52,6 +60,7 @@
 
 DECLARE_string(bucket_size);
 DECLARE_uint32(replica_num);
+DECLARE_uint32(tablet_client_channel_num);
 
 namespace openmldb {
 namespace sdk {
@@ -141,6 +150,74 @@ class QueryFutureImpl : public QueryFuture {
     openmldb::RpcCallback<openmldb::api::QueryResponse>* callback_;
 };
 
+// null if it fails to send the request
+static std::shared_ptr<QueryFuture> AsyncCallProcedure(const std::shared_ptr<openmldb::client::TabletClient>& tablet,
+                                                       const std::string& db, const std::string& sp_name,
+                                                       const std::string& row, int64_t timeout_ms, bool is_debug,
+                                                       const openmldb::api::FollowerRead* follower_read,
+                                                       hybridse::sdk::Status* status) {
+    auto response = std::make_shared<openmldb::api::QueryResponse>();
+    auto cntl = std::make_shared<brpc::Controller>();
+    auto* callback = new openmldb::RpcCallback<openmldb::api::QueryResponse>(response, cntl);
+    auto future = std::make_shared<QueryFutureImpl>(callback);
+    if (!tablet->CallProcedure(db, sp_name, row, timeout_ms, is_debug, callback, follower_read)) {
+        status->code = -1;
+        status->msg = "request server error, fail to send request to " + tablet->GetEndpoint();
+        LOG(WARNING) << status->msg;
+        return {};
+    }
+    return future;
+}
+
+// The call which is served by a follower. If the follower fails or lags behind the leader, the call is sent to the
+// leader in GetResultSet with the rest of the timeout
+class FollowerReadQueryFuture : public QueryFuture {
+ public:
+    using Fallback = std::function<std::shared_ptr<QueryFuture>(int64_t timeout_ms, hybridse::sdk::Status* status)>;
+
+    FollowerReadQueryFuture(const std::shared_ptr<QueryFuture>& follower, int64_t deadline_us, Fallback fallback)
+        : follower_(follower), deadline_us_(deadline_us), fallback_(std::move(fallback)) {}
+
+    std::shared_ptr<hybridse::sdk::ResultSet> GetResultSet(hybridse::sdk::Status* status) override {
+        if (!status) {
+            return nullptr;
+        }
+        if (leader_) {
+            return leader_->GetResultSet(status);
+        }
+        auto rs = follower_->GetResultSet(status);
+        if (rs || !NeedFallback(status->code)) {
+            return rs;
+        }
+        int64_t timeout_ms = (deadline_us_ - ::baidu::common::timer::get_micros()) / 1000;
+        if (timeout_ms <= 0) {
+            return rs;
+        }
+        DLOG(INFO) << "send the call to the leader, " << status->msg;
+        hybridse::sdk::Status leader_status;
+        leader_ = fallback_(timeout_ms, &leader_status);
+        if (!leader_) {
+            return rs;
+        }
+        *status = hybridse::sdk::Status();
+        return leader_->GetResultSet(status);
+    }
+
+    // the follower has responded, the call to the leader is not counted
+    bool IsDone() const override { return follower_->IsDone(); }
+
+ private:
+    static bool NeedFallback(int code) {
+        return code == hybridse::common::kRpcError || code == ::openmldb::base::kFollowerLagTooLarge ||
+               code == ::openmldb::base::kTableIsNotExist || code == ::openmldb::base::kReplicatorIsNotExist;
+    }
+
+    std::shared_ptr<QueryFuture> follower_;
+    int64_t deadline_us_;
+    Fallback fallback_;
+    std::shared_ptr<QueryFuture> leader_;
+};
+
 class BatchQueryFutureImpl : public QueryFuture {
  public:
     explicit BatchQueryFutureImpl(openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback)
@@ -171,6 +248,9 @@ class BatchQueryFutureImpl : public QueryFuture {
             status->msg = "request error. " + callback_->GetController()->ErrorText();
             return nullptr;
         }
+        if (callback_->GetResponse()->has_columnar()) {
+            return ColumnarResultSet::MakeResultSet(callback_->GetResponse(), callback_->GetController(), status);
+        }
         std::shared_ptr<::openmldb::sdk::SQLBatchRequestResultSet> rs =
             std::make_shared<openmldb::sdk::SQLBatchRequestResultSet>(callback_->GetResponse(),
                                                                       callback_->GetController());
@@ -189,6 +269,58 @@ class BatchQueryFutureImpl : public QueryFuture {
     openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>* callback_;
 };
 
+class InsertFutureImpl : public InsertFuture {
+ public:
+    InsertFutureImpl() {}
+    ~InsertFutureImpl() {
+        for (auto* callback : callbacks_) {
+            callback->UnRef();
+        }
+    }
+
+    // the callback must hold a reference for the future
+    void Add(openmldb::RpcCallback<openmldb::api::PutResponse>* callback) { callbacks_.push_back(callback); }
+
+    bool Wait(hybridse::sdk::Status* status) override {
+        if (!status) {
+            return false;
+        }
+        size_t failed = 0;
+        for (auto* callback : callbacks_) {
+            brpc::Join(callback->GetController()->call_id());
+            if (callback->GetController()->Failed()) {
+                failed++;
+                status->msg = "put error, " + callback->GetController()->ErrorText();
+            } else if (callback->GetResponse()->code() != ::openmldb::base::kOk) {
+                failed++;
+                status->msg = "put error, " + callback->GetResponse()->msg();
+            }
+        }
+        if (failed > 0) {
+            status->code = hybridse::common::kRpcError;
+            status->msg += ", failed/total puts: " + std::to_string(failed) + "/" + std::to_string(callbacks_.size());
+            return false;
+        }
+        return true;
+    }
+
+    bool IsDone() const override {
+        return std::all_of(callbacks_.begin(), callbacks_.end(), [](const auto* callback) { return callback->IsDone(); });
+    }
+
+ private:
+    std::vector<openmldb::RpcCallback<openmldb::api::PutResponse>*> callbacks_;
+};
+
+static bool HasConstantColumn(const hybridse::sdk::Schema& schema) {
+    for (int i = 0; i < schema.GetColumnCnt(); i++) {
+        if (schema.IsConstant(i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 SQLClusterRouter::SQLClusterRouter(const SQLRouterOptions& options)
     : options_(std::make_shared<SQLRouterOptions>(options)),
       is_cluster_mode_(true),
@@ -219,7 +351,12 @@ SQLClusterRouter::SQLClusterRouter(DBSDK* sdk)
     }
 }
 
-SQLClusterRouter::~SQLClusterRouter() { delete cluster_sdk_; }
+SQLClusterRouter::~SQLClusterRouter() {
+    // the coalescer sends the pending requests by cluster_sdk_
+    coalescer_.reset();
+    hedger_.reset();
+    delete cluster_sdk_;
+}
 
 bool SQLClusterRouter::Init() {
     // set log first(If setup before, setup below won't work, e.g. router in tablet server, router in CLI)
@@ -227,6 +364,8 @@ bool SQLClusterRouter::Init() {
         // glog setting for SDK
         FLAGS_glog_level = options_->glog_level;
         FLAGS_glog_dir = options_->glog_dir;
+        // the tablet clients are created by cluster_sdk_
+        FLAGS_tablet_client_channel_num = options_->tablet_client_channel_num;
     }
     base::SetupGlog();
 
@@ -279,6 +418,23 @@ bool SQLClusterRouter::Init() {
         }
     }
 
+    if (options_->request_coalesce_window_ms > 0) {
+        coalescer_ = std::make_unique<RequestCoalescer>(
+            options_->request_coalesce_window_ms, options_->request_coalesce_max_rows, options_->enable_debug,
+            [this](const std::string& db, const std::string& sp_name, hybridse::sdk::Status* status) {
+                return GetTablet(db, sp_name, status);
+            });
+    }
+    if (options_->enable_hedged_request) {
+        hedger_ = std::make_unique<RequestHedger>(options_->hedged_request_min_delay_ms, options_->enable_debug);
+    }
+    if (options_->enable_columnar_result) {
+        columnar_result_ = std::make_unique<::openmldb::api::ColumnarResult>();
+        if (options_->compress_columnar_result) {
+            columnar_result_->set_compress_type(::openmldb::type::CompressType::kSnappy);
+        }
+    }
+
     std::string db = openmldb::nameserver::INFORMATION_SCHEMA_DB;
     std::string table = openmldb::nameserver::GLOBAL_VARIABLES;
     std::string sql = "select * from " + table;
@@ -1183,24 +1339,88 @@ std::shared_ptr<TableReader> SQLClusterRouter::GetTableReader() {
 std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(const std::string& db,
                                                                             const std::string& sp_name,
                                                                             hybridse::sdk::Status* status) {
+    return GetTablet(db, sp_name, "", status);
+}
+
+std::shared_ptr<openmldb::client::TabletClient> SQLClusterRouter::GetTablet(const std::string& db,
+                                                                            const std::string& sp_name,
+                                                                            const std::string& row,
+                                                                            hybridse::sdk::Status* status) {
     if (status == nullptr) return nullptr;
-    std::shared_ptr<hybridse::sdk::ProcedureInfo> sp_info = cluster_sdk_->GetProcedureInfo(db, sp_name, &status->msg);
-    if (!sp_info) {
+    auto tablet = cluster_sdk_->GetProcedureTablet(db, sp_name, row, &status->msg);
+    if (!tablet) {
         status->code = -1;
-        status->msg = "procedure not found, msg: " + status->msg;
+        status->msg = "fail to get tablet, " + status->msg;
         LOG(WARNING) << status->msg;
         return nullptr;
     }
-    const std::string& table = sp_info->GetMainTable();
-    const std::string& db_name = sp_info->GetMainDb().empty() ? db : sp_info->GetMainDb();
-    auto tablet = cluster_sdk_->GetTablet(db_name, table);
-    if (!tablet) {
+    return tablet->GetClient();
+}
+
+bool SQLClusterRouter::GetProcedureRoute(const std::string& db, const std::string& sp_name, const std::string& row,
+                                         ProcedureRoute* route, hybridse::sdk::Status* status) {
+    if (!cluster_sdk_->GetProcedureRoute(db, sp_name, row, route, &status->msg)) {
         status->code = -1;
-        status->msg = "fail to get tablet, table " + db_name + "." + table;
+        status->msg = "fail to get tablet, " + status->msg;
         LOG(WARNING) << status->msg;
-        return nullptr;
+        return false;
     }
-    return tablet->GetClient();
+    return true;
+}
+
+std::shared_ptr<openmldb::sdk::QueryFuture> SQLClusterRouter::CallProcedureByRoute(const std::string& db,
+                                                                                   const std::string& sp_name,
+                                                                                   const std::string& row,
+                                                                                   int64_t timeout_ms,
+                                                                                   const ProcedureRoute& route,
+                                                                                   hybridse::sdk::Status* status) {
+    std::shared_ptr<openmldb::client::TabletClient> leader;
+    if (route.leader) {
+        leader = route.leader->GetClient();
+    }
+    ::openmldb::api::FollowerRead follower_read;
+    follower_read.set_tid(route.tid);
+    follower_read.set_pid(route.pid);
+    follower_read.set_max_lag(route.max_follower_lag);
+    if (hedger_ && leader) {
+        if (!route.follower_read || route.followers.empty()) {
+            // only the leader serves the deployments with read_policy leader, the hedge is a second call to it
+            return hedger_->Call(db, sp_name, row, timeout_ms, leader, leader, nullptr, status);
+        }
+        // the hedges of a key go to the same follower, which serves them on its local replica. It checks its lag
+        // with the hedge too, so it never serves a stale result
+        auto backup = route.followers[std::hash<std::string>()(row) % route.followers.size()]->GetClient();
+        return hedger_->Call(db, sp_name, row, timeout_ms, leader, backup, &follower_read, status);
+    }
+    if (route.follower_read && !route.followers.empty()) {
+        // the leader takes its turn too
+        uint64_t idx = follower_read_seq_.fetch_add(1, std::memory_order_relaxed) % (route.followers.size() + 1);
+        if (idx > 0 || !leader) {
+            auto follower = route.followers[idx > 0 ? idx - 1 : 0]->GetClient();
+            bool is_debug = options_->enable_debug;
+            auto fallback = [leader, db, sp_name, row, is_debug](int64_t timeout_ms, hybridse::sdk::Status* status) {
+                return AsyncCallProcedure(leader, db, sp_name, row, timeout_ms, is_debug, nullptr, status);
+            };
+            int64_t deadline_us = ::baidu::common::timer::get_micros() + timeout_ms * 1000;
+            auto future =
+                AsyncCallProcedure(follower, db, sp_name, row, timeout_ms, is_debug, &follower_read, status);
+            if (!leader) {
+                return future;
+            }
+            if (!future) {
+                *status = hybridse::sdk::Status();
+                return fallback(timeout_ms, status);
+            }
+            return std::make_shared<FollowerReadQueryFuture>(future, deadline_us, std::move(fallback));
+        }
+    }
+    if (!leader) {
+        status->code = -1;
+        status->msg = "fail to get tablet, the leader of partition " + std::to_string(route.pid) + " is not connected";
+        LOG(WARNING) << status->msg;
+        return {};
+    }
+    return AsyncCallProcedure(leader, db, sp_name, row, timeout_ms, options_->enable_debug, nullptr, status);
 }
 
 bool SQLClusterRouter::IsConstQuery(::hybridse::vm::PhysicalOpNode* node) {
@@ -1292,7 +1512,7 @@ std::shared_ptr<::hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLParamete
     DLOG(INFO) << " send query to tablet " << client->GetEndpoint();
     auto response = std::make_shared<::openmldb::api::QueryResponse>();
     if (!client->Query(db, sql, parameter_types, parameter ? parameter->GetRow() : "", cntl.get(), response.get(),
-                       options_->enable_debug)) {
+                       options_->enable_debug, columnar_result_.get())) {
         status->msg = response->msg();
         status->code = -1;
         return {};
@@ -1320,7 +1540,8 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchReque
         status->msg = "no tablet found";
         return nullptr;
     }
-    if (!client->SQLBatchRequestQuery(db, sql, row_batch, cntl.get(), response.get(), options_->enable_debug)) {
+    if (!client->SQLBatchRequestQuery(db, sql, row_batch, cntl.get(), response.get(), options_->enable_debug,
+                                      columnar_result_.get())) {
         status->code = -1;
         status->msg = "request server error " + response->msg();
         return nullptr;
@@ -1330,6 +1551,9 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchReque
         status->msg = response->msg();
         return nullptr;
     }
+    if (response->has_columnar()) {
+        return ColumnarResultSet::MakeResultSet(response, cntl, status);
+    }
     auto rs = std::make_shared<openmldb::sdk::SQLBatchRequestResultSet>(response, cntl);
     if (!rs->Init()) {
         status->code = -1;
@@ -1339,6 +1563,40 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQLBatchReque
     return rs;
 }
 
+std::shared_ptr<QueryFuture> SQLClusterRouter::ExecuteSQLBatchRequest(const std::string& db, const std::string& sql,
+                                                                      int64_t timeout_ms,
+                                                                      std::shared_ptr<SQLRequestRowBatch> row_batch,
+                                                                      hybridse::sdk::Status* status) {
+    if (!row_batch || !status) {
+        LOG(WARNING) << "input is invalid";
+        return {};
+    }
+    auto client = GetTabletClient(db, sql, hybridse::vm::kBatchRequestMode, std::shared_ptr<SQLRequestRow>(),
+                                  std::shared_ptr<SQLRequestRow>(), status);
+    if (0 != status->code) {
+        return {};
+    }
+    if (!client) {
+        status->code = -1;
+        status->msg = "no tablet found";
+        return {};
+    }
+    auto cntl = std::make_shared<brpc::Controller>();
+    auto response = std::make_shared<openmldb::api::SQLBatchRequestQueryResponse>();
+    auto* callback = new openmldb::RpcCallback<openmldb::api::SQLBatchRequestQueryResponse>(response, cntl);
+    auto future = std::make_shared<BatchQueryFutureImpl>(callback);
+    if (!client->SQLBatchRequestQuery(db, sql, row_batch, options_->enable_debug, timeout_ms, callback,
+                                      columnar_result_.get())) {
+        // the callback won't be run
+        callback->UnRef();
+        status->code = -1;
+        status->msg = "request server error, fail to send request to " + client->GetEndpoint();
+        LOG(WARNING) << status->msg;
+        return {};
+    }
+    return future;
+}
+
 bool SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& sql, ::hybridse::sdk::Status* status) {
     if (status == NULL) return false;
     std::shared_ptr<::openmldb::nameserver::TableInfo> table_info;
@@ -1428,25 +1686,75 @@ bool SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& s
         LOG(WARNING) << "input is invalid";
         return false;
     }
+    // the puts of all the rows are sent before waiting for the responses
+    auto future = ExecuteInsert(db, sql, options_->request_timeout, rows, status);
+    return future && future->Wait(status);
+}
+
+std::shared_ptr<InsertFuture> SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& sql,
+                                                              int64_t timeout_ms, std::shared_ptr<SQLInsertRows> rows,
+                                                              hybridse::sdk::Status* status) {
+    if (!rows || !status) {
+        LOG(WARNING) << "input is invalid";
+        return {};
+    }
     std::shared_ptr<SQLCache> cache = GetCache(db, sql, hybridse::vm::kBatchMode);
-    if (cache) {
-        std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
-        bool ret = cluster_sdk_->GetTablet(db, cache->GetTableName(), &tablets);
-        if (!ret || tablets.empty()) {
-            status->msg = "fail to get table " + cache->GetTableName() + " tablet";
-            return false;
-        }
-        for (uint32_t i = 0; i < rows->GetCnt(); ++i) {
-            std::shared_ptr<SQLInsertRow> row = rows->GetRow(i);
-            if (!PutRow(cache->GetTableId(), row, tablets, status)) {
-                return false;
+    if (!cache) {
+        status->code = -1;
+        status->msg = "please use getInsertRow with " + sql + " first";
+        return {};
+    }
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    bool ret = cluster_sdk_->GetTablet(db, cache->GetTableName(), &tablets);
+    if (!ret || tablets.empty()) {
+        status->code = -1;
+        status->msg = "fail to get table " + cache->GetTableName() + " tablet";
+        return {};
+    }
+    auto future = std::make_shared<InsertFutureImpl>();
+    uint64_t cur_ts = ::baidu::common::timer::get_micros() / 1000;
+    for (uint32_t i = 0; i < rows->GetCnt(); ++i) {
+        std::shared_ptr<SQLInsertRow> row = rows->GetRow(i);
+        for (const auto& kv : row->GetDimensions()) {
+            uint32_t pid = kv.first;
+            std::shared_ptr<::openmldb::client::TabletClient> client;
+            if (pid < tablets.size() && tablets[pid]) {
+                client = tablets[pid]->GetClient();
+            }
+            if (!client) {
+                status->code = -1;
+                status->msg = "fail to get tablet client. pid " + std::to_string(pid);
+                LOG(WARNING) << status->msg;
+                return {};
+            }
+            ::openmldb::api::PutRequest request;
+            request.set_time(cur_ts);
+            request.set_value(row->GetRow());
+            request.set_tid(cache->GetTableId());
+            request.set_pid(pid);
+            for (const auto& dim : kv.second) {
+                auto* d = request.add_dimensions();
+                d->set_key(dim.first);
+                d->set_idx(dim.second);
+            }
+            auto cntl = std::make_shared<brpc::Controller>();
+            cntl->set_timeout_ms(timeout_ms);
+            auto* callback = new openmldb::RpcCallback<openmldb::api::PutResponse>(
+                std::make_shared<openmldb::api::PutResponse>(), cntl);
+            // one reference for the rpc and one for the future
+            callback->Ref();
+            if (!client->AsyncPut(request, callback)) {
+                callback->UnRef();
+                callback->UnRef();
+                status->code = -1;
+                status->msg = "fail to make a put request to table. tid " + std::to_string(cache->GetTableId());
+                LOG(WARNING) << status->msg;
+                return {};
             }
+            future->Add(callback);
         }
-        return true;
-    } else {
-        status->msg = "please use getInsertRow with " + sql + " first";
-        return false;
     }
+    return future;
 }
 
 bool SQLClusterRouter::ExecuteInsert(const std::string& db, const std::string& sql, std::shared_ptr<SQLInsertRow> row,
@@ -1522,8 +1830,22 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::CallProcedure(const
         LOG(WARNING) << "make sure the request row is built before execute sql";
         return nullptr;
     }
-    auto tablet = GetTablet(db, sp_name, status);
+    ProcedureRoute route;
+    if (!GetProcedureRoute(db, sp_name, row->GetRow(), &route, status)) {
+        return nullptr;
+    }
+    if (hedger_ || route.follower_read) {
+        auto future = CallProcedureByRoute(db, sp_name, row->GetRow(), options_->request_timeout, route, status);
+        if (!future) {
+            return nullptr;
+        }
+        return future->GetResultSet(status);
+    }
+    auto tablet = route.leader ? route.leader->GetClient() : nullptr;
     if (!tablet) {
+        status->code = -1;
+        status->msg = "fail to get tablet, the leader of partition " + std::to_string(route.pid) + " is not connected";
+        LOG(WARNING) << status->msg;
         return nullptr;
     }
 
@@ -1561,7 +1883,8 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::CallSQLBatchRequestP
     auto cntl = std::make_shared<::brpc::Controller>();
     auto response = std::make_shared<::openmldb::api::SQLBatchRequestQueryResponse>();
     bool ok = tablet->CallSQLBatchRequestProcedure(db, sp_name, row_batch, cntl.get(), response.get(),
-                                                   options_->enable_debug, options_->request_timeout);
+                                                   options_->enable_debug, options_->request_timeout,
+                                                   columnar_result_.get());
     if (!ok) {
         status->code = -1;
         status->msg = "request server error, msg: " + response->msg();
@@ -1572,6 +1895,9 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::CallSQLBatchRequestP
         status->msg = response->msg();
         return nullptr;
     }
+    if (response->has_columnar()) {
+        return ColumnarResultSet::MakeResultSet(response, cntl, status);
+    }
     auto rs = std::make_shared<::openmldb::sdk::SQLBatchRequestResultSet>(response, cntl);
     if (!rs->Init()) {
         status->code = -1;
@@ -2211,24 +2537,18 @@ std::shared_ptr<openmldb::sdk::QueryFuture> SQLClusterRouter::CallProcedure(cons
         LOG(WARNING) << "make sure the request row is built before execute sql";
         return {};
     }
-    auto tablet = GetTablet(db, sp_name, status);
-    if (!tablet) {
-        return {};
+    if (coalescer_) {
+        auto sp_info = cluster_sdk_->GetProcedureInfo(db, sp_name, &status->msg);
+        // the common columns of a batch are shared by all the rows, so the rows of different calls can't be merged
+        if (sp_info && !HasConstantColumn(sp_info->GetInputSchema())) {
+            return coalescer_->Call(db, sp_name, row->GetSchema(), row->GetRow(), timeout_ms, status);
+        }
     }
-
-    std::shared_ptr<openmldb::api::QueryResponse> response = std::make_shared<openmldb::api::QueryResponse>();
-    std::shared_ptr<brpc::Controller> cntl = std::make_shared<brpc::Controller>();
-    auto* callback = new openmldb::RpcCallback<openmldb::api::QueryResponse>(response, cntl);
-
-    std::shared_ptr<openmldb::sdk::QueryFutureImpl> future = std::make_shared<openmldb::sdk::QueryFutureImpl>(callback);
-    bool ok = tablet->CallProcedure(db, sp_name, row->GetRow(), timeout_ms, options_->enable_debug, callback);
-    if (!ok) {
-        status->code = -1;
-        status->msg = "request server error, msg: " + response->msg();
-        LOG(WARNING) << status->msg;
+    ProcedureRoute route;
+    if (!GetProcedureRoute(db, sp_name, row->GetRow(), &route, status)) {
         return {};
     }
-    return future;
+    return CallProcedureByRoute(db, sp_name, row->GetRow(), timeout_ms, route, status);
 }
 
 std::shared_ptr<openmldb::sdk::QueryFuture> SQLClusterRouter::CallSQLBatchRequestProcedure(
@@ -2249,8 +2569,8 @@ std::shared_ptr<openmldb::sdk::QueryFuture> SQLClusterRouter::CallSQLBatchReques
 
     std::shared_ptr<openmldb::sdk::BatchQueryFutureImpl> future =
         std::make_shared<openmldb::sdk::BatchQueryFutureImpl>(callback);
-    bool ok =
-        tablet->CallSQLBatchRequestProcedure(db, sp_name, row_batch, options_->enable_debug, timeout_ms, callback);
+    bool ok = tablet->CallSQLBatchRequestProcedure(db, sp_name, row_batch, options_->enable_debug, timeout_ms,
+                                                   callback, columnar_result_.get());
     if (!ok) {
         status->code = -1;
         status->msg = "request server error, msg: " + response->msg();
@@ -2670,7 +2990,8 @@ std::shared_ptr<hybridse::sdk::ResultSet> SQLClusterRouter::ExecuteSQL(
                 }
             } else {
                 // Handle in standalone mode
-                *status = HandleLoadDataInfile(database, plan->Table(), plan->File(), plan->Options());
+                *status = HandleLoadDataInfile(database, plan->Table(), plan->File(), plan->Options(),
+                                               offline_job_timeout);
             }
             return {};
         }
@@ -2947,7 +3268,7 @@ void SQLClusterRouter::SetInteractive(bool value) { interactive_ = value; }
 // Only csv format
 hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     const std::string& database, const std::string& table, const std::string& file_path,
-    const std::shared_ptr<hybridse::node::OptionsMap>& options) {
+    const std::shared_ptr<hybridse::node::OptionsMap>& options, int job_timeout) {
     if (database.empty()) {
         return {::hybridse::common::StatusCode::kCmdError, "database is empty"};
     }
@@ -2984,6 +3305,9 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
         return {::hybridse::common::StatusCode::kCmdError, "mismatch column size"};
     }
 
+    // the offset and the line number of the first row of data
+    uint64_t offset = 0;
+    uint64_t first_line = 1;
     if (options_parse.GetHeader()) {
         // the first line is the column names, check if equal with table schema
         for (int i = 0; i < schema->GetColumnCnt(); ++i) {
@@ -2991,8 +3315,18 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
                 return {::hybridse::common::StatusCode::kCmdError, "mismatch column name"};
             }
         }
-        // then read the first row of data
-        std::getline(file, line);
+        // then load from the first row of data
+        auto pos = file.tellg();
+        if (pos < 0) {
+            // the header is the whole file
+            return {0, "Load 0 rows"};
+        }
+        offset = static_cast<uint64_t>(pos);
+        first_line = 2;
+    }
+    file.close();
+    if (options_parse.GetLoadMode() == "tablet") {
+        return LoadDataInfileOnTablet(database, table, file_path, options_parse, offset, first_line, job_timeout);
     }
 
     // build placeholder
@@ -3002,66 +3336,88 @@ hybridse::sdk::Status SQLClusterRouter::HandleLoadDataInfile(
     }
     hybridse::sdk::Status status;
     std::string insert_placeholder = "insert into " + table + " values(" + holders + ");";
-    std::vector<int> str_cols_idx;
-    for (int i = 0; i < schema->GetColumnCnt(); ++i) {
-        if (schema->GetColumnType(i) == hybridse::sdk::kTypeString) {
-            str_cols_idx.emplace_back(i);
-        }
+    // fill the insert cache, all the rows are built from it
+    if (!GetInsertRow(database, insert_placeholder, &status)) {
+        return {::hybridse::common::StatusCode::kCmdError, "get insert row failed, " + status.msg};
     }
-    uint64_t i = 0;
-    do {
-        cols.clear();
-        std::string error;
-        ::openmldb::sdk::SplitLineWithDelimiterForStrings(line, options_parse.GetDelimiter(), &cols,
-                                                          options_parse.GetQuote());
-        auto ret = InsertOneRow(database, insert_placeholder, str_cols_idx, options_parse.GetNullValue(), cols);
-        if (!ret.IsOK()) {
-            return {::hybridse::common::StatusCode::kCmdError, "line [" + line + "] insert failed, " + ret.msg};
-        }
-        ++i;
-    } while (std::getline(file, line));
-    return {0, "Load " + std::to_string(i) + " rows"};
-}
-
-hybridse::sdk::Status SQLClusterRouter::InsertOneRow(const std::string& database, const std::string& insert_placeholder,
-                                                     const std::vector<int>& str_col_idx, const std::string& null_value,
-                                                     const std::vector<std::string>& cols) {
-    if (cols.empty()) {
-        return {::hybridse::common::StatusCode::kCmdError, "cols is empty"};
+    auto insert_cache =
+        std::dynamic_pointer_cast<InsertSQLCache>(GetCache(database, insert_placeholder, hybridse::vm::kBatchMode));
+    if (!insert_cache) {
+        return {::hybridse::common::StatusCode::kCmdError, "get insert cache failed"};
     }
-    if (database.empty()) {
-        return {::hybridse::common::StatusCode::kCmdError, "database is empty"};
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    if (!cluster_sdk_->GetTablet(database, table, &tablets) || tablets.empty()) {
+        return {::hybridse::common::StatusCode::kCmdError, "fail to get table " + table + " tablet"};
     }
-    hybridse::sdk::Status status;
-    auto row = GetInsertRow(database, insert_placeholder, &status);
-    if (!row) {
+    uint32_t thread_num = options_parse.GetThread();
+    FileLoader loader(insert_cache, tablets, options_parse, thread_num, FileLoader::DEFAULT_MAX_INFLIGHT);
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    status = loader.Load(file_path, offset, first_line);
+    if (!status.IsOK()) {
         return status;
     }
-    // build row from cols
-    auto& schema = row->GetSchema();
-    auto cnt = schema->GetColumnCnt();
-    if (cnt != static_cast<int>(cols.size())) {
-        return {::hybridse::common::StatusCode::kCmdError, "col size mismatch"};
+    uint64_t rows = loader.GetRowCnt();
+    uint64_t elapsed_us = std::max<uint64_t>(::baidu::common::timer::get_micros() - start_time, 1);
+    return {0, absl::StrCat("Load ", rows, " rows in ", elapsed_us / 1000, " ms, ",
+                            rows * 1000000 / elapsed_us, " rows/s")};
+}
+
+hybridse::sdk::Status SQLClusterRouter::LoadDataInfileOnTablet(const std::string& database, const std::string& table,
+                                                               const std::string& file_path,
+                                                               const ReadFileOptionsParser& options_parse,
+                                                               uint64_t offset, uint64_t first_line,
+                                                               int job_timeout) {
+    auto table_info = cluster_sdk_->GetTableInfo(database, table);
+    if (!table_info) {
+        return {::hybridse::common::StatusCode::kCmdError, "table is not exist"};
     }
-    // scan all strings , calc the sum, to init SQLInsertRow's string length
-    std::string::size_type str_len_sum = 0;
-    for (auto idx : str_col_idx) {
-        if (cols[idx] != null_value) {
-            str_len_sum += cols[idx].length();
+    std::vector<std::shared_ptr<::openmldb::catalog::TabletAccessor>> tablets;
+    if (!cluster_sdk_->GetTablet(database, table, &tablets) || tablets.empty()) {
+        return {::hybridse::common::StatusCode::kCmdError, "fail to get table " + table + " tablet"};
+    }
+    // the tablet reads the file itself, the path must be valid on its host
+    char abs_path[PATH_MAX];
+    if (realpath(file_path.c_str(), abs_path) == nullptr) {
+        return {::hybridse::common::StatusCode::kCmdError, "get the absolute path of " + file_path + " failed"};
+    }
+    std::map<std::string, ::openmldb::api::LoadLocalFileRequest> requests;
+    std::map<std::string, std::shared_ptr<::openmldb::client::TabletClient>> clients;
+    for (uint32_t pid = 0; pid < tablets.size(); pid++) {
+        auto client = tablets[pid] ? tablets[pid]->GetClient() : nullptr;
+        if (!client) {
+            return {::hybridse::common::StatusCode::kCmdError, "fail to get tablet client. pid " + std::to_string(pid)};
+        }
+        auto& request = requests[client->GetEndpoint()];
+        if (request.pid_size() == 0) {
+            request.set_tid(table_info->tid());
+            request.set_partition_num(table_info->table_partition_size());
+            request.set_file_path(abs_path);
+            request.set_offset(offset);
+            request.set_first_line(first_line);
+            request.set_delimiter(options_parse.GetDelimiter());
+            request.set_null_value(options_parse.GetNullValue());
+            if (options_parse.GetQuote() != '\0') {
+                request.set_quote(std::string(1, options_parse.GetQuote()));
+            }
+            request.set_thread_num(options_parse.GetThread());
+            clients.emplace(client->GetEndpoint(), client);
         }
+        request.add_pid(pid);
     }
-    row->Init(static_cast<int>(str_len_sum));
-
-    for (int i = 0; i < cnt; ++i) {
-        if (!::openmldb::codec::AppendColumnValue(cols[i], schema->GetColumnType(i), schema->IsColumnNotNull(i),
-                                                  null_value, row)) {
-            return {::hybridse::common::StatusCode::kCmdError, "translate to insert row failed"};
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    uint64_t rows = 0;
+    for (const auto& kv : requests) {
+        uint64_t row_cnt = 0;
+        auto st = clients[kv.first]->LoadLocalFile(kv.second, std::max(job_timeout, 0), &row_cnt);
+        if (!st.OK()) {
+            return {::hybridse::common::StatusCode::kCmdError, "load on tablet " + kv.first + " failed, " + st.msg};
         }
+        // every tablet parses the whole file
+        rows = row_cnt;
     }
-    if (!ExecuteInsert(database, insert_placeholder, row, &status)) {
-        return {::hybridse::common::StatusCode::kCmdError, "insert row failed"};
-    }
-    return {};
+    uint64_t elapsed_us = std::max<uint64_t>(::baidu::common::timer::get_micros() - start_time, 1);
+    return {0, absl::StrCat("Load ", rows, " rows in ", elapsed_us / 1000, " ms, ",
+                            rows * 1000000 / elapsed_us, " rows/s")};
 }
 
 hybridse::sdk::Status SQLClusterRouter::HandleDelete(const std::string& db, const std::string& table_name,
@@ -3227,6 +3583,21 @@ hybridse::sdk::Status SQLClusterRouter::HandleDeploy(const std::string& db,
     if (deploy_node == nullptr) {
         return {::hybridse::common::StatusCode::kCmdError, "illegal deploy statement"};
     }
+    auto policy_iter = deploy_node->Options()->find(READ_POLICY);
+    if (policy_iter != deploy_node->Options()->end()) {
+        const auto& policy = policy_iter->second->GetExprString();
+        if (!absl::EqualsIgnoreCase(policy, READ_POLICY_LEADER) &&
+            !absl::EqualsIgnoreCase(policy, READ_POLICY_FOLLOWER)) {
+            return {::hybridse::common::StatusCode::kCmdError,
+                    absl::StrCat("invalid ", READ_POLICY, " ", policy, ", it should be leader or follower")};
+        }
+    }
+    auto lag_iter = deploy_node->Options()->find(MAX_FOLLOWER_LAG);
+    uint64_t max_lag = 0;
+    if (lag_iter != deploy_node->Options()->end() && !absl::SimpleAtoi(lag_iter->second->GetExprString(), &max_lag)) {
+        return {::hybridse::common::StatusCode::kCmdError,
+                absl::StrCat("invalid ", MAX_FOLLOWER_LAG, " ", lag_iter->second->GetExprString())};
+    }
 
     std::string select_sql = deploy_node->StmtStr() + ";";
     hybridse::vm::ExplainOutput explain_output;
@@ -17,6 +17,7 @@
 #ifndef SRC_SDK_SQL_CLUSTER_ROUTER_H_
 #define SRC_SDK_SQL_CLUSTER_ROUTER_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -32,6 +33,9 @@
 #include "client/tablet_client.h"
 #include "nameserver/system_table.h"
 #include "sdk/db_sdk.h"
+#include "sdk/file_option_parser.h"
+#include "sdk/request_coalescer.h"
+#include "sdk/request_hedger.h"
 #include "sdk/sql_cache.h"
 #include "sdk/sql_router.h"
 #include "sdk/table_reader_impl.h"
@@ -72,6 +76,10 @@ class SQLClusterRouter : public SQLRouter {
     bool ExecuteInsert(const std::string& db, const std::string& sql, std::shared_ptr<SQLInsertRows> rows,
                        hybridse::sdk::Status* status) override;
 
+    std::shared_ptr<InsertFuture> ExecuteInsert(const std::string& db, const std::string& sql, int64_t timeout_ms,
+                                                std::shared_ptr<SQLInsertRows> rows,
+                                                hybridse::sdk::Status* status) override;
+
     bool ExecuteDelete(std::shared_ptr<SQLDeleteRow> row, hybridse::sdk::Status* status) override;
 
     std::shared_ptr<TableReader> GetTableReader() override;
@@ -120,6 +128,11 @@ class SQLClusterRouter : public SQLRouter {
                                                                      std::shared_ptr<SQLRequestRowBatch> row_batch,
                                                                      ::hybridse::sdk::Status* status) override;
 
+    std::shared_ptr<QueryFuture> ExecuteSQLBatchRequest(const std::string& db, const std::string& sql,
+                                                        int64_t timeout_ms,
+                                                        std::shared_ptr<SQLRequestRowBatch> row_batch,
+                                                        ::hybridse::sdk::Status* status) override;
+
     /// utility functions to query registered components in the current DBMS
     //
     /// \param status result status, will set status.code to error if error happens
@@ -284,6 +297,18 @@ class SQLClusterRouter : public SQLRouter {
 
     std::shared_ptr<openmldb::client::TabletClient> GetTablet(const std::string& db, const std::string& sp_name,
                                                               hybridse::sdk::Status* status);
+    // route by the key of the encoded request row, see DBSDK::GetProcedureTablet
+    std::shared_ptr<openmldb::client::TabletClient> GetTablet(const std::string& db, const std::string& sp_name,
+                                                              const std::string& row, hybridse::sdk::Status* status);
+
+    bool GetProcedureRoute(const std::string& db, const std::string& sp_name, const std::string& row,
+                           ProcedureRoute* route, hybridse::sdk::Status* status);
+    // send the row to the replicas of the route, it's hedged to a follower if the hedger is enabled, and it may be
+    // served by a follower if the deployment has the follower read policy
+    std::shared_ptr<openmldb::sdk::QueryFuture> CallProcedureByRoute(const std::string& db, const std::string& sp_name,
+                                                                     const std::string& row, int64_t timeout_ms,
+                                                                     const ProcedureRoute& route,
+                                                                     hybridse::sdk::Status* status);
 
     bool ExtractDBTypes(const std::shared_ptr<hybridse::sdk::Schema>& schema,
                         std::vector<openmldb::type::DataType>* parameter_types);
@@ -301,11 +326,14 @@ class SQLClusterRouter : public SQLRouter {
 
     hybridse::sdk::Status HandleLoadDataInfile(const std::string& database, const std::string& table,
                                                const std::string& file_path,
-                                               const std::shared_ptr<hybridse::node::OptionsMap>& options);
+                                               const std::shared_ptr<hybridse::node::OptionsMap>& options,
+                                               int job_timeout);
 
-    hybridse::sdk::Status InsertOneRow(const std::string& database, const std::string& insert_placeholder,
-                                       const std::vector<int>& str_col_idx, const std::string& null_value,
-                                       const std::vector<std::string>& cols);
+    // the tablets read the file from their local disks and write the rows of their partitions
+    hybridse::sdk::Status LoadDataInfileOnTablet(const std::string& database, const std::string& table,
+                                                 const std::string& file_path,
+                                                 const ReadFileOptionsParser& options_parse, uint64_t offset,
+                                                 uint64_t first_line, int job_timeout);
 
     hybridse::sdk::Status HandleDeploy(const std::string& db, const hybridse::node::DeployPlanNode* deploy_node);
 
@@ -357,6 +385,14 @@ class SQLClusterRouter : public SQLRouter {
         input_lru_cache_;
     ::openmldb::base::SpinMutex mu_;
     ::openmldb::base::Random rand_;
+    // null if the coalescing of the async deployment calls is disabled
+    std::unique_ptr<RequestCoalescer> coalescer_;
+    // null if the hedging of the deployment calls is disabled
+    std::unique_ptr<RequestHedger> hedger_;
+    // the calls of the follower read deployments go to the replicas by turns
+    std::atomic<uint64_t> follower_read_seq_{0};
+    // null if the columnar result is disabled
+    std::unique_ptr<::openmldb::api::ColumnarResult> columnar_result_;
 };
 
 }  // namespace openmldb::sdk
@@ -25,6 +25,7 @@
 #include "codec/fe_row_codec.h"
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
+#include "sdk/columnar_result_set.h"
 #include "sdk/mini_cluster.h"
 #include "sdk/sql_cluster_router.h"
 #include "sdk/sql_router.h"
@@ -304,6 +305,242 @@ TEST_F(SQLClusterTest, ClusterInsert) {
     ASSERT_TRUE(ok);
 }
 
+TEST_F(SQLClusterTest, AsyncInsertAndCoalescedCall) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    sql_opt.request_coalesce_window_ms = 5;
+    sql_opt.request_coalesce_max_rows = 4;
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string name = "test" + GenRand();
+    std::string db = "db" + GenRand();
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl = "create table " + name +
+                      "(c1 string, c3 int, c4 bigint, c7 timestamp, index(key=c1, ts=c7)) options(partitionnum=4);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+
+    // the puts of all the rows are in flight together
+    std::string insert = "insert into " + name + " values(?, ?, ?, ?);";
+    auto rows = router->GetInsertRows(db, insert, &status);
+    ASSERT_TRUE(rows) << status.msg;
+    for (int i = 0; i < 10; i++) {
+        auto row = rows->NewRow();
+        std::string key = "key" + std::to_string(i);
+        ASSERT_TRUE(row->Init(key.size()));
+        ASSERT_TRUE(row->AppendString(key));
+        ASSERT_TRUE(row->AppendInt32(i));
+        ASSERT_TRUE(row->AppendInt64(i));
+        ASSERT_TRUE(row->AppendTimestamp(1590738994000 + i));
+        ASSERT_TRUE(row->Build());
+    }
+    auto insert_future = router->ExecuteInsert(db, insert, 1000, rows, &status);
+    ASSERT_TRUE(insert_future) << status.msg;
+    ASSERT_TRUE(insert_future->Wait(&status)) << status.msg;
+    ASSERT_TRUE(insert_future->IsDone());
+    auto rs = router->ExecuteSQL(db, "select * from " + name + ";", &status);
+    ASSERT_TRUE(rs) << status.msg;
+    ASSERT_EQ(10, rs->Size());
+
+    std::string sp_name = "sp" + GenRand();
+    std::string sql = "SELECT c1, c3, sum(c4) OVER w1 as w1_c4_sum FROM " + name + " WINDOW w1 AS (PARTITION BY c1 " +
+                      "ORDER BY c7 ROWS BETWEEN 2 PRECEDING AND CURRENT ROW);";
+    ASSERT_TRUE(router->ExecuteDDL(
+        db, "create procedure " + sp_name + " (c1 string, c3 int, c4 bigint, c7 timestamp) begin " + sql + " end;",
+        &status))
+        << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+
+    // the calls are coalesced into the batch requests of 4 rows, every call gets its own row
+    std::vector<std::shared_ptr<QueryFuture>> futures;
+    for (int i = 0; i < 10; i++) {
+        auto row = router->GetRequestRow(db, sql, &status);
+        ASSERT_TRUE(row) << status.msg;
+        std::string key = "key" + std::to_string(i);
+        ASSERT_TRUE(row->Init(key.size()));
+        ASSERT_TRUE(row->AppendString(key));
+        ASSERT_TRUE(row->AppendInt32(100 + i));
+        ASSERT_TRUE(row->AppendInt64(100));
+        ASSERT_TRUE(row->AppendTimestamp(1590738995000));
+        ASSERT_TRUE(row->Build());
+        auto future = router->CallProcedure(db, sp_name, 1000, row, &status);
+        ASSERT_TRUE(future) << status.msg;
+        futures.push_back(future);
+    }
+    for (int i = 0; i < 10; i++) {
+        auto result = futures[i]->GetResultSet(&status);
+        ASSERT_TRUE(result) << status.msg;
+        ASSERT_EQ(1, result->Size());
+        ASSERT_TRUE(result->Next());
+        ASSERT_EQ("key" + std::to_string(i), result->GetStringUnsafe(0));
+        ASSERT_EQ(100 + i, result->GetInt32Unsafe(1));
+        ASSERT_EQ(100 + i, result->GetInt64Unsafe(2));
+        ASSERT_FALSE(result->Next());
+    }
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop procedure " + sp_name + ";", &status));
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
+TEST_F(SQLClusterTest, HedgedCall) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    sql_opt.enable_hedged_request = true;
+    // no response in the window yet, so every call is hedged at once
+    sql_opt.hedged_request_min_delay_ms = 0;
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string name = "test" + GenRand();
+    std::string db = "db" + GenRand();
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl = "create table " + name +
+                      "(c1 string, c3 int, c4 bigint, c7 timestamp, index(key=c1, ts=c7)) "
+                      "options(partitionnum=2, replicanum=2);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status)) << status.msg;
+    std::string sp_name = "sp" + GenRand();
+    std::string sql = "SELECT c1, c3, sum(c4) OVER w1 as w1_c4_sum FROM " + name + " WINDOW w1 AS (PARTITION BY c1 " +
+                      "ORDER BY c7 ROWS BETWEEN 2 PRECEDING AND CURRENT ROW);";
+    ASSERT_TRUE(router->ExecuteDDL(
+        db, "create procedure " + sp_name + " (c1 string, c3 int, c4 bigint, c7 timestamp) begin " + sql + " end;",
+        &status))
+        << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+
+    uint64_t issued = RequestHedger::GetIssuedCount();
+    std::vector<std::shared_ptr<QueryFuture>> futures;
+    for (int i = 0; i < 10; i++) {
+        auto row = router->GetRequestRow(db, sql, &status);
+        ASSERT_TRUE(row) << status.msg;
+        std::string key = "key" + std::to_string(i);
+        ASSERT_TRUE(row->Init(key.size()));
+        ASSERT_TRUE(row->AppendString(key));
+        ASSERT_TRUE(row->AppendInt32(100 + i));
+        ASSERT_TRUE(row->AppendInt64(100));
+        ASSERT_TRUE(row->AppendTimestamp(1590738995000));
+        ASSERT_TRUE(row->Build());
+        auto future = router->CallProcedure(db, sp_name, 1000, row, &status);
+        ASSERT_TRUE(future) << status.msg;
+        futures.push_back(future);
+    }
+    // whichever replica responds first, the caller gets the result of its own row
+    for (int i = 0; i < 10; i++) {
+        auto result = futures[i]->GetResultSet(&status);
+        ASSERT_TRUE(result) << status.msg;
+        ASSERT_TRUE(futures[i]->IsDone());
+        ASSERT_EQ(1, result->Size());
+        ASSERT_TRUE(result->Next());
+        ASSERT_EQ("key" + std::to_string(i), result->GetStringUnsafe(0));
+        ASSERT_EQ(100 + i, result->GetInt32Unsafe(1));
+    }
+    ASSERT_GT(RequestHedger::GetIssuedCount(), issued);
+    ASSERT_LE(RequestHedger::GetWonCount(), RequestHedger::GetIssuedCount());
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop procedure " + sp_name + ";", &status));
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
+TEST_F(SQLClusterTest, FollowerRead) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string name = "test" + GenRand();
+    std::string db = "db" + GenRand();
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    router->ExecuteSQL(db, "use " + db + ";", &status);
+    std::string ddl = "create table " + name +
+                      "(c1 string, c3 int, c4 bigint, c7 timestamp, index(key=c1, ts=c7)) "
+                      "options(partitionnum=2, replicanum=2);";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status)) << status.msg;
+    std::string sql = "SELECT c1, c3, sum(c4) OVER w1 as w1_c4_sum FROM " + name + " WINDOW w1 AS (PARTITION BY c1 " +
+                      "ORDER BY c7 ROWS BETWEEN 2 PRECEDING AND CURRENT ROW);";
+    router->ExecuteSQL(db, "deploy d1 options(read_policy='replica') " + sql, &status);
+    ASSERT_FALSE(status.IsOK());
+    router->ExecuteSQL(db, "deploy d1 options(max_follower_lag='-1') " + sql, &status);
+    ASSERT_FALSE(status.IsOK());
+    router->ExecuteSQL(db, "deploy d1 options(read_policy='follower', max_follower_lag=10) " + sql, &status);
+    ASSERT_TRUE(status.IsOK()) << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+
+    // the calls are spread across the replicas, a lagging follower sends the call back to the leader
+    for (int i = 0; i < 10; i++) {
+        auto row = router->GetRequestRow(db, sql, &status);
+        ASSERT_TRUE(row) << status.msg;
+        std::string key = "key" + std::to_string(i);
+        ASSERT_TRUE(row->Init(key.size()));
+        ASSERT_TRUE(row->AppendString(key));
+        ASSERT_TRUE(row->AppendInt32(100 + i));
+        ASSERT_TRUE(row->AppendInt64(100));
+        ASSERT_TRUE(row->AppendTimestamp(1590738995000));
+        ASSERT_TRUE(row->Build());
+        auto result = router->CallProcedure(db, "d1", row, &status);
+        ASSERT_TRUE(result) << status.msg;
+        ASSERT_EQ(1, result->Size());
+        ASSERT_TRUE(result->Next());
+        ASSERT_EQ(key, result->GetStringUnsafe(0));
+        ASSERT_EQ(100 + i, result->GetInt32Unsafe(1));
+    }
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop procedure d1;", &status));
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + name + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
+TEST_F(SQLClusterTest, ColumnarResult) {
+    SQLRouterOptions sql_opt;
+    sql_opt.zk_cluster = mc_->GetZkCluster();
+    sql_opt.zk_path = mc_->GetZkPath();
+    sql_opt.enable_columnar_result = true;
+    sql_opt.compress_columnar_result = true;
+    auto router = NewClusterSQLRouter(sql_opt);
+    ASSERT_TRUE(router != nullptr);
+    SetOnlineMode(router);
+    std::string table = "test" + GenRand();
+    std::string db = "db" + GenRand();
+    ::hybridse::sdk::Status status;
+    ASSERT_TRUE(router->CreateDB(db, &status));
+    std::string ddl = "create table " + table + "(c1 string, c2 int, c3 bigint, index(key=c1, ts=c3));";
+    ASSERT_TRUE(router->ExecuteDDL(db, ddl, &status)) << status.msg;
+    ASSERT_TRUE(router->RefreshCatalog());
+    ASSERT_TRUE(router->ExecuteInsert(db, "insert into " + table + " values('key1', 1, 1000);", &status));
+    ASSERT_TRUE(router->ExecuteInsert(db, "insert into " + table + " values('key2', null, 2000);", &status));
+
+    auto rs = router->ExecuteSQL(db, "select c1, c2, c3 from " + table + ";", &status);
+    ASSERT_TRUE(rs) << status.msg;
+    auto columnar = ColumnarResultSet::Cast(rs);
+    ASSERT_TRUE(columnar);
+    ASSERT_EQ(2, columnar->Size());
+    // the rows are read as the row format, in any order
+    std::vector<std::string> keys;
+    while (columnar->Next()) {
+        keys.push_back(columnar->GetStringUnsafe(0));
+        ASSERT_EQ(keys.back() == "key2", columnar->IsNULL(1));
+        ASSERT_EQ(keys.back() == "key1" ? 1000 : 2000, columnar->GetInt64Unsafe(2));
+    }
+    ASSERT_EQ(2u, keys.size());
+    // and the columns are read as a whole
+    uint32_t key2 = keys[0] == "key2" ? 0 : 1;
+    ASSERT_EQ(2000, columnar->GetValues<int64_t>(2)[key2]);
+    ASSERT_EQ(1u << key2, columnar->GetNullBitmap(1)[0]);
+    std::string c1(columnar->GetColumnByteSize(0), '\0');
+    ASSERT_TRUE(columnar->CopyColumn(0, c1.data(), c1.size()));
+    ASSERT_EQ(keys[0] + keys[1], c1.substr(3 * sizeof(uint32_t)));
+
+    ASSERT_TRUE(router->ExecuteDDL(db, "drop table " + table + ";", &status));
+    ASSERT_TRUE(router->DropDB(db, &status));
+}
+
 TEST_F(SQLClusterTest, ClusterInsertWithColumnDefaultValue) {
     SQLRouterOptions sql_opt;
     sql_opt.zk_cluster = mc_->GetZkCluster();
@@ -437,13 +437,17 @@ bool SQLRequestRowBatch::AddRow(std::shared_ptr<SQLRequestRow> row) {
         return false;
     }
     const std::string& row_str = row->GetRow();
-    int8_t* input_buf = reinterpret_cast<int8_t*>(const_cast<char*>(&row_str[0]));
-    size_t input_size = row_str.size();
+    return AddRow(row_str.data(), row_str.size());
+}
+
+bool SQLRequestRowBatch::AddRow(const char* row, size_t size) {
+    const int8_t* input_buf = reinterpret_cast<const int8_t*>(row);
+    size_t input_size = size;
 
     // non-common
     if (common_column_indices_.empty() ||
         common_column_indices_.size() == static_cast<size_t>(request_schema_.size())) {
-        non_common_slices_.emplace_back(std::string(reinterpret_cast<char*>(input_buf), input_size));
+        non_common_slices_.emplace_back(std::string(row, input_size));
         return true;
     }
 
@@ -88,6 +88,8 @@ class SQLRequestRowBatch {
  public:
     SQLRequestRowBatch(std::shared_ptr<hybridse::sdk::Schema> schema, std::shared_ptr<ColumnIndicesSet> indices);
     bool AddRow(std::shared_ptr<SQLRequestRow> row);
+    // add a row which has been encoded by the request schema, e.g. a row of a binary request
+    bool AddRow(const char* row, size_t size);
     int Size() const { return non_common_slices_.size(); }
 
     const std::set<size_t>& common_column_indices() const { return common_column_indices_; }
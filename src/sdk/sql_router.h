@@ -47,6 +47,23 @@ struct BasicRouterOptions {
     int glog_level = 0;
     // empty means to stderr
     std::string glog_dir = "";
+    // the async deployment calls in the window are coalesced into one batch request, 0 means no coalescing
+    uint32_t request_coalesce_window_ms = 0;
+    // a coalesced batch is sent before the window ends if it has so many rows
+    uint32_t request_coalesce_max_rows = 64;
+    // the deployment call is sent again if the response doesn't arrive in the p95 latency of the deployment, the first
+    // response is taken. The hedge goes to a follower of the partition if the deployment has read_policy follower,
+    // within its max_follower_lag, and to the leader otherwise
+    bool enable_hedged_request = false;
+    // the hedge delay is not less than it
+    uint32_t hedged_request_min_delay_ms = 5;
+    // the connections to every tablet, the same as the gflag `tablet_client_channel_num`
+    uint32_t tablet_client_channel_num = 1;
+    // the results of the batch queries and the batch request queries are sent in the columnar encoding, the result
+    // set can be read by columns, see ColumnarResultSet
+    bool enable_columnar_result = false;
+    // the columnar results are compressed by snappy
+    bool compress_columnar_result = false;
 };
 
 struct SQLRouterOptions : BasicRouterOptions {
@@ -85,6 +102,16 @@ class QueryFuture {
     virtual bool IsDone() const = 0;
 };
 
+class InsertFuture {
+ public:
+    InsertFuture() {}
+    virtual ~InsertFuture() {}
+
+    // wait for the puts of all the rows, return false if any of them failed
+    virtual bool Wait(hybridse::sdk::Status* status) = 0;
+    virtual bool IsDone() const = 0;
+};
+
 class SQLRouter {
  public:
     SQLRouter() {}
@@ -108,6 +135,11 @@ class SQLRouter {
     virtual bool ExecuteInsert(const std::string& db, const std::string& sql,
                                std::shared_ptr<openmldb::sdk::SQLInsertRows> row, hybridse::sdk::Status* status) = 0;
 
+    // the puts are sent without waiting for the responses, call `InsertFuture::Wait` to get the result
+    virtual std::shared_ptr<openmldb::sdk::InsertFuture> ExecuteInsert(
+        const std::string& db, const std::string& sql, int64_t timeout_ms,
+        std::shared_ptr<openmldb::sdk::SQLInsertRows> rows, hybridse::sdk::Status* status) = 0;
+
     virtual bool ExecuteDelete(std::shared_ptr<openmldb::sdk::SQLDeleteRow> row, hybridse::sdk::Status* status) = 0;
 
     virtual std::shared_ptr<openmldb::sdk::TableReader> GetTableReader() = 0;
@@ -157,6 +189,10 @@ class SQLRouter {
         const std::string& db, const std::string& sql, std::shared_ptr<openmldb::sdk::SQLRequestRowBatch> row_batch,
         ::hybridse::sdk::Status* status) = 0;
 
+    virtual std::shared_ptr<openmldb::sdk::QueryFuture> ExecuteSQLBatchRequest(
+        const std::string& db, const std::string& sql, int64_t timeout_ms,
+        std::shared_ptr<openmldb::sdk::SQLRequestRowBatch> row_batch, hybridse::sdk::Status* status) = 0;
+
     virtual bool RefreshCatalog() = 0;
 
     virtual std::shared_ptr<hybridse::sdk::ResultSet> CallProcedure(const std::string& db, const std::string& sp_name,
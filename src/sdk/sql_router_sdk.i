@@ -43,7 +43,9 @@
 %shared_ptr(openmldb::sdk::ExplainInfo);
 %shared_ptr(hybridse::sdk::ProcedureInfo);
 %shared_ptr(openmldb::sdk::QueryFuture);
+%shared_ptr(openmldb::sdk::InsertFuture);
 %shared_ptr(openmldb::sdk::TableReader);
+%shared_ptr(openmldb::sdk::ColumnarResultSet);
 %template(VectorUint32) std::vector<uint32_t>;
 %template(VectorString) std::vector<std::string>;
 
@@ -56,6 +58,7 @@
 #include "sdk/sql_insert_row.h"
 #include "sdk/sql_delete_row.h"
 #include "sdk/table_reader.h"
+#include "sdk/columnar_result_set.h"
 
 using hybridse::sdk::Schema;
 using hybridse::sdk::ColumnTypes;
@@ -71,7 +74,9 @@ using openmldb::sdk::SQLInsertRows;
 using openmldb::sdk::ExplainInfo;
 using hybridse::sdk::ProcedureInfo;
 using openmldb::sdk::QueryFuture;
+using openmldb::sdk::InsertFuture;
 using openmldb::sdk::TableReader;
+using openmldb::sdk::ColumnarResultSet;
 %}
 
 %include "sdk/sql_router.h"
@@ -83,6 +88,14 @@ using openmldb::sdk::TableReader;
 %include "sdk/sql_insert_row.h"
 %include "sdk/table_reader.h"
 
+// the columnar result set is made by the router, the columns are read by the copy methods in java and python
+%ignore openmldb::sdk::ColumnarResultSet::ColumnarResultSet;
+%ignore openmldb::sdk::ColumnarResultSet::MakeResultSet;
+%ignore openmldb::sdk::ColumnarResultSet::GetNullBitmap;
+%ignore openmldb::sdk::ColumnarResultSet::GetStringOffsets;
+%ignore openmldb::sdk::ColumnarResultSet::GetStringData;
+%include "sdk/columnar_result_set.h"
+
 %template(ColumnDescPair) std::pair<std::string, hybridse::sdk::DataType>;
 %template(ColumnDescVector) std::vector<std::pair<std::string, hybridse::sdk::DataType>>;
 %template(TableColumnDescPair) std::pair<std::string, std::vector<std::pair<std::string, hybridse::sdk::DataType>>>;
@@ -362,7 +362,7 @@ bool Aggregator::Init(std::shared_ptr<LogReplicator> base_replicator) {
             continue;
         }
 
-        bool ok = entry.ParseFromString(record.ToString());
+        bool ok = entry.ParseFromArray(record.data(), record.size());
         if (!ok) {
             PDLOG(WARNING, "parse binlog failed");
             continue;
@@ -29,9 +29,12 @@
 #include "gflags/gflags.h"
 #include "log/log_writer.h"
 #include "log/status.h"
+#include "storage/log_applier.h"
 
 DECLARE_uint64(gc_on_table_recover_count);
 DECLARE_int32(binlog_name_length);
+DECLARE_uint32(binlog_apply_thread_num);
+DECLARE_uint32(binlog_apply_batch_size);
 
 namespace openmldb {
 namespace storage {
@@ -52,6 +55,8 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
     uint64_t consumed = ::baidu::common::timer::now_time();
     int last_log_index = log_reader.GetLogIndex();
     bool reach_end_log = true;
+    LogApplier applier(FLAGS_binlog_apply_thread_num, FLAGS_binlog_apply_batch_size);
+    LogApplier::Session session(&applier, table);
     while (true) {
         buffer.clear();
         ::openmldb::base::Slice record;
@@ -67,6 +72,7 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
                       tid, pid, cur_log_index, end_log_index, cur_offset);
                 continue;
             }
+            failed_cnt += session.Wait();
             consumed = ::baidu::common::timer::now_time() - consumed;
             PDLOG(INFO,
                   "table tid %u pid %u completed, succ_cnt %lu, failed_cnt "
@@ -87,7 +93,7 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
             failed_cnt++;
             continue;
         }
-        bool ok = entry.ParseFromString(record.ToString());
+        bool ok = entry.ParseFromArray(record.data(), record.size());
         if (!ok) {
             PDLOG(WARNING, "fail parse record for tid %u, pid %u with value %s", tid, pid,
                   ::openmldb::base::DebugString(record.ToString()).c_str());
@@ -107,16 +113,18 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
                   cur_offset, entry.log_index(), tid, pid);
         }
 
+        cur_offset = entry.log_index();
         if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
             if (entry.dimensions_size() == 0) {
                 PDLOG(WARNING, "no dimesion. tid %u pid %u offset %lu", tid, pid, entry.log_index());
             } else {
+                // delete is a barrier, the entries before it should be applied first
+                failed_cnt += session.Wait();
                 table->Delete(entry.dimensions(0).key(), entry.dimensions(0).idx());
             }
         } else {
-            table->Put(entry);
+            session.Put(&entry);
         }
-        cur_offset = entry.log_index();
         succ_cnt++;
         if (succ_cnt % 100000 == 0) {
             PDLOG(INFO,
@@ -128,6 +136,7 @@ bool Binlog::RecoverFromBinlog(std::shared_ptr<Table> table, uint64_t offset, ui
             table->SchedGc();
         }
     }
+    failed_cnt += session.Wait();
     latest_offset = cur_offset;
     if (!reach_end_log) {
         int log_index = log_reader.GetLogIndex();
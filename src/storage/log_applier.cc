@@ -0,0 +1,183 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/log_applier.h"
+
+#include <utility>
+
+#include "base/glog_wrapper.h"
+#include "base/hash.h"
+
+namespace openmldb {
+namespace storage {
+
+static constexpr uint32_t SEED = 0xe17a1465;
+// the tasks of a session which are not applied yet, a session waits before it adds more, so
+// the shared queues of the pools are hardly full and adding a task doesn't block
+static constexpr uint32_t MAX_PENDING_TASKS = 16;
+static constexpr uint32_t POOL_QUEUE_SIZE = 1024;
+
+LogApplier::LogApplier(uint32_t thread_num, uint32_t batch_size)
+    : thread_num_(thread_num), batch_size_(batch_size > 0 ? batch_size : 1), pools_() {
+    if (thread_num_ > 1) {
+        for (uint32_t i = 0; i < thread_num_; i++) {
+            pools_.emplace_back(new ::openmldb::base::TaskPool(1, POOL_QUEUE_SIZE));
+        }
+    }
+}
+
+LogApplier::~LogApplier() {
+    for (auto& pool : pools_) {
+        pool->Stop();
+    }
+}
+
+bool LogApplier::GetPartition(const ::openmldb::api::LogEntry& entry, uint32_t* partition) const {
+    if (entry.dimensions_size() == 0) {
+        uint32_t h = SEED;
+        if (entry.has_pk()) {
+            h = ::openmldb::base::hash(entry.pk().c_str(), entry.pk().length(), h);
+        }
+        *partition = h % thread_num_;
+        return true;
+    }
+    for (int i = 0; i < entry.dimensions_size(); i++) {
+        const auto& dimension = entry.dimensions(i);
+        uint32_t idx = dimension.idx();
+        uint32_t h = ::openmldb::base::hash(&idx, sizeof(idx), SEED);
+        h = ::openmldb::base::hash(dimension.key().c_str(), dimension.key().length(), h);
+        if (i == 0) {
+            *partition = h % thread_num_;
+        } else if (h % thread_num_ != *partition) {
+            return false;
+        }
+    }
+    return true;
+}
+
+LogApplier::Session::Session(LogApplier* applier, std::shared_ptr<Table> table)
+    : applier_(applier), table_(table), batches_(), mu_(), cv_(), pending_(0), failed_cnt_(0) {
+    if (applier_ != nullptr && applier_->thread_num_ > 1) {
+        batches_.resize(applier_->thread_num_);
+    }
+}
+
+LogApplier::Session::~Session() { Wait(); }
+
+void LogApplier::Session::Put(::openmldb::api::LogEntry* entry) {
+    if (batches_.empty()) {
+        Apply(*entry);
+        return;
+    }
+    uint32_t partition = 0;
+    if (!applier_->GetPartition(*entry, &partition)) {
+        Drain();
+        Apply(*entry);
+        return;
+    }
+    auto& batch = batches_[partition];
+    if (!batch.owned) {
+        batch.owned = std::make_shared<std::deque<::openmldb::api::LogEntry>>();
+    }
+    batch.owned->emplace_back();
+    batch.owned->back().Swap(entry);
+    batch.entries.push_back(&batch.owned->back());
+    if (batch.entries.size() >= applier_->batch_size_) {
+        Flush(partition);
+    }
+}
+
+void LogApplier::Session::Put(const ::openmldb::api::LogEntry& entry) {
+    if (batches_.empty()) {
+        Apply(entry);
+        return;
+    }
+    uint32_t partition = 0;
+    if (!applier_->GetPartition(entry, &partition)) {
+        Drain();
+        Apply(entry);
+        return;
+    }
+    auto& batch = batches_[partition];
+    batch.entries.push_back(&entry);
+    if (batch.entries.size() >= applier_->batch_size_) {
+        Flush(partition);
+    }
+}
+
+void LogApplier::Session::Flush(uint32_t partition) {
+    auto& batch = batches_[partition];
+    if (batch.entries.empty()) {
+        return;
+    }
+    auto entries = std::make_shared<std::vector<const ::openmldb::api::LogEntry*>>();
+    entries->swap(batch.entries);
+    std::shared_ptr<std::deque<::openmldb::api::LogEntry>> owned;
+    owned.swap(batch.owned);
+    {
+        // it bounds the memory of the entries not applied yet
+        std::unique_lock<bthread::Mutex> lock(mu_);
+        while (pending_ >= MAX_PENDING_TASKS) {
+            cv_.wait(lock);
+        }
+        pending_++;
+    }
+    std::shared_ptr<Table> table = table_;
+    applier_->pools_[partition]->AddTask([this, table, entries, owned]() {
+        uint64_t failed_cnt = 0;
+        for (const auto* entry : *entries) {
+            if (!table->Put(*entry)) {
+                failed_cnt++;
+            }
+        }
+        Done(failed_cnt);
+    });
+}
+
+void LogApplier::Session::Done(uint64_t failed_cnt) {
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    failed_cnt_ += failed_cnt;
+    pending_--;
+    cv_.notify_all();
+}
+
+void LogApplier::Session::Apply(const ::openmldb::api::LogEntry& entry) {
+    if (!table_->Put(entry)) {
+        std::lock_guard<bthread::Mutex> lock(mu_);
+        failed_cnt_++;
+    }
+}
+
+void LogApplier::Session::Drain() {
+    for (uint32_t i = 0; i < batches_.size(); i++) {
+        Flush(i);
+    }
+    std::unique_lock<bthread::Mutex> lock(mu_);
+    while (pending_ > 0) {
+        cv_.wait(lock);
+    }
+}
+
+uint64_t LogApplier::Session::Wait() {
+    Drain();
+    std::lock_guard<bthread::Mutex> lock(mu_);
+    uint64_t failed_cnt = failed_cnt_;
+    failed_cnt_ = 0;
+    return failed_cnt;
+}
+
+}  // namespace storage
+}  // namespace openmldb
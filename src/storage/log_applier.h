@@ -0,0 +1,101 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/taskpool.hpp"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "proto/tablet.pb.h"
+#include "storage/table.h"
+
+namespace openmldb {
+namespace storage {
+
+// LogApplier puts log entries into tables with several worker threads.
+// Entries are partitioned by the (index, key) of their dimensions, every partition
+// is applied by a single thread. An entry whose dimensions fall into different
+// partitions is applied after a barrier, so the entries sharing a key in any index
+// keep the log order.
+class LogApplier {
+ public:
+    LogApplier(uint32_t thread_num, uint32_t batch_size);
+    ~LogApplier();
+
+    // Session collects the entries of one table. Wait() is a barrier, it returns after
+    // all the entries put before have been applied. It's used in the rpc handlers, so it
+    // waits on bthread primitives and never blocks the worker pthread
+    class Session {
+     public:
+        Session(LogApplier* applier, std::shared_ptr<Table> table);
+        ~Session();
+
+        // the content of entry is swapped out
+        void Put(::openmldb::api::LogEntry* entry);
+
+        // entry is referenced, it must be alive until Wait returns
+        void Put(const ::openmldb::api::LogEntry& entry);
+
+        // return the count of entries failed to put since the last Wait
+        uint64_t Wait();
+
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+     private:
+        struct Batch {
+            // the entries swapped in are owned by the batch
+            std::shared_ptr<std::deque<::openmldb::api::LogEntry>> owned;
+            std::vector<const ::openmldb::api::LogEntry*> entries;
+        };
+
+        void Flush(uint32_t partition);
+        void Done(uint64_t failed_cnt);
+        // wait until all the entries put before have been applied
+        void Drain();
+        void Apply(const ::openmldb::api::LogEntry& entry);
+
+        LogApplier* applier_;
+        std::shared_ptr<Table> table_;
+        std::vector<Batch> batches_;
+        bthread::Mutex mu_;
+        bthread::ConditionVariable cv_;
+        uint32_t pending_;
+        uint64_t failed_cnt_;
+    };
+
+    inline uint32_t GetThreadNum() const { return thread_num_; }
+
+    LogApplier(const LogApplier&) = delete;
+    LogApplier& operator=(const LogApplier&) = delete;
+
+ private:
+    // false if the dimensions of the entry fall into different partitions
+    bool GetPartition(const ::openmldb::api::LogEntry& entry, uint32_t* partition) const;
+
+    uint32_t thread_num_;
+    uint32_t batch_size_;
+    // one single thread pool per partition to keep the order
+    std::vector<std::unique_ptr<::openmldb::base::TaskPool>> pools_;
+};
+
+}  // namespace storage
+}  // namespace openmldb
@@ -553,6 +553,47 @@ bool MemTable::GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) {
     return true;
 }
 
+bool MemTable::GetIndexStat(uint32_t idx, uint64_t* pk_cnt, uint64_t* idx_cnt) {
+    if (pk_cnt == nullptr || idx_cnt == nullptr) {
+        return false;
+    }
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    uint32_t real_idx = index_def->GetInnerPos();
+    auto ts_col = index_def->GetTsColumn();
+    *pk_cnt = 0;
+    *idx_cnt = 0;
+    for (uint32_t i = 0; i < seg_cnt_; i++) {
+        Segment* segment = segments_[real_idx][i];
+        *pk_cnt += segment->GetPkCnt();
+        uint64_t ts_cnt = 0;
+        if (ts_col && segment->GetTsCnt() > 1 && segment->GetIdxCnt(ts_col->GetId(), ts_cnt) == 0) {
+            *idx_cnt += ts_cnt;
+        } else {
+            *idx_cnt += segment->GetIdxCnt();
+        }
+    }
+    return true;
+}
+
+bool MemTable::GetKeyVersion(uint32_t idx, const std::string& key, uint64_t* version) {
+    if (version == nullptr) {
+        return false;
+    }
+    std::shared_ptr<IndexDef> index_def = table_index_.GetIndex(idx);
+    if (!index_def || !index_def->IsReady()) {
+        return false;
+    }
+    uint32_t seg_idx = 0;
+    if (seg_cnt_ > 1) {
+        seg_idx = ::openmldb::base::hash(key.data(), key.size(), SEED) % seg_cnt_;
+    }
+    *version = segments_[index_def->GetInnerPos()][seg_idx]->GetKeyVersion(Slice(key));
+    return true;
+}
+
 bool MemTable::AddIndex(const ::openmldb::common::ColumnKey& column_key) {
     // TODO(denglong): support ttl type and merge index
     auto table_meta = GetTableMeta();
@@ -110,6 +110,8 @@ class MemTable : public Table {
     bool GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) override;
     uint64_t GetRecordIdxByteSize() override;
     uint64_t GetRecordPkCnt() override;
+    bool GetIndexStat(uint32_t idx, uint64_t* pk_cnt, uint64_t* idx_cnt) override;
+    bool GetKeyVersion(uint32_t idx, const std::string& key, uint64_t* version) override;
 
     void SetCompressType(::openmldb::type::CompressType compress_type);
     ::openmldb::type::CompressType GetCompressType();
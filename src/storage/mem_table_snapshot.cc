@@ -23,6 +23,7 @@
 #include <snappy.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -40,6 +41,7 @@
 #include "log/log_reader.h"
 #include "log/sequential_file.h"
 #include "proto/tablet.pb.h"
+#include "storage/log_applier.h"
 
 using google::protobuf::RepeatedPtrField;
 using ::openmldb::codec::SchemaCodec;
@@ -51,6 +53,10 @@ DECLARE_uint32(load_table_batch);
 DECLARE_uint32(load_table_thread_num);
 DECLARE_uint32(load_table_queue_size);
 DECLARE_string(snapshot_compression);
+DECLARE_uint32(snapshot_compress_dict_size);
+DECLARE_uint32(snapshot_max_delta_num);
+DECLARE_uint32(binlog_apply_thread_num);
+DECLARE_uint32(binlog_apply_batch_size);
 
 namespace openmldb {
 namespace storage {
@@ -84,7 +90,10 @@ bool MemTableSnapshot::Recover(std::shared_ptr<Table> table, uint64_t& latest_of
         return false;
     }
     if (ret == 0) {
-        RecoverFromSnapshot(manifest.name(), manifest.count(), table);
+        RecoverFromSnapshot(manifest.name(), manifest.count(), table, manifest.compress_dict());
+        for (const auto& delta : manifest.deltas()) {
+            RecoverFromDelta(delta, table);
+        }
         latest_offset = manifest.offset();
         offset_ = latest_offset;
     }
@@ -92,11 +101,11 @@ bool MemTableSnapshot::Recover(std::shared_ptr<Table> table, uint64_t& latest_of
 }
 
 void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt,
-                                           std::shared_ptr<Table> table) {
+                                           std::shared_ptr<Table> table, const std::string& compress_dict) {
     std::string full_path = snapshot_path_ + "/" + snapshot_name;
     std::atomic<uint64_t> g_succ_cnt(0);
     std::atomic<uint64_t> g_failed_cnt(0);
-    RecoverSingleSnapshot(full_path, table, &g_succ_cnt, &g_failed_cnt);
+    RecoverSingleSnapshot(full_path, table, compress_dict, &g_succ_cnt, &g_failed_cnt);
     PDLOG(INFO, "[Recover] progress done stat: success count %lu, failed count %lu",
           g_succ_cnt.load(std::memory_order_relaxed), g_failed_cnt.load(std::memory_order_relaxed));
     if (g_succ_cnt.load(std::memory_order_relaxed) != expect_cnt) {
@@ -105,8 +114,56 @@ void MemTableSnapshot::RecoverFromSnapshot(const std::string& snapshot_name, uin
     }
 }
 
+void MemTableSnapshot::RecoverFromDelta(const ::openmldb::api::SnapshotDelta& delta, std::shared_ptr<Table> table) {
+    std::string full_path = snapshot_path_ + delta.name();
+    FILE* fd = fopen(full_path.c_str(), "rb");
+    if (fd == NULL) {
+        PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
+        return;
+    }
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(full_path, fd);
+    ::openmldb::log::Reader reader(seq_file, NULL, false, 0, IsCompressed(full_path));
+    reader.SetCompressDict(delta.compress_dict());
+    // the entries are applied in the log order like binlog recovery, a delete is a barrier
+    LogApplier applier(FLAGS_binlog_apply_thread_num, FLAGS_binlog_apply_batch_size);
+    LogApplier::Session session(&applier, table);
+    std::string buffer;
+    ::openmldb::api::LogEntry entry;
+    uint64_t succ_cnt = 0;
+    uint64_t failed_cnt = 0;
+    while (true) {
+        ::openmldb::base::Slice record;
+        ::openmldb::log::Status status = reader.ReadRecord(&record, &buffer);
+        if (status.IsWaitRecord() || status.IsEof()) {
+            break;
+        }
+        if (!status.ok() || !entry.ParseFromArray(record.data(), record.size())) {
+            PDLOG(WARNING, "fail to read record for tid %u, pid %u, path %s", tid_, pid_, full_path.c_str());
+            failed_cnt++;
+            continue;
+        }
+        if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+            if (entry.dimensions_size() > 0) {
+                failed_cnt += session.Wait();
+                table->Delete(entry.dimensions(0).key(), entry.dimensions(0).idx());
+            }
+        } else {
+            session.Put(&entry);
+        }
+        succ_cnt++;
+    }
+    failed_cnt += session.Wait();
+    delete seq_file;
+    PDLOG(INFO, "recover delta %s done. tid %u pid %u succ_cnt %lu failed_cnt %lu", delta.name().c_str(), tid_, pid_,
+          succ_cnt, failed_cnt);
+    if (succ_cnt != delta.count()) {
+        PDLOG(WARNING, "delta %s, expect cnt %lu but succ_cnt %lu", delta.name().c_str(), delta.count(), succ_cnt);
+    }
+}
+
 void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table,
-                                             std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt) {
+                                             const std::string& compress_dict, std::atomic<uint64_t>* g_succ_cnt,
+                                             std::atomic<uint64_t>* g_failed_cnt) {
     ::openmldb::base::TaskPool load_pool_(FLAGS_load_table_thread_num, FLAGS_load_table_batch);
     std::atomic<uint64_t> succ_cnt, failed_cnt;
     succ_cnt = failed_cnt = 0;
@@ -122,8 +179,9 @@ void MemTableSnapshot::RecoverSingleSnapshot(const std::string& path, std::share
             break;
         }
         bool compressed = IsCompressed(path);
-        ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(path, fd);
+        ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(path, fd);
         ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+        reader.SetCompressDict(compress_dict);
         std::string buffer;
         // second
         uint64_t consumed = ::baidu::common::timer::now_time();
@@ -204,8 +262,9 @@ int MemTableSnapshot::TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb
         return -1;
     }
     bool compressed = IsCompressed(full_path);
-    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(manifest.name(), fd);
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(manifest.name(), fd);
     ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+    reader.SetCompressDict(manifest.compress_dict());
 
     std::string buffer;
     std::string tmp_buf;
@@ -229,12 +288,17 @@ int MemTableSnapshot::TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb
             has_error = true;
             break;
         }
-        if (!entry.ParseFromString(record.ToString())) {
+        if (!entry.ParseFromArray(record.data(), record.size())) {
             PDLOG(WARNING, "fail parse record for tid %u, pid %u with value %s", tid_, pid_,
                   ::openmldb::base::DebugString(record.ToString()).c_str());
             has_error = true;
             break;
         }
+        if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete) {
+            // only deltas have delete entries, the keys are removed by RemoveDeletedKey
+            deleted_key_num++;
+            continue;
+        }
         int ret = RemoveDeletedKey(entry, deleted_index, &tmp_buf);
         if (ret == 1) {
             deleted_key_num++;
@@ -294,7 +358,7 @@ uint64_t MemTableSnapshot::CollectDeletedKey(uint64_t end_offset) {
         ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
         if (status.ok()) {
             ::openmldb::api::LogEntry entry;
-            if (!entry.ParseFromString(record.ToString())) {
+            if (!entry.ParseFromArray(record.data(), record.size())) {
                 PDLOG(WARNING, "fail to parse LogEntry. record[%s] size[%ld]",
                       ::openmldb::base::DebugString(record.ToString()).c_str(), record.ToString().size());
                 break;
@@ -352,6 +416,44 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         return -1;
     }
     making_snapshot_.store(true, std::memory_order_release);
+    ::openmldb::api::Manifest manifest;
+    int ret = 0;
+    if (GetLocalManifest(snapshot_path_ + MANIFEST, manifest) == 0 && NeedDeltaSnapshot(manifest)) {
+        ret = MakeDeltaSnapshot(table, manifest, out_offset, end_offset, term);
+    } else {
+        ret = MakeBaseSnapshot(table, out_offset, end_offset, term);
+    }
+    making_snapshot_.store(false, std::memory_order_release);
+    return ret;
+}
+
+bool MemTableSnapshot::NeedDeltaSnapshot(const ::openmldb::api::Manifest& manifest) {
+    if (FLAGS_snapshot_max_delta_num == 0 || !manifest.has_name()) {
+        return false;
+    }
+    if (manifest.deltas_size() >= static_cast<int>(FLAGS_snapshot_max_delta_num)) {
+        return false;
+    }
+    // merge the deltas when reading them costs as much as reading the base
+    uint64_t delta_count = 0;
+    for (const auto& delta : manifest.deltas()) {
+        delta_count += delta.count();
+    }
+    return delta_count < manifest.count();
+}
+
+int MemTableSnapshot::MergeDeltaSnapshot(std::shared_ptr<Table> table) {
+    ::openmldb::api::Manifest manifest;
+    if (GetLocalManifest(snapshot_path_ + MANIFEST, manifest) != 0 || manifest.deltas_size() == 0) {
+        return 0;
+    }
+    PDLOG(INFO, "merge %d deltas into base snapshot. tid %u pid %u", manifest.deltas_size(), tid_, pid_);
+    uint64_t offset = 0;
+    return MakeBaseSnapshot(table, offset, 0, 0);
+}
+
+int MemTableSnapshot::MakeBaseSnapshot(std::shared_ptr<Table> table, uint64_t& out_offset, uint64_t end_offset,
+                                       uint64_t term) {
     std::string now_time = ::openmldb::base::GetNowTime();
     std::string snapshot_name = now_time.substr(0, now_time.length() - 2) + ".sdb";
     if (FLAGS_snapshot_compression != "off") {
@@ -364,12 +466,13 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
     FILE* fd = fopen(tmp_file_path.c_str(), "ab+");
     if (fd == NULL) {
         PDLOG(WARNING, "fail to create file %s", tmp_file_path.c_str());
-        making_snapshot_.store(false, std::memory_order_release);
         return -1;
     }
     uint64_t collected_offset = CollectDeletedKey(end_offset);
     uint64_t start_time = ::baidu::common::timer::now_time();
     WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, snapshot_name_tmp, fd);
+    wh->SetTrainDictSize(FLAGS_snapshot_compress_dict_size);
+    std::string compress_dict;
     ::openmldb::api::Manifest manifest;
     bool has_error = false;
     uint64_t write_count = 0;
@@ -378,10 +481,30 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
     uint64_t last_term = term;
     int result = GetLocalManifest(snapshot_path_ + MANIFEST, manifest);
     if (result == 0) {
+        // the deletes in deltas apply to the base and the older deltas
+        CollectDeltaDeletedKey(manifest);
         // filter old snapshot
         if (TTLSnapshot(table, manifest, wh, write_count, expired_key_num, deleted_key_num) < 0) {
             has_error = true;
         }
+        for (const auto& delta : manifest.deltas()) {
+            if (has_error) {
+                break;
+            }
+            ::openmldb::api::Manifest delta_manifest;
+            delta_manifest.set_name(delta.name());
+            delta_manifest.set_count(delta.count());
+            delta_manifest.set_compress_dict(delta.compress_dict());
+            uint64_t delta_count = 0;
+            uint64_t delta_expired_num = 0;
+            uint64_t delta_deleted_num = 0;
+            if (TTLSnapshot(table, delta_manifest, wh, delta_count, delta_expired_num, delta_deleted_num) < 0) {
+                has_error = true;
+            }
+            write_count += delta_count;
+            expired_key_num += delta_expired_num;
+            deleted_key_num += delta_deleted_num;
+        }
         last_term = manifest.term();
         DEBUGLOG("old manifest term is %lu", last_term);
     } else if (result < 0) {
@@ -407,7 +530,7 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
         if (status.ok()) {
             ::openmldb::api::LogEntry entry;
-            if (!entry.ParseFromString(record.ToString())) {
+            if (!entry.ParseFromArray(record.data(), record.size())) {
                 PDLOG(WARNING, "fail to parse LogEntry. record[%s] size[%ld]",
                       ::openmldb::base::DebugString(record.ToString()).c_str(), record.ToString().size());
                 has_error = true;
@@ -474,6 +597,7 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
     }
     if (wh != NULL) {
         wh->EndLog();
+        compress_dict = wh->GetCompressDict();
         delete wh;
         wh = NULL;
     }
@@ -483,12 +607,15 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         ret = -1;
     } else {
         if (rename(tmp_file_path.c_str(), full_path.c_str()) == 0) {
-            if (GenManifest(snapshot_name, write_count, cur_offset, last_term) == 0) {
+            if (GenManifest(snapshot_name, write_count, cur_offset, last_term, compress_dict) == 0) {
                 // delete old snapshot
                 if (manifest.has_name() && manifest.name() != snapshot_name) {
                     DEBUGLOG("old snapshot[%s] has deleted", manifest.name().c_str());
                     unlink((snapshot_path_ + manifest.name()).c_str());
                 }
+                for (const auto& delta : manifest.deltas()) {
+                    unlink((snapshot_path_ + delta.name()).c_str());
+                }
                 uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
                 PDLOG(INFO,
                       "make snapshot[%s] success. update offset from %lu to %lu."
@@ -510,10 +637,182 @@ int MemTableSnapshot::MakeSnapshot(std::shared_ptr<Table> table, uint64_t& out_o
         }
     }
     deleted_keys_.clear();
-    making_snapshot_.store(false, std::memory_order_release);
     return ret;
 }
 
+int MemTableSnapshot::MakeDeltaSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest& manifest,
+                                        uint64_t& out_offset, uint64_t end_offset, uint64_t term) {
+    uint64_t start_offset = manifest.offset();
+    std::string snapshot_name = "delta_" + std::to_string(start_offset) + SNAPSHOT_SUBFIX;
+    if (FLAGS_snapshot_compression != "off") {
+        snapshot_name.append(".");
+        snapshot_name.append(FLAGS_snapshot_compression);
+    }
+    std::string full_path = snapshot_path_ + snapshot_name;
+    std::string tmp_file_path = full_path + ".tmp";
+    FILE* fd = fopen(tmp_file_path.c_str(), "wb+");
+    if (fd == NULL) {
+        PDLOG(WARNING, "fail to create file %s", tmp_file_path.c_str());
+        return -1;
+    }
+    uint64_t collected_offset = CollectDeletedKey(end_offset);
+    uint64_t start_time = ::baidu::common::timer::now_time();
+    WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, snapshot_name + ".tmp", fd);
+    wh->SetTrainDictSize(FLAGS_snapshot_compress_dict_size);
+    std::set<uint32_t> deleted_index;
+    for (const auto& it : table->GetAllIndex()) {
+        if (it->GetStatus() == ::openmldb::storage::IndexStatus::kDeleted) {
+            deleted_index.insert(it->GetId());
+        }
+    }
+    bool has_error = false;
+    uint64_t write_count = 0;
+    uint64_t deleted_key_num = 0;
+    uint64_t expired_key_num = 0;
+    uint64_t last_term = term > 0 ? term : manifest.term();
+    ::openmldb::log::LogReader log_reader(log_part_, log_path_, false);
+    log_reader.SetOffset(start_offset);
+    uint64_t cur_offset = start_offset;
+    std::string buffer;
+    std::string tmp_buf;
+    while (!has_error && cur_offset < collected_offset) {
+        buffer.clear();
+        ::openmldb::base::Slice record;
+        ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
+        if (status.ok()) {
+            ::openmldb::api::LogEntry entry;
+            if (!entry.ParseFromArray(record.data(), record.size())) {
+                PDLOG(WARNING, "fail to parse LogEntry. record[%s] size[%ld]",
+                      ::openmldb::base::DebugString(record.ToString()).c_str(), record.ToString().size());
+                has_error = true;
+                break;
+            }
+            if (entry.log_index() <= cur_offset) {
+                continue;
+            }
+            if (cur_offset + 1 != entry.log_index()) {
+                PDLOG(WARNING, "log missing expect offset %lu but %ld. tid %u pid %u", cur_offset + 1,
+                      entry.log_index(), tid_, pid_);
+                continue;
+            }
+            cur_offset = entry.log_index();
+            if (entry.has_term()) {
+                last_term = entry.term();
+            }
+            // the delete entries are kept, they delete the keys of the base and the older deltas
+            if (!(entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete)) {
+                int ret = RemoveDeletedKey(entry, deleted_index, &tmp_buf);
+                if (ret == 1) {
+                    deleted_key_num++;
+                    continue;
+                } else if (ret == 2) {
+                    record.reset(tmp_buf.data(), tmp_buf.size());
+                }
+                if (table->IsExpire(entry)) {
+                    expired_key_num++;
+                    continue;
+                }
+            }
+            status = wh->Write(record);
+            if (!status.ok()) {
+                PDLOG(WARNING, "fail to write snapshot. path[%s] status[%s]", tmp_file_path.c_str(),
+                      status.ToString().c_str());
+                has_error = true;
+                break;
+            }
+            write_count++;
+        } else if (status.IsEof()) {
+            continue;
+        } else if (status.IsWaitRecord()) {
+            int end_log_index = log_reader.GetEndLogIndex();
+            int cur_log_index = log_reader.GetLogIndex();
+            if (end_log_index >= 0 && end_log_index > cur_log_index) {
+                log_reader.RollRLogFile();
+                continue;
+            }
+            break;
+        } else {
+            PDLOG(WARNING, "fail to get record. status is %s", status.ToString().c_str());
+            has_error = true;
+            break;
+        }
+    }
+    wh->EndLog();
+    std::string compress_dict = wh->GetCompressDict();
+    delete wh;
+    deleted_keys_.clear();
+    if (has_error || cur_offset == start_offset) {
+        unlink(tmp_file_path.c_str());
+        if (has_error) {
+            return -1;
+        }
+        out_offset = cur_offset;
+        return 0;
+    }
+    if (rename(tmp_file_path.c_str(), full_path.c_str()) != 0) {
+        PDLOG(WARNING, "rename[%s] failed", snapshot_name.c_str());
+        unlink(tmp_file_path.c_str());
+        return -1;
+    }
+    ::openmldb::api::Manifest new_manifest(manifest);
+    ::openmldb::api::SnapshotDelta* delta = new_manifest.add_deltas();
+    delta->set_name(snapshot_name);
+    delta->set_count(write_count);
+    delta->set_start_offset(start_offset);
+    delta->set_end_offset(cur_offset);
+    if (!compress_dict.empty()) {
+        delta->set_compress_dict(compress_dict);
+    }
+    new_manifest.set_offset(cur_offset);
+    new_manifest.set_term(last_term);
+    if (GenManifest(new_manifest) != 0) {
+        PDLOG(WARNING, "GenManifest failed. delete snapshot file[%s]", full_path.c_str());
+        unlink(full_path.c_str());
+        return -1;
+    }
+    uint64_t consumed = ::baidu::common::timer::now_time() - start_time;
+    PDLOG(INFO,
+          "make delta snapshot[%s] success. update offset from %lu to %lu. use %lu second. "
+          "write key %lu expired key %lu deleted key %lu",
+          snapshot_name.c_str(), start_offset, cur_offset, consumed, write_count, expired_key_num, deleted_key_num);
+    offset_ = cur_offset;
+    out_offset = cur_offset;
+    return 0;
+}
+
+void MemTableSnapshot::CollectDeltaDeletedKey(const ::openmldb::api::Manifest& manifest) {
+    for (const auto& delta : manifest.deltas()) {
+        std::string full_path = snapshot_path_ + delta.name();
+        FILE* fd = fopen(full_path.c_str(), "rb");
+        if (fd == NULL) {
+            PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
+            continue;
+        }
+        ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(full_path, fd);
+        ::openmldb::log::Reader reader(seq_file, NULL, false, 0, IsCompressed(full_path));
+        reader.SetCompressDict(delta.compress_dict());
+        std::string buffer;
+        ::openmldb::api::LogEntry entry;
+        while (true) {
+            ::openmldb::base::Slice record;
+            ::openmldb::log::Status status = reader.ReadRecord(&record, &buffer);
+            if (!status.ok()) {
+                break;
+            }
+            if (!entry.ParseFromArray(record.data(), record.size())) {
+                continue;
+            }
+            if (entry.has_method_type() && entry.method_type() == ::openmldb::api::MethodType::kDelete &&
+                entry.dimensions_size() > 0) {
+                std::string combined_key = entry.dimensions(0).key() + "|" + std::to_string(entry.dimensions(0).idx());
+                uint64_t& offset = deleted_keys_[combined_key];
+                offset = std::max(offset, entry.log_index());
+            }
+        }
+        delete seq_file;
+    }
+}
+
 int MemTableSnapshot::RemoveDeletedKey(const ::openmldb::api::LogEntry& entry, const std::set<uint32_t>& deleted_index,
                                        std::string* buffer) {
     uint64_t cur_offset = entry.log_index();
@@ -676,9 +975,10 @@ base::Status MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> t
         PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
         return base::Status(base::ReturnCode::kError, "fail to open file");
     }
-    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(manifest.name(), fd);
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(manifest.name(), fd);
     bool compressed = IsCompressed(full_path);
     ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+    reader.SetCompressDict(manifest.compress_dict());
     std::string buffer;
     ::openmldb::api::LogEntry entry;
     bool has_error = false;
@@ -697,7 +997,7 @@ base::Status MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> t
             has_error = true;
             break;
         }
-        if (!entry.ParseFromString(record.ToString())) {
+        if (!entry.ParseFromArray(record.data(), record.size())) {
             PDLOG(WARNING, "fail parse record for tid %u, pid %u with value %s",
                     tid_, pid_, ::openmldb::base::DebugString(record.ToString()).c_str());
             has_error = true;
@@ -796,9 +1096,10 @@ int MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> table, con
         PDLOG(WARNING, "fail to open path %s for error %s", full_path.c_str(), strerror(errno));
         return -1;
     }
-    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(manifest.name(), fd);
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(manifest.name(), fd);
     bool compressed = IsCompressed(full_path);
     ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+    reader.SetCompressDict(manifest.compress_dict());
     std::string buffer;
     ::openmldb::api::LogEntry entry;
     bool has_error = false;
@@ -818,7 +1119,7 @@ int MemTableSnapshot::ExtractIndexFromSnapshot(std::shared_ptr<Table> table, con
             has_error = true;
             break;
         }
-        if (!entry.ParseFromString(record.ToString())) {
+        if (!entry.ParseFromArray(record.data(), record.size())) {
             PDLOG(WARNING, "fail parse record for tid %u, pid %u with value %s", tid_, pid_,
                   ::openmldb::base::DebugString(record.ToString()).c_str());
             has_error = true;
@@ -987,7 +1288,7 @@ base::Status MemTableSnapshot::ExtractIndexFromBinlog(std::shared_ptr<Table> tab
         ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
         if (status.ok()) {
             ::openmldb::api::LogEntry entry;
-            if (!entry.ParseFromString(record.ToString())) {
+            if (!entry.ParseFromArray(record.data(), record.size())) {
                 LOG(WARNING) << "fail to parse LogEntry. record " << openmldb::base::DebugString(record.ToString())
                              << " size " << record.ToString().size() << " tid " << tid << " pid " << pid;
                 return base::Status(base::ReturnCode::kError, "parse error");
@@ -1105,6 +1406,12 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return -1;
     }
+    // the new index is extracted from the base snapshot and binlog only
+    if (MergeDeltaSnapshot(table) < 0) {
+        PDLOG(WARNING, "fail to merge delta snapshot. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return -1;
+    }
     std::string snapshot_name = GenSnapshotName();
     std::string snapshot_name_tmp = snapshot_name + ".tmp";
     std::string full_path = snapshot_path_ + snapshot_name;
@@ -1118,6 +1425,8 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
     uint64_t collected_offset = CollectDeletedKey(0);
     uint64_t start_time = ::baidu::common::timer::now_time();
     WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, snapshot_name_tmp, fd);
+    wh->SetTrainDictSize(FLAGS_snapshot_compress_dict_size);
+    std::string compress_dict;
     ::openmldb::api::Manifest manifest;
     bool has_error = false;
     uint64_t write_count = 0;
@@ -1150,6 +1459,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
 
     if (wh != NULL) {
         wh->EndLog();
+        compress_dict = wh->GetCompressDict();
         delete wh;
         wh = NULL;
     }
@@ -1159,7 +1469,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table,
         ret = -1;
     } else {
         if (rename(tmp_file_path.c_str(), full_path.c_str()) == 0) {
-            if (GenManifest(snapshot_name, write_count, cur_offset, last_term) == 0) {
+            if (GenManifest(snapshot_name, write_count, cur_offset, last_term, compress_dict) == 0) {
                 // delete old snapshot
                 if (manifest.has_name() && manifest.name() != snapshot_name) {
                     DEBUGLOG("old snapshot[%s] has deleted", manifest.name().c_str());
@@ -1197,6 +1507,12 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return -1;
     }
+    // the new index is extracted from the base snapshot and binlog only
+    if (MergeDeltaSnapshot(table) < 0) {
+        PDLOG(WARNING, "fail to merge delta snapshot. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return -1;
+    }
     std::string now_time = ::openmldb::base::GetNowTime();
     std::string snapshot_name = now_time.substr(0, now_time.length() - 2) + ".sdb";
     if (FLAGS_snapshot_compression != "off") {
@@ -1215,6 +1531,8 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
     uint64_t collected_offset = CollectDeletedKey(0);
     uint64_t start_time = ::baidu::common::timer::now_time();
     WriteHandle* wh = new WriteHandle(FLAGS_snapshot_compression, snapshot_name_tmp, fd);
+    wh->SetTrainDictSize(FLAGS_snapshot_compress_dict_size);
+    std::string compress_dict;
     ::openmldb::api::Manifest manifest;
     bool has_error = false;
     uint64_t write_count = 0;
@@ -1274,7 +1592,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
         ::openmldb::log::Status status = log_reader.ReadNextRecord(&record, &buffer);
         if (status.ok()) {
             ::openmldb::api::LogEntry entry;
-            if (!entry.ParseFromString(record.ToString())) {
+            if (!entry.ParseFromArray(record.data(), record.size())) {
                 LOG(WARNING) << "fail to parse LogEntry. record " << openmldb::base::DebugString(record.ToString())
                              << " size " << record.ToString().size() << " tid " << tid << " pid " << pid;
                 has_error = true;
@@ -1416,6 +1734,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
     }
     if (wh != NULL) {
         wh->EndLog();
+        compress_dict = wh->GetCompressDict();
         delete wh;
         wh = NULL;
     }
@@ -1425,7 +1744,7 @@ int MemTableSnapshot::ExtractIndexData(std::shared_ptr<Table> table, const ::ope
         ret = -1;
     } else {
         if (rename(tmp_file_path.c_str(), full_path.c_str()) == 0) {
-            if (GenManifest(snapshot_name, write_count, cur_offset, last_term) == 0) {
+            if (GenManifest(snapshot_name, write_count, cur_offset, last_term, compress_dict) == 0) {
                 // delete old snapshot
                 if (manifest.has_name() && manifest.name() != snapshot_name) {
                     DEBUGLOG("old snapshot[%s] has deleted", manifest.name().c_str());
@@ -1553,9 +1872,10 @@ bool MemTableSnapshot::DumpSnapshotIndexData(std::shared_ptr<Table> table,
         PDLOG(WARNING, "fail to open path %s for error %s", path.c_str(), strerror(errno));
         return false;
     }
-    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFile(path, fd);
+    ::openmldb::log::SequentialFile* seq_file = ::openmldb::log::NewSeqFileByFlag(path, fd);
     bool compressed = IsCompressed(path);
     ::openmldb::log::Reader reader(seq_file, NULL, false, 0, compressed);
+    reader.SetCompressDict(manifest.compress_dict());
     ::openmldb::api::LogEntry entry;
     std::string buffer;
     std::string entry_buff;
@@ -1614,6 +1934,12 @@ bool MemTableSnapshot::DumpIndexData(std::shared_ptr<Table> table, const ::openm
         PDLOG(INFO, "snapshot is doing now. tid %u, pid %u", tid, pid);
         return false;
     }
+    // the new index is extracted from the base snapshot and binlog only
+    if (MergeDeltaSnapshot(table) < 0) {
+        PDLOG(WARNING, "fail to merge delta snapshot. tid %u, pid %u", tid, pid);
+        making_snapshot_.store(false, std::memory_order_release);
+        return false;
+    }
     std::map<std::string, uint32_t> column_desc_map;
     auto table_meta = table->GetTableMeta();
     for (int32_t i = 0; i < table_meta->column_desc_size(); ++i) {
@@ -1790,7 +2116,8 @@ int MemTableSnapshot::DecodeData(std::shared_ptr<Table> table, const openmldb::a
 
 bool MemTableSnapshot::IsCompressed(const std::string& path) {
     if (path.find(openmldb::log::ZLIB_COMPRESS_SUFFIX) != std::string::npos ||
-        path.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos) {
+        path.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos ||
+        path.find(openmldb::log::ZSTD_COMPRESS_SUFFIX) != std::string::npos) {
         return true;
     }
     return false;
@@ -50,13 +50,19 @@ class MemTableSnapshot : public Snapshot {
 
     bool Recover(std::shared_ptr<Table> table, uint64_t& latest_offset) override;
 
-    void RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt, std::shared_ptr<Table> table);
+    void RecoverFromSnapshot(const std::string& snapshot_name, uint64_t expect_cnt, std::shared_ptr<Table> table,
+                             const std::string& compress_dict = "");
 
+    // make a delta snapshot of the binlog since the last snapshot if snapshot_max_delta_num is set,
+    // or merge the base, the deltas and the binlog into a new base snapshot
     int MakeSnapshot(std::shared_ptr<Table> table,
                      uint64_t& out_offset,  // NOLINT
                      uint64_t end_offset,
                      uint64_t term = 0) override;
 
+    // merge the deltas into a new base snapshot, the caller should hold making_snapshot_
+    int MergeDeltaSnapshot(std::shared_ptr<Table> table);
+
     int TTLSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest& manifest, WriteHandle* wh,
                     uint64_t& count, uint64_t& expired_key_num,  // NOLINT
                     uint64_t& deleted_key_num);                  // NOLINT
@@ -117,11 +123,24 @@ class MemTableSnapshot : public Snapshot {
 
  private:
     // load single snapshot to table
-    void RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table, std::atomic<uint64_t>* g_succ_cnt,
-                               std::atomic<uint64_t>* g_failed_cnt);
+    void RecoverSingleSnapshot(const std::string& path, std::shared_ptr<Table> table, const std::string& compress_dict,
+                               std::atomic<uint64_t>* g_succ_cnt, std::atomic<uint64_t>* g_failed_cnt);
+
+    void RecoverFromDelta(const ::openmldb::api::SnapshotDelta& delta, std::shared_ptr<Table> table);
+
+    bool NeedDeltaSnapshot(const ::openmldb::api::Manifest& manifest);
+
+    int MakeBaseSnapshot(std::shared_ptr<Table> table, uint64_t& out_offset,  // NOLINT
+                         uint64_t end_offset, uint64_t term);
+
+    int MakeDeltaSnapshot(std::shared_ptr<Table> table, const ::openmldb::api::Manifest& manifest,
+                          uint64_t& out_offset, uint64_t end_offset, uint64_t term);  // NOLINT
 
     uint64_t CollectDeletedKey(uint64_t end_offset);
 
+    // collect the deleted keys of the delete entries in deltas
+    void CollectDeltaDeletedKey(const ::openmldb::api::Manifest& manifest);
+
     int DecodeData(std::shared_ptr<Table> table, const openmldb::api::LogEntry& entry, uint32_t maxIdx,
                    std::vector<std::string>& row);  // NOLINT
 
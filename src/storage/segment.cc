@@ -19,6 +19,7 @@
 #include <gflags/gflags.h>
 
 #include "base/glog_wrapper.h"
+#include "base/hash.h"
 #include "base/strings.h"
 #include "common/timer.h"
 #include "storage/record.h"
@@ -32,6 +33,8 @@ namespace openmldb {
 namespace storage {
 
 static const SliceComparator scmp;
+// differs from the seed picking the segment, otherwise the keys of one segment share few slots
+static constexpr uint32_t KEY_VERSION_SEED = 0x9747b28c;
 Segment::Segment()
     : entries_(NULL),
       mu_(),
@@ -198,6 +201,7 @@ void Segment::PutUnlock(const Slice& key, uint64_t time, DataBlock* row) {
         ->count_.fetch_add(1, std::memory_order_relaxed);
     byte_size += GetRecordTsIdxSize(height);
     idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
+    IncrKeyVersion(key);
 }
 
 void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t time, DataBlock* row) {
@@ -228,6 +232,7 @@ void Segment::BulkLoadPut(unsigned int key_entry_id, const Slice& key, uint64_t
         byte_size += GetRecordTsIdxSize(height);
         idx_byte_size_.fetch_add(byte_size, std::memory_order_relaxed);
         idx_cnt_vec_[key_entry_id]->fetch_add(1, std::memory_order_relaxed);
+        IncrKeyVersion(key);
     }
 }
 
@@ -310,6 +315,9 @@ void Segment::Put(const Slice& key, const std::map<int32_t, uint64_t>& ts_map, D
             delete row;
         }
     }
+    if (entry_arr != NULL) {
+        IncrKeyVersion(key);
+    }
 }
 
 bool Segment::Delete(const Slice& key) {
@@ -320,6 +328,7 @@ bool Segment::Delete(const Slice& key) {
         if (entry_node == NULL) {
             return false;
         }
+        IncrKeyVersion(key);
     }
     {
         std::lock_guard<std::mutex> lock(gc_mu_);
@@ -328,6 +337,16 @@ bool Segment::Delete(const Slice& key) {
     return true;
 }
 
+uint64_t Segment::GetKeyVersion(const Slice& key) const {
+    uint32_t slot = ::openmldb::base::hash(key.data(), key.size(), KEY_VERSION_SEED) % KEY_VERSION_SLOTS;
+    return key_versions_[slot].load(std::memory_order_acquire);
+}
+
+void Segment::IncrKeyVersion(const Slice& key) {
+    uint32_t slot = ::openmldb::base::hash(key.data(), key.size(), KEY_VERSION_SEED) % KEY_VERSION_SLOTS;
+    key_versions_[slot].fetch_add(1, std::memory_order_release);
+}
+
 void Segment::FreeList(::openmldb::base::Node<uint64_t, DataBlock*>* node, uint64_t& gc_idx_cnt,
                        uint64_t& gc_record_cnt, uint64_t& gc_record_byte_size) {
     while (node != NULL) {
@@ -17,6 +17,7 @@
 #ifndef SRC_STORAGE_SEGMENT_H_
 #define SRC_STORAGE_SEGMENT_H_
 
+#include <array>
 #include <atomic>
 #include <map>
 #include <memory>
@@ -254,6 +255,11 @@ class Segment {
 
     void IncrGcVersion() { gc_version_.fetch_add(1, std::memory_order_relaxed); }
 
+    // the version is bumped after every Put or Delete of the key, but not by the gc of expired
+    // rows. keys are hashed into KEY_VERSION_SLOTS slots, so a write may bump the version of
+    // other keys too
+    uint64_t GetKeyVersion(const Slice& key) const;
+
     void ReleaseAndCount(uint64_t& gc_idx_cnt,            // NOLINT
                          uint64_t& gc_record_cnt,         // NOLINT
                          uint64_t& gc_record_byte_size);  // NOLINT
@@ -270,7 +276,10 @@ class Segment {
     void FreeEntry(::openmldb::base::Node<Slice, void*>* entry_node, uint64_t& gc_idx_cnt,  // NOLINT
                    uint64_t& gc_record_cnt,         // NOLINT
                    uint64_t& gc_record_byte_size);  // NOLINT
+    void IncrKeyVersion(const Slice& key);
+
  public:
+    static constexpr uint32_t KEY_VERSION_SLOTS = 64;
     ::openmldb::base::TimeSeriesPool pool_;
     std::vector< ::openmldb::base::TimeSeriesPool * > pools_;
     bool flag;
@@ -290,6 +299,7 @@ class Segment {
     std::vector<std::shared_ptr<std::atomic<uint64_t>>> idx_cnt_vec_;
 
     uint64_t ttl_offset_;
+    std::array<std::atomic<uint64_t>, KEY_VERSION_SLOTS> key_versions_{};
 };
 
 }  // namespace storage
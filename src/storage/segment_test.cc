@@ -17,7 +17,9 @@
 #include "storage/segment.h"
 
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "base/glog_wrapper.h"
 #include "base/slice.h"
@@ -155,6 +157,38 @@ TEST_F(SegmentTest, Delete) {
     ASSERT_EQ(84, (int64_t)gc_record_byte_size);
 }
 
+TEST_F(SegmentTest, KeyVersion) {
+    Segment segment;
+    Slice pk("test1");
+    std::string value = "test0";
+    uint64_t version = segment.GetKeyVersion(pk);
+    segment.Put(pk, 9527, value.c_str(), value.size());
+    ASSERT_NE(version, segment.GetKeyVersion(pk));
+    version = segment.GetKeyVersion(pk);
+    uint64_t gc_idx_cnt = 0;
+    uint64_t gc_record_cnt = 0;
+    uint64_t gc_record_byte_size = 0;
+    segment.Gc4TTL(9528, gc_idx_cnt, gc_record_cnt, gc_record_byte_size);
+    ASSERT_EQ(1, (int64_t)gc_idx_cnt);
+    ASSERT_EQ(version, segment.GetKeyVersion(pk));
+    segment.Put(pk, 9529, value.c_str(), value.size());
+    ASSERT_NE(version, segment.GetKeyVersion(pk));
+    version = segment.GetKeyVersion(pk);
+    ASSERT_TRUE(segment.Delete(pk));
+    ASSERT_NE(version, segment.GetKeyVersion(pk));
+    version = segment.GetKeyVersion(pk);
+    ASSERT_FALSE(segment.Delete(pk));
+    ASSERT_EQ(version, segment.GetKeyVersion(pk));
+
+    std::vector<uint32_t> ts_idx_vec = {1, 3};
+    Segment multi_ts_segment(8, ts_idx_vec, false);
+    version = multi_ts_segment.GetKeyVersion(pk);
+    std::map<int32_t, uint64_t> ts_map = {{1, 100}, {3, 200}};
+    DataBlock* row = new DataBlock(2, value.c_str(), value.size());
+    multi_ts_segment.Put(pk, ts_map, row);
+    ASSERT_NE(version, multi_ts_segment.GetKeyVersion(pk));
+}
+
 TEST_F(SegmentTest, GetCount) {
     Segment segment;
     Slice pk("test1");
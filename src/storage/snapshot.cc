@@ -30,17 +30,24 @@ namespace storage {
 
 const std::string MANIFEST = "MANIFEST";  // NOLINT
 
-int Snapshot::GenManifest(const std::string& snapshot_name, uint64_t key_count, uint64_t offset, uint64_t term) {
+int Snapshot::GenManifest(const std::string& snapshot_name, uint64_t key_count, uint64_t offset, uint64_t term,
+                          const std::string& compress_dict) {
     DEBUGLOG("record offset[%lu]. add snapshot[%s] key_count[%lu]", offset, snapshot_name.c_str(), key_count);
-    std::string full_path = snapshot_path_ + MANIFEST;
-    std::string tmp_file = snapshot_path_ + MANIFEST + ".tmp";
     ::openmldb::api::Manifest manifest;
-    std::string manifest_info;
     manifest.set_offset(offset);
     manifest.set_name(snapshot_name);
     manifest.set_count(key_count);
     manifest.set_term(term);
-    manifest_info.clear();
+    if (!compress_dict.empty()) {
+        manifest.set_compress_dict(compress_dict);
+    }
+    return GenManifest(manifest);
+}
+
+int Snapshot::GenManifest(const ::openmldb::api::Manifest& manifest) {
+    std::string full_path = snapshot_path_ + MANIFEST;
+    std::string tmp_file = snapshot_path_ + MANIFEST + ".tmp";
+    std::string manifest_info;
     google::protobuf::TextFormat::PrintToString(manifest, &manifest_info);
     FILE* fd_write = fopen(tmp_file.c_str(), "w");
     if (fd_write == NULL) {
@@ -38,7 +38,10 @@ class Snapshot {
     virtual bool Recover(std::shared_ptr<Table> table,
                          uint64_t& latest_offset) = 0;  // NOLINT
     uint64_t GetOffset() { return offset_; }
-    int GenManifest(const std::string& snapshot_name, uint64_t key_count, uint64_t offset, uint64_t term);
+    // compress_dict is the zstd dictionary of the snapshot file, it is empty if no dictionary is used
+    int GenManifest(const std::string& snapshot_name, uint64_t key_count, uint64_t offset, uint64_t term,
+                    const std::string& compress_dict = "");
+    int GenManifest(const ::openmldb::api::Manifest& manifest);
     static int GetLocalManifest(const std::string& full_path,
                                 ::openmldb::api::Manifest& manifest);  // NOLINT
 
@@ -42,6 +42,8 @@
 
 DECLARE_string(db_root_path);
 DECLARE_string(snapshot_compression);
+DECLARE_uint32(binlog_apply_thread_num);
+DECLARE_uint32(snapshot_max_delta_num);
 
 using ::openmldb::api::LogEntry;
 namespace openmldb {
@@ -1707,6 +1709,259 @@ TEST_F(SnapshotTest, Recover_large_snapshot_and_binlog) {
     delete it;
 }
 
+TEST_F(SnapshotTest, Recover_binlog_parallel) {
+    std::string binlog_dir = FLAGS_db_root_path + "/102_0/binlog/";
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, binlog_dir, binlog_index, offset);
+    uint32_t key_num = 1000;
+    uint32_t total_num = 200000;
+    for (uint32_t count = 0; count < total_num; count++) {
+        offset++;
+        std::string key = "key" + std::to_string(count % key_num);
+        auto entry = ::openmldb::test::PackKVEntry(offset, key, "value" + std::to_string(count), count + 1, 1);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+        if (count == total_num / 2) {
+            // the rows of key0 put before the delete should be deleted
+            offset++;
+            ::openmldb::api::LogEntry delete_entry;
+            delete_entry.set_log_index(offset);
+            delete_entry.set_method_type(::openmldb::api::MethodType::kDelete);
+            ::openmldb::api::Dimension* dimension = delete_entry.add_dimensions();
+            dimension->set_key("key0");
+            dimension->set_idx(0);
+            delete_entry.SerializeToString(&buffer);
+            ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+        }
+    }
+    wh->Sync();
+    uint32_t thread_num = FLAGS_binlog_apply_thread_num;
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    for (uint32_t cur_thread_num : {1, 2, 4, 8}) {
+        FLAGS_binlog_apply_thread_num = cur_thread_num;
+        std::shared_ptr<MemTable> table =
+            std::make_shared<MemTable>("test", 102, 0, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+        table->Init();
+        uint64_t latest_offset = 0;
+        uint64_t start_time = ::baidu::common::timer::get_micros();
+        Binlog binlog(log_part, binlog_dir);
+        ASSERT_TRUE(binlog.RecoverFromBinlog(table, 0, latest_offset));
+        uint64_t end_time = ::baidu::common::timer::get_micros();
+        std::cout << "recover " << total_num << " entries with " << cur_thread_num
+                  << " threads, use time in us: " << end_time - start_time << std::endl;
+        ASSERT_EQ(offset, latest_offset);
+        auto count_key = [&table](const std::string& key) {
+            Ticket ticket;
+            TableIterator* it = table->NewIterator(key, ticket);
+            it->SeekToFirst();
+            uint32_t cnt = 0;
+            while (it->Valid()) {
+                cnt++;
+                it->Next();
+            }
+            delete it;
+            return cnt;
+        };
+        ASSERT_EQ(total_num / key_num, count_key("key1"));
+        // key0 of count 0, 1000, ..., total_num / 2 are deleted
+        ASSERT_EQ(total_num / key_num - (total_num / 2 / key_num + 1), count_key("key0"));
+    }
+    FLAGS_binlog_apply_thread_num = thread_num;
+    delete wh;
+    RemoveData(FLAGS_db_root_path);
+}
+
+TEST_F(SnapshotTest, Recover_binlog_parallel_multi_index) {
+    std::string binlog_dir = FLAGS_db_root_path + "/103_0/binlog/";
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, binlog_dir, binlog_index, offset);
+    uint32_t key_num = 100;
+    uint32_t group_num = 7;
+    uint32_t total_num = 20000;
+    for (uint32_t count = 0; count < total_num; count++) {
+        offset++;
+        std::string key = "key" + std::to_string(count % key_num);
+        auto entry = ::openmldb::test::PackKVEntry(offset, key, "value" + std::to_string(count), count + 1, 1);
+        // the second index shares its keys across the partitions of the first one
+        ::openmldb::test::AddDimension(1, "group" + std::to_string(count % group_num), &entry);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+    }
+    wh->Sync();
+    uint32_t thread_num = FLAGS_binlog_apply_thread_num;
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    mapping.insert(std::make_pair("idx1", 1));
+    for (uint32_t cur_thread_num : {1, 4}) {
+        FLAGS_binlog_apply_thread_num = cur_thread_num;
+        std::shared_ptr<MemTable> table =
+            std::make_shared<MemTable>("test", 103, 0, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+        table->Init();
+        uint64_t latest_offset = 0;
+        Binlog binlog(log_part, binlog_dir);
+        ASSERT_TRUE(binlog.RecoverFromBinlog(table, 0, latest_offset));
+        ASSERT_EQ(offset, latest_offset);
+        ASSERT_EQ(total_num, table->GetRecordCnt());
+        auto count_key = [&table](uint32_t idx, const std::string& key) {
+            Ticket ticket;
+            TableIterator* it = table->NewIterator(idx, key, ticket);
+            it->SeekToFirst();
+            uint32_t cnt = 0;
+            while (it->Valid()) {
+                cnt++;
+                it->Next();
+            }
+            delete it;
+            return cnt;
+        };
+        ASSERT_EQ(total_num / key_num, count_key(0, "key1"));
+        ASSERT_EQ((total_num + group_num - 2) / group_num, count_key(1, "group1"));
+    }
+    FLAGS_binlog_apply_thread_num = thread_num;
+    delete wh;
+    RemoveData(FLAGS_db_root_path);
+}
+
+TEST_F(SnapshotTest, MakeDeltaSnapshot) {
+    uint32_t max_delta_num = FLAGS_snapshot_max_delta_num;
+    FLAGS_snapshot_max_delta_num = 2;
+    std::string binlog_dir = FLAGS_db_root_path + "/103_0/binlog/";
+    std::string snapshot_path = FLAGS_db_root_path + "/103_0/snapshot/";
+    LogParts* log_part = new LogParts(12, 4, scmp);
+    MemTableSnapshot snapshot(103, 0, log_part, FLAGS_db_root_path);
+    snapshot.Init();
+    std::map<std::string, uint32_t> mapping;
+    mapping.insert(std::make_pair("idx0", 0));
+    auto new_table = [&mapping]() {
+        std::shared_ptr<MemTable> table =
+            std::make_shared<MemTable>("test", 103, 0, 8, mapping, 0, ::openmldb::type::TTLType::kAbsoluteTime);
+        table->Init();
+        return table;
+    };
+    std::shared_ptr<MemTable> table = new_table();
+    uint64_t offset = 0;
+    uint32_t binlog_index = 0;
+    WriteHandle* wh = NULL;
+    RollWLogFile(&wh, log_part, binlog_dir, binlog_index, offset);
+    auto put = [&wh, &offset](const std::string& key) {
+        offset++;
+        auto entry = ::openmldb::test::PackKVEntry(offset, key, "value", offset, 1);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+    };
+    auto get_manifest = [&snapshot_path]() {
+        ::openmldb::api::Manifest manifest;
+        MemTableSnapshot::GetLocalManifest(snapshot_path + "MANIFEST", manifest);
+        return manifest;
+    };
+    auto count_key = [](std::shared_ptr<MemTable> table, const std::string& key) {
+        Ticket ticket;
+        TableIterator* it = table->NewIterator(key, ticket);
+        it->SeekToFirst();
+        uint32_t cnt = 0;
+        while (it->Valid()) {
+            cnt++;
+            it->Next();
+        }
+        delete it;
+        return cnt;
+    };
+    for (int i = 0; i < 100; i++) {
+        put("key" + std::to_string(i % 10));
+    }
+    wh->Sync();
+    uint64_t offset_value = 0;
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    auto manifest = get_manifest();
+    ASSERT_EQ(100u, manifest.count());
+    ASSERT_EQ(0, manifest.deltas_size());
+
+    for (int i = 0; i < 10; i++) {
+        put("key1");
+    }
+    {
+        offset++;
+        ::openmldb::api::LogEntry entry;
+        entry.set_log_index(offset);
+        entry.set_method_type(::openmldb::api::MethodType::kDelete);
+        ::openmldb::api::Dimension* dimension = entry.add_dimensions();
+        dimension->set_key("key0");
+        dimension->set_idx(0);
+        std::string buffer;
+        entry.SerializeToString(&buffer);
+        ASSERT_TRUE(wh->Write(::openmldb::base::Slice(buffer)).ok());
+    }
+    for (int i = 0; i < 5; i++) {
+        put("key0");
+    }
+    wh->Sync();
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    manifest = get_manifest();
+    ASSERT_EQ(1, manifest.deltas_size());
+    ASSERT_EQ(100u, manifest.count());
+    ASSERT_EQ(offset, manifest.offset());
+    ASSERT_EQ(100u, manifest.deltas(0).start_offset());
+    ASSERT_EQ(offset, manifest.deltas(0).end_offset());
+    // 15 puts and 1 delete
+    ASSERT_EQ(16u, manifest.deltas(0).count());
+    {
+        // recover stacks the base and the delta
+        std::shared_ptr<MemTable> recover_table = new_table();
+        MemTableSnapshot recover_snapshot(103, 0, log_part, FLAGS_db_root_path);
+        recover_snapshot.Init();
+        uint64_t latest_offset = 0;
+        ASSERT_TRUE(recover_snapshot.Recover(recover_table, latest_offset));
+        ASSERT_EQ(offset, latest_offset);
+        ASSERT_EQ(5u, count_key(recover_table, "key0"));
+        ASSERT_EQ(20u, count_key(recover_table, "key1"));
+        ASSERT_EQ(10u, count_key(recover_table, "key2"));
+    }
+
+    for (int i = 0; i < 4; i++) {
+        put("key2");
+    }
+    wh->Sync();
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    manifest = get_manifest();
+    ASSERT_EQ(2, manifest.deltas_size());
+
+    // reach snapshot_max_delta_num, the deltas are merged into a new base
+    put("key3");
+    wh->Sync();
+    ASSERT_EQ(0, snapshot.MakeSnapshot(table, offset_value, 0));
+    manifest = get_manifest();
+    ASSERT_EQ(0, manifest.deltas_size());
+    ASSERT_EQ(offset, manifest.offset());
+    ASSERT_EQ(110u, manifest.count());
+    std::vector<std::string> vec;
+    ASSERT_EQ(0, ::openmldb::base::GetFileName(snapshot_path, vec));
+    ASSERT_EQ(2, (int32_t)vec.size());
+    {
+        std::shared_ptr<MemTable> recover_table = new_table();
+        MemTableSnapshot recover_snapshot(103, 0, log_part, FLAGS_db_root_path);
+        recover_snapshot.Init();
+        uint64_t latest_offset = 0;
+        ASSERT_TRUE(recover_snapshot.Recover(recover_table, latest_offset));
+        ASSERT_EQ(offset, latest_offset);
+        ASSERT_EQ(5u, count_key(recover_table, "key0"));
+        ASSERT_EQ(14u, count_key(recover_table, "key2"));
+        ASSERT_EQ(11u, count_key(recover_table, "key3"));
+    }
+    FLAGS_snapshot_max_delta_num = max_delta_num;
+    delete wh;
+    RemoveData(FLAGS_db_root_path);
+}
+
 }  // namespace storage
 }  // namespace openmldb
 
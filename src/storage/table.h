@@ -173,6 +173,13 @@ class Table {
     virtual uint64_t GetRecordIdxCnt() = 0;
     virtual bool GetRecordIdxCnt(uint32_t idx, uint64_t** stat, uint32_t* size) = 0;
     virtual uint64_t GetRecordPkCnt() = 0;
+    // statistics of the index `idx`: count of keys and count of rows kept in the index, the expired
+    // rows not gc'd yet are counted.
+    // return false if the table does not keep statistics
+    virtual bool GetIndexStat(uint32_t idx, uint64_t* pk_cnt, uint64_t* idx_cnt) { return false; }
+    // version of `key` in the index `idx`, it changes after every write of the key.
+    // return false if the table does not keep versions
+    virtual bool GetKeyVersion(uint32_t idx, const std::string& key, uint64_t* version) { return false; }
     virtual uint64_t GetRecordByteSize() const = 0;
     virtual uint64_t GetRecordIdxByteSize() = 0;
 
@@ -454,6 +454,79 @@ TEST_P(TableIteratorTest, SeekNonExistent) {
     ASSERT_EQ(0, now - wit->GetKey());
 }
 
+TEST_P(TableIteratorTest, get_batch) {
+    ::openmldb::common::StorageMode storageMode = GetParam();
+
+    std::string table_path = "";
+    int id = 1;
+    if (storageMode == ::openmldb::common::kHDD) {
+        id = ++counter;
+        table_path = GetDBPath(FLAGS_hdd_root_path, id, 1);
+    }
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("table1");
+    table_meta.set_tid(id);
+    table_meta.set_pid(1);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    table_meta.set_format_version(1);
+    table_meta.set_storage_mode(storageMode);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts",
+            ::openmldb::type::kLatestTime, 0, 90);
+
+    Table* table = CreateTable(table_meta, table_path);
+    table->Init();
+    codec::SDKCodec codec(table_meta);
+    uint64_t now = ::baidu::common::timer::get_micros() / 1000;
+    for (int j = 0; j < 100; j++) {
+        std::vector<std::string> row = {"card0", std::to_string(now - j)};
+        ::openmldb::api::PutRequest request;
+        ::openmldb::api::Dimension* dim = request.add_dimensions();
+        dim->set_idx(0);
+        dim->set_key("card0");
+        std::string value;
+        ASSERT_EQ(0, codec.EncodeRow(row, &value));
+        table->Put(0, value, request.dimensions());
+    }
+    ::hybridse::vm::WindowIterator* it = table->NewWindowIterator(0);
+    it->SeekToFirst();
+    ASSERT_TRUE(it->Valid());
+    std::unique_ptr<::hybridse::vm::RowIterator> wit = it->GetValue();
+    wit->SeekToFirst();
+    // the rows out of the latest ttl are not returned
+    std::vector<uint64_t> keys(64);
+    std::vector<::hybridse::codec::Row> rows(64);
+    uint64_t expect_key = now;
+    size_t total = 0;
+    size_t cnt = 0;
+    while ((cnt = wit->GetBatch(keys.size(), keys.data(), rows.data())) > 0) {
+        for (size_t i = 0; i < cnt; i++) {
+            ASSERT_EQ(expect_key, keys[i]);
+            std::vector<std::string> row;
+            ASSERT_EQ(0, codec.DecodeRow(std::string(reinterpret_cast<const char*>(rows[i].buf()), rows[i].size()),
+                                         &row));
+            ASSERT_EQ(std::to_string(expect_key), row[1]);
+            expect_key--;
+        }
+        total += cnt;
+    }
+    ASSERT_EQ(90u, total);
+    ASSERT_FALSE(wit->Valid());
+
+    // mixing GetBatch with Next
+    wit->Seek(now - 10);
+    ASSERT_TRUE(wit->Valid());
+    ASSERT_EQ(now - 10, wit->GetKey());
+    ASSERT_EQ(5u, wit->GetBatch(5, keys.data(), rows.data()));
+    ASSERT_EQ(now - 14, keys[4]);
+    ASSERT_TRUE(wit->Valid());
+    ASSERT_EQ(now - 15, wit->GetKey());
+    wit->Next();
+    ASSERT_EQ(now - 16, wit->GetKey());
+    delete it;
+}
+
 INSTANTIATE_TEST_CASE_P(TestMemAndHDD, TableIteratorTest,
                         ::testing::Values(::openmldb::common::kMemory, ::openmldb::common::kHDD));
 
@@ -16,6 +16,7 @@
 
 #include "storage/window_iterator.h"
 
+#include <algorithm>
 #include <string>
 #include "base/hash.h"
 
@@ -29,29 +30,61 @@ MemTableWindowIterator::~MemTableWindowIterator() {
 }
 
 bool MemTableWindowIterator::Valid() const {
-    if (!it_->Valid() || expire_value_.IsExpired(it_->GetKey(), record_idx_)) {
+    if (batch_pos_ >= batch_cnt_ || expire_value_.IsExpired(batch_[batch_pos_].first, record_idx_)) {
         return false;
     }
     return true;
 }
 
 void MemTableWindowIterator::Next() {
-    it_->Next();
     record_idx_++;
+    if (++batch_pos_ >= batch_cnt_) {
+        Fill();
+    }
+}
+
+void MemTableWindowIterator::Fill() {
+    batch_pos_ = 0;
+    batch_cnt_ = 0;
+    while (batch_cnt_ < batch_size_ && it_->Valid()) {
+        DataBlock* block = it_->GetValue();
+        __builtin_prefetch(block);
+        batch_[batch_cnt_++] = {it_->GetKey(), block};
+        it_->Next();
+    }
+    for (uint32_t i = 0; i < batch_cnt_; i++) {
+        __builtin_prefetch(batch_[i].second->data);
+    }
+    batch_size_ = std::min(batch_size_ * 2, MAX_BATCH_SIZE);
 }
 
 const uint64_t& MemTableWindowIterator::GetKey() const {
-    return it_->GetKey();
+    return batch_[batch_pos_].first;
 }
 
 const ::hybridse::codec::Row& MemTableWindowIterator::GetValue() {
-    row_.Reset(reinterpret_cast<const int8_t*>(it_->GetValue()->data), it_->GetValue()->size);
+    const DataBlock* block = batch_[batch_pos_].second;
+    row_.Reset(reinterpret_cast<const int8_t*>(block->data), block->size);
     return row_;
 }
 
+size_t MemTableWindowIterator::GetBatch(size_t n, uint64_t* keys, ::hybridse::codec::Row* values) {
+    size_t cnt = 0;
+    while (cnt < n && Valid()) {
+        const auto& entry = batch_[batch_pos_];
+        keys[cnt] = entry.first;
+        values[cnt].Reset(reinterpret_cast<const int8_t*>(entry.second->data), entry.second->size);
+        cnt++;
+        Next();
+    }
+    return cnt;
+}
+
 void MemTableWindowIterator::Seek(const uint64_t& key) {
     if (expire_value_.ttl_type == TTLType::kAbsoluteTime) {
         it_->Seek(key);
+        batch_size_ = MIN_BATCH_SIZE;
+        Fill();
     } else {
         SeekToFirst();
         while (Valid() && GetKey() > key) {
@@ -63,6 +96,8 @@ void MemTableWindowIterator::Seek(const uint64_t& key) {
 void MemTableWindowIterator::SeekToFirst() {
     record_idx_ = 1;
     it_->SeekToFirst();
+    batch_size_ = MIN_BATCH_SIZE;
+    Fill();
 }
 
 MemTableKeyIterator::MemTableKeyIterator(Segment** segments, uint32_t seg_cnt, ::openmldb::storage::TTLType ttl_type,
@@ -16,8 +16,10 @@
 #ifndef SRC_STORAGE_WINDOW_ITERATOR_H_
 #define SRC_STORAGE_WINDOW_ITERATOR_H_
 
+#include <array>
 #include <memory>
 #include <string>
+#include <utility>
 #include "storage/segment.h"
 #include "vm/catalog.h"
 
@@ -28,7 +30,16 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
  public:
     MemTableWindowIterator(TimeEntries::Iterator* it, ::openmldb::storage::TTLType ttl_type, uint64_t expire_time,
                            uint64_t expire_cnt)
-        : it_(it), record_idx_(1), expire_value_(expire_time, expire_cnt, ttl_type), row_() {}
+        : it_(it),
+          record_idx_(1),
+          expire_value_(expire_time, expire_cnt, ttl_type),
+          row_(),
+          batch_(),
+          batch_pos_(0),
+          batch_cnt_(0),
+          batch_size_(MIN_BATCH_SIZE) {
+        Fill();
+    }
 
     ~MemTableWindowIterator();
 
@@ -46,11 +57,26 @@ class MemTableWindowIterator : public ::hybridse::vm::RowIterator {
 
     bool IsSeekable() const override { return true; }
 
+    size_t GetBatch(size_t n, uint64_t* keys, ::hybridse::codec::Row* values) override;
+
  private:
+    // read the next entries ahead and prefetch their data blocks, so the cache
+    // misses of the following rows overlap instead of being chained. The batch
+    // grows from MIN_BATCH_SIZE, short scans do not read too much ahead
+    void Fill();
+
+    static constexpr uint32_t MIN_BATCH_SIZE = 4;
+    static constexpr uint32_t MAX_BATCH_SIZE = 32;
+
+    // it_ is ahead of the current position by the entries left in the batch
     TimeEntries::Iterator* it_;
     uint32_t record_idx_;
     TTLSt expire_value_;
     ::hybridse::codec::Row row_;
+    std::array<std::pair<uint64_t, DataBlock*>, MAX_BATCH_SIZE> batch_;
+    uint32_t batch_pos_;
+    uint32_t batch_cnt_;
+    uint32_t batch_size_;
 };
 
 class MemTableKeyIterator : public ::hybridse::vm::WindowIterator {
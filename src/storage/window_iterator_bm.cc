@@ -0,0 +1,115 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "codec/schema_codec.h"
+#include "codec/sdk_codec.h"
+#include "storage/mem_table.h"
+
+namespace openmldb {
+namespace storage {
+
+// window scan over `state.range(0)` rows of one key, reported as ns per row
+static std::shared_ptr<MemTable> BuildWindowTable(int64_t row_cnt) {
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_name("bm_table");
+    table_meta.set_tid(1);
+    table_meta.set_pid(1);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+    table_meta.set_format_version(1);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "card", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "mcc", ::openmldb::type::kString);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "amt", ::openmldb::type::kDouble);
+    codec::SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "ts", ::openmldb::type::kBigInt);
+    codec::SchemaCodec::SetIndex(table_meta.add_column_key(), "card", "card", "ts", ::openmldb::type::kAbsoluteTime,
+                                 0, 0);
+    auto table = std::make_shared<MemTable>(table_meta);
+    table->Init();
+    codec::SDKCodec codec(table_meta);
+    // interleave the keys, so the rows of one window are not adjacent in memory
+    for (int64_t i = 0; i < row_cnt; i++) {
+        for (int k = 0; k < 4; k++) {
+            std::string key = "card" + std::to_string(k);
+            std::vector<std::string> row = {key, "mcc" + std::to_string(i % 100), std::to_string(i * 1.5),
+                                            std::to_string(1000 + i)};
+            ::openmldb::api::PutRequest request;
+            ::openmldb::api::Dimension* dim = request.add_dimensions();
+            dim->set_idx(0);
+            dim->set_key(key);
+            std::string value;
+            codec.EncodeRow(row, &value);
+            table->Put(0, value, request.dimensions());
+        }
+    }
+    return table;
+}
+
+// the inverted rate is seconds per row, the row count is scaled so that it's in nanoseconds
+static void SetNsPerRow(benchmark::State& state) {  // NOLINT
+    state.counters["ns_per_row"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * state.range(0)) * 1e-9,
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+static void BM_WindowScan(benchmark::State& state) {  // NOLINT
+    auto table = BuildWindowTable(state.range(0));
+    std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(0));
+    it->Seek("card0");
+    for (auto _ : state) {
+        auto wit = it->GetValue();
+        wit->SeekToFirst();
+        int64_t sum = 0;
+        while (wit->Valid()) {
+            sum += wit->GetValue().size();
+            wit->Next();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    SetNsPerRow(state);
+}
+
+static void BM_WindowScanGetBatch(benchmark::State& state) {  // NOLINT
+    auto table = BuildWindowTable(state.range(0));
+    std::unique_ptr<::hybridse::vm::WindowIterator> it(table->NewWindowIterator(0));
+    it->Seek("card0");
+    std::vector<uint64_t> keys(64);
+    std::vector<::hybridse::codec::Row> rows(64);
+    for (auto _ : state) {
+        auto wit = it->GetValue();
+        wit->SeekToFirst();
+        int64_t sum = 0;
+        size_t cnt = 0;
+        while ((cnt = wit->GetBatch(keys.size(), keys.data(), rows.data())) > 0) {
+            for (size_t i = 0; i < cnt; i++) {
+                sum += rows[i].size();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    SetNsPerRow(state);
+}
+
+BENCHMARK(BM_WindowScan)->Args({100})->Args({1000})->Args({10000});
+BENCHMARK(BM_WindowScanGetBatch)->Args({100})->Args({1000})->Args({10000});
+
+}  // namespace storage
+}  // namespace openmldb
+
+BENCHMARK_MAIN();
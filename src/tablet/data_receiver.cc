@@ -96,9 +96,10 @@ bool DataReceiver::WriteBinlogToReplicator(const std::shared_ptr<replica::LogRep
             << next_part_id_ - 1 << ", request part id " << request->part_id();
         return false;
     }
+    std::vector<::openmldb::api::LogEntry> entries(request->binlog_info_size());
     for (int i = 0; i < request->binlog_info_size(); ++i) {
         const auto& info = request->binlog_info(i);
-        ::openmldb::api::LogEntry entry;
+        auto& entry = entries[i];
         auto* block = info.block_id() < data_blocks_.size() ? data_blocks_[info.block_id()] : nullptr;
         if (block == nullptr) {
             LOG(ERROR) << "binlog wants " << info.block_id() << ", but cached block size = " << data_blocks_.size();
@@ -113,7 +114,11 @@ bool DataReceiver::WriteBinlogToReplicator(const std::shared_ptr<replica::LogRep
             entry.mutable_ts_dimensions()->CopyFrom(info.ts_dimensions());
         }
         entry.set_ts(info.time());
-        replicator->AppendEntry(entry);
+    }
+    // append the whole part under one lock of the replicator
+    if (!replicator->AppendEntries(&entries)) {
+        LOG(WARNING) << tid_ << "-" << pid_ << " append binlog failed";
+        return false;
     }
     LOG(INFO) << "binlog write num " << request->binlog_info_size();
     return true;
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/deploy_result_cache.h"
+
+#include <set>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "base/glog_wrapper.h"
+#include "codec/fe_row_codec.h"
+#include "common/timer.h"
+#include "vm/physical_op.h"
+
+namespace openmldb::tablet {
+
+using ::hybridse::vm::PhysicalDataProviderNode;
+using ::hybridse::vm::PhysicalOpNode;
+using ::hybridse::vm::PhysicalPartitionProviderNode;
+using ::hybridse::vm::PhysicalRequestJoinNode;
+using ::hybridse::vm::PhysicalRequestUnionNode;
+
+// the index keys of a deployment, all taken from the request row
+struct KeyDependency {
+    std::shared_ptr<catalog::TabletTableHandler> table;
+    std::string index_name;
+    // positions of the key columns in the request row
+    std::vector<uint32_t> cols;
+};
+
+struct DeployResultCache::Deployment {
+    Deployment(uint64_t id, const std::string& name, uint64_t ttl_ms, const hybridse::codec::Schema& request_schema)
+        : id(id), name(name), ttl_ms(ttl_ms), row_view(request_schema), deps() {}
+
+    const uint64_t id;
+    const std::string name;
+    const uint64_t ttl_ms;
+    // only the const methods taking the row are used, so it can be shared by requests
+    const hybridse::codec::RowView row_view;
+    std::vector<KeyDependency> deps;
+};
+
+namespace {
+
+// trace the column `column_id` of `node` back to the request row
+bool TraceRequestColumn(const PhysicalOpNode* node, size_t column_id, uint32_t* col_idx) {
+    while (node != nullptr) {
+        size_t schema_idx = 0;
+        size_t idx = 0;
+        if (!node->schemas_ctx()->ResolveColumnIndexByID(column_id, &schema_idx, &idx).isOK()) {
+            return false;
+        }
+        if (node->GetOpType() == hybridse::vm::kPhysicalOpDataProvider) {
+            auto provider = dynamic_cast<const PhysicalDataProviderNode*>(node);
+            if (provider == nullptr || provider->provider_type_ != hybridse::vm::kProviderTypeRequest) {
+                return false;
+            }
+            *col_idx = idx;
+            return true;
+        }
+        auto source = node->schemas_ctx()->GetSchemaSource(schema_idx);
+        if (!source->IsSourceColumn(idx)) {
+            return false;
+        }
+        size_t child_idx = static_cast<size_t>(source->GetSourceChildIdx(idx));
+        if (child_idx >= node->GetProducerCnt()) {
+            return false;
+        }
+        column_id = source->GetSourceColumnID(idx);
+        node = node->GetProducer(child_idx);
+    }
+    return false;
+}
+
+// the partition provider under `node`, skipping the unary nodes like filter and simple project
+const PhysicalPartitionProviderNode* FindPartitionProvider(const PhysicalOpNode* node) {
+    while (node != nullptr && node->GetOpType() != hybridse::vm::kPhysicalOpDataProvider) {
+        if (node->GetProducerCnt() != 1) {
+            return nullptr;
+        }
+        node = node->GetProducer(0);
+    }
+    if (node == nullptr) {
+        return nullptr;
+    }
+    auto provider = dynamic_cast<const PhysicalDataProviderNode*>(node);
+    if (provider == nullptr || provider->provider_type_ != hybridse::vm::kProviderTypePartition) {
+        return nullptr;
+    }
+    return dynamic_cast<const PhysicalPartitionProviderNode*>(node);
+}
+
+class DependencyCollector {
+ public:
+    bool Collect(const PhysicalOpNode* node) {
+        if (node == nullptr) {
+            return false;
+        }
+        if (!visited_.insert(node).second) {
+            return true;
+        }
+        switch (node->GetOpType()) {
+            case hybridse::vm::kPhysicalOpRequestAggUnion: {
+                // long windows read the pre-aggregated tables, whose writes are not tracked
+                return false;
+            }
+            case hybridse::vm::kPhysicalOpDataProvider: {
+                auto provider = dynamic_cast<const PhysicalDataProviderNode*>(node);
+                if (provider->provider_type_ == hybridse::vm::kProviderTypeTable) {
+                    return false;
+                }
+                if (provider->provider_type_ == hybridse::vm::kProviderTypePartition) {
+                    partitions_.insert(node);
+                }
+                break;
+            }
+            case hybridse::vm::kPhysicalOpRequestUnion: {
+                auto union_op = dynamic_cast<const PhysicalRequestUnionNode*>(node);
+                if (!AddKey(node->GetProducer(0), union_op->window().index_key(), node->GetProducer(1))) {
+                    return false;
+                }
+                for (const auto& window_union : union_op->window_unions_.window_unions_) {
+                    if (!AddKey(node->GetProducer(0), window_union.second.index_key(), window_union.first) ||
+                        !Collect(window_union.first)) {
+                        return false;
+                    }
+                }
+                break;
+            }
+            case hybridse::vm::kPhysicalOpRequestJoin: {
+                auto join_op = dynamic_cast<const PhysicalRequestJoinNode*>(node);
+                if (join_op->join().join_type() == hybridse::node::kJoinTypeConcat) {
+                    // the windows of a multi-window deployment are concatenated, both sides are
+                    // read by the request row and collected below
+                    break;
+                }
+                if (!AddKey(node->GetProducer(0), join_op->join().index_key(), node->GetProducer(1))) {
+                    return false;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        for (auto producer : node->GetProducers()) {
+            if (!Collect(producer)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // every partition read must be looked up by the request row
+    bool AllPartitionsKeyed() const {
+        for (auto partition : partitions_) {
+            if (keyed_.find(partition) == keyed_.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<KeyDependency>& deps() { return deps_; }
+
+ private:
+    bool AddKey(const PhysicalOpNode* key_node, const hybridse::vm::Key& key, const PhysicalOpNode* right) {
+        auto partition = FindPartitionProvider(right);
+        if (partition == nullptr || !key.ValidKey()) {
+            return false;
+        }
+        auto table = std::dynamic_pointer_cast<catalog::TabletTableHandler>(partition->table_handler_);
+        if (!table) {
+            return false;
+        }
+        KeyDependency dep;
+        dep.table = table;
+        dep.index_name = partition->index_name_;
+        for (uint32_t i = 0; i < key.keys()->GetChildNum(); i++) {
+            size_t column_id = 0;
+            uint32_t col_idx = 0;
+            if (!key_node->schemas_ctx()->ResolveColumnID(key.keys()->GetChild(i), &column_id).isOK() ||
+                !TraceRequestColumn(key_node, column_id, &col_idx)) {
+                return false;
+            }
+            dep.cols.push_back(col_idx);
+        }
+        keyed_.insert(partition);
+        for (const auto& cur : deps_) {
+            if (cur.table == dep.table && cur.index_name == dep.index_name && cur.cols == dep.cols) {
+                return true;
+            }
+        }
+        deps_.push_back(std::move(dep));
+        return true;
+    }
+
+    std::set<const PhysicalOpNode*> visited_;
+    std::set<const PhysicalOpNode*> partitions_;
+    std::set<const PhysicalOpNode*> keyed_;
+    std::vector<KeyDependency> deps_;
+};
+
+// build the key in the same format as the index keys of the request plan
+void AppendKey(const hybridse::codec::RowView& row_view, const int8_t* row, uint32_t pos, std::string* key) {
+    if (row_view.IsNULL(row, pos)) {
+        key->append(hybridse::codec::NONETOKEN);
+        return;
+    }
+    auto type = row_view.GetSchema()->Get(pos).type();
+    switch (type) {
+        case hybridse::type::kVarchar: {
+            const char* buf = nullptr;
+            uint32_t size = 0;
+            if (row_view.GetValue(row, pos, &buf, &size) == 0) {
+                if (size == 0) {
+                    key->append(hybridse::codec::EMPTY_STRING);
+                } else {
+                    key->append(buf, size);
+                }
+            }
+            break;
+        }
+        case hybridse::type::kBool: {
+            bool val = false;
+            if (row_view.GetValue(row, pos, type, &val) == 0) {
+                key->append(val ? "true" : "false");
+            }
+            break;
+        }
+        case hybridse::type::kInt16: {
+            int16_t val = 0;
+            if (row_view.GetValue(row, pos, type, &val) == 0) {
+                key->append(std::to_string(val));
+            }
+            break;
+        }
+        case hybridse::type::kInt32:
+        case hybridse::type::kDate: {
+            int32_t val = 0;
+            if (row_view.GetValue(row, pos, type, &val) == 0) {
+                key->append(std::to_string(val));
+            }
+            break;
+        }
+        case hybridse::type::kInt64:
+        case hybridse::type::kTimestamp: {
+            int64_t val = 0;
+            if (row_view.GetValue(row, pos, type, &val) == 0) {
+                key->append(std::to_string(val));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+double GetHitRatio(void* arg) {
+    auto stats = static_cast<DeployResultCache*>(arg)->GetStats();
+    uint64_t total = stats.hit_cnt + stats.miss_cnt;
+    return total == 0 ? 0 : static_cast<double>(stats.hit_cnt) / total;
+}
+
+}  // namespace
+
+DeployResultCache::DeployResultCache(uint64_t max_bytes)
+    : max_bytes_(max_bytes),
+      mu_(),
+      deployments_(),
+      lru_(),
+      entries_(),
+      byte_size_(0),
+      next_deployment_id_(0),
+      hit_cnt_("deploy_result_cache_hit_count"),
+      miss_cnt_("deploy_result_cache_miss_count"),
+      invalidate_cnt_("deploy_result_cache_invalidate_count"),
+      evict_cnt_("deploy_result_cache_evict_count"),
+      hit_ratio_("deploy_result_cache_hit_ratio", GetHitRatio, this) {}
+
+bool DeployResultCache::Register(const std::string& db, const std::string& sp_name, uint64_t ttl_ms,
+                                 const std::shared_ptr<hybridse::vm::CompileInfo>& compile_info) {
+    Unregister(db, sp_name);
+    if (max_bytes_ == 0 || ttl_ms == 0 || !compile_info) {
+        return false;
+    }
+    DependencyCollector collector;
+    if (!collector.Collect(compile_info->GetPhysicalPlan()) || !collector.AllPartitionsKeyed()) {
+        LOG(INFO) << "results of deployment " << db << "." << sp_name << " can not be cached";
+        return false;
+    }
+    std::string name = absl::StrCat(db, ".", sp_name);
+    std::lock_guard<std::mutex> lock(mu_);
+    auto deployment =
+        std::make_shared<Deployment>(next_deployment_id_++, name, ttl_ms, compile_info->GetRequestSchema());
+    deployment->deps = std::move(collector.deps());
+    LOG(INFO) << "cache results of deployment " << name << " for " << ttl_ms << "ms, key dependencies "
+              << deployment->deps.size();
+    deployments_[name] = deployment;
+    return true;
+}
+
+void DeployResultCache::Unregister(const std::string& db, const std::string& sp_name) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto iter = deployments_.find(absl::StrCat(db, ".", sp_name));
+    if (iter == deployments_.end()) {
+        return;
+    }
+    EraseDeploymentUnlock(iter->second);
+    deployments_.erase(iter);
+}
+
+bool DeployResultCache::Prepare(const std::string& db, const std::string& sp_name,
+                                const hybridse::codec::Row& request_row, Lookup* lookup) const {
+    if (lookup == nullptr || request_row.GetRowPtrCnt() != 1 || request_row.size() <= 0) {
+        return false;
+    }
+    std::shared_ptr<const Deployment> deployment;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (deployments_.empty()) {
+            return false;
+        }
+        auto iter = deployments_.find(absl::StrCat(db, ".", sp_name));
+        if (iter == deployments_.end()) {
+            return false;
+        }
+        deployment = iter->second;
+    }
+    const int8_t* row = request_row.buf();
+    lookup->versions.clear();
+    for (const auto& dep : deployment->deps) {
+        std::string key;
+        for (uint32_t i = 0; i < dep.cols.size(); i++) {
+            if (i > 0) {
+                key.append("|");
+            }
+            AppendKey(deployment->row_view, row, dep.cols[i], &key);
+        }
+        uint64_t version = 0;
+        if (!dep.table->GetKeyVersion(dep.index_name, key, &version)) {
+            return false;
+        }
+        lookup->versions.push_back(version);
+    }
+    lookup->key.clear();
+    lookup->key.append(reinterpret_cast<const char*>(&deployment->id), sizeof(deployment->id));
+    lookup->key.append(reinterpret_cast<const char*>(row), request_row.size());
+    lookup->deployment = std::move(deployment);
+    return true;
+}
+
+bool DeployResultCache::Get(const Lookup& lookup, butil::IOBuf* buf, uint32_t* byte_size) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto iter = entries_.find(lookup.key);
+    if (iter == entries_.end()) {
+        miss_cnt_ << 1;
+        return false;
+    }
+    auto entry = iter->second;
+    if (entry->versions != lookup.versions || entry->expire_time < ::baidu::common::timer::get_micros() / 1000) {
+        EraseUnlock(entry);
+        invalidate_cnt_ << 1;
+        miss_cnt_ << 1;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, entry);
+    buf->append(entry->buf);
+    *byte_size = entry->byte_size;
+    hit_cnt_ << 1;
+    return true;
+}
+
+void DeployResultCache::Put(const Lookup& lookup, const butil::IOBuf& buf, uint32_t byte_size) {
+    if (!lookup.deployment) {
+        return;
+    }
+    uint64_t mem_size = sizeof(Entry) + lookup.key.size() * 2 + lookup.versions.size() * sizeof(uint64_t) + buf.size();
+    if (mem_size > max_bytes_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    auto deploy_iter = deployments_.find(lookup.deployment->name);
+    if (deploy_iter == deployments_.end() || deploy_iter->second != lookup.deployment) {
+        // the deployment has been dropped or replaced while the request runs
+        return;
+    }
+    auto iter = entries_.find(lookup.key);
+    if (iter != entries_.end()) {
+        EraseUnlock(iter->second);
+    }
+    lru_.push_front(Entry{lookup.key, lookup.deployment, lookup.versions, buf, byte_size,
+                          ::baidu::common::timer::get_micros() / 1000 + lookup.deployment->ttl_ms, mem_size});
+    entries_.emplace(lookup.key, lru_.begin());
+    byte_size_ += mem_size;
+    while (byte_size_ > max_bytes_ && !lru_.empty()) {
+        EraseUnlock(std::prev(lru_.end()));
+        evict_cnt_ << 1;
+    }
+}
+
+DeployResultCache::Stats DeployResultCache::GetStats() const {
+    Stats stats;
+    stats.hit_cnt = hit_cnt_.get_value();
+    stats.miss_cnt = miss_cnt_.get_value();
+    stats.invalidate_cnt = invalidate_cnt_.get_value();
+    stats.evict_cnt = evict_cnt_.get_value();
+    std::lock_guard<std::mutex> lock(mu_);
+    stats.entry_cnt = lru_.size();
+    stats.byte_size = byte_size_;
+    return stats;
+}
+
+void DeployResultCache::EraseUnlock(EntryList::iterator iter) {
+    byte_size_ -= iter->mem_size;
+    entries_.erase(iter->key);
+    lru_.erase(iter);
+}
+
+void DeployResultCache::EraseDeploymentUnlock(const std::shared_ptr<const Deployment>& deployment) {
+    for (auto iter = lru_.begin(); iter != lru_.end();) {
+        auto cur = iter++;
+        if (cur->deployment == deployment) {
+            EraseUnlock(cur);
+        }
+    }
+}
+
+}  // namespace openmldb::tablet
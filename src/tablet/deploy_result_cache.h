@@ -0,0 +1,123 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_DEPLOY_RESULT_CACHE_H_
+#define SRC_TABLET_DEPLOY_RESULT_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "butil/iobuf.h"
+#include "bvar/bvar.h"
+#include "catalog/tablet_catalog.h"
+#include "codec/fe_row_codec.h"
+#include "vm/engine.h"
+
+namespace openmldb::tablet {
+
+// deploy option to enable the result cache, the value is the ttl of the results in milliseconds
+inline constexpr const char* RESULT_CACHE_TTL = "result_cache_ttl";
+
+// DeployResultCache keeps the encoded output rows of the deployments created with the option
+// `result_cache_ttl`, keyed by the request row. The windows and last joins of a deployment read
+// the local tables by keys taken from the request row, a cached result is valid until its ttl
+// expires or the version of any of these keys changes. Rows expired by the ttl of the tables don't
+// change the versions, so a result may count rows expired after it is cached until it expires
+// itself. Deployments reading by other keys, whole tables or long windows are not cached
+class DeployResultCache {
+ public:
+    struct Stats {
+        uint64_t hit_cnt = 0;
+        uint64_t miss_cnt = 0;
+        // results dropped because of writes to their keys or expiration
+        uint64_t invalidate_cnt = 0;
+        // results dropped to keep the memory under the limit
+        uint64_t evict_cnt = 0;
+        uint64_t entry_cnt = 0;
+        uint64_t byte_size = 0;
+    };
+
+    struct Deployment;
+
+    // the state of one request, filled by Prepare and passed to Get and Put
+    struct Lookup {
+        std::shared_ptr<const Deployment> deployment;
+        std::string key;
+        // versions of the keys read by the request, taken before the request runs
+        std::vector<uint64_t> versions;
+    };
+
+    explicit DeployResultCache(uint64_t max_bytes);
+    ~DeployResultCache() = default;
+
+    // analyze the request plan of a deployment, return false if its results can not be cached.
+    // registering the same deployment again replaces the old one and drops its results
+    bool Register(const std::string& db, const std::string& sp_name, uint64_t ttl_ms,
+                  const std::shared_ptr<hybridse::vm::CompileInfo>& compile_info);
+    void Unregister(const std::string& db, const std::string& sp_name);
+
+    // return false if the result of `request_row` can not be cached, e.g. the deployment is not
+    // registered or some keys it reads are in the remote partitions
+    bool Prepare(const std::string& db, const std::string& sp_name, const hybridse::codec::Row& request_row,
+                 Lookup* lookup) const;
+
+    // append the cached result to `buf` if it is still valid
+    bool Get(const Lookup& lookup, butil::IOBuf* buf, uint32_t* byte_size);
+
+    void Put(const Lookup& lookup, const butil::IOBuf& buf, uint32_t byte_size);
+
+    Stats GetStats() const;
+
+    DeployResultCache(const DeployResultCache&) = delete;
+    DeployResultCache& operator=(const DeployResultCache&) = delete;
+
+ private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Deployment> deployment;
+        std::vector<uint64_t> versions;
+        butil::IOBuf buf;
+        uint32_t byte_size;
+        uint64_t expire_time;
+        uint64_t mem_size;
+    };
+    typedef std::list<Entry> EntryList;
+
+    void EraseUnlock(EntryList::iterator iter);
+    void EraseDeploymentUnlock(const std::shared_ptr<const Deployment>& deployment);
+
+    const uint64_t max_bytes_;
+    mutable std::mutex mu_;
+    absl::flat_hash_map<std::string, std::shared_ptr<const Deployment>> deployments_;
+    // the most recently used result is at the front
+    EntryList lru_;
+    absl::flat_hash_map<std::string, EntryList::iterator> entries_;
+    uint64_t byte_size_;
+    uint64_t next_deployment_id_;
+
+    bvar::Adder<uint64_t> hit_cnt_;
+    bvar::Adder<uint64_t> miss_cnt_;
+    bvar::Adder<uint64_t> invalidate_cnt_;
+    bvar::Adder<uint64_t> evict_cnt_;
+    bvar::PassiveStatus<double> hit_ratio_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_DEPLOY_RESULT_CACHE_H_
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/deploy_result_cache.h"
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "base/glog_wrapper.h"
+#include "codec/schema_codec.h"
+#include "gflags/gflags.h"
+#include "gtest/gtest.h"
+#include "schema/schema_adapter.h"
+#include "storage/mem_table.h"
+
+namespace openmldb::tablet {
+
+using ::openmldb::codec::SchemaCodec;
+
+class DeployResultCacheTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        catalog_ = std::make_shared<catalog::TabletCatalog>();
+        ASSERT_TRUE(catalog_->Init());
+        ::openmldb::api::TableMeta meta;
+        meta.set_name("t1");
+        meta.set_db("db1");
+        meta.set_tid(1);
+        meta.set_pid(0);
+        meta.set_seg_cnt(8);
+        meta.add_table_partition();
+        meta.set_mode(::openmldb::api::TableMode::kTableLeader);
+        SchemaCodec::SetColumnDesc(meta.add_column_desc(), "col1", ::openmldb::type::kString);
+        SchemaCodec::SetColumnDesc(meta.add_column_desc(), "col2", ::openmldb::type::kBigInt);
+        SchemaCodec::SetColumnDesc(meta.add_column_desc(), "col3", ::openmldb::type::kString);
+        SchemaCodec::SetIndex(meta.add_column_key(), "index0", "col1", "col2", ::openmldb::type::kAbsoluteTime, 0, 0);
+        SchemaCodec::SetIndex(meta.add_column_key(), "index1", "col3", "col2", ::openmldb::type::kAbsoluteTime, 0, 0);
+        table_ = std::make_shared<::openmldb::storage::MemTable>(meta);
+        ASSERT_TRUE(table_->Init());
+        ASSERT_TRUE(catalog_->AddTable(meta, table_));
+        schema::SchemaAdapter::ConvertSchema(meta.column_desc(), &schema_);
+        engine_ = std::make_shared<::hybridse::vm::Engine>(catalog_);
+        for (int64_t ts = 1; ts <= 5; ts++) {
+            Put("pk0", ts, "k0");
+        }
+    }
+
+    std::string EncodeRow(const std::string& col1, int64_t col2, const std::string& col3) {
+        ::hybridse::codec::RowBuilder rb(schema_);
+        uint32_t size = rb.CalTotalLength(col1.size() + col3.size());
+        std::string value;
+        value.resize(size);
+        rb.SetBuffer(reinterpret_cast<int8_t*>(&(value[0])), size);
+        rb.AppendString(col1.c_str(), col1.size());
+        rb.AppendInt64(col2);
+        rb.AppendString(col3.c_str(), col3.size());
+        return value;
+    }
+
+    void Put(const std::string& col1, int64_t col2, const std::string& col3) {
+        ::openmldb::storage::Dimensions dimensions;
+        auto* d0 = dimensions.Add();
+        d0->set_key(col1);
+        d0->set_idx(0);
+        auto* d1 = dimensions.Add();
+        d1->set_key(col3);
+        d1->set_idx(1);
+        ASSERT_TRUE(table_->Put(col2, EncodeRow(col1, col2, col3), dimensions));
+    }
+
+    ::hybridse::codec::Row RequestRow(const std::string& col1, int64_t col2, const std::string& col3) {
+        std::string value = EncodeRow(col1, col2, col3);
+        return ::hybridse::codec::Row(::hybridse::base::RefCountedSlice::Create(value.c_str(), value.size()));
+    }
+
+    std::shared_ptr<::hybridse::vm::CompileInfo> Compile(const std::string& sql) {
+        ::hybridse::vm::RequestRunSession session;
+        ::hybridse::base::Status status;
+        EXPECT_TRUE(engine_->Get(sql, "db1", session, status)) << status.msg;
+        return session.GetCompileInfo();
+    }
+
+    static butil::IOBuf Result(const std::string& data) {
+        butil::IOBuf buf;
+        buf.append(data);
+        return buf;
+    }
+
+ protected:
+    std::shared_ptr<catalog::TabletCatalog> catalog_;
+    std::shared_ptr<::openmldb::storage::MemTable> table_;
+    std::shared_ptr<::hybridse::vm::Engine> engine_;
+    ::hybridse::vm::Schema schema_;
+};
+
+static const char* const WINDOW_SQL =
+    "SELECT col1, sum(col2) OVER w1 AS w1_sum FROM t1 "
+    "WINDOW w1 AS (PARTITION BY col1 ORDER BY col2 ROWS_RANGE BETWEEN 10 PRECEDING AND CURRENT ROW);";
+
+TEST_F(DeployResultCacheTest, Hit) {
+    DeployResultCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.Register("db1", "d1", 60000, Compile(WINDOW_SQL)));
+    auto row = RequestRow("pk0", 6, "k0");
+    DeployResultCache::Lookup lookup;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_EQ(1u, lookup.versions.size());
+    butil::IOBuf buf;
+    uint32_t byte_size = 0;
+    ASSERT_FALSE(cache.Get(lookup, &buf, &byte_size));
+    cache.Put(lookup, Result("result"), 6);
+
+    DeployResultCache::Lookup lookup2;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup2));
+    ASSERT_TRUE(cache.Get(lookup2, &buf, &byte_size));
+    ASSERT_EQ("result", buf.to_string());
+    ASSERT_EQ(6u, byte_size);
+
+    // another request row misses
+    DeployResultCache::Lookup lookup3;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", RequestRow("pk0", 7, "k0"), &lookup3));
+    ASSERT_FALSE(cache.Get(lookup3, &buf, &byte_size));
+    // the deployments not registered are not cached
+    ASSERT_FALSE(cache.Prepare("db1", "d2", row, &lookup3));
+
+    auto stats = cache.GetStats();
+    ASSERT_EQ(1u, stats.hit_cnt);
+    ASSERT_EQ(2u, stats.miss_cnt);
+    ASSERT_EQ(1u, stats.entry_cnt);
+
+    // the results are dropped with the deployment
+    cache.Unregister("db1", "d1");
+    ASSERT_EQ(0u, cache.GetStats().entry_cnt);
+    ASSERT_FALSE(cache.Prepare("db1", "d1", row, &lookup3));
+}
+
+TEST_F(DeployResultCacheTest, InvalidateByWrite) {
+    DeployResultCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.Register("db1", "d1", 60000, Compile(WINDOW_SQL)));
+    auto row = RequestRow("pk0", 6, "k0");
+    DeployResultCache::Lookup lookup;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    cache.Put(lookup, Result("result"), 6);
+
+    Put("pk0", 6, "k0");
+    butil::IOBuf buf;
+    uint32_t byte_size = 0;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_FALSE(cache.Get(lookup, &buf, &byte_size));
+    ASSERT_EQ(1u, cache.GetStats().invalidate_cnt);
+
+    cache.Put(lookup, Result("result2"), 7);
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_TRUE(cache.Get(lookup, &buf, &byte_size));
+    ASSERT_EQ("result2", buf.to_string());
+
+    ASSERT_TRUE(table_->Delete("pk0", 0));
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    buf.clear();
+    ASSERT_FALSE(cache.Get(lookup, &buf, &byte_size));
+    ASSERT_EQ(2u, cache.GetStats().invalidate_cnt);
+    ASSERT_EQ(0u, cache.GetStats().entry_cnt);
+}
+
+TEST_F(DeployResultCacheTest, Expire) {
+    DeployResultCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.Register("db1", "d1", 1, Compile(WINDOW_SQL)));
+    auto row = RequestRow("pk0", 6, "k0");
+    DeployResultCache::Lookup lookup;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    cache.Put(lookup, Result("result"), 6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    butil::IOBuf buf;
+    uint32_t byte_size = 0;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_FALSE(cache.Get(lookup, &buf, &byte_size));
+    ASSERT_EQ(1u, cache.GetStats().invalidate_cnt);
+    ASSERT_EQ(0u, cache.GetStats().entry_cnt);
+}
+
+TEST_F(DeployResultCacheTest, Evict) {
+    std::string data(1000, 'a');
+    // room for one result only
+    DeployResultCache cache(1500);
+    ASSERT_TRUE(cache.Register("db1", "d1", 60000, Compile(WINDOW_SQL)));
+    DeployResultCache::Lookup lookup1;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", RequestRow("pk0", 6, "k0"), &lookup1));
+    cache.Put(lookup1, Result(data), data.size());
+    DeployResultCache::Lookup lookup2;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", RequestRow("pk0", 7, "k0"), &lookup2));
+    cache.Put(lookup2, Result(data), data.size());
+
+    auto stats = cache.GetStats();
+    ASSERT_EQ(1u, stats.evict_cnt);
+    ASSERT_EQ(1u, stats.entry_cnt);
+    ASSERT_LE(stats.byte_size, 1500u);
+    butil::IOBuf buf;
+    uint32_t byte_size = 0;
+    ASSERT_FALSE(cache.Get(lookup1, &buf, &byte_size));
+    ASSERT_TRUE(cache.Get(lookup2, &buf, &byte_size));
+}
+
+TEST_F(DeployResultCacheTest, MultiWindow) {
+    // the windows over different keys are concatenated by a concat join
+    const std::string sql =
+        "SELECT col1, sum(col2) OVER w1 AS w1_sum, count(col2) OVER w2 AS w2_cnt FROM t1 "
+        "WINDOW w1 AS (PARTITION BY col1 ORDER BY col2 ROWS_RANGE BETWEEN 10 PRECEDING AND CURRENT ROW), "
+        "w2 AS (PARTITION BY col3 ORDER BY col2 ROWS BETWEEN 3 PRECEDING AND CURRENT ROW);";
+    DeployResultCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.Register("db1", "d1", 60000, Compile(sql)));
+    auto row = RequestRow("pk0", 6, "k0");
+    DeployResultCache::Lookup lookup;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_EQ(2u, lookup.versions.size());
+    cache.Put(lookup, Result("result"), 6);
+    butil::IOBuf buf;
+    uint32_t byte_size = 0;
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_TRUE(cache.Get(lookup, &buf, &byte_size));
+
+    // a write to the key of the second window invalidates the result
+    Put("pk1", 6, "k0");
+    ASSERT_TRUE(cache.Prepare("db1", "d1", row, &lookup));
+    ASSERT_FALSE(cache.Get(lookup, &buf, &byte_size));
+}
+
+TEST_F(DeployResultCacheTest, NotCacheable) {
+    DeployResultCache cache(1024 * 1024);
+    ASSERT_FALSE(cache.Register("db1", "d1", 0, Compile(WINDOW_SQL)));
+    ASSERT_FALSE(cache.Register("db1", "d1", 60000, nullptr));
+    DeployResultCache::Lookup lookup;
+    ASSERT_FALSE(cache.Prepare("db1", "d1", RequestRow("pk0", 6, "k0"), &lookup));
+
+    DeployResultCache disabled(0);
+    ASSERT_FALSE(disabled.Register("db1", "d1", 60000, Compile(WINDOW_SQL)));
+}
+
+}  // namespace openmldb::tablet
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::openmldb::base::SetLogLevel(INFO);
+    ::google::ParseCommandLineFlags(&argc, &argv, true);
+    ::hybridse::vm::Engine::InitializeGlobalLLVM();
+    return RUN_ALL_TESTS();
+}
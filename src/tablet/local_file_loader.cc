@@ -0,0 +1,345 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tablet/local_file_loader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "base/hash.h"
+#include "base/line_chunk_reader.h"
+#include "base/taskpool.hpp"
+#include "codec/codec.h"
+#include "codec/field_codec.h"
+#include "codec/schema_codec.h"
+#include "common/timer.h"
+#include "glog/logging.h"
+#include "sdk/split.h"
+
+namespace openmldb::tablet {
+
+// the max binlog entries of a partition kept by a worker before they are appended to the replicator
+static constexpr size_t BINLOG_BATCH_SIZE = 4096;
+
+static hybridse::sdk::DataType ConvertToSdkType(::openmldb::type::DataType type) {
+    switch (type) {
+        case ::openmldb::type::kBool:
+            return hybridse::sdk::kTypeBool;
+        case ::openmldb::type::kSmallInt:
+            return hybridse::sdk::kTypeInt16;
+        case ::openmldb::type::kInt:
+            return hybridse::sdk::kTypeInt32;
+        case ::openmldb::type::kBigInt:
+            return hybridse::sdk::kTypeInt64;
+        case ::openmldb::type::kFloat:
+            return hybridse::sdk::kTypeFloat;
+        case ::openmldb::type::kDouble:
+            return hybridse::sdk::kTypeDouble;
+        case ::openmldb::type::kVarchar:
+        case ::openmldb::type::kString:
+            return hybridse::sdk::kTypeString;
+        case ::openmldb::type::kDate:
+            return hybridse::sdk::kTypeDate;
+        case ::openmldb::type::kTimestamp:
+            return hybridse::sdk::kTypeTimestamp;
+        default:
+            return hybridse::sdk::kTypeUnknow;
+    }
+}
+
+// RowEncoder encodes a row with RowBuilder and keeps the values of the index columns,
+// the keys are the same as the ones built by SQLInsertRow
+class RowEncoder {
+ public:
+    RowEncoder(const ::openmldb::codec::Schema& schema, const std::vector<bool>& is_key_col,
+               const std::vector<bool>& is_ts_col)
+        : rb_(schema), is_key_col_(is_key_col), is_ts_col_(is_ts_col), keys_(schema.size()) {}
+
+    bool Init(uint32_t str_len, std::string* row) {
+        uint32_t size = rb_.CalTotalLength(str_len);
+        row->resize(size);
+        return rb_.SetBuffer(reinterpret_cast<int8_t*>(&(*row)[0]), size);
+    }
+
+    bool AppendBool(bool val) {
+        SetKey(val ? "true" : "false");
+        return rb_.AppendBool(val);
+    }
+    bool AppendInt16(int16_t val) {
+        SetKey(std::to_string(val));
+        return rb_.AppendInt16(val);
+    }
+    bool AppendInt32(int32_t val) {
+        SetKey(std::to_string(val));
+        return rb_.AppendInt32(val);
+    }
+    bool AppendInt64(int64_t val) {
+        SetKey(std::to_string(val));
+        return rb_.AppendInt64(val);
+    }
+    bool AppendTimestamp(int64_t val) {
+        SetKey(std::to_string(val));
+        return rb_.AppendTimestamp(val);
+    }
+    bool AppendFloat(float val) { return rb_.AppendFloat(val); }
+    bool AppendDouble(double val) { return rb_.AppendDouble(val); }
+    bool AppendString(const char* val, uint32_t length) {
+        if (is_key_col_[rb_.GetAppendPos()]) {
+            if (length == 0) {
+                keys_[rb_.GetAppendPos()] = ::openmldb::codec::EMPTY_STRING;
+            } else {
+                keys_[rb_.GetAppendPos()].assign(val, length);
+            }
+        }
+        return rb_.AppendString(val, length);
+    }
+    bool AppendDate(uint32_t year, uint32_t month, uint32_t day) {
+        uint32_t date = 0;
+        if (!::openmldb::codec::RowBuilder::ConvertDate(year, month, day, &date)) {
+            return false;
+        }
+        SetKey(std::to_string(date));
+        return rb_.AppendDate(static_cast<int32_t>(date));
+    }
+    bool AppendNULL() {
+        if (is_ts_col_[rb_.GetAppendPos()]) {
+            return false;
+        }
+        SetKey(::openmldb::codec::NONETOKEN);
+        return rb_.AppendNULL();
+    }
+
+    bool IsComplete() { return rb_.IsComplete(); }
+
+    const std::string& GetKey(uint32_t col) const { return keys_[col]; }
+
+ private:
+    void SetKey(std::string key) {
+        if (is_key_col_[rb_.GetAppendPos()]) {
+            keys_[rb_.GetAppendPos()] = std::move(key);
+        }
+    }
+
+ private:
+    ::openmldb::codec::RowBuilder rb_;
+    const std::vector<bool>& is_key_col_;
+    const std::vector<bool>& is_ts_col_;
+    std::vector<std::string> keys_;
+};
+
+LocalFileLoader::LocalFileLoader(const std::shared_ptr<::openmldb::api::TableMeta>& table_meta,
+                                 uint32_t partition_num, const std::map<uint32_t, Partition>& partitions)
+    : table_meta_(table_meta),
+      partition_num_(partition_num),
+      partitions_(partitions),
+      index_cols_(),
+      is_key_col_(table_meta->column_desc_size(), false),
+      is_ts_col_(table_meta->column_desc_size(), false),
+      row_cnt_(0),
+      failed_(false),
+      mu_(),
+      error_msg_() {
+    std::map<std::string, uint32_t> column_name_map;
+    for (int idx = 0; idx < table_meta_->column_desc_size(); idx++) {
+        column_name_map.emplace(table_meta_->column_desc(idx).name(), idx);
+    }
+    for (const auto& column_key : table_meta_->column_key()) {
+        std::vector<uint32_t> cols;
+        for (const auto& name : column_key.col_name()) {
+            auto it = column_name_map.find(name);
+            if (it != column_name_map.end()) {
+                cols.push_back(it->second);
+                is_key_col_[it->second] = true;
+            }
+        }
+        index_cols_.emplace_back(std::move(cols));
+        auto it = column_name_map.find(column_key.ts_name());
+        if (it != column_name_map.end()) {
+            is_ts_col_[it->second] = true;
+        }
+    }
+}
+
+base::Status LocalFileLoader::Load(const ::openmldb::api::LoadLocalFileRequest& request) {
+    ::openmldb::base::LineChunkReader reader;
+    if (!reader.Open(request.file_path(), request.offset())) {
+        return {base::ReturnCode::kInvalidParameter, "open file " + request.file_path() + " failed"};
+    }
+    uint32_t thread_num = std::max(request.thread_num(), 1u);
+    // the queue only holds a few chunks, the reader is blocked if the workers fall behind
+    ::openmldb::base::TaskPool pool(thread_num, thread_num * 2);
+    uint64_t line_no = request.first_line();
+    while (!failed_.load(std::memory_order_relaxed)) {
+        auto chunk = std::make_shared<Chunk>();
+        if (!reader.Next(&chunk->data)) {
+            break;
+        }
+        chunk->first_line = line_no;
+        line_no += std::count(chunk->data.begin(), chunk->data.end(), '\n');
+        pool.AddTask([this, &request, chunk]() { LoadChunk(request, chunk.get()); });
+    }
+    // the queued chunks are loaded before the workers exit
+    pool.Stop();
+    if (reader.HasError()) {
+        SetError("read from file " + request.file_path() + " failed");
+    }
+    if (failed_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mu_);
+        return {base::ReturnCode::kWriteDataFailed, error_msg_};
+    }
+    return {};
+}
+
+void LocalFileLoader::LoadChunk(const ::openmldb::api::LoadLocalFileRequest& request, Chunk* chunk) {
+    if (failed_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const auto& schema = table_meta_->column_desc();
+    int col_cnt = schema.size();
+    std::vector<hybridse::sdk::DataType> types;
+    for (const auto& col : schema) {
+        types.push_back(ConvertToSdkType(col.data_type()));
+    }
+    char quote = request.quote().empty() ? '\0' : request.quote()[0];
+    const std::string& delimiter = request.delimiter();
+    const std::string& null_value = request.null_value();
+    RowEncoder encoder(schema, is_key_col_, is_ts_col_);
+    std::map<uint32_t, std::vector<::openmldb::api::LogEntry>> binlogs;
+    std::map<uint32_t, uint64_t> terms;
+    for (const auto& kv : partitions_) {
+        binlogs[kv.first].reserve(BINLOG_BATCH_SIZE);
+        terms.emplace(kv.first, kv.second.replicator->GetLeaderTerm());
+    }
+    std::vector<char*> cols;
+    std::string value;
+    uint64_t line_no = chunk->first_line;
+    uint64_t row_cnt = 0;
+    char* line = &chunk->data[0];
+    char* data_end = line + chunk->data.size();
+    while (line < data_end && !failed_.load(std::memory_order_relaxed)) {
+        char* line_end = static_cast<char*>(memchr(line, '\n', data_end - line));
+        if (line_end == nullptr) {
+            line_end = data_end;
+        } else {
+            *line_end = '\0';
+        }
+        cols.clear();
+        ::openmldb::sdk::SplitLineWithDelimiter(line, line_end - line, delimiter.c_str(), &cols, quote);
+        if (static_cast<int>(cols.size()) != col_cnt) {
+            SetError("line " + std::to_string(line_no) + " load failed, column size mismatch");
+            break;
+        }
+        uint32_t str_len = 0;
+        for (int i = 0; i < col_cnt; i++) {
+            if (types[i] == hybridse::sdk::kTypeString && null_value != cols[i]) {
+                str_len += strlen(cols[i]);
+            }
+        }
+        bool ok = encoder.Init(str_len, &value);
+        for (int i = 0; i < col_cnt && ok; i++) {
+            ok = ::openmldb::codec::AppendColumnValue(cols[i], types[i], schema.Get(i).not_null(), null_value,
+                                                      &encoder);
+        }
+        if (!ok || !encoder.IsComplete()) {
+            SetError("line " + std::to_string(line_no) + " load failed, translate to row failed");
+            break;
+        }
+        uint64_t cur_ts = ::baidu::common::timer::get_micros() / 1000;
+        std::map<uint32_t, ::openmldb::api::LogEntry*> row_entries;
+        for (size_t idx = 0; idx < index_cols_.size(); idx++) {
+            std::string key;
+            for (uint32_t col : index_cols_[idx]) {
+                if (!key.empty()) {
+                    key += "|";
+                }
+                key += encoder.GetKey(col);
+            }
+            uint32_t pid = 0;
+            if (partition_num_ > 0) {
+                pid = static_cast<uint32_t>(::openmldb::base::hash64(key) % partition_num_);
+            }
+            auto binlog_it = binlogs.find(pid);
+            if (binlog_it == binlogs.end()) {
+                // the partition is not on this tablet
+                continue;
+            }
+            auto& entry = row_entries[pid];
+            if (entry == nullptr) {
+                entry = &binlog_it->second.emplace_back();
+                entry->set_ts(cur_ts);
+                entry->set_value(value);
+                entry->set_term(terms[pid]);
+            }
+            auto* dim = entry->add_dimensions();
+            dim->set_key(std::move(key));
+            dim->set_idx(idx);
+        }
+        for (const auto& kv : row_entries) {
+            const auto* entry = kv.second;
+            if (!partitions_.at(kv.first).table->Put(entry->ts(), entry->value(), entry->dimensions())) {
+                SetError("line " + std::to_string(line_no) + " load failed, put to partition " +
+                         std::to_string(kv.first) + " failed");
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        for (const auto& kv : row_entries) {
+            auto& entries = binlogs[kv.first];
+            if (entries.size() >= BINLOG_BATCH_SIZE && !FlushBinlog(kv.first, &entries)) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        row_cnt++;
+        line = line_end + 1;
+        line_no++;
+    }
+    // the rows put to the tables must have their binlog even if the load failed
+    for (auto& kv : binlogs) {
+        FlushBinlog(kv.first, &kv.second);
+    }
+    row_cnt_.fetch_add(row_cnt, std::memory_order_relaxed);
+}
+
+bool LocalFileLoader::FlushBinlog(uint32_t pid, std::vector<::openmldb::api::LogEntry>* entries) {
+    if (entries->empty()) {
+        return true;
+    }
+    bool ok = partitions_.at(pid).replicator->AppendEntries(entries);
+    entries->clear();
+    if (!ok) {
+        SetError("append binlog to partition " + std::to_string(pid) + " failed");
+    }
+    return ok;
+}
+
+void LocalFileLoader::SetError(const std::string& msg) {
+    LOG(WARNING) << "table " << table_meta_->tid() << " " << msg;
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!failed_.load(std::memory_order_relaxed)) {
+        error_msg_ = msg;
+        failed_.store(true, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace openmldb::tablet
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2021 4Paradigm
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SRC_TABLET_LOCAL_FILE_LOADER_H_
+#define SRC_TABLET_LOCAL_FILE_LOADER_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "base/status.h"
+#include "proto/tablet.pb.h"
+#include "replica/log_replicator.h"
+#include "storage/table.h"
+
+namespace openmldb::tablet {
+
+// LocalFileLoader loads a csv file on the local disk to the leader partitions of a table on this tablet.
+// The chunks of the file are parsed by `thread_num` workers, the rows are encoded with RowBuilder and put
+// to the tables directly, and the binlog of every chunk is appended to the replicators in one batch.
+// The rows which belong to the partitions of other tablets are skipped
+class LocalFileLoader {
+ public:
+    struct Partition {
+        std::shared_ptr<::openmldb::storage::Table> table;
+        std::shared_ptr<::openmldb::replica::LogReplicator> replicator;
+    };
+
+    LocalFileLoader(const std::shared_ptr<::openmldb::api::TableMeta>& table_meta, uint32_t partition_num,
+                    const std::map<uint32_t, Partition>& partitions);
+
+    base::Status Load(const ::openmldb::api::LoadLocalFileRequest& request);
+
+    // the lines loaded, include the lines that have no dimension in the partitions
+    uint64_t GetRowCnt() const { return row_cnt_.load(std::memory_order_relaxed); }
+
+    LocalFileLoader(const LocalFileLoader&) = delete;
+    LocalFileLoader& operator=(const LocalFileLoader&) = delete;
+
+ private:
+    struct Chunk {
+        std::string data;
+        uint64_t first_line;
+    };
+
+    void LoadChunk(const ::openmldb::api::LoadLocalFileRequest& request, Chunk* chunk);
+
+    bool FlushBinlog(uint32_t pid, std::vector<::openmldb::api::LogEntry>* entries);
+
+    void SetError(const std::string& msg);
+
+ private:
+    std::shared_ptr<::openmldb::api::TableMeta> table_meta_;
+    uint32_t partition_num_;
+    std::map<uint32_t, Partition> partitions_;
+    // the columns of every index, in the order of column_key
+    std::vector<std::vector<uint32_t>> index_cols_;
+    std::vector<bool> is_key_col_;
+    std::vector<bool> is_ts_col_;
+    std::atomic<uint64_t> row_cnt_;
+    std::atomic<bool> failed_;
+    std::mutex mu_;
+    std::string error_msg_;
+};
+
+}  // namespace openmldb::tablet
+#endif  // SRC_TABLET_LOCAL_FILE_LOADER_H_
@@ -50,6 +50,7 @@
 #include "brpc/controller.h"
 #include "butil/iobuf.h"
 #include "codec/codec.h"
+#include "codec/columnar_codec.h"
 #include "codec/row_codec.h"
 #include "codec/sql_rpc_row_codec.h"
 #include "common/timer.h"
@@ -61,6 +62,9 @@
 #include "storage/table.h"
 #include "storage/disk_table_snapshot.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "sdk/routing_table.h"
 
 using google::protobuf::RepeatedPtrField;
 using ::openmldb::base::ReturnCode;
@@ -71,6 +75,8 @@ using ::openmldb::storage::DiskTable;
 
 DECLARE_int32(gc_interval);
 DECLARE_int32(gc_pool_size);
+DECLARE_uint32(binlog_apply_thread_num);
+DECLARE_uint32(binlog_apply_batch_size);
 DECLARE_int32(disk_gc_interval);
 DECLARE_int32(statdb_ttl);
 DECLARE_uint32(scan_max_bytes_size);
@@ -115,6 +121,13 @@ DECLARE_uint32(snapshot_ttl_time);
 DECLARE_uint32(snapshot_ttl_check_interval);
 DECLARE_uint32(put_slow_log_threshold);
 DECLARE_uint32(query_slow_log_threshold);
+DECLARE_uint32(request_max_parallelism);
+DECLARE_bool(enable_sql_literal_parameterize);
+DECLARE_bool(enable_tiered_compile);
+DECLARE_uint32(tiered_compile_threshold);
+DECLARE_bool(enable_window_column_pruning);
+DECLARE_bool(enable_index_statistics);
+DECLARE_uint64(deploy_result_cache_max_bytes);
 DECLARE_int32(snapshot_pool_size);
 
 namespace openmldb {
@@ -136,15 +149,19 @@ TabletImpl::TabletImpl()
       task_pool_(FLAGS_task_pool_size),
       io_pool_(FLAGS_io_pool_size),
       snapshot_pool_(FLAGS_snapshot_pool_size),
+      follower_applier_(FLAGS_binlog_apply_thread_num, FLAGS_binlog_apply_batch_size),
       mode_root_paths_(),
       mode_recycle_root_paths_(),
       follower_(false),
       catalog_(new ::openmldb::catalog::TabletCatalog()),
       engine_(),
+      follower_engine_(),
       zk_cluster_(),
       zk_path_(),
       endpoint_(),
       sp_cache_(std::shared_ptr<SpCache>(new SpCache())),
+      follower_sp_cache_(std::make_shared<SpCache>()),
+      deploy_result_cache_(FLAGS_deploy_result_cache_max_bytes),
       notify_path_(),
       globalvar_changed_notify_path_(),
       startup_mode_(::openmldb::type::StartupMode::kStandalone) {}
@@ -207,10 +224,18 @@ bool TabletImpl::Init(const std::string& zk_cluster, const std::string& zk_path,
     } else {
         options.SetClusterOptimized(false);
     }
+    options.SetEnableLiteralParameterize(FLAGS_enable_sql_literal_parameterize);
+    options.SetEnableTieredCompile(FLAGS_enable_tiered_compile);
+    options.SetTieredCompileThreshold(FLAGS_tiered_compile_threshold);
+    options.SetEnableWindowColumnPruning(FLAGS_enable_window_column_pruning);
+    options.SetEnableIndexStatistics(FLAGS_enable_index_statistics);
     engine_ = std::unique_ptr<::hybridse::vm::Engine>(new ::hybridse::vm::Engine(catalog_, options));
+    // the deployments with read_policy follower are compiled on the tables with the local followers
+    follower_engine_ = std::make_unique<::hybridse::vm::Engine>(
+        std::make_shared<::openmldb::catalog::FollowerReadCatalog>(catalog_), options);
     catalog_->SetLocalTablet(
         std::shared_ptr<::hybridse::vm::Tablet>(new ::hybridse::vm::LocalTablet(engine_.get(), sp_cache_)));
-    std::set<std::string> snapshot_compression_set{"off", "zlib", "snappy"};
+    std::set<std::string> snapshot_compression_set{"off", "zlib", "snappy", "zstd"};
     if (snapshot_compression_set.find(FLAGS_snapshot_compression) == snapshot_compression_set.end()) {
         LOG(ERROR) << "wrong snapshot_compression: " << FLAGS_snapshot_compression;
         return false;
@@ -1633,9 +1658,62 @@ void TabletImpl::Query(RpcController* ctrl, const openmldb::api::QueryRequest* r
     brpc::ClosureGuard done_guard(done);
     brpc::Controller* cntl = static_cast<brpc::Controller*>(ctrl);
     butil::IOBuf& buf = cntl->response_attachment();
+    if (request->has_follower_read()) {
+        auto status = CheckFollowerRead(request->follower_read());
+        if (!status.OK()) {
+            response->set_code(status.code);
+            response->set_msg(status.msg);
+            return;
+        }
+    }
     ProcessQuery(ctrl, request, response, &buf);
 }
 
+base::Status TabletImpl::CheckFollowerRead(const ::openmldb::api::FollowerRead& follower_read) {
+    uint32_t tid = follower_read.tid();
+    uint32_t pid = follower_read.pid();
+    std::shared_ptr<Table> table = GetTable(tid, pid);
+    if (!table) {
+        return {base::kTableIsNotExist, "table is not exist"};
+    }
+    if (table->IsLeader()) {
+        return {};
+    }
+    std::shared_ptr<LogReplicator> replicator = GetReplicator(tid, pid);
+    if (!replicator) {
+        return {base::kReplicatorIsNotExist, "replicator is not exist"};
+    }
+    uint64_t lag = replicator->GetFollowerLag();
+    if (lag > follower_read.max_lag()) {
+        DLOG(INFO) << "follower of tid " << tid << " pid " << pid << " is behind the leader by " << lag;
+        return {base::kFollowerLagTooLarge,
+                "follower lag is too large. tid " + std::to_string(tid) + " pid " + std::to_string(pid)};
+    }
+    return {};
+}
+
+// Encode the first `count` rows in the columnar encoding which is requested by the client. It's false if the rows can't
+// be encoded so, then they are sent in the row format
+static bool EncodeColumnarResult(const ::openmldb::api::ColumnarResult& columnar, const ::hybridse::codec::Schema& schema,
+                                 const std::vector<size_t>& common_indices,
+                                 const std::vector<::hybridse::codec::Row>& rows, size_t count, butil::IOBuf* buf,
+                                 ::openmldb::api::ColumnarResult* result) {
+    std::string encoded;
+    if (!::openmldb::codec::ColumnarEncoder(schema, common_indices).Encode(rows, count, &encoded)) {
+        return false;
+    }
+    result->set_raw_size(encoded.size());
+    if (columnar.compress_type() == ::openmldb::type::CompressType::kSnappy) {
+        std::string compressed;
+        ::snappy::Compress(encoded.data(), encoded.size(), &compressed);
+        buf->append(compressed);
+        result->set_compress_type(::openmldb::type::CompressType::kSnappy);
+    } else {
+        buf->append(encoded);
+    }
+    return true;
+}
+
 void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryRequest* request,
                               ::openmldb::api::QueryResponse* response, butil::IOBuf* buf) {
     auto start = absl::Now();
@@ -1697,6 +1775,27 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
         }
         uint32_t byte_size = 0;
         uint32_t count = 0;
+        if (request->has_columnar()) {
+            // the same rows as the row format
+            while (count < output_rows.size() && byte_size <= FLAGS_scan_max_bytes_size) {
+                byte_size += output_rows[count].size();
+                count++;
+            }
+            if (count < output_rows.size()) {
+                LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
+            }
+            if (EncodeColumnarResult(request->columnar(), session.GetSchema(), {}, output_rows, count, buf,
+                                     response->mutable_columnar())) {
+                response->set_schema(session.GetEncodedSchema());
+                response->set_byte_size(buf->size());
+                response->set_count(count);
+                response->set_code(::openmldb::base::kOk);
+                return;
+            }
+            response->clear_columnar();
+            byte_size = 0;
+            count = 0;
+        }
         for (auto& output_row : output_rows) {
             if (byte_size > FLAGS_scan_max_bytes_size) {
                 LOG(WARNING) << "reach the max byte size " << FLAGS_scan_max_bytes_size << " truncate result";
@@ -1718,6 +1817,7 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
                    << byte_size;
     } else {
         ::hybridse::vm::RequestRunSession session;
+        session.SetMaxParallelism(FLAGS_request_max_parallelism);
         if (request->is_debug()) {
             session.EnableDebug();
         }
@@ -1727,7 +1827,12 @@ void TabletImpl::ProcessQuery(RpcController* ctrl, const openmldb::api::QueryReq
             std::shared_ptr<hybridse::vm::CompileInfo> request_compile_info;
             {
                 hybridse::base::Status status;
-                request_compile_info = sp_cache_->GetRequestInfo(db_name, sp_name, status);
+                // a follower read runs the plan on the local followers if the deployment has read_policy follower
+                if (request->has_follower_read() && follower_sp_cache_->ProcedureExist(db_name, sp_name)) {
+                    request_compile_info = follower_sp_cache_->GetRequestInfo(db_name, sp_name, status);
+                } else {
+                    request_compile_info = sp_cache_->GetRequestInfo(db_name, sp_name, status);
+                }
                 if (!status.isOK()) {
                     response->set_code(::openmldb::base::ReturnCode::kProcedureNotFound);
                     response->set_msg(status.msg);
@@ -1898,6 +2003,20 @@ void TabletImpl::ProcessBatchRequestQuery(RpcController* ctrl,
     auto& output_common_indices = batch_request_info.output_common_column_indices;
     bool has_common_and_uncomon_slice =
         !request->has_task_id() && !output_common_indices.empty() && output_common_indices.size() < output_col_num;
+    if (request->has_columnar() && !request->has_task_id()) {
+        std::vector<size_t> common_indices;
+        if (has_common_and_uncomon_slice) {
+            common_indices.assign(output_common_indices.begin(), output_common_indices.end());
+        }
+        if (EncodeColumnarResult(request->columnar(), session.GetSchema(), common_indices, output_rows,
+                                 output_rows.size(), &buf, response->mutable_columnar())) {
+            response->set_schema(session.GetEncodedSchema());
+            response->set_count(output_rows.size());
+            response->set_code(::openmldb::base::kOk);
+            return;
+        }
+        response->clear_columnar();
+    }
 
     if (has_common_and_uncomon_slice && !output_rows.empty()) {
         const auto& first_row = output_rows[0];
@@ -2044,7 +2163,7 @@ void TabletImpl::ChangeRole(RpcController* controller, const ::openmldb::api::Ch
         }
         PDLOG(INFO, "change to follower. tid[%u] pid[%u]", tid, pid);
         if (!table->GetDB().empty()) {
-            catalog_->DeleteTable(table->GetDB(), table->GetName(), pid);
+            catalog_->AddFollowerTable(*(table->GetTableMeta()), table);
         }
     }
     response->set_code(::openmldb::base::ReturnCode::kOk);
@@ -2221,9 +2340,13 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
     }
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
+    std::lock_guard<bthread::Mutex> apply_lock(*replicator->GetFollowerApplyMutex());
     uint64_t last_log_offset = replicator->GetOffset();
     if (request->pre_log_index() == 0 && request->entries_size() == 0) {
         response->set_log_offset(last_log_offset);
+        if (request->has_leader_log_offset()) {
+            replicator->SetFollowerOffsets(last_log_offset, request->leader_log_offset(), true);
+        }
         if (!FLAGS_zk_cluster.empty() && request->term() > term) {
             replicator->SetLeaderTerm(request->term());
             PDLOG(INFO, "get log_offset %lu and set term %lu. tid %u, pid %u",
@@ -2233,6 +2356,17 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
         PDLOG(INFO, "first sync log_index! log_offset[%lu] tid[%u] pid[%u]", last_log_offset, tid, pid);
         return;
     }
+    if (request->pre_log_index() > last_log_offset) {
+        // the previous batch from the pipelined leader has not arrived yet, the leader will resend it
+        PDLOG(WARNING, "pre log index %lu is greater than cur log_offset %lu. tid %u pid %u", request->pre_log_index(),
+              last_log_offset, tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator);
+        response->set_msg("pre log index mismatch");
+        response->set_log_offset(last_log_offset);
+        return;
+    }
+    // the binlog is written in order and the entries are put into table by the applier
+    ::openmldb::storage::LogApplier::Session session(&follower_applier_, table);
     for (int32_t i = 0; i < request->entries_size(); i++) {
         const auto& entry = request->entries(i);
         if (entry.log_index() <= last_log_offset) {
@@ -2253,14 +2387,25 @@ void TabletImpl::AppendEntries(RpcController* controller, const ::openmldb::api:
                 response->set_msg("fail to append entries to replicator");
                 return;
             }
+            // delete is a barrier, the entries before it should be applied first
+            if (session.Wait() > 0) {
+                PDLOG(WARNING, "fail to put entry. tid %u pid %u", tid, pid);
+                response->set_code(::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator);
+                response->set_msg("fail to append entry to table");
+                return;
+            }
             table->Delete(entry.dimensions(0).key(), entry.dimensions(0).idx());
         }
-        if (!table->Put(entry)) {
-            PDLOG(WARNING, "fail to put entry. tid %u pid %u", tid, pid);
-            response->set_code(::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator);
-            response->set_msg("fail to append entry to table");
-            return;
-        }
+        session.Put(entry);
+    }
+    if (session.Wait() > 0) {
+        PDLOG(WARNING, "fail to put entry. tid %u pid %u", tid, pid);
+        response->set_code(::openmldb::base::ReturnCode::kFailToAppendEntriesToReplicator);
+        response->set_msg("fail to append entry to table");
+        return;
+    }
+    if (request->has_leader_log_offset()) {
+        replicator->SetFollowerOffsets(replicator->GetOffset(), request->leader_log_offset(), false);
     }
     response->set_log_offset(replicator->GetOffset());
 }
@@ -2392,6 +2537,7 @@ void TabletImpl::GetTableStatus(RpcController* controller, const ::openmldb::api
             std::shared_ptr<LogReplicator> replicator = GetReplicatorUnLock(table->GetId(), table->GetPid());
             if (replicator) {
                 status->set_offset(replicator->GetOffset());
+                replicator->GetFollowerLagStatus(status);
             }
             status->set_record_cnt(table->GetRecordCnt());
             if (table->GetStorageMode() == common::kMemory) {
@@ -2822,6 +2968,7 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
         full_path.append("snapshot/");
         std::string manifest_file = full_path + "MANIFEST";
         std::string snapshot_file;
+        std::vector<std::string> delta_files;
         {
             int fd = open(manifest_file.c_str(), O_RDONLY);
             if (fd < 0) {
@@ -2837,6 +2984,9 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
                 break;
             }
             snapshot_file = manifest.name();
+            for (const auto& delta : manifest.deltas()) {
+                delta_files.push_back(delta.name());
+            }
         }
         if (table->GetStorageMode() == common::kMemory) {
             // send snapshot file
@@ -2844,6 +2994,17 @@ void TabletImpl::SendSnapshotInternal(const std::string& endpoint, uint32_t tid,
                 PDLOG(WARNING, "send snapshot failed. tid[%u] pid[%u]", tid, pid);
                 break;
             }
+            bool send_delta_failed = false;
+            for (const auto& delta_file : delta_files) {
+                if (sender.SendFile(delta_file, full_path + delta_file) < 0) {
+                    PDLOG(WARNING, "send delta snapshot %s failed. tid[%u] pid[%u]", delta_file.c_str(), tid, pid);
+                    send_delta_failed = true;
+                    break;
+                }
+            }
+            if (send_delta_failed) {
+                break;
+            }
         } else {
             if (sender.SendDir(snapshot_file, full_path + snapshot_file) < 0) {
                 PDLOG(WARNING, "send snapshot failed. tid[%u] pid[%u]", tid, pid);
@@ -3275,7 +3436,8 @@ int32_t TabletImpl::DeleteTableInternal(uint32_t tid, uint32_t pid,
         std::shared_ptr<LogReplicator> replicator = GetReplicator(tid, pid);
         {
             std::lock_guard<SpinMutex> spin_lock(spin_mutex_);
-            engine_->ClearCacheLocked(table->GetTableMeta()->db());
+            engine_->ClearCacheLocked(table->GetTableMeta()->db(), table->GetTableMeta()->name());
+            follower_engine_->ClearCacheLocked(table->GetTableMeta()->db(), table->GetTableMeta()->name());
             tables_[tid].erase(pid);
             replicators_[tid].erase(pid);
             snapshots_[tid].erase(pid);
@@ -3899,12 +4061,22 @@ int TabletImpl::CreateTableInternal(const ::openmldb::api::TableMeta* table_meta
         } else {
             LOG(WARNING) << "fail to add table " << table_meta->name() << " to catalog with db " << table_meta->db();
         }
-        engine_->ClearCacheLocked(table_meta->db());
+        engine_->ClearCacheLocked(table_meta->db(), table_meta->name());
+        follower_engine_->ClearCacheLocked(table_meta->db(), table_meta->name());
 
         // we always refresh the aggr catalog in case zk notification arrives later than the `deploy` sql
         if (boost::iequals(table_meta->db(), openmldb::nameserver::PRE_AGG_DB)) {
             RefreshAggrCatalog();
         }
+    } else if (!table_meta->db().empty()) {
+        // the followers are only read by the deployments with read_policy follower
+        if (catalog_->AddFollowerTable(*table_meta, table)) {
+            LOG(INFO) << "add follower table " << table_meta->name() << " to catalog with db " << table_meta->db();
+        } else {
+            LOG(WARNING) << "fail to add follower table " << table_meta->name() << " to catalog with db "
+                         << table_meta->db();
+        }
+        follower_engine_->ClearCacheLocked(table_meta->db(), table_meta->name());
     }
     return 0;
 }
@@ -5401,6 +5573,8 @@ void TabletImpl::CreateProcedure(RpcController* controller, const openmldb::api:
 
     sp_cache_->InsertSQLProcedureCacheEntry(db_name, sp_name, sp_info_impl, session.GetCompileInfo(),
                                             batch_session.GetCompileInfo());
+    RegisterResultCache(sp_info_impl, session.GetCompileInfo());
+    CreateFollowerReadProcedure(sp_info_impl, options);
 
     response->set_code(::openmldb::base::ReturnCode::kOk);
     response->set_msg("ok");
@@ -5417,6 +5591,8 @@ void TabletImpl::DropProcedure(RpcController* controller, const ::openmldb::api:
     auto is_deployment_procedure = sp_info.ok() && sp_info.value()->GetType() == hybridse::sdk::kReqDeployment;
 
     sp_cache_->DropSQLProcedureCacheEntry(db_name, sp_name);
+    follower_sp_cache_->DropSQLProcedureCacheEntry(db_name, sp_name);
+    deploy_result_cache_.Unregister(db_name, sp_name);
     if (!catalog_->DropProcedure(db_name, sp_name)) {
         LOG(WARNING) << "drop procedure " << db_name << "." << sp_name << " in catalog failed";
     }
@@ -5449,6 +5625,21 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
         response.set_msg("fail to decode input row");
         return;
     }
+    // the results of the deployments with option result_cache_ttl are cached by the request row
+    DeployResultCache::Lookup lookup;
+    // the key versions are of the leaders, so the follower reads aren't cached
+    bool cacheable = request.is_procedure() && !request.is_debug() && !request.has_task_id() &&
+                     !request.has_follower_read() &&
+                     deploy_result_cache_.Prepare(request.db(), request.sp_name(), row, &lookup);
+    uint32_t cached_size = 0;
+    if (cacheable && deploy_result_cache_.Get(lookup, &buf, &cached_size)) {
+        response.set_schema(session.GetEncodedSchema());
+        response.set_byte_size(cached_size);
+        response.set_count(1);
+        response.set_row_slices(1);
+        response.set_code(::openmldb::base::kOk);
+        return;
+    }
     ::hybridse::codec::Row output;
     int32_t ret = 0;
     if (request.has_task_id()) {
@@ -5465,12 +5656,18 @@ void TabletImpl::RunRequestQuery(RpcController* ctrl, const openmldb::api::Query
         response.set_msg("do not support multiple output row slices");
         return;
     }
+    size_t buf_offset = buf.size();
     size_t buf_total_size;
     if (!codec::EncodeRpcRow(output, &buf, &buf_total_size)) {
         response.set_code(::openmldb::base::kSQLRunError);
         response.set_msg("fail to encode sql output row");
         return;
     }
+    if (cacheable) {
+        butil::IOBuf result;
+        buf.append_to(&result, buf.size() - buf_offset, buf_offset);
+        deploy_result_cache_.Put(lookup, result, buf_total_size);
+    }
     if (!request.has_task_id()) {
         response.set_schema(session.GetEncodedSchema());
     }
@@ -5516,10 +5713,47 @@ void TabletImpl::CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureI
     }
     sp_cache_->InsertSQLProcedureCacheEntry(db_name, sp_name, sp_info, session.GetCompileInfo(),
                                             batch_session.GetCompileInfo());
+    RegisterResultCache(sp_info, session.GetCompileInfo());
+    CreateFollowerReadProcedure(sp_info, options);
 
     LOG(INFO) << "refresh procedure success! sp_name: " << sp_name << ", db: " << db_name << ", sql: " << sql;
 }
 
+void TabletImpl::RegisterResultCache(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                     const std::shared_ptr<hybridse::vm::CompileInfo>& request_info) {
+    auto ttl = sp_info->GetOption(RESULT_CACHE_TTL);
+    if (!ttl) {
+        return;
+    }
+    uint64_t ttl_ms = 0;
+    if (!absl::SimpleAtoi(*ttl, &ttl_ms)) {
+        LOG(WARNING) << "invalid " << RESULT_CACHE_TTL << " " << *ttl << " of deployment " << sp_info->GetDbName()
+                     << "." << sp_info->GetSpName();
+        return;
+    }
+    deploy_result_cache_.Register(sp_info->GetDbName(), sp_info->GetSpName(), ttl_ms, request_info);
+}
+
+void TabletImpl::CreateFollowerReadProcedure(
+    const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+    const std::shared_ptr<std::unordered_map<std::string, std::string>>& options) {
+    auto policy = sp_info->GetOption(::openmldb::sdk::READ_POLICY);
+    if (!policy || !absl::EqualsIgnoreCase(*policy, ::openmldb::sdk::READ_POLICY_FOLLOWER)) {
+        return;
+    }
+    ::hybridse::base::Status status;
+    ::hybridse::vm::RequestRunSession session;
+    session.SetOptions(options);
+    if (!follower_engine_->Get(sp_info->GetSql(), sp_info->GetDbName(), session, status) ||
+        session.GetCompileInfo() == nullptr) {
+        // the follower reads fall back to the plan of the leaders
+        LOG(WARNING) << "fail to compile sql for follower read " << sp_info->GetSql() << std::endl << status.str();
+        return;
+    }
+    follower_sp_cache_->InsertSQLProcedureCacheEntry(sp_info->GetDbName(), sp_info->GetSpName(), sp_info,
+                                                     session.GetCompileInfo(), nullptr);
+}
+
 void TabletImpl::GetBulkLoadInfo(RpcController* controller, const ::openmldb::api::BulkLoadInfoRequest* request,
                                  ::openmldb::api::BulkLoadInfoResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -5713,6 +5947,80 @@ void TabletImpl::BulkLoad(RpcController* controller, const ::openmldb::api::Bulk
     }
 }
 
+void TabletImpl::LoadLocalFile(RpcController* controller, const ::openmldb::api::LoadLocalFileRequest* request,
+                               ::openmldb::api::LoadLocalFileResponse* response, Closure* done) {
+    brpc::ClosureGuard done_guard(done);
+    if (follower_.load(std::memory_order_relaxed)) {
+        response->set_code(::openmldb::base::ReturnCode::kIsFollowerCluster);
+        response->set_msg("is follower cluster");
+        return;
+    }
+    uint32_t tid = request->tid();
+    if (request->pid_size() == 0 || request->file_path().empty() || request->partition_num() == 0) {
+        response->set_code(::openmldb::base::ReturnCode::kInvalidParameter);
+        response->set_msg("pid, file path and partition num are required");
+        return;
+    }
+    std::map<uint32_t, LocalFileLoader::Partition> partitions;
+    std::shared_ptr<::openmldb::api::TableMeta> table_meta;
+    for (auto pid : request->pid()) {
+        std::shared_ptr<Table> table = GetTable(tid, pid);
+        if (!table) {
+            PDLOG(WARNING, "table is not exist. tid %u, pid %u", tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kTableIsNotExist);
+            response->set_msg("table is not exist");
+            return;
+        }
+        if (!table->IsLeader()) {
+            response->set_code(::openmldb::base::ReturnCode::kTableIsFollower);
+            response->set_msg("table is follower");
+            return;
+        }
+        if (table->GetTableStat() == ::openmldb::storage::kLoading) {
+            PDLOG(WARNING, "table is loading. tid %u, pid %u", tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kTableIsLoading);
+            response->set_msg("table is loading");
+            return;
+        }
+        // the rows skip the pre-aggregators, which are only updated by the put path
+        auto aggrs = GetAggregators(tid, pid);
+        if (table->GetStorageMode() != ::openmldb::common::kMemory || (aggrs && !aggrs->empty())) {
+            response->set_code(::openmldb::base::ReturnCode::kOperatorNotSupport);
+            response->set_msg("only memory table without pre-aggregator is supported");
+            return;
+        }
+        auto replicator = GetReplicator(tid, pid);
+        if (!replicator) {
+            PDLOG(WARNING, "fail to find table tid %u pid %u leader's log replicator", tid, pid);
+            response->set_code(::openmldb::base::ReturnCode::kReplicatorIsNotExist);
+            response->set_msg("replicator is not exist");
+            return;
+        }
+        if (!table_meta) {
+            table_meta = table->GetTableMeta();
+        }
+        partitions.emplace(pid, LocalFileLoader::Partition{table, replicator});
+    }
+    uint64_t start_time = ::baidu::common::timer::get_micros();
+    LocalFileLoader loader(table_meta, request->partition_num(), partitions);
+    auto status = loader.Load(*request);
+    if (FLAGS_binlog_notify_on_put) {
+        for (const auto& kv : partitions) {
+            kv.second.replicator->Notify();
+        }
+    }
+    response->set_row_cnt(loader.GetRowCnt());
+    if (!status.OK()) {
+        response->set_code(status.GetCode());
+        response->set_msg(status.GetMsg());
+        return;
+    }
+    PDLOG(INFO, "load file %s to tid %u with %d partitions, %lu rows, cost %lu us", request->file_path().c_str(), tid,
+          request->pid_size(), loader.GetRowCnt(), ::baidu::common::timer::get_micros() - start_time);
+    response->set_code(::openmldb::base::ReturnCode::kOk);
+    response->set_msg("ok");
+}
+
 void TabletImpl::CreateFunction(RpcController* controller, const openmldb::api::CreateFunctionRequest* request,
         openmldb::api::CreateFunctionResponse* response, Closure* done) {
     brpc::ClosureGuard done_guard(done);
@@ -5754,6 +6062,7 @@ void TabletImpl::DropFunction(RpcController* controller, const openmldb::api::Dr
         arg_types.emplace_back(data_type);
     }
     engine_->ClearCacheLocked("");
+    follower_engine_->ClearCacheLocked("");
     auto status = engine_->RemoveExternalFunction(fun.name(), arg_types, fun.file());
     if (status.isOK()) {
         LOG(INFO) << "Drop function success. name " << fun.name() << " path " << fun.file();
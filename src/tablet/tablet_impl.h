@@ -25,6 +25,7 @@
 #include <mutex>  // NOLINT
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -35,13 +36,16 @@
 #include "proto/tablet.pb.h"
 #include "replica/log_replicator.h"
 #include "storage/aggregator.h"
+#include "storage/log_applier.h"
 #include "sdk/sql_cluster_router.h"
 #include "statistics/query_response_time/deploy_query_response_time.h"
 #include "storage/mem_table.h"
 #include "storage/mem_table_snapshot.h"
 #include "tablet/bulk_load_mgr.h"
 #include "tablet/combine_iterator.h"
+#include "tablet/deploy_result_cache.h"
 #include "tablet/file_receiver.h"
+#include "tablet/local_file_loader.h"
 #include "tablet/sp_cache.h"
 #include "vm/engine.h"
 #include "zk/zk_client.h"
@@ -273,6 +277,9 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     void BulkLoad(RpcController* controller, const ::openmldb::api::BulkLoadRequest* request,
                   ::openmldb::api::GeneralResponse* response, Closure* done);
 
+    void LoadLocalFile(RpcController* controller, const ::openmldb::api::LoadLocalFileRequest* request,
+                       ::openmldb::api::LoadLocalFileResponse* response, Closure* done);
+
     void CreateAggregator(RpcController* controller, const ::openmldb::api::CreateAggregatorRequest* request,
                           ::openmldb::api::CreateAggregatorResponse* response, Closure* done);
 
@@ -421,6 +428,8 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     void ProcessQuery(RpcController* controller, const openmldb::api::QueryRequest* request,
                       ::openmldb::api::QueryResponse* response, butil::IOBuf* buf);
+    // the local replica of the partition can serve the follower read if it's the leader or not behind it too much
+    base::Status CheckFollowerRead(const ::openmldb::api::FollowerRead& follower_read);
     void ProcessBatchRequestQuery(RpcController* controller, const openmldb::api::SQLBatchRequestQueryRequest* request,
                                   openmldb::api::SQLBatchRequestQueryResponse* response,
                                   butil::IOBuf& buf);  // NOLINT
@@ -448,6 +457,15 @@ class TabletImpl : public ::openmldb::api::TabletServer {
 
     void CreateProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info);
 
+    // register the deployment to the result cache if it has the option result_cache_ttl
+    void RegisterResultCache(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                             const std::shared_ptr<hybridse::vm::CompileInfo>& request_info);
+
+    // compile the deployment on the local followers too if it has the option read_policy follower, so the follower
+    // reads are served by this tablet
+    void CreateFollowerReadProcedure(const std::shared_ptr<hybridse::sdk::ProcedureInfo>& sp_info,
+                                     const std::shared_ptr<std::unordered_map<std::string, std::string>>& options);
+
     // refresh the pre-aggr tables info
     bool RefreshAggrCatalog();
 
@@ -464,6 +482,8 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     ThreadPool task_pool_;
     ThreadPool io_pool_;
     ThreadPool snapshot_pool_;
+    // apply the entries from leader in parallel
+    ::openmldb::storage::LogApplier follower_applier_;
     std::map<uint64_t, std::list<std::shared_ptr<::openmldb::api::TaskInfo>>> task_map_;
     std::set<std::string> sync_snapshot_set_;
     std::map<std::string, std::shared_ptr<FileReceiver>> file_receiver_map_;
@@ -478,11 +498,16 @@ class TabletImpl : public ::openmldb::api::TabletServer {
     std::shared_ptr<::openmldb::catalog::TabletCatalog> catalog_;
     // thread safe
     std::unique_ptr<::hybridse::vm::Engine> engine_;
+    // thread safe, the engine of the deployments with read_policy follower
+    std::unique_ptr<::hybridse::vm::Engine> follower_engine_;
     std::shared_ptr<::hybridse::vm::LocalTablet> local_tablet_;
     std::string zk_cluster_;
     std::string zk_path_;
     std::string endpoint_;
     std::shared_ptr<SpCache> sp_cache_;
+    // the request compile info of the deployments with read_policy follower
+    std::shared_ptr<SpCache> follower_sp_cache_;
+    DeployResultCache deploy_result_cache_;
     std::string notify_path_;
     std::string sp_root_path_;
     std::string globalvar_changed_notify_path_;
@@ -24,17 +24,21 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <fstream>
 #include <utility>
 
 #include "absl/cleanup/cleanup.h"
 #include "base/file_util.h"
 #include "base/glog_wrapper.h"
+#include "base/hash.h"
 #include "base/kv_iterator.h"
 #include "base/strings.h"
 #include "boost/lexical_cast.hpp"
 #include "codec/codec.h"
+#include "codec/fe_schema_codec.h"
 #include "codec/row_codec.h"
 #include "codec/schema_codec.h"
+#include "codec/sql_rpc_row_codec.h"
 #include "common/timer.h"
 #include "gtest/gtest.h"
 #include "log/log_reader.h"
@@ -59,6 +63,7 @@ DECLARE_string(recycle_bin_ssd_root_path);
 DECLARE_string(recycle_bin_hdd_root_path);
 DECLARE_string(endpoint);
 DECLARE_uint32(recycle_ttl);
+DECLARE_int32(follower_read_max_idle_ms);
 
 namespace openmldb {
 namespace tablet {
@@ -413,6 +418,138 @@ TEST_F(TabletImplTest, ChangeRole) {
     }
 }
 
+TEST_F(TabletImplTest, FollowerRead) {
+    TabletImpl tablet;
+    ASSERT_TRUE(tablet.Init(""));
+    MockClosure closure;
+    uint32_t id = counter++;
+    ::openmldb::api::TableMeta table_meta;
+    table_meta.set_db("db0");
+    table_meta.set_name("t1");
+    table_meta.set_tid(id);
+    table_meta.set_pid(0);
+    table_meta.add_table_partition()->set_pid(0);
+    table_meta.set_mode(::openmldb::api::TableMode::kTableFollower);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "c1", ::openmldb::type::kString);
+    SchemaCodec::SetColumnDesc(table_meta.add_column_desc(), "c2", ::openmldb::type::kBigInt);
+    SchemaCodec::SetIndex(table_meta.add_column_key(), "index0", "c1", "c2", kAbsoluteTime, 0, 0);
+    {
+        ::openmldb::api::CreateTableRequest request;
+        request.mutable_table_meta()->CopyFrom(table_meta);
+        ::openmldb::api::CreateTableResponse response;
+        tablet.CreateTable(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code()) << response.msg();
+    }
+    auto encode = [&table_meta](const std::string& c1, int64_t c2) {
+        codec::RowBuilder builder(table_meta.column_desc());
+        uint32_t size = builder.CalTotalLength(c1.size());
+        std::string row;
+        row.resize(size);
+        builder.SetBuffer(reinterpret_cast<int8_t*>(&(row[0])), size);
+        builder.AppendString(c1.c_str(), c1.size());
+        builder.AppendInt64(c2);
+        return row;
+    };
+    // the entries from the leader, the rows only exist in the local follower replica
+    auto append_entries = [&](uint64_t pre_log_index, uint64_t leader_log_offset, uint64_t cnt) {
+        ::openmldb::api::AppendEntriesRequest request;
+        request.set_tid(id);
+        request.set_pid(0);
+        request.set_pre_log_index(pre_log_index);
+        request.set_leader_log_offset(leader_log_offset);
+        for (uint64_t i = 1; i <= cnt; i++) {
+            auto entry = request.add_entries();
+            entry->set_log_index(pre_log_index + i);
+            entry->set_ts(1000 + pre_log_index + i);
+            entry->set_value(encode("key0", 1000 + pre_log_index + i));
+            auto dimension = entry->add_dimensions();
+            dimension->set_key("key0");
+            dimension->set_idx(0);
+        }
+        ::openmldb::api::AppendEntriesResponse response;
+        tablet.AppendEntries(NULL, &request, &response, &closure);
+        return response.code();
+    };
+    ASSERT_EQ(0, append_entries(0, 2, 0));
+    ASSERT_EQ(0, append_entries(0, 2, 2));
+    {
+        ::openmldb::api::CreateProcedureRequest request;
+        auto sp_info = request.mutable_sp_info();
+        sp_info->set_db_name("db0");
+        sp_info->set_sp_name("d1");
+        sp_info->set_sql(
+            "SELECT c1, count(c2) OVER w1 AS cnt FROM t1 "
+            "WINDOW w1 AS (PARTITION BY c1 ORDER BY c2 ROWS BETWEEN 10 PRECEDING AND CURRENT ROW);");
+        sp_info->set_type(::openmldb::type::ProcedureType::kReqDeployment);
+        sp_info->mutable_input_schema()->CopyFrom(table_meta.column_desc());
+        auto option = sp_info->add_options();
+        option->set_name("read_policy");
+        option->mutable_value()->set_value("follower");
+        ::openmldb::api::GeneralResponse response;
+        tablet.CreateProcedure(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code()) << response.msg();
+    }
+    // the count of the window of key0, -1 if the call fails with `code`
+    auto call = [&](bool follower_read, uint64_t max_lag, int* code) -> int64_t {
+        ::openmldb::api::QueryRequest request;
+        request.set_db("db0");
+        request.set_sp_name("d1");
+        request.set_is_procedure(true);
+        request.set_is_batch(false);
+        std::string row = encode("key0", 2000);
+        brpc::Controller cntl;
+        cntl.request_attachment().append(row);
+        request.set_row_size(row.size());
+        request.set_row_slices(1);
+        if (follower_read) {
+            auto read = request.mutable_follower_read();
+            read->set_tid(id);
+            read->set_pid(0);
+            read->set_max_lag(max_lag);
+        }
+        ::openmldb::api::QueryResponse response;
+        tablet.Query(&cntl, &request, &response, &closure);
+        *code = response.code();
+        if (response.code() != 0) {
+            return -1;
+        }
+        ::hybridse::codec::Schema schema;
+        ::hybridse::codec::Row output;
+        if (!::hybridse::codec::SchemaCodec::Decode(response.schema(), &schema) ||
+            !codec::DecodeRpcRow(cntl.response_attachment(), 0, response.byte_size(), response.row_slices(),
+                                 &output)) {
+            *code = -1;
+            return -1;
+        }
+        ::hybridse::codec::RowView view(schema, output.buf(), output.size());
+        return view.GetInt64Unsafe(1);
+    };
+    int code = 0;
+    // the follower read runs on the local follower replica, the window has the two replicated rows
+    ASSERT_EQ(3, call(true, 10, &code));
+    ASSERT_EQ(0, code);
+    // the other calls read the leaders, which are not local
+    ASSERT_EQ(1, call(false, 0, &code));
+    ASSERT_EQ(0, code);
+
+    // the leader is ahead by 98 entries
+    ASSERT_EQ(0, append_entries(2, 100, 0));
+    ASSERT_EQ(-1, call(true, 10, &code));
+    ASSERT_EQ(::openmldb::base::ReturnCode::kFollowerLagTooLarge, code);
+    ASSERT_EQ(3, call(true, 100, &code));
+
+    // the follower which hasn't heard from the leader for long is rejected too
+    int32_t max_idle_ms = FLAGS_follower_read_max_idle_ms;
+    absl::Cleanup restore = [max_idle_ms] { FLAGS_follower_read_max_idle_ms = max_idle_ms; };
+    FLAGS_follower_read_max_idle_ms = 100;
+    usleep(200 * 1000);
+    ASSERT_EQ(-1, call(true, 100, &code));
+    ASSERT_EQ(::openmldb::base::ReturnCode::kFollowerLagTooLarge, code);
+    // an empty request from the leader makes it readable again
+    ASSERT_EQ(0, append_entries(2, 100, 0));
+    ASSERT_EQ(3, call(true, 100, &code));
+}
+
 TEST_P(TabletImplTest, CountLatestTable) {
     ::openmldb::common::StorageMode storage_mode = GetParam();
     TabletImpl tablet;
@@ -5478,6 +5615,96 @@ TEST_P(TabletImplTest, PutCompress) {
     }
 }
 
+TEST_F(TabletImplTest, LoadLocalFile) {
+    TabletImpl tablet;
+    tablet.Init("");
+    MockClosure closure;
+    uint32_t id = counter++;
+    uint32_t partition_num = 2;
+    for (uint32_t pid = 0; pid < partition_num; pid++) {
+        ::openmldb::api::CreateTableRequest request;
+        ::openmldb::api::TableMeta* table_meta = request.mutable_table_meta();
+        AddDefaultAggregatorBaseSchema(table_meta);
+        table_meta->set_tid(id);
+        table_meta->set_pid(pid);
+        ::openmldb::api::CreateTableResponse response;
+        tablet.CreateTable(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+    }
+    std::string file_path = "/tmp/load_local_file_" + GenRand() + ".csv";
+    absl::Cleanup clean = [&file_path] { remove(file_path.c_str()); };
+    {
+        std::ofstream ofile(file_path);
+        ofile << "id,ts_col,col3,col4\n";
+        for (int i = 0; i < 100; i++) {
+            ofile << "key" << i % 10 << "," << 1000 + i << "," << i % 5 << "," << i * 1.5 << "\n";
+        }
+    }
+    ::openmldb::api::LoadLocalFileRequest request;
+    request.set_tid(id);
+    request.add_pid(0);
+    request.add_pid(1);
+    request.set_partition_num(partition_num);
+    request.set_file_path(file_path);
+    // skip the header
+    request.set_offset(strlen("id,ts_col,col3,col4\n"));
+    request.set_first_line(2);
+    request.set_thread_num(2);
+    {
+        ::openmldb::api::LoadLocalFileResponse response;
+        tablet.LoadLocalFile(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code()) << response.msg();
+        ASSERT_EQ(100u, response.row_cnt());
+    }
+    auto count = [&](const std::string& idx_name, const std::string& key) {
+        ::openmldb::api::CountRequest request;
+        request.set_tid(id);
+        request.set_pid(static_cast<uint32_t>(::openmldb::base::hash64(key) % partition_num));
+        request.set_idx_name(idx_name);
+        request.set_key(key);
+        ::openmldb::api::CountResponse response;
+        tablet.Count(NULL, &request, &response, &closure);
+        EXPECT_EQ(0, response.code());
+        return response.count();
+    };
+    ASSERT_EQ(10u, count("idx1", "key3"));
+    ASSERT_EQ(20u, count("idx2", "4"));
+    // every row has one binlog entry in each partition it belongs to
+    uint64_t offset = 0;
+    {
+        ::openmldb::api::GetTableStatusRequest request;
+        ::openmldb::api::GetTableStatusResponse response;
+        tablet.GetTableStatus(NULL, &request, &response, &closure);
+        ASSERT_EQ(0, response.code());
+        for (const auto& status : response.all_table_status()) {
+            if (status.tid() == id) {
+                offset += status.offset();
+            }
+        }
+    }
+    ASSERT_GE(offset, 100u);
+    ASSERT_LE(offset, 200u);
+
+    // the line number of the bad row is in the message
+    {
+        std::ofstream ofile(file_path, std::ios::app);
+        ofile << "key0,1000,abc,1.0\n";
+    }
+    {
+        ::openmldb::api::LoadLocalFileResponse response;
+        tablet.LoadLocalFile(NULL, &request, &response, &closure);
+        ASSERT_NE(0, response.code());
+        ASSERT_NE(response.msg().find("line 102"), std::string::npos) << response.msg();
+    }
+    // the partition must be on the tablet
+    {
+        request.add_pid(partition_num);
+        ::openmldb::api::LoadLocalFileResponse response;
+        tablet.LoadLocalFile(NULL, &request, &response, &closure);
+        ASSERT_EQ(::openmldb::base::ReturnCode::kTableIsNotExist, response.code());
+    }
+}
+
 INSTANTIATE_TEST_CASE_P(TabletMemAndHDD, TabletImplTest,
                         ::testing::Values(::openmldb::common::kMemory,/*::openmldb::common::kSSD,*/
                                           ::openmldb::common::kHDD));
@@ -40,7 +40,7 @@ DEFINE_string(delimiter, ",", "delimiter");
 
 using ::openmldb::base::ParseFileNameFromPath;
 using ::openmldb::base::Slice;
-using ::openmldb::log::NewSeqFile;
+using ::openmldb::log::NewMmapSeqFile;
 using ::openmldb::log::Reader;
 using ::openmldb::log::SequentialFile;
 using ::openmldb::log::Status;
@@ -58,6 +58,7 @@ void LogExporter::ReadManifest() {
     std::string snapshot_name = manifest.name();
     snapshot_path_ = table_dir_path_ + "/snapshot/" + snapshot_name;
     offset_ = manifest.offset();
+    compress_dict_ = manifest.compress_dict();
     PDLOG(INFO, "Snapshot's offset: %lu, path: %s.", offset_, snapshot_path_.c_str());
 }
 
@@ -106,7 +107,7 @@ uint64_t LogExporter::GetLogStartOffset(std::string &log_path) {
         PDLOG(ERROR, "fopen failed: %s", log_path.c_str());
         return 0;
     }
-    SequentialFile* rf = NewSeqFile(log_path, fd_r);
+    SequentialFile* rf = NewMmapSeqFile(log_path, fd_r);
     std::string scratch;
     bool is_compress = false;
 
@@ -116,7 +117,7 @@ uint64_t LogExporter::GetLogStartOffset(std::string &log_path) {
     Slice first_value;
     status = reader.ReadRecord(&first_value, &scratch);
     ::openmldb::api::LogEntry first_entry;
-    first_entry.ParseFromString(first_value.ToString());
+    first_entry.ParseFromArray(first_value.data(), first_value.size());
     PDLOG(INFO, "The start offset of binlog file %s is %lu, ", log_path.c_str(), first_entry.log_index());
     if (first_entry.log_index() < offset_) {
         PDLOG(INFO, "The start offset of binlog file %s is %lu, smaller than snapshot's offset.",
@@ -135,7 +136,7 @@ void LogExporter::ReadLog(const std::string &log_path) {
         return;
     }
 
-    SequentialFile* rf = NewSeqFile(log_path, fd_r);
+    SequentialFile* rf = NewMmapSeqFile(log_path, fd_r);
     std::string scratch;
     bool is_compress = false;
 
@@ -152,15 +153,15 @@ void LogExporter::ReadLog(const std::string &log_path) {
             break;
         }
         ::openmldb::api::LogEntry entry;
-        entry.ParseFromString(value.ToString());
+        entry.ParseFromArray(value.data(), value.size());
 
         // Determine if there is a dimension with an idx of 0 in the dimensions.
         // If so, parse the value, else skip it
         if (entry.dimensions_size() != 0 && entry.log_index() > offset_) {
             for (int i = 0; i < entry.dimensions_size(); i++) {
                 if (entry.dimensions(i).idx() == 0) {
-                    std::string row = entry.value();
-                    view.Reset(reinterpret_cast<int8_t*>(&(row[0])), row.size());
+                    const std::string& row = entry.value();
+                    view.Reset(reinterpret_cast<const int8_t*>(row.data()), row.size());
                     WriteToFile(view);
                     success_cnt++;
                     break;
@@ -178,14 +179,16 @@ void LogExporter::ReadSnapshot() {
         PDLOG(ERROR, "fopen failed: %s", snapshot_path_.c_str());
         return;
     }
-    SequentialFile* rf = NewSeqFile(snapshot_path_, fd_r);
+    SequentialFile* rf = NewMmapSeqFile(snapshot_path_, fd_r);
     std::string scratch;
     bool is_compress = false;
     if (snapshot_path_.find(openmldb::log::ZLIB_COMPRESS_SUFFIX) != std::string::npos ||
-        snapshot_path_.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos) {
+        snapshot_path_.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos ||
+        snapshot_path_.find(openmldb::log::ZSTD_COMPRESS_SUFFIX) != std::string::npos) {
         is_compress = true;
     }
     Reader reader(rf, NULL, true, 0, is_compress);
+    reader.SetCompressDict(compress_dict_);
     Status status;
     RowView view(schema_);
 
@@ -197,16 +200,15 @@ void LogExporter::ReadSnapshot() {
             break;
         }
         ::openmldb::api::LogEntry entry;
-        entry.ParseFromString(value.ToString());
+        entry.ParseFromArray(value.data(), value.size());
 
         // Determine if there is a dimension with an idx of 0 in the dimensions.
         // If so, parse the value, else skip it
         if (entry.dimensions_size() != 0) {
             for (int i = 0; i < entry.dimensions_size(); i++) {
                 if (entry.dimensions(i).idx() == 0) {
-                    std::string row;
-                    row = entry.value();
-                    view.Reset(reinterpret_cast<int8_t*>(&(row[0])), row.size());
+                    const std::string& row = entry.value();
+                    view.Reset(reinterpret_cast<const int8_t*>(row.data()), row.size());
                     WriteToFile(view);
                     break;
                 }
@@ -58,6 +58,7 @@ class LogExporter {
     std::ofstream& table_cout_;
     uint64_t offset_;
     std::string snapshot_path_;
+    std::string compress_dict_;
     Schema schema_;
 
     uint64_t GetLogStartOffset(std::string&);
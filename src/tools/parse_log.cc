@@ -50,7 +50,8 @@ void ReadLog(const std::string& full_path) {
     std::string scratch;
     bool for_snapshot = false;
     if (full_path.find(openmldb::log::ZLIB_COMPRESS_SUFFIX) != std::string::npos ||
-        full_path.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos) {
+        full_path.find(openmldb::log::SNAPPY_COMPRESS_SUFFIX) != std::string::npos ||
+        full_path.find(openmldb::log::ZSTD_COMPRESS_SUFFIX) != std::string::npos) {
         for_snapshot = true;
     }
     Reader reader(rf, NULL, true, 0, for_snapshot);
@@ -94,6 +94,9 @@ class ZkClient {
 
     bool GetNodeValueAndStat(const char* node, std::string* value, Stat* stat);
 
+    // only the stat is read, the value of the node isn't transferred
+    bool GetNodeStat(const std::string& node, Stat* stat);
+
     bool SetNodeValue(const std::string& node, const std::string& value);
 
     bool SetNodeWatcher(const std::string& node, watcher_fn watcher, void* watcherCtx);